@@ -39,13 +39,13 @@ dataset_hdr2.c dataset_hdr3.c datum.c descriptor.c dft.c dimension.c dsdf.c \
 encoding.c frame.c http.c io.c iterator.c json.c log.c node.c oob.c operator.c \
 packet.c plane.c processor.c property.c send.c stream.c time.c tt2000.c \
 units.c utf8.c util.c value.c var_base.c var_con.c var_seq.c var_ary.c var_una.c \
-var_bin.c vector.c uri.c
+var_bin.c vector.c uri.c binacc.c histo.c fmt.c xform.c
  
 HDRS:=defs.h time.h das1.h util.h log.h buffer.h utf8.h value.h units.h \
  tt2000.h operator.h datum.h frame.h array.h encoding.h variable.h descriptor.h \
  dimension.h dataset.h plane.h packet.h stream.h processor.h property.h oob.h \
  io.h iterator.h builder.h dsdf.h credentials.h http.h dft.h json.h node.h cli.h \
- send.h uri.h vector.h codec.h codex.h core.h
+ send.h uri.h vector.h codec.h codex.h binacc.h histo.h fmt.h xform.h core.h
  
 ifeq ($(SPICE),yes)
 SRCS:=$(SRCS) spice.c
@@ -55,11 +55,13 @@ endif
 UTIL_PROGS=das1_inctime das2_prtime das1_fxtime das2_ascii das2_bin_avg \
  das2_bin_avgsec das2_bin_peakavgsec das2_from_das1 das2_from_tagged_das1 \
  das1_ascii das1_bin_avg das2_bin_ratesec das2_psd das2_hapi das2_histo \
- das2_cache_rdr das3_node das3_csv das3_test das3_text
+ das2_cache_rdr das3_node das3_csv das3_test das3_text das2_wisdom \
+ das2_bin_quantile
 
 TEST_PROGS:=TestUnits TestArray TestVariable TestDataset TestBuilder \
  TestAuth TestCatalog TestTT2000 ex_das_cli ex_das_ephem TestCredMngr \
- TestV3Read TestProp TestIter TestUri TestFilter TestValue TestRaggedEncode
+ TestV3Read TestProp TestIter TestUri TestFilter TestValue TestRaggedEncode \
+ TestBinAcc TestDft TestHisto TestFmt TestXform TestHttp
 
 CDF_PROGS:=das3_cdf das3_from_cdf
  
@@ -291,6 +293,7 @@ test_main: $(BD) $(BD)/$(TARG).a $(BUILD_TEST_PROGS) $(BULID_UTIL_PROGS)
 	test/das2_bin_avgsec_test1.sh $(BD)
 	test/das2_bin_avgsec_test2.sh $(BD)
 	test/das2_bin_peakavgsec_test1.sh $(BD)
+	test/das2_bin_quantile_test1.sh $(BD)
 	test/das2_from_das1_test1.sh $(BD)
 	test/das2_from_das1_test2.sh $(BD)
 	test/das2_histo_test1.sh $(BD)
@@ -309,6 +312,18 @@ test_main: $(BD) $(BD)/$(TARG).a $(BUILD_TEST_PROGS) $(BULID_UTIL_PROGS)
 	@$(BD)/TestVariable
 	@echo "INFO: Running unit test for dataset shape/length merge, $(BD)/TestDataset..."
 	@$(BD)/TestDataset
+	@echo "INFO: Running unit test for bin accumulators, $(BD)/TestBinAcc..."
+	@$(BD)/TestBinAcc
+	@echo "INFO: Running unit test for real input and parallel DFTs, $(BD)/TestDft..."
+	@$(BD)/TestDft
+	@echo "INFO: Running unit test for histograms and quantile sketches, $(BD)/TestHisto..."
+	@$(BD)/TestHisto
+	@echo "INFO: Running unit test for printf-free value formatting, $(BD)/TestFmt..."
+	@$(BD)/TestFmt
+	@echo "INFO: Running unit test for rotation and state interpolation, $(BD)/TestXform..."
+	@$(BD)/TestXform
+	@echo "INFO: Running unit test for HTTP keep-alive and body framing, $(BD)/TestHttp..."
+	@$(BD)/TestHttp
 	@echo "INFO: Running unit test for dataset builder, $(BD)/TestBuilder..."
 	@$(BD)/TestBuilder
 	@echo "INFO: Running unit test for dataset loader, $(BD)/das3_test..."
@@ -39,7 +39,7 @@ SRCS=$(SD)\das1.c $(SD)\array.c $(SD)\buffer.c $(SD)\builder.c $(SD)\cli.c \
   $(SD)\plane.c $(SD)\processor.c $(SD)\property.c $(SD)\send.c $(SD)\stream.c \
   $(SD)\time.c $(SD)\tt2000.c $(SD)\units.c $(SD)\utf8.c $(SD)\util.c $(SD)\value.c \
   $(SD)\var_base.c $(SD)\var_con.c $(SD)\var_seq.c $(SD)\var_ary.c $(SD)\var_una.c \
-  $(SD)\var_bin.c $(SD)\vector.c
+  $(SD)\var_bin.c $(SD)\vector.c $(SD)\binacc.c $(SD)\histo.c $(SD)\fmt.c $(SD)\xform.c
 
 
 LD=$(BD)\static
@@ -51,7 +51,7 @@ STATIC_OBJS=$(LD)\das1.obj $(LD)\array.obj $(LD)\buffer.obj $(LD)\builder.obj $(
   $(LD)\plane.obj $(LD)\processor.obj $(LD)\property.obj $(LD)\send.obj $(LD)\stream.obj \
   $(LD)\time.obj $(LD)\tt2000.obj $(LD)\units.obj $(LD)\utf8.obj $(LD)\util.obj $(LD)\value.obj \
   $(LD)\var_base.obj $(LD)\var_con.obj $(LD)\var_seq.obj $(LD)\var_ary.obj $(LD)\var_una.obj \
-  $(LD)\var_bin.obj $(LD)\vector.obj
+  $(LD)\var_bin.obj $(LD)\vector.obj $(LD)\binacc.obj $(LD)\histo.obj $(LD)\fmt.obj $(LD)\xform.obj
   
 DD=$(BD)\shared
 DLL_OBJS=$(DD)\das1.obj $(DD)\array.obj $(DD)\buffer.obj $(DD)\builder.obj $(DD)\cli.obj \
@@ -62,7 +62,7 @@ DLL_OBJS=$(DD)\das1.obj $(DD)\array.obj $(DD)\buffer.obj $(DD)\builder.obj $(DD)
   $(DD)\plane.obj $(DD)\processor.obj $(DD)\property.obj $(DD)\send.obj $(DD)\stream.obj \
   $(DD)\time.obj $(DD)\tt2000.obj $(DD)\units.obj $(DD)\utf8.obj $(DD)\util.obj $(DD)\value.obj \
   $(DD)\var_base.obj $(DD)\var_con.obj $(DD)\var_seq.obj $(DD)\var_ary.obj $(DD)\var_una.obj \
-  $(DD)\var_bin.obj $(DD)\vector.obj
+  $(DD)\var_bin.obj $(DD)\vector.obj $(DD)\binacc.obj $(DD)\histo.obj $(DD)\fmt.obj $(DD)\xform.obj
   
 HDRS=$(SD)\das1.h $(SD)\array.h $(SD)\buffer.h $(SD)\builder.h $(SD)\core.h \
   $(SD)\codec.h $(SD)\cli.h $(SD)\credentials.h $(SD)\dataset.h $(SD)\datum.h \
@@ -71,14 +71,15 @@ HDRS=$(SD)\das1.h $(SD)\array.h $(SD)\buffer.h $(SD)\builder.h $(SD)\core.h \
   $(SD)\json.h $(SD)\log.h $(SD)\node.h $(SD)\oob.h $(SD)\operator.h $(SD)\packet.h \
   $(SD)\plane.h $(SD)\processor.h $(SD)\property.h $(SD)\send.h $(SD)\stream.h \
   $(SD)\time.h $(SD)\tt2000.h $(SD)\units.h $(SD)\utf8.h $(SD)\util.h $(SD)\value.h \
-  $(SD)\variable.h $(SD)\vector.h
+  $(SD)\variable.h $(SD)\vector.h $(SD)\binacc.h $(SD)\histo.h $(SD)\fmt.h $(SD)\xform.h
 
 UTIL_PROGS=$(BD)\das1_inctime.exe $(BD)\das2_prtime.exe $(BD)\das1_fxtime.exe \
  $(BD)\das2_ascii.exe $(BD)\das2_bin_avg.exe $(BD)\das2_bin_avgsec.exe \
  $(BD)\das2_bin_peakavgsec.exe $(BD)\das2_cache_rdr.exe $(BD)\das2_from_das1.exe \
  $(BD)\das2_from_tagged_das1.exe $(BD)\das1_ascii.exe $(BD)\das1_bin_avg.exe \
  $(BD)\das2_bin_ratesec.exe $(BD)\das2_psd.exe $(BD)\das2_hapi.exe \
- $(BD)\das2_histo.exe $(BD)\das3_node.exe $(BD)\das3_csv.exe $(BD)\das3_test.exe
+ $(BD)\das2_histo.exe $(BD)\das3_node.exe $(BD)\das3_csv.exe $(BD)\das3_test.exe \
+ $(BD)\das2_wisdom.exe $(BD)\das2_bin_quantile.exe
 
 TEST_PROGS=$(BD)\TestUnits.exe $(BD)\TestArray.exe $(BD)\TestBuilder.exe \
  $(BD)\TestAuth.exe $(BD)\TestCatalog.exe $(BD)\TestTT2000.exe $(BD)\TestVariable.exe \
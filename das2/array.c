@@ -15,13 +15,22 @@
  * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>. 
  */
 
+#ifdef __linux__
+#define _GNU_SOURCE  /* for mremap */
+#else
 #define _POSIX_C_SOURCE 200112L
+#endif
 
 #include <assert.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stddef.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#define DYNABUF_CAN_MAP
+#endif
+
 #include "util.h"
 #define _das_array_c_
 #include "array.h"
@@ -104,10 +113,90 @@ int das_rng2shape(
 /* ************************************************************************* */
 /* DynaBuf functions */ 
 
+#ifdef DYNABUF_CAN_MAP
+
+/* Maps are sized in huge page multiples so the kernel may back them with 
+ * transparent huge pages, the extra room just becomes growth space */
+#define DYNABUF_MAP_ALIGN 2097152
+
+/* Move or grow the element storage into an anonymous memory map with room
+ * for at least uAlloc items.  Valid items must start at pBuf if the storage
+ * is already mapped. */
+static bool _DynaBuf_mapTo(DynaBuf* pThis, size_t uAlloc)
+{
+	size_t uBytes = uAlloc * pThis->uElemSz;
+	uBytes = ((uBytes + DYNABUF_MAP_ALIGN - 1) / DYNABUF_MAP_ALIGN) * DYNABUF_MAP_ALIGN;
+	void* pNew = NULL;
+	
+	if(pThis->uMapSz > 0){
+		pNew = mremap(pThis->pBuf, pThis->uMapSz, uBytes, MREMAP_MAYMOVE);
+	}
+	else{
+		pNew = mmap(NULL, uBytes, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if(pNew != MAP_FAILED){
+			if(pThis->uValid)
+				memcpy(pNew, pThis->pHead, pThis->uElemSz * pThis->uValid);
+			if((pThis->pBuf != NULL)&&(!pThis->bKeepMem)) free(pThis->pBuf);
+			pThis->bKeepMem = false;  /* The map is ours */
+		}
+	}
+	if(pNew == MAP_FAILED){
+		das_error(DASERR_ARRAY, "Couldn't map %zu bytes for %zu items of size %zu",
+		          uBytes, uAlloc, pThis->uElemSz);
+		return false;
+	}
+#ifdef MADV_HUGEPAGE
+	madvise(pNew, uBytes, MADV_HUGEPAGE);
+#endif
+	pThis->pBuf = (ubyte*)pNew;
+	pThis->uMapSz = uBytes;
+	pThis->uSize = uBytes / pThis->uElemSz;
+	return true;
+}
+
+/* Move element storage out of a memory map and back to the heap */
+static bool _DynaBuf_unmap(DynaBuf* pThis, size_t uAlloc)
+{
+	if(uAlloc == 0) uAlloc = 1;  /* malloc(0) may legally return NULL */
+
+	ubyte* pNew = (ubyte*) malloc( uAlloc * pThis->uElemSz );
+	if(pNew == NULL){
+		das_error(DASERR_ARRAY, "Couldn't allocate for %zu items of size %zu",
+		          uAlloc, pThis->uElemSz );
+		return false;
+	}
+	if(pThis->uValid)
+		memcpy(pNew, pThis->pBuf, pThis->uElemSz * pThis->uValid);
+	munmap(pThis->pBuf, pThis->uMapSz);
+	pThis->pBuf = pNew;
+	pThis->uMapSz = 0;
+	pThis->uSize = uAlloc;
+	return true;
+}
+
+#endif
+
 bool DynaBuf_alloc(DynaBuf* pThis, size_t uMore)
 {
-	if(pThis->uSize >= (pThis->pHead - pThis->pBuf) + pThis->uValid + uMore)
+	size_t uHeadOff = 0;
+	if(pThis->pHead != NULL)
+		uHeadOff = (pThis->pHead - pThis->pBuf) / pThis->uElemSz;
+	
+	/* Memory the caller took via DasAry_disownElements is no longer ours to
+	 * write, so any growth at all moves to fresh storage */
+	if((!pThis->bKeepMem)&&(pThis->uSize >= uHeadOff + pThis->uValid + uMore))
 		return true;
+	
+	/* Reclaim space trimmed off the front.  Only skip growing if the gap was at
+	 * least as big as the valid data, otherwise repeated small appends would 
+	 * slide the whole buffer each time */
+	if((uHeadOff > 0)&&(!pThis->bKeepMem)){
+		if(pThis->uValid)
+			memmove(pThis->pBuf, pThis->pHead, (pThis->uElemSz) * (pThis->uValid));
+		pThis->pHead = pThis->pBuf;
+		if((uHeadOff >= pThis->uValid)&&(pThis->uSize >= pThis->uValid + uMore))
+			return true;
+	}
 		
 	size_t uAlloc = pThis->uValid + uMore;  /* The minimum to alloc */
 		
@@ -118,19 +207,35 @@ bool DynaBuf_alloc(DynaBuf* pThis, size_t uMore)
 	if(uAlloc < 64) uAlloc = 64;
 		
 	/* Make sure the total allocation is an integer number of chunk sizes */
-	if((pThis->uChunkSz > 0)&&(pThis->uChunkSz != uAlloc)){
-		size_t uRemain = 0;
-		if(pThis->uChunkSz < uAlloc)
-			uRemain = uAlloc % pThis->uChunkSz;
-		else
-			uRemain = pThis->uChunkSz - uAlloc;
-		uAlloc += uRemain;
+	if(pThis->uChunkSz > 0){
+		size_t uRemain = uAlloc % pThis->uChunkSz;
+		if(uRemain > 0) uAlloc += pThis->uChunkSz - uRemain;
+	}
+
+#ifdef DYNABUF_CAN_MAP
+	if(pThis->bLargeMem){
+		if(!_DynaBuf_mapTo(pThis, uAlloc)) return false;
+		pThis->pHead = pThis->pBuf;
+		return true;
+	}
+	if(pThis->uMapSz > 0){
+		if(!_DynaBuf_unmap(pThis, uAlloc)) return false;
+		pThis->pHead = pThis->pBuf;
+		return true;
+	}
+#endif
+	
+	/* Grow in place when the allocator can, memory the caller took via 
+	 * DasAry_disownElements is copied instead since it's no longer ours */
+	ubyte* pNew = NULL;
+	if(pThis->bKeepMem){
+		pNew = (ubyte*) malloc( uAlloc * pThis->uElemSz );
+		if((pNew != NULL)&&(pThis->uValid))
+			memcpy(pNew, pThis->pHead, (pThis->uElemSz) * (pThis->uValid) );
+	}
+	else{
+		pNew = (ubyte*) realloc(pThis->pBuf, uAlloc * pThis->uElemSz );
 	}
-		
-	/* Just using malloc below since we are going to fill this space
-	 * anyway, though you might consider a debug build which uses calloc
-	 * so than empty expanses of memory are noticeable */
-	ubyte* pNew = (ubyte*) malloc( uAlloc * pThis->uElemSz );
 	
 	if(pNew == NULL){
 		das_error(DASERR_ARRAY, "Couldn't allocate for %zu items of size %zu",
@@ -138,17 +243,9 @@ bool DynaBuf_alloc(DynaBuf* pThis, size_t uMore)
 		return false;
 	}
 	pThis->uSize = uAlloc;
-	
-	/* Maintain the old write offset */
-	/* pThis->pWrite = pNew + (pThis->pWrite - pThis->pHead); */
-	
-	if(pThis->uValid)
-		memcpy(pNew, pThis->pHead, (pThis->uElemSz) * (pThis->uValid) );
-	
-	if(pThis->pBuf != NULL) free(pThis->pBuf);
-	
 	pThis->pBuf = pNew;
-	pThis->pHead = pNew; /* <-- TODO: this feel like a bug, check it */
+	pThis->pHead = pNew;
+	pThis->bKeepMem = false;  /* The new storage is ours */
 	return true;
 }
 
@@ -197,6 +294,8 @@ bool DynaBuf_init(
 	pThis->uChunkSz = uChunkSz;
 	pThis->uShape = uShape;
 	pThis->bKeepMem = false;
+	pThis->bLargeMem = false;
+	pThis->uMapSz = 0;
 	
 	/* Alloc space for fill IF it's bigger than the size of an index_info
 	 * object, just store it in the static fill buffer  */
@@ -225,7 +324,15 @@ bool DynaBuf_init(
 /* Opposite of init, free all memory */
 void DynaBuf_release(DynaBuf* pThis)
 {
-	if(!pThis->bKeepMem && pThis->pBuf != NULL) free(pThis->pBuf);
+	if(!pThis->bKeepMem && pThis->pBuf != NULL){
+#ifdef DYNABUF_CAN_MAP
+		if(pThis->uMapSz > 0)
+			munmap(pThis->pBuf, pThis->uMapSz);
+		else
+#endif
+		free(pThis->pBuf);
+	}
+	pThis->uMapSz = 0;
 	pThis->pBuf = pThis->pHead = NULL; /*pThis->pWrite = NULL; */
 	pThis->uSize = pThis->uValid = pThis->uChunkSz = 0;
 	if(pThis->pFill != pThis->fillBuf) free(pThis->pFill);
@@ -1305,6 +1412,20 @@ ubyte* DasAry_disownElements(DasAry* pThis, size_t* pLen, size_t* pOffset)
 	/* I don't own my elements so return NULL, though the number of elements is
 	   *not* zero */	
 	if(!DasAry_ownsElements(pThis)) return NULL;
+
+#ifdef DYNABUF_CAN_MAP
+	/* Callers free() what they take, so hand over heap memory */
+	if(pDb->uMapSz > 0){
+		pDb->bLargeMem = false;
+		size_t uHeadOff = (pDb->pHead - pDb->pBuf) / pDb->uElemSz;
+		if(uHeadOff > 0){
+			memmove(pDb->pBuf, pDb->pHead, pDb->uElemSz * pDb->uValid);
+			pDb->pHead = pDb->pBuf;
+		}
+		if(!_DynaBuf_unmap(pDb, pDb->uValid)) return NULL;
+		pDb->pHead = pDb->pBuf;
+	}
+#endif
 	
 	pThis->bufs[iLast].bKeepMem = true;  /* Don't nuke memory on decrement */
 	
@@ -1381,6 +1502,13 @@ void DasAry_deInit(DasAry* pThis)
 unsigned int DasAry_setUsage(DasAry* pThis, unsigned int uFlags){
 	unsigned int uOld = pThis->uFlags;
 	pThis->uFlags = uFlags;
+	
+	/* Memory backing only applies to element storage I own, takes effect 
+	   the next time the storage grows */
+	int iLast = pThis->nRank - 1;
+	if((iLast >= 0)&&(pThis->pBufs[iLast] == &(pThis->bufs[iLast])))
+		pThis->bufs[iLast].bLargeMem = ((uFlags & D2ARY_LARGE_MEM) != 0);
+	
 	return uOld;
 }
 unsigned int DasAry_getUsage(DasAry* pThis){
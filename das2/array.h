@@ -197,6 +197,11 @@ typedef struct dyna_buf{
 	bool bKeepMem;            /* If true memory will not be deleted when the
 									   * buffer is deleted */
 
+	bool bLargeMem;           /* Back with anonymous memory maps on next growth,
+	                           * see D2ARY_LARGE_MEM */
+	size_t uMapSz;            /* Bytes mapped if pBuf is a memory map, 0 if
+	                           * pBuf came from malloc */
+
 } DynaBuf;
 
 /** @addtogroup DM 
@@ -448,6 +453,16 @@ DAS_API DasAry* new_DasPtrAry(const char* sType, int rank, size_t* shape);
  * This flag is useful for UTF-8 string data. */
 #define D2ARY_AS_STRING 0x00000007
 
+/** Element storage is expected to grow very large.
+ * 
+ * This flag does not change how the array is used, only how element memory is
+ * provided.  On platforms that support it (Linux) element storage is moved to
+ * anonymous memory maps that are eligible for transparent huge pages and that
+ * grow via mremap, which avoids copying the whole array on each expansion.
+ * Elsewhere the flag is accepted but has no effect.  Use this for arrays that
+ * accumulate many hours of high rate waveform records. */
+#define D2ARY_LARGE_MEM 0x00000100
+
 /** Set usage flags to assist arbitrary consumers understand how to use this
  * array.
  * 
@@ -459,6 +474,10 @@ DAS_API DasAry* new_DasPtrAry(const char* sType, int rank, size_t* shape);
  *   - D2ARY_FILL_TERM : Contains FILL terminated sub-sequences 
  *   - D2ARY_AS_STRING : Contains FILL terminated sub-sequences and FILL is 0
  * 
+ * In addition the following flag changes how element memory is allocated:
+ * 
+ *   - D2ARY_LARGE_MEM : Grow element storage in memory maps, see above
+ * 
  * You can add your own flags as well so long as they have the value:
  * 
  *   - 0x0001000
@@ -897,16 +916,16 @@ DAS_API const ubyte* DasAry_getAt(const DasAry* pThis, das_val_type et, ptrdiff_
 #define DasAry_getByteAt(pThis, pLoc)  *((ubyte*)(DasAry_getAt(pThis, vtUByte, pLoc)))
 /** Wrapper around DasAry_get for unsigned 16-bit integers
  * @memberof DasAry */
-#define DasAry_getUShortAt(pThis, pLoc)  *((uint16_t*)(DasAry_getAt(pThis, etUint16, pLoc)))
+#define DasAry_getUShortAt(pThis, pLoc)  *((uint16_t*)(DasAry_getAt(pThis, vtUShort, pLoc)))
 /** Wrapper around DasAry_get for signed 16-bit integers
  * @memberof DasAry */
-#define DasAry_getShortAt(pThis, pLoc)  *((int16_t*)(DasAry_getAt(pThis, etInt16, pLoc)))
+#define DasAry_getShortAt(pThis, pLoc)  *((int16_t*)(DasAry_getAt(pThis, vtShort, pLoc)))
 /** Wrapper around DasAry_get for 32-bit integers
  * @memberof DasAry */
-#define DasAry_getIntAt(pThis, pLoc)  *((int32_t*)(DasAry_getAt(pThis, etInt32, pLoc)))
+#define DasAry_getIntAt(pThis, pLoc)  *((int32_t*)(DasAry_getAt(pThis, vtInt, pLoc)))
 /** Wrapper around DasAry_get for signed 64-bit integers
  * @memberof DasAry */
-#define DasAry_getLongAt(pThis, pLoc)  *((int64_t*)(DasAry_getAt(pThis, etInt64, pLoc)))
+#define DasAry_getLongAt(pThis, pLoc)  *((int64_t*)(DasAry_getAt(pThis, vtLong, pLoc)))
 /** Wrapper around DasAry_get for das_time_t structures
  * @memberof DasAry */
 #define DasAry_getTimeAt(pThis, pLoc)  *((das_time*)(DasAry_getAt(pThis, vtTime, pLoc)))
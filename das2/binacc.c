@@ -0,0 +1,387 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <math.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(DAS_NO_SIMD)
+#define _DAS_BINACC_SIMD
+#include <emmintrin.h>
+#endif
+
+#include "util.h"
+#include "binacc.h"
+
+/* Same relative tolerance as PlaneDesc_isFill(), but multiplied through so
+   that a zero fill value needs no special case beyond equality */
+#define _FILL_TOL 0.00001
+
+/* ************************************************************************* */
+/* Construction */
+
+static void _DasBinAcc_delSketches(DasBinAcc* pThis)
+{
+	if(pThis->ppSketch == NULL) return;
+	for(size_t u = 0; u < pThis->uBins*pThis->uItems; ++u)
+		del_DasQuantile(pThis->ppSketch[u]);
+	free(pThis->ppSketch);
+	pThis->ppSketch = NULL;
+}
+
+static DasErrCode _DasBinAcc_newSketches(DasBinAcc* pThis, size_t uCap)
+{
+	size_t uCells = pThis->uBins * pThis->uItems;
+	pThis->ppSketch = (DasQuantile**)calloc(uCells, sizeof(DasQuantile*));
+	if(pThis->ppSketch == NULL)
+		return das_error(DASERR_BINACC, "Couldn't allocate %zu quantile sketches",
+			uCells);
+
+	for(size_t u = 0; u < uCells; ++u){
+		if((pThis->ppSketch[u] = new_DasQuantile(uCap)) == NULL){
+			_DasBinAcc_delSketches(pThis);
+			return das_error(DASERR_BINACC, "Couldn't allocate %zu quantile "
+				"sketches", uCells);
+		}
+	}
+	return DAS_OKAY;
+}
+
+DasBinAcc* new_DasBinAcc(size_t uBins, size_t uItems, double rFill, int nStats)
+{
+	if((uBins == 0)||(uItems == 0)){
+		das_error(DASERR_BINACC, "Bin accumulators need at least one bin and item");
+		return NULL;
+	}
+
+	DasBinAcc* pThis = (DasBinAcc*)calloc(1, sizeof(DasBinAcc));
+	if(pThis == NULL){
+		das_error(DASERR_BINACC, "Out of memory");
+		return NULL;
+	}
+	pThis->uBins = uBins;
+	pThis->uItems = uItems;
+	pThis->rFill = rFill;
+	pThis->nStats = nStats & (DAS_BINACC_MIN | DAS_BINACC_MAX | DAS_BINACC_QUANT);
+
+	/* One block for all the statistics plus the output buffer */
+	size_t uCells = uBins * uItems;
+	size_t uArys = 2;
+	if(pThis->nStats & DAS_BINACC_MIN) ++uArys;
+	if(pThis->nStats & DAS_BINACC_MAX) ++uArys;
+
+	double* pBlock = (double*)malloc((uArys*uCells + uItems)*sizeof(double));
+	if(pBlock == NULL){
+		free(pThis);
+		das_error(DASERR_BINACC, "Couldn't allocate %zu bins of %zu items",
+			uBins, uItems);
+		return NULL;
+	}
+	pThis->pSum   = pBlock;  pBlock += uCells;
+	pThis->pCount = pBlock;  pBlock += uCells;
+	if(pThis->nStats & DAS_BINACC_MIN){ pThis->pMin = pBlock;  pBlock += uCells; }
+	if(pThis->nStats & DAS_BINACC_MAX){ pThis->pMax = pBlock;  pBlock += uCells; }
+	pThis->pOut = pBlock;
+
+	if((pThis->nStats & DAS_BINACC_QUANT) && (_DasBinAcc_newSketches(pThis, 0) != DAS_OKAY)){
+		free(pThis->pSum);
+		free(pThis);
+		return NULL;
+	}
+
+	DasBinAcc_clear(pThis);
+	return pThis;
+}
+
+void del_DasBinAcc(DasBinAcc* pThis)
+{
+	if(pThis == NULL) return;
+	_DasBinAcc_delSketches(pThis);
+	free(pThis->pSum);   /* Start of the block */
+	free(pThis);
+}
+
+/* ************************************************************************* */
+/* Clearing */
+
+static void _DasBinAcc_clearCells(DasBinAcc* pThis, size_t uBeg, size_t uEnd)
+{
+	for(size_t u = uBeg; u < uEnd; ++u){
+		pThis->pSum[u] = 0.0;
+		pThis->pCount[u] = 0.0;
+	}
+	/* Empty cells start at the far end of the range so the first value wins */
+	if(pThis->pMin)
+		for(size_t u = uBeg; u < uEnd; ++u) pThis->pMin[u] = HUGE_VAL;
+	if(pThis->pMax)
+		for(size_t u = uBeg; u < uEnd; ++u) pThis->pMax[u] = -HUGE_VAL;
+	if(pThis->ppSketch)
+		for(size_t u = uBeg; u < uEnd; ++u) DasQuantile_clear(pThis->ppSketch[u]);
+}
+
+void DasBinAcc_clearBin(DasBinAcc* pThis, size_t uBin)
+{
+	if(uBin >= pThis->uBins) return;
+	_DasBinAcc_clearCells(pThis, uBin*pThis->uItems, (uBin + 1)*pThis->uItems);
+}
+
+void DasBinAcc_clear(DasBinAcc* pThis)
+{
+	_DasBinAcc_clearCells(pThis, 0, pThis->uBins*pThis->uItems);
+}
+
+DasErrCode DasBinAcc_setSketchCap(DasBinAcc* pThis, size_t uCap)
+{
+	if(pThis->ppSketch == NULL)
+		return das_error(DASERR_BINACC, "Quantiles are not kept by this accumulator");
+
+	_DasBinAcc_delSketches(pThis);
+	DasErrCode nRet = _DasBinAcc_newSketches(pThis, uCap);
+	if(nRet != DAS_OKAY)
+		pThis->nStats &= ~DAS_BINACC_QUANT;
+	DasBinAcc_clear(pThis);
+	return nRet;
+}
+
+/* ************************************************************************* */
+/* Accumulation */
+
+#ifdef _DAS_BINACC_SIMD
+
+/* The fill mask is all ones for fill values.  NaN's are never fill, which
+   matches the scalar test */
+#define _FILL_MASK(X) _mm_or_pd( \
+	_mm_cmpeq_pd(X, vFill), \
+	_mm_cmplt_pd(_mm_and_pd(_mm_sub_pd(vFill, X), vAbs), vTol) \
+)
+
+/* Select A where the mask is set, B otherwise */
+#define _SELECT(M, A, B) _mm_or_pd(_mm_and_pd(M, A), _mm_andnot_pd(M, B))
+
+/* Item-wise accumulation, returns the number of values handled */
+static size_t _binacc_add_sse2(
+	DasBinAcc* pThis, size_t uOff, const double* pVals, size_t uVals
+){
+	const __m128d vFill = _mm_set1_pd(pThis->rFill);
+	const __m128d vTol  = _mm_set1_pd(fabs(pThis->rFill) * _FILL_TOL);
+	const __m128d vAbs  = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	const __m128d vOne  = _mm_set1_pd(1.0);
+
+	double* pSum = pThis->pSum + uOff;
+	double* pCount = pThis->pCount + uOff;
+	double* pMin = pThis->pMin ? pThis->pMin + uOff : NULL;
+	double* pMax = pThis->pMax ? pThis->pMax + uOff : NULL;
+
+	size_t u = 0;
+	__m128d x, mFill, y;
+	for(; u + 2 <= uVals; u += 2){
+		x = _mm_loadu_pd(pVals + u);
+		mFill = _FILL_MASK(x);
+
+		y = _mm_loadu_pd(pSum + u);
+		_mm_storeu_pd(pSum + u, _mm_add_pd(y, _mm_andnot_pd(mFill, x)));
+		y = _mm_loadu_pd(pCount + u);
+		_mm_storeu_pd(pCount + u, _mm_add_pd(y, _mm_andnot_pd(mFill, vOne)));
+
+		if(pMin){
+			y = _mm_loadu_pd(pMin + u);
+			_mm_storeu_pd(pMin + u, _SELECT(mFill, y, _mm_min_pd(x, y)));
+		}
+		if(pMax){
+			y = _mm_loadu_pd(pMax + u);
+			_mm_storeu_pd(pMax + u, _SELECT(mFill, y, _mm_max_pd(x, y)));
+		}
+	}
+	return u;
+}
+
+/* Collapsing accumulation, partial results are added to the output pointers */
+static size_t _binacc_reduce_sse2(
+	const DasBinAcc* pThis, const double* pVals, size_t uVals,
+	double* pSum, double* pCount, double* pMin, double* pMax
+){
+	const __m128d vFill = _mm_set1_pd(pThis->rFill);
+	const __m128d vTol  = _mm_set1_pd(fabs(pThis->rFill) * _FILL_TOL);
+	const __m128d vAbs  = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+	const __m128d vOne  = _mm_set1_pd(1.0);
+
+	__m128d vSum = _mm_setzero_pd();
+	__m128d vCount = _mm_setzero_pd();
+	__m128d vMin = _mm_set1_pd(HUGE_VAL);
+	__m128d vMax = _mm_set1_pd(-HUGE_VAL);
+
+	size_t u = 0;
+	__m128d x, mFill;
+	for(; u + 2 <= uVals; u += 2){
+		x = _mm_loadu_pd(pVals + u);
+		mFill = _FILL_MASK(x);
+		vSum = _mm_add_pd(vSum, _mm_andnot_pd(mFill, x));
+		vCount = _mm_add_pd(vCount, _mm_andnot_pd(mFill, vOne));
+		vMin = _SELECT(mFill, vMin, _mm_min_pd(x, vMin));
+		vMax = _SELECT(mFill, vMax, _mm_max_pd(x, vMax));
+	}
+
+	double a[2];
+	_mm_storeu_pd(a, vSum);   *pSum += a[0] + a[1];
+	_mm_storeu_pd(a, vCount); *pCount += a[0] + a[1];
+	_mm_storeu_pd(a, vMin);
+	if(a[0] < *pMin) *pMin = a[0];
+	if(a[1] < *pMin) *pMin = a[1];
+	_mm_storeu_pd(a, vMax);
+	if(a[0] > *pMax) *pMax = a[0];
+	if(a[1] > *pMax) *pMax = a[1];
+	return u;
+}
+
+#endif /* _DAS_BINACC_SIMD */
+
+DasErrCode DasBinAcc_add(
+	DasBinAcc* pThis, size_t uBin, const double* pVals, size_t uVals
+){
+	if(uBin >= pThis->uBins)
+		return das_error(DASERR_BINACC, "Bin %zu is out of range, only %zu bins "
+			"are defined", uBin, pThis->uBins);
+
+	const double rFill = pThis->rFill;
+	const double rTol = fabs(rFill) * _FILL_TOL;
+	size_t uOff = uBin * pThis->uItems;
+	size_t u = 0;
+	double x;
+
+	/* Item by item */
+	if(uVals == pThis->uItems){
+#ifdef _DAS_BINACC_SIMD
+		u = _binacc_add_sse2(pThis, uOff, pVals, uVals);
+#endif
+		for(; u < uVals; ++u){
+			x = pVals[u];
+			if((x == rFill)||(fabs(rFill - x) < rTol))
+				continue;
+			pThis->pSum[uOff + u] += x;
+			pThis->pCount[uOff + u] += 1.0;
+			if(pThis->pMin && (x < pThis->pMin[uOff + u])) pThis->pMin[uOff + u] = x;
+			if(pThis->pMax && (x > pThis->pMax[uOff + u])) pThis->pMax[uOff + u] = x;
+		}
+
+		/* Sketches keep values, not running totals, so they get their own pass */
+		for(u = 0; pThis->ppSketch && (u < uVals); ++u){
+			x = pVals[u];
+			if((x != rFill)&&(fabs(rFill - x) >= rTol))
+				DasQuantile_add(pThis->ppSketch[uOff + u], x);
+		}
+		return DAS_OKAY;
+	}
+
+	if(pThis->uItems != 1)
+		return das_error(DASERR_BINACC, "Can't add %zu values to bins of %zu items",
+			uVals, pThis->uItems);
+
+	/* Collapse all values into one item, min and max are always gathered here
+	   since they're in registers anyway */
+	double rSum = 0.0, rCount = 0.0, rMin = HUGE_VAL, rMax = -HUGE_VAL;
+#ifdef _DAS_BINACC_SIMD
+	u = _binacc_reduce_sse2(pThis, pVals, uVals, &rSum, &rCount, &rMin, &rMax);
+#endif
+	for(; u < uVals; ++u){
+		x = pVals[u];
+		if((x == rFill)||(fabs(rFill - x) < rTol))
+			continue;
+		rSum += x;
+		rCount += 1.0;
+		if(x < rMin) rMin = x;
+		if(x > rMax) rMax = x;
+	}
+
+	pThis->pSum[uOff] += rSum;
+	pThis->pCount[uOff] += rCount;
+	if(pThis->pMin && (rMin < pThis->pMin[uOff])) pThis->pMin[uOff] = rMin;
+	if(pThis->pMax && (rMax > pThis->pMax[uOff])) pThis->pMax[uOff] = rMax;
+
+	for(u = 0; pThis->ppSketch && (u < uVals); ++u){
+		x = pVals[u];
+		if((x != rFill)&&(fabs(rFill - x) >= rTol))
+			DasQuantile_add(pThis->ppSketch[uOff], x);
+	}
+	return DAS_OKAY;
+}
+
+/* ************************************************************************* */
+/* Output */
+
+const double* DasBinAcc_get(const DasBinAcc* pThis, size_t uBin, int nStat)
+{
+	if(uBin >= pThis->uBins){
+		das_error(DASERR_BINACC, "Bin %zu is out of range, only %zu bins are "
+			"defined", uBin, pThis->uBins);
+		return NULL;
+	}
+
+	size_t uOff = uBin * pThis->uItems;
+	const double* pCount = pThis->pCount + uOff;
+	const double* pSrc = NULL;
+	double* pOut = pThis->pOut;
+
+	switch(nStat){
+	case DAS_BINACC_MEAN:
+		for(size_t u = 0; u < pThis->uItems; ++u)
+			pOut[u] = (pCount[u] == 0.0) ? pThis->rFill : pThis->pSum[uOff + u] / pCount[u];
+		return pOut;
+	case DAS_BINACC_COUNT:
+		for(size_t u = 0; u < pThis->uItems; ++u) pOut[u] = pCount[u];
+		return pOut;
+	case DAS_BINACC_SUM: pSrc = pThis->pSum; break;
+	case DAS_BINACC_MIN: pSrc = pThis->pMin; break;
+	case DAS_BINACC_MAX: pSrc = pThis->pMax; break;
+	default: break;
+	}
+
+	if(pSrc == NULL){
+		das_error(DASERR_BINACC, "Statistic 0x%02X is not kept by this "
+			"accumulator", nStat);
+		return NULL;
+	}
+
+	for(size_t u = 0; u < pThis->uItems; ++u)
+		pOut[u] = (pCount[u] == 0.0) ? pThis->rFill : pSrc[uOff + u];
+	return pOut;
+}
+
+const double* DasBinAcc_getQuantile(
+	const DasBinAcc* pThis, size_t uBin, double rFrac
+){
+	if(uBin >= pThis->uBins){
+		das_error(DASERR_BINACC, "Bin %zu is out of range, only %zu bins are "
+			"defined", uBin, pThis->uBins);
+		return NULL;
+	}
+	if(pThis->ppSketch == NULL){
+		das_error(DASERR_BINACC, "Quantiles are not kept by this accumulator");
+		return NULL;
+	}
+
+	size_t uOff = uBin * pThis->uItems;
+	DasQuantile* pSketch = NULL;
+	double* pOut = pThis->pOut;
+	for(size_t u = 0; u < pThis->uItems; ++u){
+		pSketch = pThis->ppSketch[uOff + u];
+		pOut[u] = (DasQuantile_count(pSketch) == 0) ?
+			pThis->rFill : DasQuantile_value(pSketch, rFrac);
+	}
+	return pOut;
+}
@@ -0,0 +1,167 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file binacc.h Fill aware sum, count, min, max and quantile accumulators
+ * for binning reducers
+ */
+
+#ifndef _das_binacc_h_
+#define _das_binacc_h_
+
+#include <das2/defs.h>
+#include <das2/histo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup DM
+ * @{
+ */
+
+/* Statistics that may be requested from an accumulator.  Sums and counts are
+   always kept, MIN, MAX and QUANT are kept if requested at construction */
+#define DAS_BINACC_MEAN   0x00
+#define DAS_BINACC_SUM    0x01
+#define DAS_BINACC_COUNT  0x02
+#define DAS_BINACC_MIN    0x04
+#define DAS_BINACC_MAX    0x08
+#define DAS_BINACC_QUANT  0x10  /* See DasBinAcc_getQuantile() */
+
+/** Running statistics over a fixed set of bins
+ *
+ * Each bin holds a record of uItems values.  Incoming records are added
+ * item by item, skipping fill values, or collapsed to a single value if
+ * the accumulator has only one item per bin.  Each statistic is stored in
+ * one contiguous array of uBins*uItems doubles so that adding a record is a
+ * straight pass over memory.  On x86_64 the fill test and accumulation are
+ * done two values at a time with SSE2.
+ *
+ * Binning reducers that only track the current time bin just use a
+ * single bin and clear it after each output.
+ *
+ * Fill values are identified the same way PlaneDesc_isFill() does, any value
+ * within 1 part in 10^5 of the fill value is fill.
+ */
+typedef struct das_bin_acc {
+	size_t uBins;
+	size_t uItems;
+	double rFill;
+	int nStats;       /* DAS_BINACC_MIN, DAS_BINACC_MAX and/or DAS_BINACC_QUANT */
+
+	double* pSum;     /* All arrays are uBins * uItems in size */
+	double* pCount;
+	double* pMin;     /* NULL unless requested */
+	double* pMax;     /* NULL unless requested */
+	DasQuantile** ppSketch;  /* NULL unless requested, one sketch per cell */
+	double* pOut;     /* Output buffer for DasBinAcc_get, uItems long */
+} DasBinAcc;
+
+/** Create a new bin accumulator
+ *
+ * @param uBins The number of bins to keep, must be at least 1
+ * @param uItems The number of values in each bin, must be at least 1
+ * @param rFill The fill value for input and output
+ * @param nStats Optional statistics to keep in addition to sums and
+ *        counts, an or'ed combination of DAS_BINACC_MIN, DAS_BINACC_MAX
+ *        and DAS_BINACC_QUANT, or 0 for none.  Quantile sketches use the
+ *        default size, see DasBinAcc_setSketchCap().
+ * @returns A new accumulator with all bins empty, or NULL on an error
+ * @memberof DasBinAcc
+ */
+DAS_API DasBinAcc* new_DasBinAcc(size_t uBins, size_t uItems, double rFill, int nStats);
+
+/** Free an accumulator and all it's arrays
+ * @memberof DasBinAcc
+ */
+DAS_API void del_DasBinAcc(DasBinAcc* pThis);
+
+/** Add a record of values to a bin
+ *
+ * @param pThis The accumulator
+ * @param uBin The bin to update
+ * @param pVals The values to add, fill values are skipped
+ * @param uVals The number of values, must equal the number of items per bin
+ *        unless the accumulator has one item per bin, in which case all
+ *        values are collapsed into it.
+ * @returns 0 on success or a positive error code if the bin is out of range
+ *        or the record is the wrong length.
+ * @memberof DasBinAcc
+ */
+DAS_API DasErrCode DasBinAcc_add(
+	DasBinAcc* pThis, size_t uBin, const double* pVals, size_t uVals
+);
+
+/** Get a statistic for all items of a bin
+ *
+ * @param pThis The accumulator
+ * @param uBin The bin to read
+ * @param nStat One of DAS_BINACC_MEAN, DAS_BINACC_SUM, DAS_BINACC_COUNT,
+ *        DAS_BINACC_MIN or DAS_BINACC_MAX.
+ * @returns A pointer to uItems values, items that received no data are set
+ *        to the fill value (or 0 for counts).  The pointer is to an internal
+ *        buffer that is overwritten on the next call.  NULL is returned if
+ *        the bin is out of range or the statistic was not kept.
+ * @memberof DasBinAcc
+ */
+DAS_API const double* DasBinAcc_get(const DasBinAcc* pThis, size_t uBin, int nStat);
+
+/** Estimate a quantile for all items of a bin
+ *
+ * Only available if DAS_BINACC_QUANT was requested at construction.
+ *
+ * @param pThis The accumulator
+ * @param uBin The bin to read
+ * @param rFrac The quantile from 0 to 1, 0.5 is the median
+ * @returns A pointer to uItems values, items that received no data are set
+ *        to the fill value.  The pointer is to an internal buffer that is
+ *        overwritten on the next call.  NULL is returned if the bin is out
+ *        of range or quantiles were not kept.
+ * @memberof DasBinAcc
+ */
+DAS_API const double* DasBinAcc_getQuantile(
+	const DasBinAcc* pThis, size_t uBin, double rFrac
+);
+
+/** Change the size of the quantile sketches, this empties all bins
+ *
+ * @param pThis The accumulator
+ * @param uCap Values held per sketch level, 0 for the default, see
+ *        new_DasQuantile()
+ * @returns 0 on success or a positive error code if quantiles are not kept
+ *        or the new sketches couldn't be allocated.
+ * @memberof DasBinAcc
+ */
+DAS_API DasErrCode DasBinAcc_setSketchCap(DasBinAcc* pThis, size_t uCap);
+
+/** Empty a single bin
+ * @memberof DasBinAcc
+ */
+DAS_API void DasBinAcc_clearBin(DasBinAcc* pThis, size_t uBin);
+
+/** Empty all bins
+ * @memberof DasBinAcc
+ */
+DAS_API void DasBinAcc_clear(DasBinAcc* pThis);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _das_binacc_h_ */
@@ -55,8 +55,10 @@ DasErrCode DasBuf_initReadOnly(DasBuf* pThis, const char* sExternal, size_t uLen
 {
 	pThis->sBuf = (char*)sExternal;
 	pThis->uLen = uLen;
+	pThis->pWrite = NULL;  /* marks the buffer read-only */
+	pThis->uWrap = 0;
 	pThis->pReadBeg = pThis->sBuf;
-	pThis->pReadEnd = pThis->pReadBeg;
+	pThis->pReadEnd = pThis->sBuf + uLen;
 	return 0;
 }
 
@@ -322,12 +324,11 @@ int DasBuf_writeFromSSL(DasBuf* pThis, void* pvSsl, size_t uLen)
 	
 size_t DasBuf_read(DasBuf* pThis, char* pOut, size_t uOut)
 {
-	size_t uRead = 0;
-	while( pThis->pReadBeg < pThis->pReadEnd &&  uRead < uOut){
-		*pOut = *pThis->pReadBeg;
-		pOut++;
-		pThis->pReadBeg++;
-		uRead++;
+	size_t uRead = pThis->pReadEnd - pThis->pReadBeg;
+	if(uRead > uOut) uRead = uOut;
+	if(uRead > 0){
+		memcpy(pOut, pThis->pReadBeg, uRead);
+		pThis->pReadBeg += uRead;
 	}
 	return uRead;
 }
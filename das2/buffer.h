@@ -79,7 +79,9 @@ DAS_API DasErrCode DasBuf_initReadWrite(DasBuf* pThis, char* sBuf, size_t uLen);
 
 /** Initialize a read-only buffer than points to an external byte array.
  * 
- * This function re-sets the read point for the buffer.
+ * This function re-sets the read point for the buffer.  All uLen bytes of
+ * the external array are available for reading, and none may be written.
+ * The external array is not copied and must out-live the buffer.
  * 
  * @param pThis the buffer initialize
  * @param sBuf an pre-allocated character buffer to receive new data
@@ -67,6 +67,34 @@ size_t _DasDsBldr_addPair(DasDsBldr* pThis, PktDesc* pPd, DasDs* pCd)
 	return (pThis->uValidPairs - 1);
 }
 
+/* Packet ID to pair index map, grows to fit the largest ID seen */
+
+static int _DasDsBldr_mapGet(const DasDsBldr* pThis, int iPktId)
+{
+	if((iPktId < 0)||(iPktId >= pThis->nDsMapSz)) return -1;
+	return pThis->lDsMap[iPktId];
+}
+
+static DasErrCode _DasDsBldr_mapSet(DasDsBldr* pThis, int iPktId, int iPairIdx)
+{
+	if((iPktId < 1)||(iPktId >= MAX_PKTIDS))
+		return das_error(DASERR_BLDR, "Illegal packet id: %d", iPktId);
+
+	if(iPktId >= pThis->nDsMapSz){
+		int nNewSz = pThis->nDsMapSz ? pThis->nDsMapSz : 16;
+		while(nNewSz <= iPktId) nNewSz *= 2;
+
+		int* pNew = (int*)realloc(pThis->lDsMap, nNewSz * sizeof(int));
+		if(pNew == NULL)
+			return das_error(DASERR_BLDR, "Couldn't grow packet ID map");
+		for(int i = pThis->nDsMapSz; i < nNewSz; ++i) pNew[i] = -1;
+		pThis->lDsMap = pNew;
+		pThis->nDsMapSz = nNewSz;
+	}
+	pThis->lDsMap[iPktId] = iPairIdx;
+	return DAS_OKAY;
+}
+
 /* ************************************************************************** */
 /* On new stream  */
 
@@ -239,11 +267,10 @@ DasErrCode DasDsBldr_onPktDesc(DasStream* pSd, PktDesc* pPd, void* vpUd)
 	 * old one needs to be kept, or are they starting an actual new one) */
 	int iPktId = PktDesc_getId(pPd);
 	int iPairIdx = -1;
-	if(pThis->lDsMap[iPktId] != -1){
+	if(_DasDsBldr_mapGet(pThis, iPktId) != -1){
 		if( (iPairIdx = _DasDsBldr_hasContainer(pThis, pPd)) != -1){
 			/* Reuse old CorData */
-			pThis->lDsMap[iPktId] = iPairIdx;
-			return DAS_OKAY;
+			return _DasDsBldr_mapSet(pThis, iPktId, iPairIdx);
 		}
 	}
 
@@ -255,9 +282,7 @@ DasErrCode DasDsBldr_onPktDesc(DasStream* pSd, PktDesc* pPd, void* vpUd)
 
 	DasStream_addDesc(pThis->pStream, (DasDesc*)pCd, iPktId);
 	size_t uIdx = _DasDsBldr_addPair(pThis, pPd, pCd);
-	pThis->lDsMap[iPktId] = uIdx;
-
-	return DAS_OKAY;
+	return _DasDsBldr_mapSet(pThis, iPktId, (int)uIdx);
 }
 
 /* ************************************************************************* */
@@ -268,16 +293,14 @@ DasErrCode DasDsBldr_onDataSet(DasStream* pSd, int iPktId, DasDs* pDs, void* vpU
 
 	/* Not much to do here, we already have a valid dataset, just add it to
 	   the list, but don't associate a packet descriptor */
-	if( pThis->lDsMap[iPktId] != -1)
+	if(_DasDsBldr_mapGet(pThis, iPktId) != -1)
 		return das_error(DASERR_BLDR, "Packet reuse not supported for DasDs descriptors");
 	
 	size_t uIdx = _DasDsBldr_addPair(pThis, NULL, pDs);
 
 	DasStream_shadowPktDesc(pThis->pStream, (DasDesc*)pDs, iPktId);
 
-	pThis->lDsMap[iPktId] = uIdx;
-
-	return DAS_OKAY;
+	return _DasDsBldr_mapSet(pThis, iPktId, (int)uIdx);
 }
 
 /* ************************************************************************* */
@@ -287,7 +310,11 @@ DasErrCode DasDsBldr_onPktData(PktDesc* pPd, void* vpUd)
 	DasDsBldr* pThis = (DasDsBldr*)vpUd;
 	int nPktId = PktDesc_getId(pPd);
 
-	struct ds_pd_set set = pThis->lPairs[ pThis->lDsMap[nPktId] ];
+	int iPairIdx = _DasDsBldr_mapGet(pThis, nPktId);
+	if(iPairIdx < 0)
+		return das_error(DASERR_BLDR, "No dataset for packet id %d", nPktId);
+
+	struct ds_pd_set set = pThis->lPairs[ iPairIdx ];
 	DasDs* pDs = set.pDs;
 
 	/* Loop through all the arrays in the dataset object and add values */
@@ -382,7 +409,8 @@ DasDsBldr* new_DasDsBldr(void)
 	pThis->base.commentHandler    = DasDsBldr_onComment;
 	pThis->_released = false;
 
-	for(int i = 0; i<MAX_PKTIDS; ++i) pThis->lDsMap[i] = -1;
+	pThis->lDsMap = NULL;  /* Grows on first use */
+	pThis->nDsMapSz = 0;
 
 	/* Make room for 64 dataset pointers, can always expand if needed */
 	pThis->uValidPairs = 0;
@@ -431,6 +459,7 @@ void del_DasDsBldr(DasDsBldr* pThis){
 	}
 
    free(pThis->lPairs);
+	free(pThis->lDsMap);
 	free(pThis);
 }
 
@@ -67,8 +67,10 @@ typedef struct das_builder {
 	 *
 	 * If a packet ID is re-defined, first look to see if the new definition is
 	 * actually something that's been seen before and change the value in lDsMap
-	 * to the old definition. */
-	int lDsMap[MAX_PKTIDS];
+	 * to the old definition.  lDsMap grows to fit the largest packet ID seen,
+	 * slots without a pair hold -1. */
+	int* lDsMap;
+	int nDsMapSz;
 
 	size_t uValidPairs;
 	struct ds_pd_set* lPairs;
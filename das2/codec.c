@@ -21,6 +21,13 @@
 #include <string.h>
 #include <ctype.h>
 #include <limits.h>
+#include <float.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(DAS_NO_SIMD)
+#define _DAS_CODEC_SIMD
+#include <immintrin.h>
+#endif
 
 #include "value.h"
 #include "log.h"
@@ -911,45 +918,351 @@ void DasCodec_deInit(DasCodec* pThis){
 }
 
 /* ************************************************************************* */
-/* Read helper */
+/* Swap and width change kernels
+
+   The binary read and write helpers below spend nearly all of their time in
+   these loops.  On x86_64 builds with GCC or clang the kernels run on SSE2
+   vectors, or on AVX2 vectors if the CPU reports support for them at runtime.
+   Each kernel reports how many values it handled and the plain C loops finish
+   the remainder, so other targets (or builds with DAS_NO_SIMD defined) just
+   run the plain C versions.
+*/
 
-static DasErrCode _swap_read(ubyte* pDest, const ubyte* pSrc, size_t uVals, int nSzEa){
-   /* Now swap and write */
-	ubyte uSwap[8];
+/* Values handled per pass when a transform has to stage data in scratch
+   space on the stack, small enough that the scratch stays in L1 */
+#define _XFORM_CHUNK 256
+
+/* Widening conversions that have vector kernels, named as buffer->array */
+enum _widen_kind {
+	_W_NONE = 0, _W_S16_I32, _W_U16_I32, _W_S16_F32, _W_U16_F32,
+	_W_S16_F64, _W_U16_F64, _W_S32_F64, _W_F32_F64
+};
+
+static enum _widen_kind _widen_kind(das_val_type vtAry, das_val_type vtBuf)
+{
+	switch(vtAry){
+	case vtDouble:
+		switch(vtBuf){
+		case vtShort:  return _W_S16_F64;
+		case vtUShort: return _W_U16_F64;
+		case vtInt:    return _W_S32_F64;
+		case vtFloat:  return _W_F32_F64;
+		default: return _W_NONE;
+		}
+	case vtFloat:
+		if(vtBuf == vtShort)  return _W_S16_F32;
+		if(vtBuf == vtUShort) return _W_U16_F32;
+		return _W_NONE;
+	case vtInt:
+		if(vtBuf == vtShort)  return _W_S16_I32;
+		if(vtBuf == vtUShort) return _W_U16_I32;
+		return _W_NONE;
+	case vtUInt:
+		if(vtBuf == vtUShort) return _W_U16_I32;  /* same bits as signed output */
+		return _W_NONE;
+	default:
+		return _W_NONE;
+	}
+}
+
+#ifdef _DAS_CODEC_SIMD
+
+/* SSE2 is part of the x86_64 baseline, AVX2 has to be checked for.  The
+   check is a bit test on data libgcc fills in before main() */
+#define _HAS_AVX2() __builtin_cpu_supports("avx2")
 
+static size_t _swap_sse2(ubyte* pDest, const ubyte* pSrc, size_t uVals, int nSzEa)
+{
+	size_t uBytes = uVals * nSzEa;
+	size_t u = 0;
+	__m128i x;
+
+	for(; u + 16 <= uBytes; u += 16){
+		x = _mm_loadu_si128((const __m128i*)(pSrc + u));
+		x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+		if(nSzEa == 4){
+			x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2,3,0,1));
+			x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2,3,0,1));
+		}
+		else if(nSzEa == 8){
+			x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0,1,2,3));
+			x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0,1,2,3));
+		}
+		_mm_storeu_si128((__m128i*)(pDest + u), x);
+	}
+	return u / nSzEa;
+}
+
+__attribute__((target("avx2")))
+static size_t _swap_avx2(ubyte* pDest, const ubyte* pSrc, size_t uVals, int nSzEa)
+{
+	__m256i mask;
 	switch(nSzEa){
 	case 2:
-		for(size_t u = 0; u < (uVals*2); u += 2){
-			uSwap[0] = pSrc[u+1];
-			uSwap[1] = pSrc[u];
-			*((uint16_t*)(pDest + u)) = *((uint16_t*)uSwap);
+		mask = _mm256_setr_epi8(
+			1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+			1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14
+		);
+		break;
+	case 4:
+		mask = _mm256_setr_epi8(
+			3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12,
+			3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12
+		);
+		break;
+	default:
+		mask = _mm256_setr_epi8(
+			7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8,
+			7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8
+		);
+		break;
+	}
+
+	size_t uBytes = uVals * nSzEa;
+	size_t u = 0;
+	__m256i x;
+	for(; u + 32 <= uBytes; u += 32){
+		x = _mm256_loadu_si256((const __m256i*)(pSrc + u));
+		_mm256_storeu_si256((__m256i*)(pDest + u), _mm256_shuffle_epi8(x, mask));
+	}
+	return u / nSzEa;
+}
+
+static size_t _widen_sse2(
+	ubyte* pDest, const ubyte* pSrc, size_t uVals, enum _widen_kind kind
+){
+	size_t v = 0;
+	__m128i x, lo, hi;
+	__m128 f;
+	const __m128i zero = _mm_setzero_si128();
+
+	switch(kind){
+	case _W_S32_F64:
+		for(; v + 4 <= uVals; v += 4){
+			x = _mm_loadu_si128((const __m128i*)(pSrc + 4*v));
+			_mm_storeu_pd((double*)(pDest + 8*v), _mm_cvtepi32_pd(x));
+			_mm_storeu_pd((double*)(pDest + 8*v + 16),
+				_mm_cvtepi32_pd(_mm_shuffle_epi32(x, _MM_SHUFFLE(3,2,3,2)))
+			);
+		}
+		return v;
+
+	case _W_F32_F64:
+		for(; v + 4 <= uVals; v += 4){
+			f = _mm_loadu_ps((const float*)(pSrc + 4*v));
+			_mm_storeu_pd((double*)(pDest + 8*v), _mm_cvtps_pd(f));
+			_mm_storeu_pd((double*)(pDest + 8*v + 16), _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+		}
+		return v;
+
+	case _W_NONE:
+		return 0;
+
+	default:  /* All the rest read 16-bit integers */
+		break;
+	}
+
+	bool bSigned = (kind == _W_S16_I32)||(kind == _W_S16_F32)||(kind == _W_S16_F64);
+
+	for(; v + 8 <= uVals; v += 8){
+		x = _mm_loadu_si128((const __m128i*)(pSrc + 2*v));
+		if(bSigned){
+			lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+			hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+		}
+		else{
+			lo = _mm_unpacklo_epi16(x, zero);
+			hi = _mm_unpackhi_epi16(x, zero);
+		}
+
+		switch(kind){
+		case _W_S16_I32:
+		case _W_U16_I32:
+			_mm_storeu_si128((__m128i*)(pDest + 4*v),      lo);
+			_mm_storeu_si128((__m128i*)(pDest + 4*v + 16), hi);
+			break;
+		case _W_S16_F32:
+		case _W_U16_F32:
+			_mm_storeu_ps((float*)(pDest + 4*v),      _mm_cvtepi32_ps(lo));
+			_mm_storeu_ps((float*)(pDest + 4*v + 16), _mm_cvtepi32_ps(hi));
+			break;
+		default:
+			_mm_storeu_pd((double*)(pDest + 8*v),      _mm_cvtepi32_pd(lo));
+			_mm_storeu_pd((double*)(pDest + 8*v + 16),
+				_mm_cvtepi32_pd(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3,2,3,2)))
+			);
+			_mm_storeu_pd((double*)(pDest + 8*v + 32), _mm_cvtepi32_pd(hi));
+			_mm_storeu_pd((double*)(pDest + 8*v + 48),
+				_mm_cvtepi32_pd(_mm_shuffle_epi32(hi, _MM_SHUFFLE(3,2,3,2)))
+			);
+			break;
+		}
+	}
+	return v;
+}
+
+__attribute__((target("avx2")))
+static size_t _widen_avx2(
+	ubyte* pDest, const ubyte* pSrc, size_t uVals, enum _widen_kind kind
+){
+	size_t v = 0;
+	__m128i x;
+	__m256i y;
+
+	switch(kind){
+	case _W_S32_F64:
+		for(; v + 4 <= uVals; v += 4){
+			x = _mm_loadu_si128((const __m128i*)(pSrc + 4*v));
+			_mm256_storeu_pd((double*)(pDest + 8*v), _mm256_cvtepi32_pd(x));
+		}
+		return v;
+
+	case _W_F32_F64:
+		for(; v + 4 <= uVals; v += 4){
+			_mm256_storeu_pd((double*)(pDest + 8*v),
+				_mm256_cvtps_pd(_mm_loadu_ps((const float*)(pSrc + 4*v)))
+			);
+		}
+		return v;
+
+	case _W_NONE:
+		return 0;
+
+	default:
+		break;
+	}
+
+	bool bSigned = (kind == _W_S16_I32)||(kind == _W_S16_F32)||(kind == _W_S16_F64);
+
+	for(; v + 8 <= uVals; v += 8){
+		x = _mm_loadu_si128((const __m128i*)(pSrc + 2*v));
+		y = bSigned ? _mm256_cvtepi16_epi32(x) : _mm256_cvtepu16_epi32(x);
+
+		switch(kind){
+		case _W_S16_I32:
+		case _W_U16_I32:
+			_mm256_storeu_si256((__m256i*)(pDest + 4*v), y);
+			break;
+		case _W_S16_F32:
+		case _W_U16_F32:
+			_mm256_storeu_ps((float*)(pDest + 4*v), _mm256_cvtepi32_ps(y));
+			break;
+		default:
+			_mm256_storeu_pd((double*)(pDest + 8*v),
+				_mm256_cvtepi32_pd(_mm256_castsi256_si128(y))
+			);
+			_mm256_storeu_pd((double*)(pDest + 8*v + 32),
+				_mm256_cvtepi32_pd(_mm256_extracti128_si256(y, 1))
+			);
+			break;
+		}
+	}
+	return v;
+}
+
+/* Double to float, stops at the first pair of values that is out of float
+   range or matches the input fill value, those need das_value_binXform */
+static size_t _narrow_f64_f32_sse2(
+	ubyte* pDest, const ubyte* pSrc, size_t uVals, double rFill, bool bFill
+){
+	const __m128d absmask = _mm_castsi128_pd(_mm_set1_epi64x(INT64_MAX));
+	const __m128d maxval  = _mm_set1_pd(FLT_MAX);
+	const __m128d fill    = _mm_set1_pd(rFill);
+	__m128d x, bad;
+	
+	size_t v = 0;
+	for(; v + 2 <= uVals; v += 2){
+		x = _mm_loadu_pd((const double*)(pSrc + 8*v));
+		bad = _mm_cmpgt_pd(_mm_and_pd(x, absmask), maxval);
+		if(bFill)
+			bad = _mm_or_pd(bad, _mm_cmpeq_pd(x, fill));
+		if(_mm_movemask_pd(bad) != 0)
+			break;
+		_mm_storel_pi((__m64*)(pDest + 4*v), _mm_cvtpd_ps(x));
+	}
+	return v;
+}
+
+#endif /* _DAS_CODEC_SIMD */
+
+/* Reverse the bytes in each value, pDest may equal pSrc */
+static void _swap_vals(ubyte* pDest, const ubyte* pSrc, size_t uVals, int nSzEa)
+{
+	size_t v = 0;
+#ifdef _DAS_CODEC_SIMD
+	if(_HAS_AVX2())
+		v = _swap_avx2(pDest, pSrc, uVals, nSzEa);
+	v += _swap_sse2(pDest + v*nSzEa, pSrc + v*nSzEa, uVals - v, nSzEa);
+#endif
+
+	uint16_t u2;
+	uint32_t u4;
+	uint64_t u8;
+
+	switch(nSzEa){
+	case 2:
+		for(; v < uVals; ++v){
+			memcpy(&u2, pSrc + 2*v, 2);
+			u2 = (uint16_t)((u2 << 8) | (u2 >> 8));
+			memcpy(pDest + 2*v, &u2, 2);
 		}
 		break;
 	case 4:
-		for(size_t u = 0; u < (uVals*4); u += 4){
-			uSwap[0] = pSrc[u+3];
-			uSwap[1] = pSrc[u+2];
-			uSwap[2] = pSrc[u+1];
-			uSwap[3] = pSrc[u];
-			*((uint32_t*)(pDest + u)) = *((uint32_t*)uSwap);
+		for(; v < uVals; ++v){
+			memcpy(&u4, pSrc + 4*v, 4);
+			u4 = ((u4 & 0x000000FFu) << 24) | ((u4 & 0x0000FF00u) <<  8) |
+			     ((u4 & 0x00FF0000u) >>  8) | ((u4 & 0xFF000000u) >> 24);
+			memcpy(pDest + 4*v, &u4, 4);
 		}
 		break;
 	case 8:
-		for(size_t u = 0; u < (uVals*8); u += 8){
-			uSwap[0] = pSrc[u+7];
-			uSwap[1] = pSrc[u+6];
-			uSwap[2] = pSrc[u+5];
-			uSwap[3] = pSrc[u+4];
-			uSwap[4] = pSrc[u+3];
-			uSwap[5] = pSrc[u+2];
-			uSwap[6] = pSrc[u+1];
-			uSwap[7] = pSrc[u];
-			*((uint64_t*)(pDest + u)) = *((uint64_t*)uSwap);
+		for(; v < uVals; ++v){
+			memcpy(&u8, pSrc + 8*v, 8);
+			u8 = ((u8 & 0x00FF00FF00FF00FFULL) <<  8) | ((u8 >>  8) & 0x00FF00FF00FF00FFULL);
+			u8 = ((u8 & 0x0000FFFF0000FFFFULL) << 16) | ((u8 >> 16) & 0x0000FFFF0000FFFFULL);
+			u8 = (u8 << 32) | (u8 >> 32);
+			memcpy(pDest + 8*v, &u8, 8);
 		}
 		break;
 	default:
-		return das_error(DASERR_ENC, "Logic error");
+		assert(false);
+		break;
 	}
+}
+
+/* Run the vector widening kernel if there is one for this pair, returns the
+   number of values converted, the caller converts the rest */
+static size_t _widen_vals(
+	ubyte* pDest, const ubyte* pSrc, size_t uVals, das_val_type vtAry,
+	das_val_type vtBuf
+){
+#ifdef _DAS_CODEC_SIMD
+	enum _widen_kind kind = _widen_kind(vtAry, vtBuf);
+	if(kind == _W_NONE)
+		return 0;
+
+	size_t v = 0;
+	if(_HAS_AVX2())
+		v = _widen_avx2(pDest, pSrc, uVals, kind);
+	
+	size_t uAryEa = das_vt_size(vtAry);
+	size_t uBufEa = das_vt_size(vtBuf);
+	v += _widen_sse2(pDest + v*uAryEa, pSrc + v*uBufEa, uVals - v, kind);
+	return v;
+#else
+	(void)pDest; (void)pSrc; (void)uVals; (void)vtAry; (void)vtBuf;
+	return 0;
+#endif
+}
+
+/* ************************************************************************* */
+/* Read helper */
+
+static DasErrCode _swap_read(ubyte* pDest, const ubyte* pSrc, size_t uVals, int nSzEa){
+	if((nSzEa != 2)&&(nSzEa != 4)&&(nSzEa != 8))
+		return das_error(DASERR_ENC, "Logic error");
+
+	_swap_vals(pDest, pSrc, uVals, nSzEa);
 	return DAS_OKAY;
 }
 
@@ -960,7 +1273,15 @@ static DasErrCode _swap_read(ubyte* pDest, const ubyte* pSrc, size_t uVals, int
 static DasErrCode _cast_read(
 	ubyte* pDest, const ubyte* pSrc, size_t uVals, das_val_type vtAry, das_val_type vtBuf
 ){
-	size_t v;
+	/* Vector kernels take the bulk, loops below handle the tail and the 
+	   less common pairs */
+	size_t v = _widen_vals(pDest, pSrc, uVals, vtAry, vtBuf);
+	if(v > 0){
+		pDest += v*das_vt_size(vtAry);
+		pSrc  += v*das_vt_size(vtBuf);
+		uVals -= v;
+	}
+
 	switch(vtAry){
 	case vtDouble:
 		switch(vtBuf){
@@ -1051,6 +1372,23 @@ static DasErrCode _swap_cast_read(
 	size_t v;
 	ubyte val[8];
 
+	/* For pairs with vector kernels, swap a chunk into scratch space and widen
+	   from there, both passes stay in L1 */
+	if(_widen_kind(vtAry, vtBuf) != _W_NONE){
+		uint64_t aScratch[_XFORM_CHUNK/2];  /* room for _XFORM_CHUNK 32-bit values */
+		size_t uBufEa = das_vt_size(vtBuf);
+		size_t uAryEa = das_vt_size(vtAry);
+		size_t uChunk;
+		DasErrCode nRet;
+		for(v = 0; v < uVals; v += uChunk){
+			uChunk = (uVals - v) < _XFORM_CHUNK ? (uVals - v) : _XFORM_CHUNK;
+			_swap_vals((ubyte*)aScratch, pSrc + v*uBufEa, uChunk, (int)uBufEa);
+			nRet = _cast_read(pDest + v*uAryEa, (ubyte*)aScratch, uChunk, vtAry, vtBuf);
+			if(nRet != DAS_OKAY) return nRet;
+		}
+		return DAS_OKAY;
+	}
+
 	switch(vtAry){
 	case vtDouble:
 		switch(vtBuf){
@@ -1108,7 +1446,157 @@ static DasErrCode _swap_cast_read(
 /* ************************************************************************ */
 /* Helper for helpers */
 
-static int _convert_n_store_text(DasCodec* pThis, const char* sValue)
+/* Store a TT2000 time in the array's value type */
+static int _store_tt2k_val(DasCodec* pThis, das_val_type vtAry, int64_t nTime)
+{
+	if(vtAry != vtLong){
+		if(vtAry == vtDouble){
+			if(! pThis->bResLossWarn ){
+				daslog_warn_v(
+					"Resolution loss detected while converting TT2000 values "
+					"to %s.  Hint: Use the 'storage' attribute in your streams "
+					"to fix this.", das_vt_toStr(vtAry)
+				);
+				pThis->bResLossWarn = true;
+			}
+			double rTime = (double)nTime;
+			memcpy(&nTime, &rTime, 8);
+		}
+		else{
+			return das_error(DASERR_ENC,
+				"Refusing to store TT2000 values in a %s", das_vt_toStr(vtAry)
+			);
+		}
+	}
+	
+	DasAry_append(pThis->pAry, (const ubyte*) &nTime, 1);
+	return DAS_OKAY;
+}
+
+/* Store any other epoch time in the array's value type */
+static int _store_epoch_val(DasCodec* pThis, das_val_type vtAry, double rTime)
+{
+	if(vtAry != vtDouble){
+		if(vtAry == vtFloat){
+			if(! pThis->bResLossWarn){
+				daslog_warn_v(
+					"Resolution loss detected while converting %s values "
+					"to %s.  Hint: Use the 'storage' attribute in you're streams "
+					"to fix this.", Units_toStr(pThis->timeUnits), das_vt_toStr(vtAry)
+				);
+				pThis->bResLossWarn = true;
+			}
+			float rTime2 = (float)rTime;
+			DasAry_append(pThis->pAry, (const ubyte*) &rTime2, 1);
+			return DAS_OKAY;			
+		}
+		else{
+			return das_error(DASERR_ENC,"Refusing to store %s values in a %s", 
+				Units_toStr(pThis->timeUnits), das_vt_toStr(vtAry)
+			);
+		}
+	}
+	DasAry_append(pThis->pAry, (const ubyte*) &rTime, 1);
+	return DAS_OKAY;
+}
+
+/* Convert fixed layout ISO times with the codec's cached time parser */
+static int _fast_store_text_time(
+	DasCodec* pThis, das_val_type vtAry, const char* pText, int nLen
+){
+	if((vtAry == vtTime)||(pThis->timeUnits == UNIT_UTC))
+		return 0;
+
+	if(pThis->tparser.units != pThis->timeUnits)
+		das_tparser_init(&(pThis->tparser), pThis->timeUnits);
+
+	int nRet;
+	if(pThis->timeUnits == UNIT_TT2000){
+		int64_t nTime;
+		if(!das_tparser_toTT2k(&(pThis->tparser), pText, nLen, &nTime))
+			return 0;
+		nRet = _store_tt2k_val(pThis, vtAry, nTime);
+	}
+	else{
+		double rTime;
+		if(!das_tparser_toDouble(&(pThis->tparser), pText, nLen, &rTime))
+			return 0;
+		nRet = _store_epoch_val(pThis, vtAry, rTime);
+	}
+	if(nRet != DAS_OKAY)
+		return (nRet < 0) ? nRet : -nRet;
+	return 1;
+}
+
+/* Parse plain numbers and times straight into the array without sscanf.  The
+   whole field must be consumed.  Returns 1 if the value was stored, 0 if the text
+   needs the general path below, or a negative error code. */
+static int _fast_store_text_num(DasCodec* pThis, const char* pText, int nLen)
+{
+	if((pThis->uProc & DASENC_BOOL)||(nLen < 1))
+		return 0;
+
+	if(pThis->timeUnits != NULL)
+		return _fast_store_text_time(pThis, DasAry_valType(pThis->pAry), pText, nLen);
+
+	union { uint8_t u8; int8_t i8; uint16_t u16; int16_t i16; uint32_t u32;
+	        int32_t i32; uint64_t u64; int64_t i64; float f; double d; } val;
+	int64_t nVal = 0;
+	uint64_t uVal = 0;
+
+	das_val_type vtAry = DasAry_valType(pThis->pAry);
+	switch(vtAry){
+	case vtDouble:
+		if(das_txt2double(pText, nLen, &(val.d)) != nLen) return 0;
+		break;
+	case vtFloat:
+		if(das_txt2float(pText, nLen, &(val.f)) != nLen) return 0;
+		break;
+	/* vtByteSeq elements are a pointer and length, not bytes, they take the
+	   general path */
+	case vtUByte:
+		if((das_txt2ulong(pText, nLen, &uVal) != nLen)||(uVal > UINT8_MAX)) return 0;
+		val.u8 = (uint8_t)uVal;
+		break;
+	case vtUShort:
+		if((das_txt2ulong(pText, nLen, &uVal) != nLen)||(uVal > UINT16_MAX)) return 0;
+		val.u16 = (uint16_t)uVal;
+		break;
+	case vtUInt:
+		if((das_txt2ulong(pText, nLen, &uVal) != nLen)||(uVal > UINT32_MAX)) return 0;
+		val.u32 = (uint32_t)uVal;
+		break;
+	case vtULong:
+		if(das_txt2ulong(pText, nLen, &(val.u64)) != nLen) return 0;
+		break;
+	case vtByte:
+		if((das_txt2long(pText, nLen, &nVal) != nLen)||(nVal < INT8_MIN)||(nVal > INT8_MAX))
+			return 0;
+		val.i8 = (int8_t)nVal;
+		break;
+	case vtShort:
+		if((das_txt2long(pText, nLen, &nVal) != nLen)||(nVal < INT16_MIN)||(nVal > INT16_MAX))
+			return 0;
+		val.i16 = (int16_t)nVal;
+		break;
+	case vtInt:
+		if((das_txt2long(pText, nLen, &nVal) != nLen)||(nVal < INT32_MIN)||(nVal > INT32_MAX))
+			return 0;
+		val.i32 = (int32_t)nVal;
+		break;
+	case vtLong:
+		if(das_txt2long(pText, nLen, &(val.i64)) != nLen) return 0;
+		break;
+	default:
+		return 0;
+	}
+
+	if(!DasAry_append(pThis->pAry, (const ubyte*)&val, 1))
+		return -1 * DASERR_ARRAY;
+	return 1;
+}
+
+static int _convert_n_store_text(DasCodec* pThis, const char* sValue, int nLen)
 {
 	ubyte aValue[sizeof(das_time)];
 
@@ -1141,7 +1629,11 @@ static int _convert_n_store_text(DasCodec* pThis, const char* sValue)
 		return DAS_OKAY;
 	}
 
-	int nRet = das_value_fromStr(aValue, sizeof(das_time), vtAry, sValue);
+	int nRet = _fast_store_text_num(pThis, sValue, nLen);
+	if(nRet != 0)
+		return (nRet > 0) ? DAS_OKAY : nRet;
+
+	nRet = das_value_fromStr(aValue, sizeof(das_time), vtAry, sValue);
 	if(nRet != DAS_OKAY)
 		return -1 * nRet;
 
@@ -1153,57 +1645,13 @@ static int _convert_n_store_text(DasCodec* pThis, const char* sValue)
 	}
 
 	/* TT2000 time conversion */
-	if(pThis->timeUnits == UNIT_TT2000){
-		int64_t nTime = dt_to_tt2k((das_time*)aValue);
-
-		if(vtAry != vtLong){
-			if(vtAry == vtDouble){
-				if(! pThis->bResLossWarn ){
-					daslog_warn_v(
-						"Resolution loss detected while converting TT2000 values "
-						"to %s.  Hint: Use the 'storage' attribute in your streams "
-						"to fix this.", das_vt_toStr(vtAry)
-					);
-					pThis->bResLossWarn = true;
-				}
-				double rTime = (double)nTime;
-				memcpy(&nTime, &rTime, 8);
-			}
-			else{
-				return das_error(DASERR_ENC,
-					"Refusing to store TT2000 values in a %s", das_vt_toStr(vtAry)
-				);
-			}
-		}
-		
-		DasAry_append(pThis->pAry, (const ubyte*) &nTime, 1);
-		return DAS_OKAY;
-	}
+	if(pThis->timeUnits == UNIT_TT2000)
+		return _store_tt2k_val(pThis, vtAry, dt_to_tt2k((das_time*)aValue));
 
 	/* Any other time conversion */
-	double rTime = Units_convertFromDt(pThis->timeUnits, (das_time*)aValue);
-	if(vtAry != vtDouble){
-		if(vtAry == vtFloat){
-			if(! pThis->bResLossWarn){
-				daslog_warn_v(
-					"Resolution loss detected while converting %s values "
-					"to %s.  Hint: Use the 'storage' attribute in you're streams "
-					"to fix this.", Units_toStr(pThis->timeUnits), das_vt_toStr(vtAry)
-				);
-				pThis->bResLossWarn = true;
-			}
-			float rTime2 = (float)rTime;
-			DasAry_append(pThis->pAry, (const ubyte*) &rTime2, 1);
-			return DAS_OKAY;			
-		}
-		else{
-			return das_error(DASERR_ENC,"Refusing to store %s values in a %s", 
-				Units_toStr(pThis->timeUnits), das_vt_toStr(vtAry)
-			);
-		}
-	}
-	DasAry_append(pThis->pAry, (const ubyte*) &rTime, 1);
-	return DAS_OKAY;
+	return _store_epoch_val(
+		pThis, vtAry, Units_convertFromDt(pThis->timeUnits, (das_time*)aValue)
+	);
 }
 
 /* Helper ***************************************************************** */
@@ -1240,6 +1688,16 @@ static int _fixed_text_convert(
 	int nBytesRead = 0;
 
 	for(int i = 0; i < nNumToRead; ++i){
+
+		/* Column fast path, parse numbers in place without the copy */
+		nRet = _fast_store_text_num(pThis, pRead, nSzEach);
+		if(nRet < 0) return nRet;
+		if(nRet > 0){
+			pRead += nSzEach;
+			nBytesRead += nSzEach;
+			continue;
+		}
+
 		memset(pValue, 0, uValSz);
 		/* Copy in the non whitespace text */
 		pWrite = pValue;
@@ -1255,7 +1713,7 @@ static int _fixed_text_convert(
 		if(pValue[0] == '\0')
 			DasAry_append(pThis->pAry, NULL, 1);
 		else
-			if((nRet = _convert_n_store_text(pThis, pValue)) != DAS_OKAY)
+			if((nRet = _convert_n_store_text(pThis, pValue, (int)(pWrite - pValue))) != DAS_OKAY)
 				return -1 * nRet;
 	}
 
@@ -1439,7 +1897,7 @@ static int _var_text_read(
 				if(!DasAry_append(pThis->pAry, DasAry_getFill(pThis->pAry), 1))
 					return -1 * DASERR_ARRAY;
 			}
-			else if((nRet = _convert_n_store_text(pThis, pValue)) != DAS_OKAY)
+			else if((nRet = _convert_n_store_text(pThis, pValue, nValSz)) != DAS_OKAY)
 				return -1 * nRet;
 		}
 		else{
@@ -1782,41 +2240,20 @@ int DasCodec_decode(
 /* TODO: Refactor via das_value_binXform */
 
 static DasErrCode _swap_write(DasBuf* pBuf, const ubyte* pSrc, size_t uVals, int nSzEa){
-   /* Now swap and write */
-	ubyte uSwap[8];
-
-	switch(nSzEa){
-	case 2:
-		for(size_t u = 0; u < (uVals*2); u += 2){
-			uSwap[0] = pSrc[u+1];
-			uSwap[1] = pSrc[u];
-			DasBuf_write(pBuf, uSwap, 2);
-		}
-		break;
-	case 4:
-		for(size_t u = 0; u < (uVals*4); u += 4){
-			uSwap[0] = pSrc[u+3];
-			uSwap[1] = pSrc[u+2];
-			uSwap[2] = pSrc[u+1];
-			uSwap[3] = pSrc[u];
-			DasBuf_write(pBuf, uSwap, 4);
-		}
-		break;
-	case 8:
-		for(size_t u = 0; u < (uVals*8); u += 8){
-			uSwap[0] = pSrc[u+7];
-			uSwap[1] = pSrc[u+6];
-			uSwap[2] = pSrc[u+5];
-			uSwap[3] = pSrc[u+4];
-			uSwap[4] = pSrc[u+3];
-			uSwap[5] = pSrc[u+2];
-			uSwap[6] = pSrc[u+1];
-			uSwap[7] = pSrc[u];
-			DasBuf_write(pBuf, uSwap, 8);
-		}
-		break;
-	default:
+	if((nSzEa != 2)&&(nSzEa != 4)&&(nSzEa != 8))
 		return das_error(DASERR_ENC, "Logic error");
+
+	/* Swap a chunk at a time into scratch space, one buffer write per chunk */
+	uint64_t aScratch[_XFORM_CHUNK];
+	size_t uPerChunk = sizeof(aScratch) / nSzEa;
+	size_t uChunk;
+	DasErrCode nRet;
+
+	for(size_t v = 0; v < uVals; v += uChunk){
+		uChunk = (uVals - v) < uPerChunk ? (uVals - v) : uPerChunk;
+		_swap_vals((ubyte*)aScratch, pSrc + v*nSzEa, uChunk, nSzEa);
+		if((nRet = DasBuf_write(pBuf, aScratch, uChunk*nSzEa)) != DAS_OKAY)
+			return nRet;
 	}
 	return DAS_OKAY;
 }
@@ -1827,36 +2264,54 @@ static DasErrCode _cast_swap_write(
 	DasBuf* pBuf, const ubyte* pSrc, size_t uVals, das_val_type vtAry, 
 	const ubyte* pFillIn, das_val_type vtBuf, const ubyte* pFillOut
 ){
-
-	uint64_t outval;
-	uint64_t outswap;
-
 	size_t   insize = das_vt_size(vtAry);
 	size_t   outsize = das_vt_size(vtBuf);
 	assert(outsize <= 8);
 
-	ubyte* pIn = NULL;
-	ubyte* pOut = NULL;
+	/* Values that are out of range or match the fill value have to go through
+	   das_value_binXform.  Doubles are compared to fill with vector compares,
+	   which only agree with a bitwise compare for non-zero, non-NaN fill. */
+#ifdef _DAS_CODEC_SIMD
+	double rFill = 0.0;
+	bool bFill = (pFillIn != NULL);
+	bool bFastF32 = false;
+	if((vtAry == vtDouble)&&(vtBuf == vtFloat)){
+		if(bFill) memcpy(&rFill, pFillIn, sizeof(double));
+		bFastF32 = !bFill || ((rFill == rFill)&&(rFill != 0.0));
+	}
+#endif
 
+	/* Narrow a chunk into scratch space, swap it in place and write it */
+	uint64_t aScratch[_XFORM_CHUNK];
+	size_t uChunk, v, w;
 	int nRet;
-	for(size_t u = 0; u < (uVals*insize); u += insize){
 
-		nRet = das_value_binXform(
-			vtAry, pSrc + u,          pFillIn,
-			vtBuf, (ubyte*)(&outval), pFillOut,
-			0
-		);
-		if(nRet != DAS_OKAY) return nRet;
+	for(v = 0; v < uVals; v += uChunk){
+		uChunk = (uVals - v) < _XFORM_CHUNK ? (uVals - v) : _XFORM_CHUNK;
+		const ubyte* pIn = pSrc + v*insize;
+		ubyte* pOut = (ubyte*)aScratch;
 
-		pIn = (ubyte*)(&outval) + (outsize - 1);
-		pOut = (ubyte*)(&outswap);
-		for(size_t v = 0; v < outsize; ++v){
-			*pOut = *pIn;
-			--pIn;
-			++pOut;
+		for(w = 0; w < uChunk; ++w){
+#ifdef _DAS_CODEC_SIMD
+			if(bFastF32){
+				w += _narrow_f64_f32_sse2(
+					pOut + w*outsize, pIn + w*insize, uChunk - w, rFill, bFill
+				);
+				if(w == uChunk) break;
+			}
+#endif
+			nRet = das_value_binXform(
+				vtAry, pIn + w*insize,    pFillIn,
+				vtBuf, pOut + w*outsize, pFillOut,
+				0
+			);
+			if(nRet != DAS_OKAY) return nRet;
 		}
 
-		nRet = DasBuf_write(pBuf, (ubyte*)&outswap, outsize);
+		if(outsize > 1)
+			_swap_vals(pOut, pOut, uChunk, (int)outsize);
+
+		nRet = DasBuf_write(pBuf, pOut, uChunk*outsize);
 		if(nRet != DAS_OKAY) return nRet;
 	}
 
@@ -1919,6 +2374,8 @@ DasErrCode _DasCodec_printItems(
 		if(nRet != DAS_OKAY)
 			return nRet;
 	}
+	if(strcmp(pThis->outfmt.sFmt, pThis->sOutFmt) != 0)
+		das_fmt_init(&(pThis->outfmt), pThis->sOutFmt);
 
 	/* If the header flag is set wrap after 100 chars or so */
 	int nRoughOutEa = 25;
@@ -1998,19 +2455,23 @@ DasErrCode _DasCodec_printItems(
 			   %g: clean values come out short and readable instead of scientific,
 			   and %g drops trailing zeros itself (no das_value_trimReal needed).
 			   Packet data keeps the width-fitted format the codec built so columns
-			   stay aligned. */
-			const char* sFmt = bInHdr ? ((vt == vtFloat) ? "%.7g" : "%.15g")
-			                          : pThis->sOutFmt;
-			if(vt == vtFloat)
-				snprintf(pReal, uRealSz, sFmt,  (double) *((float*  )(pItem0 + i*uSzEa)));
+			   stay aligned, written by the cached formatter instead of printf. */
+			double rVal = (vt == vtFloat) ? (double) *((float*)(pItem0 + i*uSzEa))
+			                              : *((double*)(pItem0 + i*uSzEa));
+			if(bInHdr)
+				snprintf(pReal, uRealSz, (vt == vtFloat) ? "%.7g" : "%.15g", rVal);
 			else
-				snprintf(pReal, uRealSz, sFmt,  *((double*  )(pItem0 + i*uSzEa)));
+				das_fmt_real(&(pThis->outfmt), pReal, uRealSz, rVal);
 			DasBuf_write(pBuf, pReal, strlen(pReal));
 			break;
 		}
 
 		case vtTime:
 			dt = *((das_time*)(pItem0 + i*uSzEa));
+			if(das_fmt_time(&(pThis->outfmt), pReal, uRealSz, &dt) < (int)uRealSz){
+				DasBuf_write(pBuf, pReal, strlen(pReal));
+				break;
+			}
 			/* why this works... extra arguments are ignored if format string doesn't mention them :-) */
 			DasBuf_printf(pBuf, pThis->sOutFmt, dt.year, dt.month, dt.mday, dt.hour, dt.minute, dt.second);
 			break;
@@ -25,6 +25,7 @@
 #include <das2/value.h>
 #include <das2/array.h>
 #include <das2/buffer.h>
+#include <das2/fmt.h>
 
 #include <das2/encoding.h>  /* <-- only to get DASENC_FMT_LEN, DASENC_TYPE_LEN */
 									 /* otherwise independent */
@@ -77,8 +78,12 @@ typedef struct das_codec {
 	das_units timeUnits; /* If ascii times are to be stored as an integral type
 									this is needed */
 
+	das_tparser tparser; /* Caches the layout and date of ascii times, re-targeted
+	                        whenever timeUnits changes */
+
 	/* For output, thte sprintf string (if UTF8) or the stream encode type */
 	char sOutFmt[DASENC_FMT_LEN];
+	das_fmt outfmt;    /* Cached writer for sOutFmt, re-targeted when it changes */
 
 	char* pOverflow;   /* If the size of a variable length value breaks the */
 	size_t uOverflow;  /* small vector assumption, extra space is here */
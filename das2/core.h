@@ -224,6 +224,10 @@
 #include <das2/iterator.h>
 #include <das2/builder.h>
 #include <das2/dft.h>
+#include <das2/binacc.h>
+#include <das2/histo.h>
+#include <das2/fmt.h>
+#include <das2/xform.h>
 #include <das2/log.h>
 #include <das2/credentials.h>
 #include <das2/http.h>
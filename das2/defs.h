@@ -210,7 +210,9 @@ typedef int DasErrCode;
 #define DASERR_ITER   42
 #define DASERR_SPICE  43
 #define DASERR_URI    44
-#define DASERR_MAX    44
+#define DASERR_BINACC 45
+#define DASERR_HISTO  46
+#define DASERR_MAX    46
 
 #ifdef __cplusplus
  } 
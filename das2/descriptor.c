@@ -71,6 +71,9 @@ void DasDesc_init(DasDesc* pThis, desc_type_t dt){
 	pThis->parent = NULL;
 	pThis->bLooseParsing = false;
 	pThis->uInvalid = 0;
+	pThis->pPropIdx = NULL;
+	pThis->uPropIdxSz = 0;
+	pThis->uPropIdxRows = 0;
 }
 
 DasDesc* new_Descriptor(){
@@ -84,11 +87,21 @@ DasDesc* new_Descriptor(){
 	return pThis;
 }
 
+static void _DasDesc_dropIdx(DasDesc* pThis)
+{
+	free(pThis->pPropIdx);
+	pThis->pPropIdx = NULL;
+	pThis->uPropIdxSz = 0;
+	pThis->uPropIdxRows = 0;
+}
+
 void DasDesc_freeProps(DasDesc* pThis){
+	_DasDesc_dropIdx(pThis);
 	DasAry_deInit(&(pThis->properties));
 }
 
 void DasDesc_clearProps(DasDesc* pThis){
+	_DasDesc_dropIdx(pThis);
 	DasAry_clear(&(pThis->properties));
 }
 
@@ -162,23 +175,110 @@ const DasDesc* DasDesc_parent(const DasDesc* pThis)
 }
 
 /* ************************************************************************* */
-/* Getting Properties */
+/* Property name index */
 
-const DasProp* DasDesc_getLocal(const DasDesc* pThis, const char* sName)
+/* Setting a property that's already present either reuses its row or
+ * invalidates it and appends a new one, and removing one just invalidates
+ * it.  So rows are looked up by name from the end and a name's last row is
+ * the only one that can be valid. */
+
+/* Below this many rows a straight scan is as fast as hashing */
+#define _PROP_IDX_MIN 16
+
+static size_t _DasDesc_hash(const char* sName)
+{
+	size_t uHash = 2166136261u;
+	for(const unsigned char* p = (const unsigned char*)sName; *p != '\0'; ++p){
+		uHash ^= *p;
+		uHash *= 16777619u;
+	}
+	return uHash;
+}
+
+static const char* _DasDesc_rowName(const DasAry* pProps, size_t uRow)
+{
+	size_t uLen = 0;
+	return DasProp_name((const DasProp*)DasAry_getBytesIn(pProps, DIM1_AT(uRow), &uLen));
+}
+
+/* Index any rows appended since the last sync.  Called by the functions
+ * that append property rows so that lookups never have to write to the
+ * descriptor.  If the index can't be allocated it's left behind and lookups
+ * just scan. */
+static void _DasDesc_syncIdx(DasDesc* pThis)
 {
 	const DasAry* pProps = &(pThis->properties);
-	size_t nProps = DasAry_lengthIn(pProps, DIM0);
-	const DasProp* pProp;
+	size_t uRows = DasAry_lengthIn(pProps, DIM0);
+	if(uRows < _PROP_IDX_MIN)
+		return;
+	if((pThis->pPropIdx != NULL)&&(pThis->uPropIdxRows == uRows))
+		return;
+
+	/* Keep the table under half full, re-index from scratch on growth */
+	if(uRows * 2 > pThis->uPropIdxSz){
+		size_t uSz = 64;
+		while(uSz < uRows * 4) uSz <<= 1;
+		size_t* pIdx = (size_t*)calloc(uSz, sizeof(size_t));
+		if(pIdx == NULL) return;   /* Just fall back to scanning */
+		free(pThis->pPropIdx);
+		pThis->pPropIdx = pIdx;
+		pThis->uPropIdxSz = uSz;
+		pThis->uPropIdxRows = 0;
+	}
 
-	for(size_t i = 0; i < nProps; ++i){
-		size_t uPropLen = 0;
-		pProp = (const DasProp*) DasAry_getBytesIn(pProps, DIM1_AT(i), &uPropLen);
-		if((pProp->flags & DASPROP_VALID_MASK) && 
-			(strcmp(DasProp_name(pProp), sName) == 0)
-		)
-		return pProp;
+	size_t uMask = pThis->uPropIdxSz - 1;
+	size_t* pIdx = pThis->pPropIdx;
+	for(size_t uRow = pThis->uPropIdxRows; uRow < uRows; ++uRow){
+		const char* sName = _DasDesc_rowName(pProps, uRow);
+		size_t i = _DasDesc_hash(sName) & uMask;
+		while(pIdx[i] != 0){
+			if(strcmp(_DasDesc_rowName(pProps, pIdx[i] - 1), sName) == 0)
+				break;  /* later rows supersede earlier ones */
+			i = (i + 1) & uMask;
+		}
+		pIdx[i] = uRow + 1;
 	}
-	return NULL;
+	pThis->uPropIdxRows = uRows;
+}
+
+/* Find the last row for a name, valid or not, returns -1 if not present */
+static ptrdiff_t _DasDesc_findRow(const DasDesc* pThis, const char* sName)
+{
+	const DasAry* pProps = &(pThis->properties);
+	size_t uRows = DasAry_lengthIn(pProps, DIM0);
+
+	/* Only trust the index if it covers every row */
+	if((pThis->pPropIdx != NULL)&&(pThis->uPropIdxRows == uRows)){
+		size_t uMask = pThis->uPropIdxSz - 1;
+		const size_t* pIdx = pThis->pPropIdx;
+		for(size_t i = _DasDesc_hash(sName) & uMask; pIdx[i] != 0; i = (i + 1) & uMask){
+			if(strcmp(_DasDesc_rowName(pProps, pIdx[i] - 1), sName) == 0)
+				return (ptrdiff_t)(pIdx[i] - 1);
+		}
+		return -1;
+	}
+
+	for(ptrdiff_t i = (ptrdiff_t)uRows - 1; i >= 0; --i){
+		if(strcmp(_DasDesc_rowName(pProps, i), sName) == 0)
+			return i;
+	}
+	return -1;
+}
+
+/* ************************************************************************* */
+/* Getting Properties */
+
+const DasProp* DasDesc_getLocal(const DasDesc* pThis, const char* sName)
+{
+	ptrdiff_t iRow = _DasDesc_findRow(pThis, sName);
+	if(iRow < 0)
+		return NULL;
+
+	size_t uPropLen = 0;
+	const DasProp* pProp = (const DasProp*) DasAry_getBytesIn(
+		&(pThis->properties), DIM1_AT(iRow), &uPropLen
+	);
+	return (pProp->flags & DASPROP_VALID_MASK) ? pProp : NULL;
 }
 
 const DasProp* DasDesc_getProp(const DasDesc* pThis, const char* sName)
@@ -528,16 +628,11 @@ bool DasDesc_equals(const DasDesc* pThis, const DasDesc* pOther)
 /* Get pointer to property memory by name, even if it's invalid */
 static ubyte* _DasDesc_getPropBuf(DasDesc* pThis, const char* sName, size_t* pPropSz)
 {
-	DasAry* pProps = &(pThis->properties);
-	size_t nProps = DasAry_lengthIn(pProps, DIM0);
-	DasProp* pProp;
+	ptrdiff_t iRow = _DasDesc_findRow(pThis, sName);
+	if(iRow < 0)
+		return NULL;
 
-	for(size_t i = 0; i < nProps; ++i){
-		pProp = (DasProp*) DasAry_getBuf(pProps, vtUByte, DIM1_AT(i), pPropSz);
-		if(strcmp(DasProp_name(pProp), sName) == 0)
-			return (ubyte*)pProp;
-	}
-	return NULL;
+	return DasAry_getBuf(&(pThis->properties), vtUByte, DIM1_AT(iRow), pPropSz);
 }
 
 static ubyte* _DasDesc_getWriteBuf(DasDesc* pThis, const char* sName, size_t uNeedSz)
@@ -583,9 +678,11 @@ DasErrCode DasDesc_flexSet(
 		);
 	}
 
-	return DasProp_init(
+	DasErrCode nRet = DasProp_init(
 		pBuf, uPropSz, sType, uType, sName, sVal, cSep, units, nStandard
 	);
+	_DasDesc_syncIdx(pThis);   /* index new rows once they're named */
+	return nRet;
 }
 
 DasErrCode DasDesc_setProp(DasDesc* pThis, const DasProp* pProp)
@@ -602,6 +699,7 @@ DasErrCode DasDesc_setProp(DasDesc* pThis, const DasProp* pProp)
 	}
 
 	memcpy(pBuf, pProp, uPropSz);
+	_DasDesc_syncIdx(pThis);
 	return DAS_OKAY;
 }
 
@@ -862,6 +960,7 @@ void DasDesc_copyIn(DasDesc* pThis, const DasDesc* pOther)
 			pBuf = DasAry_getBuf(&(pThis->properties), vtUByte, DIM1_AT(-1), &uTmp);
 			assert(uTmp >= uNewLen);
 			memcpy(pBuf, pProp, uNewLen);
+			_DasDesc_syncIdx(pThis);
 		}
 	}
 }
@@ -95,6 +95,14 @@ typedef struct das_descriptor {
     //Number of invalid properites (saved to make length cals faster)
     size_t uInvalid;
 
+    /* Name index over the property rows, built once a descriptor has
+       enough properties to make it pay and extended as rows are appended.
+       Slots hold row+1, 0 is an empty slot.  Only the property setters
+       write to it, so concurrent readers of one descriptor are safe. */
+    size_t* pPropIdx;
+    size_t uPropIdxSz;   /* Slot count, a power of 2, 0 if there's no index */
+    size_t uPropIdxRows; /* Property rows already in the index */
+
     struct das_descriptor* parent;
 	 bool bLooseParsing;
 } DasDesc;
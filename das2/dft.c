@@ -18,15 +18,18 @@
 #define _POSIX_C_SOURCE 200112L
 /* #define _XOPEN_SOURCE 500 */ /* Trying to get pthread_mutexattr_settype */
 
+#include <limits.h>
 #include <pthread.h>
 #include <string.h>
 #include <math.h>
 
 #ifdef _WIN32
+#include <windows.h>
 #define strcasecmp _stricmp
 #define strncasecmp _strnicmp
 #else
 #include <strings.h>
+#include <unistd.h>
 #endif
 
 #include <fftw3.h>
@@ -50,9 +53,17 @@
 #define QDEF(x) _QDEF(x)
 #define DEF_WISDOM QDEF(WISDOM_FILE)
 
-int g_nExecCount = 0;
-pthread_mutex_t g_mtxExecCount = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t g_cndExecCountDec = PTHREAD_COND_INITIALIZER;
+/* Per-account wisdom, relative to the home directory */
+#define DEF_USER_WISDOM ".daswisdom"
+#define USER_WISDOM_ENV "DAS_FFTW_WISDOM"
+
+static char g_sUserWisdom[512] = {'\0'};
+
+/* The FFTW planner is not re-entrant, so plan creation and destruction is
+ * serialized by this lock.  Executing an existing plan is thread safe and
+ * never touches the planner, so transforms don't take it.  Plans are kept
+ * alive by the per-plan reference counts instead. */
+pthread_mutex_t g_mtxPlanner = PTHREAD_MUTEX_INITIALIZER;
 
 bool dft_init(const char* sProgName){
 	/* import the system wide FFTW wisdom */
@@ -78,13 +89,30 @@ bool dft_init(const char* sProgName){
 		}
 	}
 	
+	/* Then layer on any wisdom learned by das2_wisdom for this account */
+	const char* sEnv = getenv(USER_WISDOM_ENV);
+	if((sEnv != NULL)&&(sEnv[0] != '\0'))
+		strncpy(g_sUserWisdom, sEnv, sizeof(g_sUserWisdom) - 1);
+	else
+		snprintf(g_sUserWisdom, sizeof(g_sUserWisdom) - 1, "%s" DAS_DSEPS 
+		         DEF_USER_WISDOM, das_userhome());
+	
+	if(das_isfile(g_sUserWisdom)){
+		bHaveWisdomFile = true;
+		if(fftw_import_wisdom_from_filename(g_sUserWisdom) != 1){
+			daslog_debug_v("(%s) fftw3 refused the wisdom in %s", sProgName,
+			               g_sUserWisdom);
+		}
+	}
+	
 	if(!bHaveWisdomFile){
 		/* Default das2 log level is info, so this works before the call to 
 		 * lower it */
 		daslog_debug_v(
 			"(%s) FFTW wisdom file not found. Hint: you can speed up libdas2 DFT"
-			" functions by running fftw-wisdom and saving the the results in "
-			DEF_WISDOM, sProgName
+			" functions by running das2_wisdom for the DFT lengths you use, or"
+			" by running fftw-wisdom and saving the results in " DEF_WISDOM,
+			sProgName
 		);
 	}
 	
@@ -93,7 +121,7 @@ bool dft_init(const char* sProgName){
 #ifndef NDEBUG
 	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
 #endif
-	if( pthread_mutex_init(&g_mtxExecCount, &attr) != 0) return false;
+	if( pthread_mutex_init(&g_mtxPlanner, &attr) != 0) return false;
 	return true;
 }
 
@@ -105,9 +133,13 @@ struct dft_plan{
 	/* Intentionally held as a void pointer so that application code
 	 * doesn't need to have access to the fftw3.h file */
 	void* vpPlan;
+	
+	/* Half-length real-to-complex plan, forward plans only */
+	void* vpPlanR2c;
 		
 	/* I think the planner needs memory as well */
 	void* vpIn;
+	void* vpInR;
 	void* vpOut;
 	
 	/* Save the length and the direction */
@@ -130,16 +162,8 @@ struct dft_plan{
 
 DftPlan* new_DftPlan(size_t uLen, bool bForward)
 {
-	/* Don't let the DFT exec count change while we are in the planner */
-	pthread_mutex_lock(&g_mtxExecCount);
-	
-	while(g_nExecCount > 0){
-		/* ... unless we need to wait for it to decrease */
-		/* the cond wait function will release the count mutex and this thread
-		 * will not wake up again until another thread calls 
-		 * pthread_cond_broadcast or pthread_cond_signal */
-		pthread_cond_wait(&g_cndExecCountDec, &g_mtxExecCount);
-	}
+	/* Only one thread in the planner at a time */
+	pthread_mutex_lock(&g_mtxPlanner);
 	
 	DftPlan* pThis = (DftPlan*)calloc(1, sizeof(DftPlan));
 	
@@ -162,35 +186,78 @@ DftPlan* new_DftPlan(size_t uLen, bool bForward)
 		nSign, FFTW_MEASURE
 	);
 	
+	/* Real signals only need the non-negative frequencies, which is half
+	 * the work and output memory of a complex transform.  The output buffer
+	 * is reused since the input is a separate array. */
+	if(bForward){
+		pThis->vpInR = fftw_malloc(uLen*sizeof(double));
+		pThis->vpPlanR2c = fftw_plan_dft_r2c_1d(
+			uLen, (double*)pThis->vpInR, (fftw_complex*)pThis->vpOut,
+			FFTW_MEASURE
+		);
+	}
+	
 	pThis->uLen = uLen;
 	pThis->bForward = bForward;
 	
-	pthread_mutex_unlock(&g_mtxExecCount);
+	pthread_mutex_unlock(&g_mtxPlanner);
 	return pThis;
 }
 
 bool del_DftPlan(DftPlan* pThis)
 {	
-	/* Don't let the DFT exec count change while we are in the planner... */
-	pthread_mutex_lock(&g_mtxExecCount);
-	
-	while(g_nExecCount > 0){
-		/* ... unless we need to wait for it to decrease */
-		pthread_cond_wait(&g_cndExecCountDec, &g_mtxExecCount);
-		
-		/* Don't delete this plan if someone is using it */
-		while(pThis->nCount > 0){
-			pthread_cond_wait(&(pThis->cndCountDec), &(pThis->mtxCount));
-		}
-	}
+	/* Don't delete this plan if someone is using it */
+	pthread_mutex_lock(&(pThis->mtxCount));
+	while(pThis->nCount > 0)
+		pthread_cond_wait(&(pThis->cndCountDec), &(pThis->mtxCount));
+	pthread_mutex_unlock(&(pThis->mtxCount));
 	
+	pthread_mutex_lock(&g_mtxPlanner);
 	fftw_destroy_plan( (fftw_plan)pThis->vpPlan);
-	pthread_mutex_unlock(&(pThis->mtxCount));
-	pthread_mutex_unlock(&g_mtxExecCount);
+	if(pThis->vpPlanR2c) fftw_destroy_plan( (fftw_plan)pThis->vpPlanR2c);
+	pthread_mutex_unlock(&g_mtxPlanner);
+	
+	fftw_free(pThis->vpIn);
+	fftw_free(pThis->vpOut);
+	if(pThis->vpInR) fftw_free(pThis->vpInR);
+	pthread_mutex_destroy(&(pThis->mtxCount));
+	pthread_cond_destroy(&(pThis->cndCountDec));
 	free(pThis);
 	return true;
 }
 
+/* ************************************************************************* */
+/* Buffers shared by DFT and PSD objects
+ *
+ * Objects on a forward plan start with a real input array and a half length
+ * output array.  The complex input array and full length output are only
+ * allocated the first time a complex transform is run, so vpIn is NULL
+ * until then. */
+
+static void _dft_allocBufs(
+	const DftPlan* pPlan, void** pvpIn, void** pvpInR, void** pvpOut
+){
+	size_t uLen = pPlan->uLen;
+	*pvpIn = NULL;
+	*pvpInR = NULL;
+	if(pPlan->vpPlanR2c != NULL){
+		*pvpInR = fftw_malloc(uLen*sizeof(double));
+		*pvpOut = fftw_malloc((uLen/2 + 1)*sizeof(fftw_complex));
+	}
+	else{
+		*pvpIn = fftw_malloc(uLen*sizeof(fftw_complex));
+		*pvpOut = fftw_malloc(uLen*sizeof(fftw_complex));
+	}
+}
+
+static void _dft_growBufs(size_t uLen, void** pvpIn, void** pvpOut)
+{
+	if(*pvpIn != NULL) return;
+	*pvpIn = fftw_malloc(uLen*sizeof(fftw_complex));
+	fftw_free(*pvpOut);
+	*pvpOut = fftw_malloc(uLen*sizeof(fftw_complex));
+}
+
 /* ************************************************************************* */
 /* Construction/Destruction DFT object */
 
@@ -233,10 +300,10 @@ Das2Dft* new_Dft(DftPlan* pPlan, const char* sWindow)
 	
 	pThis->uLen = pPlan->uLen;
 	
-	pThis->vpIn = fftw_malloc((pThis->uLen)*sizeof(fftw_complex));
-	pThis->vpOut = fftw_malloc((pThis->uLen)*sizeof(fftw_complex));
+	_dft_allocBufs(pPlan, &(pThis->vpIn), &(pThis->vpInR), &(pThis->vpOut));
 	
 	pThis->bRealOnly = false;
+	pThis->bHalfOut = false;
 	
 	pThis->pWnd = (double*)calloc(pThis->uLen, sizeof(double));
 	size_t u;
@@ -270,6 +337,7 @@ void del_Dft(Das2Dft* pThis){
 	pthread_mutex_unlock(&(pThis->pPlan->mtxCount));
 	
 	if(pThis->vpIn) fftw_free( pThis->vpIn);
+	if(pThis->vpInR) fftw_free( pThis->vpInR);
 	if(pThis->vpOut) fftw_free( pThis->vpOut);
 	if(pThis->pWnd) free(pThis->pWnd);
 	if(pThis->sWindow) free(pThis->sWindow);
@@ -286,16 +354,8 @@ void del_Dft(Das2Dft* pThis){
 DasErrCode Dft_calculate(
 	Das2Dft* pThis, const double* pReal, const double* pImg
 ){
-	
-	/* Block waiting to increment the exec count */
-	pthread_mutex_lock(&g_mtxExecCount);
-	g_nExecCount += 1;
-	pthread_mutex_unlock(&g_mtxExecCount);
-	
+	/* No global lock here, our reference on the plan keeps it alive */
 	if(pThis->pPlan->uLen != pThis->uLen){
-		pthread_mutex_lock(&g_mtxExecCount);
-		g_nExecCount -= 1;
-		pthread_mutex_unlock(&g_mtxExecCount);
 		return das_error(DASERR_DFT, 
 			"Some one changed the plan while it was in use! "
 			"Plan/DFT length mismatch, attempting to calculate a %zu length DFT "
@@ -303,30 +363,39 @@ DasErrCode Dft_calculate(
 		);
 	}
 	
-	fftw_plan     pFftwPlan  = (fftw_plan)   pThis->pPlan->vpPlan;
-	fftw_complex* pIn  = (fftw_complex*) pThis->vpIn;
-	fftw_complex* pOut = (fftw_complex*) pThis->vpOut;
+	size_t u;
 	
-	for(size_t u = 0; u < pThis->uLen; u++){
-		pIn[u][0] = pReal[u] * pThis->pWnd[u];
-		if(pImg)
-			pIn[u][1] = pImg[u] * pThis->pWnd[u];
-		else
-			pIn[u][1] = 0.0;
+	if((pImg == NULL)&&(pThis->pPlan->vpPlanR2c != NULL)){
+		double* pInR = (double*) pThis->vpInR;
+		for(u = 0; u < pThis->uLen; u++)
+			pInR[u] = pReal[u] * pThis->pWnd[u];
+		
+		fftw_execute_dft_r2c(
+			(fftw_plan)pThis->pPlan->vpPlanR2c, pInR, (fftw_complex*)pThis->vpOut
+		);
+		pThis->bHalfOut = true;
+	}
+	else{
+		_dft_growBufs(pThis->uLen, &(pThis->vpIn), &(pThis->vpOut));
+		
+		fftw_complex* pIn  = (fftw_complex*) pThis->vpIn;
+		for(u = 0; u < pThis->uLen; u++){
+			pIn[u][0] = pReal[u] * pThis->pWnd[u];
+			if(pImg)
+				pIn[u][1] = pImg[u] * pThis->pWnd[u];
+			else
+				pIn[u][1] = 0.0;
+		}
+		
+		fftw_execute_dft(
+			(fftw_plan)pThis->pPlan->vpPlan, pIn, (fftw_complex*)pThis->vpOut
+		);
+		pThis->bHalfOut = false;
 	}
-	
-	fftw_execute_dft(pFftwPlan, pIn, pOut);
 
 	pThis->bNewMag = true;
 	pThis->bNewCmp[0] = true; pThis->bNewCmp[1] = true;
 	pThis->bRealOnly = (pImg == NULL);
-
-	/* Block waiting to decrement the exec count, and signal anyone waiting 
-	 * to hear that the count has decreased */
-	pthread_mutex_lock(&g_mtxExecCount);
-	g_nExecCount -= 1;
-	pthread_cond_broadcast(&g_cndExecCountDec);
-	pthread_mutex_unlock(&g_mtxExecCount);
 	
 	return DAS_OKAY;
 }
@@ -346,12 +415,25 @@ const double* _Dft_getComp(Das2Dft* pThis, size_t* pLen, size_t uCmp)
 	if(pThis->uCmpLen[uCmp] != pThis->uLen){
 		if(pThis->pCmpOut[uCmp]) free(pThis->pCmpOut[uCmp]);
 		pThis->pCmpOut[uCmp] = (double*)calloc(pThis->uLen, sizeof(double));
+		pThis->uCmpLen[uCmp] = pThis->uLen;
 	}
 	
 	fftw_complex* pOut = (fftw_complex*) pThis->vpOut;
+	size_t u;
 	
-	for(size_t u = 0; u<pThis->uLen; u++)
-		pThis->pCmpOut[uCmp][u] = pOut[u][uCmp];
+	if(pThis->bHalfOut){
+		/* Real input, negative frequencies are the conjugates of the positive */
+		size_t N = pThis->uLen;
+		for(u = 0; u <= N/2; u++)
+			pThis->pCmpOut[uCmp][u] = pOut[u][uCmp];
+		for(u = N/2 + 1; u < N; u++)
+			pThis->pCmpOut[uCmp][u] = (uCmp == 0) ? pOut[N-u][0] : -pOut[N-u][1];
+	}
+	else{
+		for(u = 0; u<pThis->uLen; u++)
+			pThis->pCmpOut[uCmp][u] = pOut[u][uCmp];
+	}
+	pThis->bNewCmp[uCmp] = false;
 	
 	return pThis->pCmpOut[uCmp];
 }
@@ -393,8 +475,11 @@ const double* Dft_getMagnitude(Das2Dft* pThis, size_t* pLen)
 			for(u = 1; u< uNyquist; u++){
 				uPos = u;
 				uNeg = pThis->uLen - u;
-				pThis->pMag[u] = MAGNITUDE(pOut[uPos][0], pOut[uPos][1]) + 
-			                    MAGNITUDE(pOut[uNeg][0], pOut[uNeg][1]);
+				if(pThis->bHalfOut)
+					pThis->pMag[u] = 2.0 * MAGNITUDE(pOut[uPos][0], pOut[uPos][1]);
+				else
+					pThis->pMag[u] = MAGNITUDE(pOut[uPos][0], pOut[uPos][1]) + 
+				                    MAGNITUDE(pOut[uNeg][0], pOut[uNeg][1]);
 				pThis->pMag[u] /= pThis->uLen;
 			}
 		}
@@ -442,8 +527,7 @@ Das2Psd* new_Psd(DftPlan* pPlan, bool bCenter, const char* sWindow)
 	
 	pThis->uLen = pPlan->uLen;
 	
-	pThis->vpIn = fftw_malloc((pThis->uLen)*sizeof(fftw_complex));
-	pThis->vpOut = fftw_malloc((pThis->uLen)*sizeof(fftw_complex));
+	_dft_allocBufs(pPlan, &(pThis->vpIn), &(pThis->vpInR), &(pThis->vpOut));
 		
 	pThis->bRealOnly = false;
 	pThis->bCenter = bCenter;
@@ -491,6 +575,7 @@ void del_Das2Psd(Das2Psd* pThis)
 	pthread_mutex_unlock(&(pThis->pPlan->mtxCount));
 
 	if(pThis->vpIn) fftw_free( pThis->vpIn);
+	if(pThis->vpInR) fftw_free( pThis->vpInR);
 	if(pThis->vpOut) fftw_free( pThis->vpOut);
 	if(pThis->pWnd) free(pThis->pWnd);
 	if(pThis->sWindow) free(pThis->sWindow);
@@ -525,16 +610,8 @@ DasErrCode Psd_calculate_f(
 DasErrCode Psd_calculate(
 	Das2Psd* pThis, const double* pReal, const double* pImg
 ){
-	
-	/* Block waiting to increment the exec count */
-	pthread_mutex_lock(&g_mtxExecCount);
-	g_nExecCount += 1;
-	pthread_mutex_unlock(&g_mtxExecCount);
-
+	/* No global lock here, our reference on the plan keeps it alive */
 	if(pThis->pPlan->uLen != pThis->uLen){
-		pthread_mutex_lock(&g_mtxExecCount);
-		g_nExecCount -= 1;
-		pthread_mutex_unlock(&g_mtxExecCount);
 		return das_error(DASERR_DFT, 
 			"Some one changed the plan while it was in use! "
 			"Plan/DFT length mismatch, attempting to calculate a %zu length DFT "
@@ -542,12 +619,15 @@ DasErrCode Psd_calculate(
 		);
 	}
 	
-	fftw_plan     pFftwPlan  = (fftw_plan)   pThis->pPlan->vpPlan;
+	pThis->bRealOnly = (pImg == NULL);
+	bool bR2c = pThis->bRealOnly && (pThis->pPlan->vpPlanR2c != NULL);
+	if(!bR2c)
+		_dft_growBufs(pThis->uLen, &(pThis->vpIn), &(pThis->vpOut));
+	
 	fftw_complex* pIn  = (fftw_complex*) pThis->vpIn;
+	double*       pInR = (double*) pThis->vpInR;
 	fftw_complex* pOut = (fftw_complex*) pThis->vpOut;
 	
-	pThis->bRealOnly = (pImg == NULL);
-	
 	/* Shift Out the DC component, if desired */
 	double rRealAvg = 0.0;
 	double rImgAvg = 0.0;
@@ -563,22 +643,33 @@ DasErrCode Psd_calculate(
 	
 	/* Apply the window, calculate input power, and load to FFTW input */
 	pThis->rPwrIn = 0.0;
-	for(u=0; u<pThis->uLen; u++){
-		pIn[u][0] = (pReal[u] - rRealAvg) * pThis->pWnd[u];
-		if(pImg)
-			pIn[u][1] = (pImg[u] - rImgAvg) * pThis->pWnd[u];
-		else
-			pIn[u][1] = 0.0;
-		
-		if(pImg)
-			pThis->rPwrIn += SQUARE((pReal[u] - rRealAvg), (pImg[u] - rImgAvg));
-		else
+	if(bR2c){
+		for(u=0; u<pThis->uLen; u++){
+			pInR[u] = (pReal[u] - rRealAvg) * pThis->pWnd[u];
 			pThis->rPwrIn += SQUARE((pReal[u] - rRealAvg), 0.0);
+		}
+	}
+	else{
+		for(u=0; u<pThis->uLen; u++){
+			pIn[u][0] = (pReal[u] - rRealAvg) * pThis->pWnd[u];
+			if(pImg)
+				pIn[u][1] = (pImg[u] - rImgAvg) * pThis->pWnd[u];
+			else
+				pIn[u][1] = 0.0;
+			
+			if(pImg)
+				pThis->rPwrIn += SQUARE((pReal[u] - rRealAvg), (pImg[u] - rImgAvg));
+			else
+				pThis->rPwrIn += SQUARE((pReal[u] - rRealAvg), 0.0);
+		}
 	}
 	pThis->rPwrIn /= pThis->uLen;
 	
 	/* Get the DFT */
-	fftw_execute_dft(pFftwPlan, pIn, pOut);
+	if(bR2c)
+		fftw_execute_dft_r2c((fftw_plan)pThis->pPlan->vpPlanR2c, pInR, pOut);
+	else
+		fftw_execute_dft((fftw_plan)pThis->pPlan->vpPlan, pIn, pOut);
 
 	/* Calc the power spectral density and the output power */
 	size_t uMagLen = 0;
@@ -604,9 +695,13 @@ DasErrCode Psd_calculate(
 		pThis->rPwrOut += pThis->pMag[No2];
 		
 		for(u = 1; u<No2; u++){
-			pThis->pMag[u] = (SQUARE(pOut[u][0], pOut[u][1])  + 
-					            SQUARE(pOut[N-u][0], pOut[N-u][1]) ) / 
-					            pThis->rWndSqSum;
+			if(bR2c)
+				pThis->pMag[u] = 2.0 * SQUARE(pOut[u][0], pOut[u][1]) / 
+				                 pThis->rWndSqSum;
+			else
+				pThis->pMag[u] = (SQUARE(pOut[u][0], pOut[u][1])  + 
+				                  SQUARE(pOut[N-u][0], pOut[N-u][1]) ) / 
+				                 pThis->rWndSqSum;
 			pThis->rPwrOut += pThis->pMag[u];
 		}
 	}
@@ -617,10 +712,6 @@ DasErrCode Psd_calculate(
 		}
 	}
 	
-	pthread_mutex_lock(&g_mtxExecCount);
-	g_nExecCount -= 1;
-	pthread_mutex_unlock(&g_mtxExecCount);
-	
 	return DAS_OKAY;
 }
 
@@ -637,3 +728,595 @@ const double* Psd_get(const Das2Psd* pThis, size_t* pLen)
 	*pLen = pThis->uMagLen;
 	return pThis->pMag;
 }
+
+/* ************************************************************************* */
+/* Batched PSD setups, one per length and window, shared by all calculators */
+
+#define _PSD_WND_NONE 0
+#define _PSD_WND_HANN 1
+
+/* Aim for about 2 MB of input per FFTW call, but always at least one segment */
+#define _PSD_BATCH_DBLS 262144
+#define _PSD_BATCH_MAX  64
+
+struct psd_setup{
+	size_t uLen;
+	int nWindow;
+	size_t uBatch;      /* Segments transformed per FFTW call */
+	void* vpPlan;       /* A many_dft_r2c plan for uBatch segments */
+	double* pWnd;       /* Aligned window table */
+	double rWndSqSum;
+	struct psd_setup* pNext;
+};
+
+static size_t _psd_batchSize(size_t uLen)
+{
+	size_t uBatch = _PSD_BATCH_DBLS / uLen;
+	if(uBatch < 1) uBatch = 1;
+	if(uBatch > _PSD_BATCH_MAX) uBatch = _PSD_BATCH_MAX;
+	return uBatch;
+}
+
+/* Never freed, guarded by g_mtxPlanner since making one enters the planner */
+static struct psd_setup* g_pPsdSetups = NULL;
+
+static struct psd_setup* _findPsdSetup(size_t uLen, int nWindow)
+{
+	struct psd_setup* pSetup = g_pPsdSetups;
+	for(; pSetup != NULL; pSetup = pSetup->pNext)
+		if((pSetup->uLen == uLen)&&(pSetup->nWindow == nWindow)) break;
+	return pSetup;
+}
+
+static const PsdSetup* _getPsdSetup(size_t uLen, int nWindow)
+{
+	pthread_mutex_lock(&g_mtxPlanner);
+
+	struct psd_setup* pSetup = _findPsdSetup(uLen, nWindow);
+	if(pSetup != NULL){
+		pthread_mutex_unlock(&g_mtxPlanner);
+		return pSetup;
+	}
+
+	pSetup = (struct psd_setup*)calloc(1, sizeof(struct psd_setup));
+	if(pSetup != NULL)
+		pSetup->pWnd = (double*)fftw_malloc(uLen*sizeof(double));
+	if((pSetup == NULL)||(pSetup->pWnd == NULL)){
+		free(pSetup);
+		pthread_mutex_unlock(&g_mtxPlanner);
+		das_error(DASERR_DFT, "Couldn't allocate a PSD setup for length %zu", uLen);
+		return NULL;
+	}
+	pSetup->uLen = uLen;
+	pSetup->nWindow = nWindow;
+	pSetup->uBatch = _psd_batchSize(uLen);
+
+	/* Window and window square sum, same definitions as new_Psd() */
+	size_t u;
+	if(nWindow == _PSD_WND_HANN){
+		for(u = 0; u < uLen; u++){
+			pSetup->pWnd[u] = 0.5*(1.0 - cos((2.0*M_PI*u)/(uLen - 1)));
+			pSetup->rWndSqSum += pSetup->pWnd[u] * pSetup->pWnd[u];
+		}
+		pSetup->rWndSqSum *= uLen;
+	}
+	else{
+		for(u = 0; u < uLen; u++) pSetup->pWnd[u] = 1.0;
+		pSetup->rWndSqSum = ((double)uLen) * ((double)uLen);
+	}
+
+	/* Measuring overwrites the arrays, so plan on scratch buffers.  All
+	   buffers come from fftw_malloc so the plan can run on any of them */
+	int n = (int)uLen;
+	int nOut = n/2 + 1;
+	double* pIn = (double*)fftw_malloc(pSetup->uBatch * uLen * sizeof(double));
+	fftw_complex* pOut = (fftw_complex*)fftw_malloc(
+		pSetup->uBatch * nOut * sizeof(fftw_complex)
+	);
+	if((pIn != NULL)&&(pOut != NULL)){
+		pSetup->vpPlan = fftw_plan_many_dft_r2c(
+			1, &n, (int)pSetup->uBatch, pIn, NULL, 1, n, pOut, NULL, 1, nOut,
+			FFTW_MEASURE
+		);
+	}
+	if(pIn) fftw_free(pIn);
+	if(pOut) fftw_free(pOut);
+
+	if(pSetup->vpPlan == NULL){
+		fftw_free(pSetup->pWnd);
+		free(pSetup);
+		pthread_mutex_unlock(&g_mtxPlanner);
+		das_error(DASERR_DFT, "FFTW could not plan a batch of %zu length real "
+		          "transforms", uLen);
+		return NULL;
+	}
+
+	pSetup->pNext = g_pPsdSetups;
+	g_pPsdSetups = pSetup;
+	pthread_mutex_unlock(&g_mtxPlanner);
+	return pSetup;
+}
+
+/* ************************************************************************* */
+/* Construction/Destruction batched PSD object */
+
+DasPsdBatch* new_DasPsdBatch(size_t uLen, bool bCenter, const char* sWindow)
+{
+	if((uLen < 2) || (uLen % 2 != 0) || (uLen > INT_MAX)){
+		das_error(DASERR_DFT, "Can't handle odd length DFTs, DFTs less than 2 "
+		          "points long, or DFTs longer than %d points.", INT_MAX);
+		return NULL;
+	}
+
+	int nWindow = _PSD_WND_NONE;
+	if(sWindow != NULL){
+		if(strncasecmp(sWindow, "HANN", 4) != 0){
+			das_error(DASERR_DFT, "Unknown window function: '%s'", sWindow);
+			return NULL;
+		}
+		nWindow = _PSD_WND_HANN;
+	}
+
+	const PsdSetup* pSetup = _getPsdSetup(uLen, nWindow);
+	if(pSetup == NULL) return NULL;
+
+	DasPsdBatch* pThis = (DasPsdBatch*)calloc(1, sizeof(DasPsdBatch));
+	if(pThis == NULL){
+		das_error(DASERR_DFT, "Couldn't allocate a PSD batch");
+		return NULL;
+	}
+	pThis->pSetup = pSetup;
+	pThis->uLen = uLen;
+	pThis->uPsdLen = uLen/2 + 1;
+	pThis->bCenter = bCenter;
+	pThis->pIn = (double*)fftw_malloc(pSetup->uBatch * uLen * sizeof(double));
+	pThis->vpOut = fftw_malloc(pSetup->uBatch * pThis->uPsdLen * sizeof(fftw_complex));
+	if((pThis->pIn == NULL)||(pThis->vpOut == NULL)){
+		del_DasPsdBatch(pThis);
+		das_error(DASERR_DFT, "Couldn't allocate transform buffers for %zu "
+		          "segments of length %zu", pSetup->uBatch, uLen);
+		return NULL;
+	}
+	return pThis;
+}
+
+void del_DasPsdBatch(DasPsdBatch* pThis)
+{
+	if(pThis == NULL) return;
+	if(pThis->pIn) fftw_free(pThis->pIn);
+	if(pThis->vpOut) fftw_free(pThis->vpOut);
+	if(pThis->pPsd) free(pThis->pPsd);
+	free(pThis);
+}
+
+/* ************************************************************************* */
+/* Calculate batched PSDs */
+
+static bool _DasPsdBatch_reserve(DasPsdBatch* pThis, size_t uSegs)
+{
+	pThis->uSegs = 0;
+	if(uSegs <= pThis->uSegsAlloc) return true;
+
+	double* pPsd = (double*)realloc(pThis->pPsd, uSegs*pThis->uPsdLen*sizeof(double));
+	if(pPsd == NULL) return false;
+	pThis->pPsd = pPsd;
+	pThis->uSegsAlloc = uSegs;
+	return true;
+}
+
+/* Segment s either comes from a list of pointers or slides along one signal */
+#define _PSD_SEG(ppReal, pReal, uShift, s) \
+	((ppReal) != NULL ? (ppReal)[s] : (pReal) + (s)*(uShift))
+
+/* Calculate PSDs for segments uFirst up to uFirst + uCount into rows of pPsd.
+ * The input and output buffers must have room for one batch of the setup,
+ * they are passed in so that pool workers can use their own. */
+static void _psd_segs(
+	const PsdSetup* pSetup, bool bCenter, double* pIn, fftw_complex* pOut,
+	const double* const* ppReal, const double* pReal, size_t uShift,
+	size_t uFirst, size_t uCount, double* pPsd
+){
+	size_t N = pSetup->uLen;
+	size_t No2 = N / 2;
+	size_t uPsdLen = No2 + 1;
+	double rWss = pSetup->rWndSqSum;
+	const double* pWnd = pSetup->pWnd;
+
+	size_t uEnd = uFirst + uCount;
+	size_t uSlots, s, u;
+	for(size_t uBeg = uFirst; uBeg < uEnd; uBeg += uSlots){
+		uSlots = uEnd - uBeg;
+		if(uSlots > pSetup->uBatch) uSlots = pSetup->uBatch;
+
+		/* Center and window each segment into a slot of the input batch */
+		for(s = 0; s < uSlots; ++s){
+			const double* pSeg = _PSD_SEG(ppReal, pReal, uShift, uBeg + s);
+			double* pSlot = pIn + s*N;
+			double rAvg = 0.0;
+			if(bCenter){
+				for(u = 0; u < N; u++) rAvg += pSeg[u];
+				rAvg /= N;
+			}
+			for(u = 0; u < N; u++)
+				pSlot[u] = (pSeg[u] - rAvg) * pWnd[u];
+		}
+
+		/* The plan always transforms a whole batch, clear any unused slots
+		   so that stale or never written values aren't fed to FFTW */
+		if(uSlots < pSetup->uBatch)
+			memset(pIn + uSlots*N, 0, (pSetup->uBatch - uSlots)*N*sizeof(double));
+
+		fftw_execute_dft_r2c((fftw_plan)pSetup->vpPlan, pIn, pOut);
+
+		for(s = 0; s < uSlots; ++s){
+			fftw_complex* pRow = pOut + s*uPsdLen;
+			double* pDest = pPsd + (uBeg + s)*uPsdLen;
+
+			/* Real input, so the negative frequencies mirror the positive ones */
+			pDest[0] = SQUARE(pRow[0][0], pRow[0][1]) / rWss;
+			pDest[No2] = SQUARE(pRow[No2][0], pRow[No2][1]) / rWss;
+			for(u = 1; u < No2; u++)
+				pDest[u] = 2.0 * SQUARE(pRow[u][0], pRow[u][1]) / rWss;
+		}
+	}
+}
+
+static size_t _psd_slideSegs(size_t uLen, size_t uSamples, size_t uShift)
+{
+	return (uSamples < uLen) ? 0 : (uSamples - uLen)/uShift + 1;
+}
+
+int DasPsdBatch_slide(
+	DasPsdBatch* pThis, const double* pReal, size_t uSamples, size_t uShift
+){
+	if(uShift < 1)
+		return -1 * das_error(DASERR_DFT, "Segment shift must be at least 1");
+
+	size_t uSegs = _psd_slideSegs(pThis->uLen, uSamples, uShift);
+	if(!_DasPsdBatch_reserve(pThis, uSegs))
+		return -1 * das_error(DASERR_DFT, "Couldn't allocate %zu PSDs", uSegs);
+
+	_psd_segs(pThis->pSetup, pThis->bCenter, pThis->pIn,
+		(fftw_complex*)pThis->vpOut, NULL, pReal, uShift, 0, uSegs, pThis->pPsd
+	);
+	pThis->uSegs = uSegs;
+	return (int)uSegs;
+}
+
+int DasPsdBatch_calc(
+	DasPsdBatch* pThis, const double* const* ppReal, size_t uSegs
+){
+	if(!_DasPsdBatch_reserve(pThis, uSegs))
+		return -1 * das_error(DASERR_DFT, "Couldn't allocate %zu PSDs", uSegs);
+
+	_psd_segs(pThis->pSetup, pThis->bCenter, pThis->pIn,
+		(fftw_complex*)pThis->vpOut, ppReal, NULL, 0, 0, uSegs, pThis->pPsd
+	);
+	pThis->uSegs = uSegs;
+	return (int)uSegs;
+}
+
+const double* DasPsdBatch_get(const DasPsdBatch* pThis, size_t uSeg, size_t* pLen)
+{
+	if(uSeg >= pThis->uSegs){
+		*pLen = 0;
+		return NULL;
+	}
+	*pLen = pThis->uPsdLen;
+	return pThis->pPsd + uSeg*pThis->uPsdLen;
+}
+
+/* ************************************************************************* */
+/* Parallel PSD pool */
+
+struct psd_worker{
+	struct das_psd_pool* pPool;
+	pthread_t thread;
+
+	/* Scratch FFTW buffers, grown to fit the largest batch seen */
+	double* pIn;
+	fftw_complex* pOut;
+	size_t uInAlloc;
+	size_t uOutAlloc;
+};
+
+struct das_psd_pool{
+	int nThreads;                  /* Including the calling thread */
+	struct psd_worker* pWorkers;   /* Worker 0 is the calling thread */
+
+	pthread_mutex_t mtx;
+	pthread_cond_t cndStart;
+	pthread_cond_t cndDone;
+	unsigned int uGen;             /* Incremented for each job */
+	int nBusy;                     /* Threads still working on this job */
+	bool bQuit;
+
+	/* The current job, only written while no threads are busy */
+	DasPsdBatch* pDest;
+	const double* const* ppReal;
+	const double* pReal;
+	size_t uShift;
+	size_t uSegs;
+	size_t uNext;                  /* Next segment to claim, guarded by mtx */
+};
+
+/* Each claim covers a whole FFTW batch, so taking the pool mutex for it
+   costs nothing next to the transforms and works with any compiler */
+static size_t _DasPsdPool_claim(DasPsdPool* pThis, size_t uChunk)
+{
+	pthread_mutex_lock(&(pThis->mtx));
+	size_t uFirst = pThis->uNext;
+	pThis->uNext += uChunk;
+	pthread_mutex_unlock(&(pThis->mtx));
+	return uFirst;
+}
+
+/* Claim one FFTW batch worth of segments at a time until none are left.  A
+   worker that can't get scratch buffers claims nothing and leaves the job
+   to the others. */
+static void _DasPsdPool_work(DasPsdPool* pThis, struct psd_worker* pWorker)
+{
+	const PsdSetup* pSetup = pThis->pDest->pSetup;
+	size_t uChunk = pSetup->uBatch;
+
+	size_t uIn = uChunk * pSetup->uLen;
+	size_t uOut = uChunk * (pSetup->uLen/2 + 1);
+	if(pWorker->uInAlloc < uIn){
+		if(pWorker->pIn) fftw_free(pWorker->pIn);
+		pWorker->pIn = (double*)fftw_malloc(uIn * sizeof(double));
+		pWorker->uInAlloc = (pWorker->pIn == NULL) ? 0 : uIn;
+	}
+	if(pWorker->uOutAlloc < uOut){
+		if(pWorker->pOut) fftw_free(pWorker->pOut);
+		pWorker->pOut = (fftw_complex*)fftw_malloc(uOut * sizeof(fftw_complex));
+		pWorker->uOutAlloc = (pWorker->pOut == NULL) ? 0 : uOut;
+	}
+	if((pWorker->pIn == NULL)||(pWorker->pOut == NULL))
+		return;
+
+	size_t uFirst, uCount;
+	for(;;){
+		uFirst = _DasPsdPool_claim(pThis, uChunk);
+		if(uFirst >= pThis->uSegs) break;
+		uCount = pThis->uSegs - uFirst;
+		if(uCount > uChunk) uCount = uChunk;
+
+		_psd_segs(pSetup, pThis->pDest->bCenter, pWorker->pIn, pWorker->pOut,
+			pThis->ppReal, pThis->pReal, pThis->uShift, uFirst, uCount,
+			pThis->pDest->pPsd
+		);
+	}
+}
+
+static void* _DasPsdPool_main(void* vpWorker)
+{
+	struct psd_worker* pWorker = (struct psd_worker*)vpWorker;
+	DasPsdPool* pThis = pWorker->pPool;
+	unsigned int uSeen = 0;
+
+	pthread_mutex_lock(&(pThis->mtx));
+	for(;;){
+		while(!pThis->bQuit && (pThis->uGen == uSeen))
+			pthread_cond_wait(&(pThis->cndStart), &(pThis->mtx));
+		if(pThis->bQuit) break;
+		uSeen = pThis->uGen;
+		pthread_mutex_unlock(&(pThis->mtx));
+
+		_DasPsdPool_work(pThis, pWorker);
+
+		pthread_mutex_lock(&(pThis->mtx));
+		if(--(pThis->nBusy) == 0) pthread_cond_signal(&(pThis->cndDone));
+	}
+	pthread_mutex_unlock(&(pThis->mtx));
+	return NULL;
+}
+
+DasPsdPool* new_DasPsdPool(int nThreads)
+{
+	if(nThreads < 1){
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		long nCpus = (long)info.dwNumberOfProcessors;
+#else
+		long nCpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		nThreads = (nCpus < 1) ? 1 : (int)nCpus;
+	}
+
+	DasPsdPool* pThis = (DasPsdPool*)calloc(1, sizeof(DasPsdPool));
+	if(pThis == NULL){
+		das_error(DASERR_DFT, "Couldn't allocate a PSD thread pool");
+		return NULL;
+	}
+	pThis->pWorkers = (struct psd_worker*)calloc(nThreads, sizeof(struct psd_worker));
+	if(pThis->pWorkers == NULL){
+		free(pThis);
+		das_error(DASERR_DFT, "Couldn't allocate %d PSD workers", nThreads);
+		return NULL;
+	}
+	pthread_mutex_init(&(pThis->mtx), NULL);
+	pthread_cond_init(&(pThis->cndStart), NULL);
+	pthread_cond_init(&(pThis->cndDone), NULL);
+
+	pThis->nThreads = 1;
+	pThis->pWorkers[0].pPool = pThis;
+	for(int i = 1; i < nThreads; ++i){
+		pThis->pWorkers[i].pPool = pThis;
+		if(pthread_create(
+			&(pThis->pWorkers[i].thread), NULL, _DasPsdPool_main, pThis->pWorkers + i
+		) != 0){
+			daslog_warn_v("Only started %d of %d PSD threads", i, nThreads);
+			break;
+		}
+		pThis->nThreads += 1;
+	}
+	return pThis;
+}
+
+void del_DasPsdPool(DasPsdPool* pThis)
+{
+	if(pThis == NULL) return;
+
+	pthread_mutex_lock(&(pThis->mtx));
+	pThis->bQuit = true;
+	pthread_cond_broadcast(&(pThis->cndStart));
+	pthread_mutex_unlock(&(pThis->mtx));
+
+	for(int i = 0; i < pThis->nThreads; ++i){
+		if(i > 0) pthread_join(pThis->pWorkers[i].thread, NULL);
+		if(pThis->pWorkers[i].pIn) fftw_free(pThis->pWorkers[i].pIn);
+		if(pThis->pWorkers[i].pOut) fftw_free(pThis->pWorkers[i].pOut);
+	}
+	pthread_mutex_destroy(&(pThis->mtx));
+	pthread_cond_destroy(&(pThis->cndStart));
+	pthread_cond_destroy(&(pThis->cndDone));
+	free(pThis->pWorkers);
+	free(pThis);
+}
+
+int DasPsdPool_threads(const DasPsdPool* pThis)
+{
+	return pThis->nThreads;
+}
+
+static int _DasPsdPool_run(
+	DasPsdPool* pThis, DasPsdBatch* pDest, const double* const* ppReal,
+	const double* pReal, size_t uShift, size_t uSegs
+){
+	if(!_DasPsdBatch_reserve(pDest, uSegs))
+		return -1 * das_error(DASERR_DFT, "Couldn't allocate %zu PSDs", uSegs);
+
+	pThis->pDest = pDest;
+	pThis->ppReal = ppReal;
+	pThis->pReal = pReal;
+	pThis->uShift = uShift;
+	pThis->uSegs = uSegs;
+	pThis->uNext = 0;
+
+	/* Not worth waking anyone for a single batch */
+	if((pThis->nThreads > 1)&&(uSegs > pDest->pSetup->uBatch)){
+		pthread_mutex_lock(&(pThis->mtx));
+		pThis->nBusy = pThis->nThreads - 1;
+		pThis->uGen += 1;
+		pthread_cond_broadcast(&(pThis->cndStart));
+		pthread_mutex_unlock(&(pThis->mtx));
+
+		_DasPsdPool_work(pThis, pThis->pWorkers);
+
+		pthread_mutex_lock(&(pThis->mtx));
+		while(pThis->nBusy > 0)
+			pthread_cond_wait(&(pThis->cndDone), &(pThis->mtx));
+		pthread_mutex_unlock(&(pThis->mtx));
+	}
+	else{
+		_DasPsdPool_work(pThis, pThis->pWorkers);
+	}
+
+	pThis->pDest = NULL;
+
+	/* Only possible if no thread could get scratch buffers */
+	if((uSegs > 0)&&(pThis->uNext == 0))
+		return -1 * das_error(DASERR_DFT, "Couldn't allocate PSD transform buffers");
+
+	pDest->uSegs = uSegs;
+	return (int)uSegs;
+}
+
+int DasPsdPool_slide(
+	DasPsdPool* pThis, DasPsdBatch* pDest, const double* pReal, size_t uSamples,
+	size_t uShift
+){
+	if(uShift < 1)
+		return -1 * das_error(DASERR_DFT, "Segment shift must be at least 1");
+
+	return _DasPsdPool_run(pThis, pDest, NULL, pReal, uShift,
+		_psd_slideSegs(pDest->uLen, uSamples, uShift)
+	);
+}
+
+int DasPsdPool_calc(
+	DasPsdPool* pThis, DasPsdBatch* pDest, const double* const* ppReal,
+	size_t uSegs
+){
+	return _DasPsdPool_run(pThis, pDest, ppReal, NULL, 0, uSegs);
+}
+
+/* ************************************************************************* */
+/* Wisdom management */
+
+const char* dft_userWisdom(void)
+{
+	return g_sUserWisdom;
+}
+
+DasErrCode dft_learn(size_t uLen, int nEffort)
+{
+	if((uLen < 2)||(uLen > INT_MAX))
+		return das_error(DASERR_DFT, "Can't plan DFTs of length %zu", uLen);
+
+	unsigned int uFlags = FFTW_MEASURE;
+	switch(nEffort){
+	case DAS_DFT_MEASURE:    uFlags = FFTW_MEASURE;    break;
+	case DAS_DFT_PATIENT:    uFlags = FFTW_PATIENT;    break;
+	case DAS_DFT_EXHAUSTIVE: uFlags = FFTW_EXHAUSTIVE; break;
+	default:
+		return das_error(DASERR_DFT, "Unknown planning effort %d", nEffort);
+	}
+
+	/* The same problems, strides and alignment as new_DftPlan() and
+	   new_DasPsdBatch() so that their plans come straight from wisdom */
+	int n = (int)uLen;
+	int nOut = n/2 + 1;
+	int nBatch = (int)_psd_batchSize(uLen);
+
+	pthread_mutex_lock(&g_mtxPlanner);
+
+	fftw_complex* pIn = (fftw_complex*)fftw_malloc(uLen*sizeof(fftw_complex));
+	fftw_complex* pOut = (fftw_complex*)fftw_malloc(uLen*sizeof(fftw_complex));
+	double* pInR = (double*)fftw_malloc(nBatch*uLen*sizeof(double));
+	fftw_complex* pOutR = (fftw_complex*)fftw_malloc(nBatch*nOut*sizeof(fftw_complex));
+
+	fftw_plan aPlans[4];
+	aPlans[0] = fftw_plan_dft_1d(n, pIn, pOut, FFTW_FORWARD, uFlags);
+	aPlans[1] = fftw_plan_dft_1d(n, pIn, pOut, FFTW_BACKWARD, uFlags);
+	aPlans[2] = fftw_plan_dft_r2c_1d(n, pInR, pOutR, uFlags);
+	aPlans[3] = fftw_plan_many_dft_r2c(
+		1, &n, nBatch, pInR, NULL, 1, n, pOutR, NULL, 1, nOut, uFlags
+	);
+
+	DasErrCode nRet = DAS_OKAY;
+	for(int i = 0; i < 4; ++i){
+		if(aPlans[i] == NULL) nRet = DASERR_DFT;
+		else fftw_destroy_plan(aPlans[i]);
+	}
+
+	fftw_free(pIn);
+	fftw_free(pOut);
+	fftw_free(pInR);
+	fftw_free(pOutR);
+	pthread_mutex_unlock(&g_mtxPlanner);
+
+	if(nRet != DAS_OKAY)
+		return das_error(nRet, "FFTW could not plan all %zu point transforms", uLen);
+	return DAS_OKAY;
+}
+
+DasErrCode dft_saveWisdom(const char* sFile)
+{
+	if(sFile == NULL) sFile = g_sUserWisdom;
+	if(sFile[0] == '\0')
+		return das_error(DASERR_DFT, "No wisdom file, has das_init been called?");
+
+	DasErrCode nRet = das_mkdirsto(sFile);
+	if(nRet != DAS_OKAY) return nRet;
+
+	/* Exporting reads the planner's state */
+	pthread_mutex_lock(&g_mtxPlanner);
+	int nOkay = fftw_export_wisdom_to_filename(sFile);
+	pthread_mutex_unlock(&g_mtxPlanner);
+
+	if(!nOkay)
+		return das_error(DASERR_DFT, "Couldn't write FFTW wisdom to %s", sFile);
+	return DAS_OKAY;
+}
@@ -25,13 +25,26 @@
  * 
  * This module provides an amplitude preserving 1-D Fourier transform and power
  * preserving Power Spectral Density estimator.  One key concept for this 
- * module is FFT plans can not be created and destroyed while transforms are
- * running.  On Linux the FFTW3 library is used to provide fast transform
- * capability, the library to use for Windows is yet to be determined.  
+ * module is FFT plans can not be destroyed while transforms that use them
+ * exist.  Each plan keeps a count of the DFT and PSD objects using it, so
+ * transforms on separate threads never wait on each other, only plan
+ * creation and deletion are serialized.  On Linux the FFTW3 library is used
+ * to provide fast transform capability, the library to use for Windows is
+ * yet to be determined.
+ *
+ * Forward plans also carry a half-length real-to-complex plan which is used
+ * automatically for real-only input.
+ *
+ * For spectrograms, DasPsdBatch transforms many segments per FFTW call and
+ * DasPsdPool spreads those segments over a set of worker threads.
  * 
  * On linux if the file /etc/fftw/wisdom exists it will be loaded during the
- * call to das_init().  Pre-planning FFT operations can significantly 
- * increase the speed of new_DftPlan() calls
+ * call to das_init().  After that the per-account wisdom file, 
+ * $HOME/.daswisdom or the file named by the DAS_FFTW_WISDOM environment
+ * variable, is loaded if it exists.  Pre-planning FFT operations can
+ * significantly increase the speed of new_DftPlan() calls and the quality
+ * of the plans.  The das2_wisdom program uses dft_learn() and
+ * dft_saveWisdom() to fill the per-account file for the lengths you use.
  * 
  * The following example uses the pthread library to demonstrate running four
  * simultaneous transforms.
@@ -121,6 +134,53 @@ extern "C" {
 /* Called from das_init */
 bool dft_init(const char* sProgName);
 
+/* Planning effort for dft_learn(), the same as the FFTW planner flags */
+#define DAS_DFT_MEASURE    0
+#define DAS_DFT_PATIENT    1
+#define DAS_DFT_EXHAUSTIVE 2
+
+/** Get the per-account FFTW wisdom file
+ *
+ * @return The value of the DAS_FFTW_WISDOM environment variable at the time
+ *         das_init() was called, or $HOME/.daswisdom if that was not set.
+ *         The file may not exist.
+ */
+DAS_API const char* dft_userWisdom(void);
+
+/** Measure the best FFTW plans for a DFT length
+ *
+ * Plans forward and reverse complex transforms, a real-to-complex transform
+ * and the batched real-to-complex transform used by DasPsdBatch for this
+ * length.  The plans are thrown away but the process-wide FFTW wisdom
+ * remembers them, so later calls to new_DftPlan() and new_DasPsdBatch()
+ * for this length don't need to measure again.  Use dft_saveWisdom() to
+ * keep the results for future programs.
+ *
+ * Takes the global planner lock, so plans can't be created or deleted
+ * while this runs, though existing DFTs continue to calculate.
+ *
+ * @param uLen The DFT length
+ * @param nEffort One of DAS_DFT_MEASURE, DAS_DFT_PATIENT or
+ *        DAS_DFT_EXHAUSTIVE.  Higher effort planning takes longer but can
+ *        find significantly faster plans for lengths with large prime
+ *        factors.  Wisdom at one effort level satisfies all lower levels.
+ *
+ * @return DAS_OKAY or a positive error code.
+ */
+DAS_API DasErrCode dft_learn(size_t uLen, int nEffort);
+
+/** Save all FFTW wisdom gathered by this process
+ *
+ * This includes anything loaded at startup, so saving to the per-account
+ * file adds to its contents instead of replacing them.
+ *
+ * @param sFile The file to write, directories are created as needed.  If
+ *        NULL the per-account wisdom file is written.
+ *
+ * @return DAS_OKAY or a positive error code.
+ */
+DAS_API DasErrCode dft_saveWisdom(const char* sFile);
+
 /** An structure containing a set of global planning data for DFTs 
  * to be preformed. */
 typedef struct dft_plan DftPlan;
@@ -129,8 +189,8 @@ typedef struct dft_plan DftPlan;
  * 
  * DFT plan creation is thread safe in that this function will block until it 
  * can obtain a global plan lock while the new plan is created.  This function
- * will block if any DFTs are currently being calculated or if another thread is 
- * in the process of creating or deleting a new plan.
+ * will block if another thread is in the process of creating or deleting a
+ * plan, but not if DFTs are being calculated.
  * 
  * @param uLen The length of the 1-D complex signal to analyze
  * @param bForward Wether to do a forward DFT or revers DFT
@@ -143,10 +203,9 @@ DAS_API DftPlan* new_DftPlan(size_t uLen, bool bForward);
 
 /** Delete a shareable DFT plan from the heap
  * 
- * DFT plan destruction is thread safe in that this function will block until it 
- * can obtain a global plan lock while the plan is being deleted.  This function
- * will block if any DFTs are currently being calculated or if another thread is 
- * in the process of creating or deleting a plan.
+ * DFT plan destruction is thread safe in that this function will block until
+ * all DFT and PSD objects using this plan have been deleted and then until it
+ * can obtain a global plan lock while the plan is being deleted.
  * 
  * @warning For the love of all that's holy don't run this function if any of
  * your exec threads are still executing.  I don't mean the actual 
@@ -169,8 +228,9 @@ typedef struct das_dft_t{
 	/* The plan, the only varible changed in the plan is the usage count */
 	DftPlan* pPlan;
 
-	/* FFTW variables */
+	/* FFTW variables, vpIn is not allocated until the first complex input */
 	void* vpIn;
+	void* vpInR;
 	void* vpOut;
 	
 	/* Input vector length */
@@ -179,6 +239,9 @@ typedef struct das_dft_t{
 	/* Input vector is real only*/
 	bool bRealOnly;
 	
+	/* Output only has the non-negative frequencies, from a r2c transform */
+	bool bHalfOut;
+	
 	/* DFT Direction */
 	bool bForward;
 	
@@ -301,8 +364,9 @@ typedef struct das_psd_t{
 	/* The plan, the only varible changed in the plan is the usage count */
 	DftPlan* pPlan;
 	
-	/* FFTW variables */
+	/* FFTW variables, vpIn is not allocated until the first complex input */
 	void* vpIn;
+	void* vpInR;
 	void* vpOut;
 	
 	/* Input vector information */
@@ -480,6 +544,174 @@ DAS_API double Psd_powerRatio(
  */
 DAS_API const double* Psd_get(const Das2Psd* pThis, size_t* pLen);
 
+
+/** Cached transform setup shared by all batched PSD calculators with the
+ * same length and window */
+typedef struct psd_setup PsdSetup;
+
+/** A batched power spectral density estimator
+ *
+ * Computes many real-input periodograms per FFTW call.  Segments are
+ * windowed and loaded into an aligned buffer and then transformed together
+ * using a single fftw_plan_many_dft_r2c() plan.  Plans and window tables are
+ * cached process-wide by DFT length and window name, so creating one of
+ * these for a length that has been seen before does not enter the FFTW
+ * planner.  Since real-to-complex transforms are always forward, the
+ * direction is implied.
+ *
+ * Normalization is the same as for Das2Psd, so for real input
+ * DasPsdBatch_get() returns the same values as Psd_get() would after a call
+ * to Psd_calculate() on each segment, to within rounding error.
+ *
+ * Each calculator has it's own buffers, so separate threads may use separate
+ * calculators at the same time.
+ */
+typedef struct das_psd_batch{
+	const PsdSetup* pSetup;
+
+	size_t uLen;      /* Input segment length */
+	size_t uPsdLen;   /* Output length, uLen/2 + 1 */
+	bool bCenter;     /* Center data about the segment average first */
+
+	/* Aligned FFTW buffers, room for one batch */
+	double* pIn;
+	void* vpOut;
+
+	/* Holder for the PSD results, one row of uPsdLen for each segment */
+	double* pPsd;
+	size_t uSegs;     /* Number of valid rows in pPsd */
+	size_t uSegsAlloc;
+} DasPsdBatch;
+
+/** Create a new batched power spectral density calculator
+ *
+ * @param uLen The length of each segment to transform, must be even and at
+ *        least 2.
+ *
+ * @param bCenter If true, each segment is centered on its mean value before
+ *        the window is applied.  This shifts-out the DC component from the
+ *        input.
+ *
+ * @param sWindow A named window to use for the data, either "hann" or NULL
+ *        for a square window.  Same as for new_Psd().
+ *
+ * @return A new batched PSD calculator allocated on the heap, or NULL on an
+ *         error.
+ * @memberof DasPsdBatch
+ */
+DAS_API DasPsdBatch* new_DasPsdBatch(size_t uLen, bool bCenter, const char* sWindow);
+
+/** Free a batched PSD calculator, the shared setup remains cached
+ * @memberof DasPsdBatch
+ */
+DAS_API void del_DasPsdBatch(DasPsdBatch* pThis);
+
+/** Calculate PSDs for overlapping segments of a single real signal
+ *
+ * Segment i starts at sample i*uShift, only segments that fit completely
+ * within the input are calculated.
+ *
+ * @param pThis The batched PSD calculator
+ * @param pReal The real input signal
+ * @param uSamples The number of samples in the input signal
+ * @param uShift The number of samples between segment starts, for example
+ *        uLen/2 for 50% overlap.  Must be at least 1.
+ *
+ * @returns The number of PSDs calculated, which may be 0, or a negative
+ *        error code.  Previous results are overwritten.
+ * @memberof DasPsdBatch
+ */
+DAS_API int DasPsdBatch_slide(
+	DasPsdBatch* pThis, const double* pReal, size_t uSamples, size_t uShift
+);
+
+/** Calculate PSDs for a set of unrelated real segments
+ *
+ * @param pThis The batched PSD calculator
+ * @param ppReal An array of uSegs pointers, each to uLen real values
+ * @param uSegs The number of segments
+ *
+ * @returns The number of PSDs calculated, or a negative error code.  Previous
+ *        results are overwritten.
+ * @memberof DasPsdBatch
+ */
+DAS_API int DasPsdBatch_calc(
+	DasPsdBatch* pThis, const double* const* ppReal, size_t uSegs
+);
+
+/** Get the PSD of one segment from the last calculation
+ *
+ * @param pThis The batched PSD calculator
+ * @param uSeg The segment index
+ * @param pLen Set to the length of the PSD, uLen/2 + 1
+ * @return A pointer to the internal result for this segment, or NULL if the
+ *         segment was not part of the last calculation.  Invalidated by the
+ *         next calculation.
+ * @memberof DasPsdBatch
+ */
+DAS_API const double* DasPsdBatch_get(
+	const DasPsdBatch* pThis, size_t uSeg, size_t* pLen
+);
+
+/** A pool of threads for parallel spectrogram calculation
+ *
+ * Spectrogram columns are handed out to the threads one FFTW batch at a
+ * time, results land in an ordinary DasPsdBatch so they are read back with
+ * DasPsdBatch_get().  The calling thread works on the job as well, and jobs
+ * that fit in a single batch are not handed out at all.
+ *
+ * A pool runs one job at a time, don't share one between threads that may
+ * submit jobs simultaneously.
+ */
+typedef struct das_psd_pool DasPsdPool;
+
+/** Start a pool of spectrogram threads
+ *
+ * @param nThreads The total number of threads, including the calling thread.
+ *        Use 0 or less to match the number of online CPUs, and 1 to run
+ *        everything in the calling thread.
+ *
+ * @return A new thread pool allocated on the heap, or NULL if memory could
+ *         not be allocated
+ * @memberof DasPsdPool
+ */
+DAS_API DasPsdPool* new_DasPsdPool(int nThreads);
+
+/** Stop all threads and free a spectrogram pool
+ * @memberof DasPsdPool
+ */
+DAS_API void del_DasPsdPool(DasPsdPool* pThis);
+
+/** Get the number of threads working on each job, including the caller
+ * @memberof DasPsdPool
+ */
+DAS_API int DasPsdPool_threads(const DasPsdPool* pThis);
+
+/** Same as DasPsdBatch_slide(), but the segments are spread over the pool
+ *
+ * @param pThis The thread pool
+ * @param pDest The batched PSD calculator to hold the results, only it's
+ *        setup and output storage are used.
+ * @param pReal The real input signal
+ * @param uSamples The number of samples in the input signal
+ * @param uShift The number of samples between segment starts
+ *
+ * @returns The number of PSDs calculated or a negative error code.
+ * @memberof DasPsdPool
+ */
+DAS_API int DasPsdPool_slide(
+	DasPsdPool* pThis, DasPsdBatch* pDest, const double* pReal, size_t uSamples,
+	size_t uShift
+);
+
+/** Same as DasPsdBatch_calc(), but the segments are spread over the pool
+ * @memberof DasPsdPool
+ */
+DAS_API int DasPsdPool_calc(
+	DasPsdPool* pThis, DasPsdBatch* pDest, const double* const* ppReal,
+	size_t uSegs
+);
+
 #ifdef __cplusplus
 }
 #endif
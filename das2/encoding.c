@@ -484,20 +484,19 @@ DasErrCode _encodeAsciiValue(DasEncoding* pThis, DasBuf* pBuf, double data)
 	
 	/* Select a default output format if needed */
 	if(pThis->sFmt[0] == '\0') _DasEnc_setDefaultAsciiFmt(pThis);
+	if(strcmp(pThis->fmt.sFmt, pThis->sFmt) != 0)
+		das_fmt_init(&(pThis->fmt), pThis->sFmt);
 	
-	size_t uPosBeg = DasBuf_written(pBuf);
-	int nRet = DasBuf_printf(pBuf, pThis->sFmt, data);
-	if(nRet != 0) return nRet;
-	size_t uPosEnd = DasBuf_written(pBuf);
+	char sVal[128];
+	int nLen = das_fmt_real(&(pThis->fmt), sVal, sizeof(sVal), data);
 	
-	if(nExpect != uPosEnd - uPosBeg)
+	if(nExpect != nLen)
 		return das_error(
-			14, "Output value '%s' using format '%s' for encoding '%s' occupied %zu "
-			"bytes, expected %d", pBuf->sBuf + uPosBeg, pThis->sFmt, pThis->sType, 
-			uPosEnd - uPosBeg, nExpect
+			14, "Output value '%s' using format '%s' for encoding '%s' occupied %d "
+			"bytes, expected %d", sVal, pThis->sFmt, pThis->sType, nLen, nExpect
 		);
 	
-	return 0;
+	return DasBuf_write(pBuf, sVal, nLen);
 }
 
 DasErrCode _encodeTimeValue(
@@ -514,19 +513,17 @@ DasErrCode _encodeTimeValue(
 	
 	/* Select a default output format if needed */
 	if(pThis->sFmt[0] == '\0') _DasEnc_setDefaultTimeFmt(pThis);
+	if(strcmp(pThis->fmt.sFmt, pThis->sFmt) != 0)
+		das_fmt_init(&(pThis->fmt), pThis->sFmt);
 	
-	size_t uPosBeg = DasBuf_written(pBuf);
-	int nRet = DasBuf_printf(pBuf, pThis->sFmt, dt.year, dt.month, dt.mday, 
-			                   dt.hour, dt.minute, dt.second);
-	if(nRet != 0) return nRet;
-	size_t uPosEnd = DasBuf_written(pBuf);
+	char sVal[128];
+	int nLen = das_fmt_time(&(pThis->fmt), sVal, sizeof(sVal), &dt);
 	
-	if(nExpect != uPosEnd - uPosBeg){
+	if(nExpect != nLen){
 		return das_error(14, "Output value '%s' for encoding %s occupied %d "
-				            "bytes, expected %d", pBuf->sBuf + uPosBeg, pThis->sType, 
-		                  uPosEnd - uPosBeg, nExpect);
+				            "bytes, expected %d", sVal, pThis->sType, nLen, nExpect);
 	}
-	return 0;
+	return DasBuf_write(pBuf, sVal, nLen);
 }
 
 
@@ -566,6 +563,18 @@ DasErrCode DasEnc_read(
 ){
 	*pOut = DAS_FILL_VALUE;
 	
+	/* Text numbers are parsed in place, no copy, no sscanf.  As before a field
+	   that doesn't start with a number is left as fill. */
+	if(pThis->nCat == DAS2DT_ASCII){
+		size_t uUnread = 0;
+		const char* pField = (const char*) DasBuf_direct(pBuf, &uUnread);
+		if((pField == NULL)||(uUnread < (size_t)pThis->nWidth))
+			return das_error(14, "Input buffer ends in the middle of a value");
+
+		das_txt2double(pField, pThis->nWidth, pOut);
+		return DasBuf_setReadOffset(pBuf, DasBuf_readOffset(pBuf) + pThis->nWidth);
+	}
+
 	char sBuf[128] = {'\0'};  /* Max field width is 127 chars so we're good */
 	int nHash = DasEnc_hash(pThis);
 	
@@ -607,11 +616,6 @@ DasErrCode DasEnc_read(
 		return 0;
 	}
 	
-	if(pThis->nCat == DAS2DT_ASCII){
-		sscanf(sBuf, "%lf", pOut);
-		return 0;
-	}
-	
 	das_time dt = {0};
 	if(pThis->nCat == DAS2DT_TIME){
 		/* String parsing can be persnicity, copy over to a null terminated buffer */
@@ -26,6 +26,7 @@
 #include <das2/util.h>
 #include <das2/units.h>
 #include <das2/buffer.h>
+#include <das2/fmt.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -139,6 +140,9 @@ typedef struct das_encoding{
 	 *  */
 	char sType[DASENC_TYPE_LEN];
 	
+	/** Cached writer for sFmt, re-initialized whenever sFmt changes */
+	das_fmt fmt;
+	
 } DasEncoding;
 
 /** @} */
@@ -0,0 +1,505 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "fmt.h"
+
+/* Exactly representable powers of ten */
+static const double g_aPow10[23] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const uint64_t g_aPow10u[19] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+	100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+	1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+	1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+	1000000000000000000ULL
+};
+
+#define _TWO_63   9223372036854775808.0
+#define _MAX_PREC 17     /* Most fraction digits for %e, 18 digits < 2^63 */
+#define _TIE_TOL  1e-9   /* Undecided rounding band around one half */
+
+/* ************************************************************************* */
+/* Exact scaling */
+
+/* Dekker's product, a*b = p + *pErr exactly, no FMA instruction needed.  Only
+   used on values well away from overflow and underflow. */
+static double _two_prod(double a, double b, double* pErr)
+{
+	const double rSplit = 134217729.0;  /* 2^27 + 1 */
+	double t, aHi, aLo, bHi, bLo;
+
+	t = rSplit * a;  aHi = t - (t - a);  aLo = a - aHi;
+	t = rSplit * b;  bHi = t - (t - b);  bLo = b - bHi;
+
+	double p = a * b;
+	*pErr = ((aHi*bHi - p) + aHi*bLo + aLo*bHi) + aLo*bLo;
+	return p;
+}
+
+/* Get a * 10^k as x + err.  The error term is exact for 0 <= k <= 22 and
+   good to about 100 bits otherwise.  Returns false if k is out of range. */
+static bool _scale(double a, int k, double* pX, double* pErr, bool* pExact)
+{
+	double e1, e2;
+	*pExact = false;
+
+	if((k >= 0)&&(k <= 22)){
+		*pX = _two_prod(a, g_aPow10[k], pErr);
+		*pExact = true;
+		return true;
+	}
+	if((k > 22)&&(k <= 44)){
+		double x1 = _two_prod(a, 1e22, &e1);
+		*pX = _two_prod(x1, g_aPow10[k - 22], &e2);
+		*pErr = e2 + e1*g_aPow10[k - 22];
+		return true;
+	}
+	if((k < 0)&&(k >= -22)){
+		double p = g_aPow10[-k];
+		double x = a / p;
+		double rHi = _two_prod(x, p, &e1);
+		*pX = x;
+		*pErr = ((a - rHi) - e1) / p;  /* a - rHi is exact, Sterbenz */
+		return true;
+	}
+	return false;
+}
+
+/* Round x + err to an integer the way printf does, half to even on the exact
+   binary value.  Returns false if x + err is too close to a half to decide. */
+static bool _round_int(double x, double err, bool bExact, uint64_t* pR)
+{
+	if(!(x < _TWO_63)) return false;   /* also catches NaN */
+
+	uint64_t uFloor = (uint64_t)x;      /* x >= 0, so this is floor() */
+	double rDist = (x - (double)uFloor) + err;  /* x - floor is exact */
+
+	/* Above 2^53 the error term can be more than one unit */
+	int64_t nAdj = (int64_t)rDist;
+	if((double)nAdj > rDist) --nAdj;
+	uFloor += nAdj;
+	rDist -= (double)nAdj;
+
+	if(rDist < 0.5 - _TIE_TOL)
+		*pR = uFloor;
+	else if(rDist > 0.5 + _TIE_TOL)
+		*pR = uFloor + 1;
+	else if(bExact && (err == 0.0) && (rDist == 0.5))
+		*pR = uFloor + (uFloor & 1);
+	else
+		return false;
+
+	return true;
+}
+
+/* Binary exponent, a = m * 2^e2 with m in [0.5, 1) same as frexp() */
+static int _exp2(double a)
+{
+	uint64_t uBits;
+	memcpy(&uBits, &a, sizeof(uBits));
+	int nBiased = (int)((uBits >> 52) & 0x7FF);
+	if(nBiased == 0){   /* subnormal */
+		int e2;
+		frexp(a, &e2);
+		return e2;
+	}
+	return nBiased - 1022;
+}
+
+/* Get the nPrec+1 significant digits of a >= 0 as an integer r and a
+   decimal exponent, a ~= r * 10^(e10 - nPrec) */
+static bool _exp_digits(double a, int nPrec, uint64_t* pR, int* pE10)
+{
+	if(a == 0.0){ *pR = 0; *pE10 = 0; return true; }
+
+	int e2 = _exp2(a);
+	/* a >= 2^(e2-1), so this never over-estimates */
+	int e10 = (int)floor((e2 - 1) * 0.30102999566398120);
+	uint64_t uLo = g_aPow10u[nPrec];
+	uint64_t uHi = g_aPow10u[nPrec + 1];
+	uint64_t r;
+	double x, err;
+	bool bExact;
+
+	for(int i = 0; i < 3; ++i){
+		if(!_scale(a, nPrec - e10, &x, &err, &bExact)) return false;
+		if(!_round_int(x, err, bExact, &r)) return false;
+
+		if(r < uLo){ --e10; continue; }
+		if(r >= uHi){
+			if(r == uHi){         /* 9.99... rounded up to 10.0 */
+				*pR = uLo;  *pE10 = e10 + 1;
+				return true;
+			}
+			++e10;
+			continue;
+		}
+		*pR = r;  *pE10 = e10;
+		return true;
+	}
+	return false;
+}
+
+/* ************************************************************************* */
+/* Text assembly */
+
+/* Write at least nMin decimal digits of u, returns the count */
+static int _put_uint(char* pOut, uint64_t u, int nMin)
+{
+	char sRev[24];
+	int n = 0;
+	do{ sRev[n++] = (char)('0' + (u % 10));  u /= 10; } while(u > 0);
+	while(n < nMin) sRev[n++] = '0';
+	for(int i = 0; i < n; ++i) pOut[i] = sRev[n - 1 - i];
+	return n;
+}
+
+/* d.ddde+XX from the digits integer, returns the count */
+static int _put_exp(char* pOut, uint64_t r, int e10, int nPrec, char cExp)
+{
+	char sDigits[24];
+	int nDigits = _put_uint(sDigits, r, nPrec + 1);
+	int n = 0;
+
+	pOut[n++] = sDigits[0];
+	if(nPrec > 0){
+		pOut[n++] = '.';
+		memcpy(pOut + n, sDigits + 1, nDigits - 1);
+		n += nDigits - 1;
+	}
+	pOut[n++] = cExp;
+	if(e10 < 0){ pOut[n++] = '-'; e10 = -e10; }
+	else         pOut[n++] = '+';
+	n += _put_uint(pOut + n, (uint64_t)e10, 2);
+	return n;
+}
+
+/* ddd.ddd from the value times 10^nPrec as an integer, returns the count */
+static int _put_fix(char* pOut, uint64_t r, int nPrec)
+{
+	char sDigits[24];
+	int nDigits = _put_uint(sDigits, r, nPrec + 1);
+	int nInt = nDigits - nPrec;
+
+	memcpy(pOut, sDigits, nInt);
+	if(nPrec == 0) return nInt;
+	pOut[nInt] = '.';
+	memcpy(pOut + nInt + 1, sDigits + nInt, nPrec);
+	return nDigits + 1;
+}
+
+/* Format one value with a parsed %e or %f conversion into sOut, which must
+   have room for 64 bytes.  Returns the length, or -1 to use snprintf. */
+static int _write_real(const das_fmt* pThis, char* sOut, double rVal)
+{
+	if(!isfinite(rVal)) return -1;
+
+	char sBody[48];
+	int nBody;
+	double a = fabs(rVal);
+	uint64_t r;
+
+	if(pThis->nKind == DASFMT_EXP){
+		int e10;
+		if(!_exp_digits(a, pThis->nPrec, &r, &e10)) return -1;
+		nBody = _put_exp(sBody, r, e10, pThis->nPrec, pThis->cExp);
+	}
+	else{
+		double x, err;
+		bool bExact;
+		if(!_scale(a, pThis->nPrec, &x, &err, &bExact)) return -1;
+		if(!_round_int(x, err, bExact, &r)) return -1;
+		nBody = _put_fix(sBody, r, pThis->nPrec);
+	}
+
+	char cSign = signbit(rVal) ? '-' : pThis->cSign;
+	int nLen = nBody + (cSign ? 1 : 0);
+	int nPad = (pThis->nWidth > nLen) ? pThis->nWidth - nLen : 0;
+	int n = 0;
+
+	if(nPad && !pThis->bLeft && !pThis->bZero){
+		memset(sOut, ' ', nPad); n = nPad;
+	}
+	if(cSign) sOut[n++] = cSign;
+	if(nPad && !pThis->bLeft && pThis->bZero){
+		memset(sOut + n, '0', nPad); n += nPad;
+	}
+	memcpy(sOut + n, sBody, nBody);
+	n += nBody;
+	if(nPad && pThis->bLeft){
+		memset(sOut + n, ' ', nPad); n += nPad;
+	}
+	return n;
+}
+
+/* Copy with snprintf semantics */
+static int _copy_out(char* sBuf, size_t uLen, const char* sSrc, int nSrc)
+{
+	if(uLen > 0){
+		size_t u = ((size_t)nSrc < uLen) ? (size_t)nSrc : uLen - 1;
+		memcpy(sBuf, sSrc, u);
+		sBuf[u] = '\0';
+	}
+	return nSrc;
+}
+
+/* ************************************************************************* */
+/* Format parsing */
+
+/* Parse "%[-+ 0][W][.P](e|E|f)" at p, returns a pointer past the conversion
+   or NULL if it is something else */
+static const char* _parse_real(das_fmt* pThis, const char* p)
+{
+	if(*p != '%') return NULL;
+	++p;
+
+	for(;; ++p){
+		if(*p == '-')      pThis->bLeft = true;
+		else if(*p == '0') pThis->bZero = true;
+		else if(*p == '+') pThis->cSign = '+';
+		else if(*p == ' '){ if(pThis->cSign != '+') pThis->cSign = ' '; }
+		else break;
+	}
+
+	pThis->nWidth = 0;
+	while((*p >= '0')&&(*p <= '9')){
+		pThis->nWidth = pThis->nWidth*10 + (*p - '0');
+		if(pThis->nWidth > 40) return NULL;
+		++p;
+	}
+
+	pThis->nPrec = 6;
+	if(*p == '.'){
+		++p;
+		pThis->nPrec = 0;
+		while((*p >= '0')&&(*p <= '9')){
+			pThis->nPrec = pThis->nPrec*10 + (*p - '0');
+			if(pThis->nPrec > 22) return NULL;
+			++p;
+		}
+	}
+
+	switch(*p){
+	case 'e': case 'E':
+		if(pThis->nPrec > _MAX_PREC) return NULL;
+		pThis->nKind = DASFMT_EXP;
+		pThis->cExp = *p;
+		break;
+	case 'f':
+		pThis->nKind = DASFMT_FIX;
+		break;
+	default:
+		return NULL;
+	}
+	return p + 1;
+}
+
+static const char* g_aTimeParts[5] = {
+	"%04d", "-%02d", "-%02d", "T%02d", ":%02d"
+};
+
+void das_fmt_init(das_fmt* pThis, const char* sFmt)
+{
+	memset(pThis, 0, sizeof(das_fmt));
+	strncpy(pThis->sFmt, sFmt, DAS_FMT_LEN - 1);
+
+	const char* p = pThis->sFmt;
+	das_fmt tmp = *pThis;
+
+	/* A lone real value conversion */
+	const char* pEnd = _parse_real(&tmp, p);
+	if(pEnd != NULL){
+		if(*pEnd == '\0') *pThis = tmp;
+		return;
+	}
+
+	/* Leading calendar fields, then optionally seconds */
+	int nFields = 0;
+	while(nFields < 5){
+		size_t uLen = strlen(g_aTimeParts[nFields]);
+		if(strncmp(p, g_aTimeParts[nFields], uLen) != 0) break;
+		p += uLen;
+		++nFields;
+	}
+	if(nFields == 0) return;
+
+	tmp = *pThis;
+	if((nFields == 5)&&(*p == ':')){
+		pEnd = _parse_real(&tmp, p + 1);
+		if((pEnd == NULL)||(tmp.nKind != DASFMT_FIX)) return;
+		p = pEnd;
+		++nFields;
+	}
+
+	int nTrail = 0;
+	while(*p == ' '){ ++p; ++nTrail; }
+	if(*p != '\0') return;
+
+	*pThis = tmp;
+	pThis->nKind = DASFMT_TIME;
+	pThis->nFields = nFields;
+	pThis->nTrail = nTrail;
+}
+
+/* ************************************************************************* */
+/* Output */
+
+int das_fmt_real(das_fmt* pThis, char* sBuf, size_t uLen, double rVal)
+{
+	if((pThis->nKind == DASFMT_EXP)||(pThis->nKind == DASFMT_FIX)){
+		char sOut[64];
+		int nOut = _write_real(pThis, sOut, rVal);
+		if(nOut >= 0) return _copy_out(sBuf, uLen, sOut, nOut);
+	}
+	return snprintf(sBuf, uLen, pThis->sFmt, rVal);
+}
+
+int das_fmt_time(das_fmt* pThis, char* sBuf, size_t uLen, const das_time* pDt)
+{
+	if(pThis->nKind != DASFMT_TIME) goto PRINTF;
+
+	int aKey[5] = {pDt->year, pDt->month, pDt->mday, pDt->hour, pDt->minute};
+	int nKey = (pThis->nFields < 5) ? pThis->nFields : 5;
+
+	if(!pThis->bPrefix || (memcmp(aKey, pThis->aKey, nKey*sizeof(int)) != 0)){
+		if((aKey[0] < 0)||(aKey[0] > 9999)) goto PRINTF;
+		for(int i = 1; i < nKey; ++i)
+			if((aKey[i] < 0)||(aKey[i] > 99)) goto PRINTF;
+
+		char* p = pThis->sPrefix;
+		p += _put_uint(p, (uint64_t)aKey[0], 4);
+		for(int i = 1; i < nKey; ++i){
+			*p++ = g_aTimeParts[i][0];
+			p += _put_uint(p, (uint64_t)aKey[i], 2);
+		}
+		if(pThis->nFields == 6) *p++ = ':';
+
+		pThis->nPrefix = (int)(p - pThis->sPrefix);
+		memcpy(pThis->aKey, aKey, sizeof(aKey));
+		pThis->bPrefix = true;
+	}
+
+	char sOut[128];
+	int n = pThis->nPrefix;
+	memcpy(sOut, pThis->sPrefix, n);
+
+	if(pThis->nFields == 6){
+		int nSec = _write_real(pThis, sOut + n, pDt->second);
+		if(nSec < 0) goto PRINTF;
+		n += nSec;
+	}
+	memset(sOut + n, ' ', pThis->nTrail);
+	n += pThis->nTrail;
+
+	return _copy_out(sBuf, uLen, sOut, n);
+
+PRINTF:
+	/* Extra arguments are ignored if the format doesn't mention them */
+	return snprintf(sBuf, uLen, pThis->sFmt, pDt->year, pDt->month, pDt->mday,
+		pDt->hour, pDt->minute, pDt->second);
+}
+
+/* ************************************************************************* */
+/* Shortest round trip output */
+
+/* Does a > 0 printed with nPrec fraction digits read back the same?
+   Decided by where the rounded digits land in the interval of reals that
+   round to a, only falls back to parsing text when that's too close to
+   call or the scaling isn't exact. */
+static bool _round_trips(double a, int nPrec, bool bFloat)
+{
+	double x, err, u, uErr;
+	uint64_t r;
+	int e10;
+	bool bExact;
+
+	if(!_exp_digits(a, nPrec, &r, &e10)) goto PARSE;
+	int k = nPrec - e10;
+	if(!_scale(a, k, &x, &err, &bExact)) goto PARSE;
+
+	/* Distance from the digits to a, in units of 10^-k */
+	double rFloor = floor(x);
+	double rDist = (double)(int64_t)(r - (uint64_t)rFloor) - (x - rFloor) - err;
+
+	/* Half the gap to the neighboring values */
+	int e2;
+	double rMant = frexp(a, &e2);
+	int nUlp = bFloat ? e2 - 24 : e2 - 53;
+	int nMinUlp = bFloat ? -149 : -1074;
+	if(nUlp < nMinUlp) nUlp = nMinUlp;
+	if(!_scale(ldexp(1.0, nUlp), k, &u, &uErr, &bExact)) goto PARSE;
+	double rHalf = (u + uErr) * 0.5;
+
+	/* The gap below a power of two is half as large, unless subnormal */
+	if((rMant == 0.5)&&(rDist < 0.0)&&(nUlp > nMinUlp))
+		rHalf *= 0.5;
+
+	rDist = fabs(rDist);
+	if(rDist < rHalf*(1.0 - _TIE_TOL)) return true;
+	if(rDist > rHalf*(1.0 + _TIE_TOL)) return false;
+
+PARSE:
+	{
+		char sTmp[40];
+		snprintf(sTmp, sizeof(sTmp), "%.*e", nPrec, a);
+		if(bFloat) return strtof(sTmp, NULL) == (float)a;
+		return strtod(sTmp, NULL) == a;
+	}
+}
+
+int das_fmt_shortest(char* sBuf, size_t uLen, double rVal, bool bFloat)
+{
+	if(!isfinite(rVal)) return snprintf(sBuf, uLen, "%.0e", rVal);
+	if(bFloat) rVal = (float)rVal;
+
+	double a = fabs(rVal);
+	int nLo = 0;
+	int nHi = bFloat ? 8 : 16;   /* 9 and 17 digits always round trip */
+
+	if(a == 0.0){
+		nHi = 0;
+	}
+	else{
+		while(nLo < nHi){
+			int nMid = (nLo + nHi) / 2;
+			if(_round_trips(a, nMid, bFloat)) nHi = nMid;
+			else nLo = nMid + 1;
+		}
+	}
+
+	uint64_t r;
+	int e10;
+	if(!_exp_digits(a, nHi, &r, &e10))
+		return snprintf(sBuf, uLen, "%.*e", nHi, rVal);
+
+	char sOut[40];
+	int n = 0;
+	if(signbit(rVal)) sOut[n++] = '-';
+	n += _put_exp(sOut + n, r, e10, nHi, 'e');
+	return _copy_out(sBuf, uLen, sOut, n);
+}
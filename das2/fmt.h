@@ -0,0 +1,146 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file fmt.h Fast text output of real values and time stamps */
+
+#ifndef _das_fmt_h_
+#define _das_fmt_h_
+
+#include <das2/defs.h>
+#include <das2/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup DM
+ * @{
+ */
+
+#define DAS_FMT_LEN 64
+
+#define DASFMT_PRINTF 0   /* Not recognized, values go through snprintf */
+#define DASFMT_EXP    1   /* %W.Pe or %W.PE */
+#define DASFMT_FIX    2   /* %W.Pf */
+#define DASFMT_TIME   3   /* %04d-%02d-%02dT%02d:%02d:%0W.Pf, or a prefix */
+
+/** Cached writer for columns of real values or time stamps
+ *
+ * Text streams format every value with the same printf conversion.  This
+ * object parses that conversion once and then writes values directly,
+ * without going through vsnprintf.  Output is byte for byte the same as
+ * snprintf.
+ *
+ * Recognized real conversions are a single @c %e, @c %E or @c %f with any of
+ * the '-', '+', ' ' and '0' flags, a width and a precision.  Digits are
+ * found by scaling the value by a power of ten with an exact error term, so
+ * the rounding is the same as printf's.  When the rounding can't be decided
+ * that way, for values at an exact tie, values too large or small to scale
+ * exactly, or precisions over 17 digits, the value goes through snprintf.
+ *
+ * Recognized time conversions are the layouts made by das_value_fmt(), that
+ * is @c YYYY-MM-DDThh:mm:ss.fff or any leading part of it, with optional
+ * trailing spaces.  The text up to the seconds field is cached and only
+ * re-written when the minute changes.
+ *
+ * Any other conversion is handed to snprintf unchanged.  Embed one per
+ * column, no heap memory is used and no cleanup is needed.
+ */
+typedef struct das_fmt_t {
+	char sFmt[DAS_FMT_LEN];  /* The printf conversion this object is for   */
+	int  nKind;              /* One of the DASFMT_ values                  */
+	int  nWidth;             /* Minimum field width                        */
+	int  nPrec;              /* Fraction digits                            */
+	char cSign;              /* Non-negative sign: '\0', '+' or ' '        */
+	bool bLeft;              /* Left justify in the field                  */
+	bool bZero;              /* Pad with zeros after the sign              */
+	char cExp;               /* 'e' or 'E'                                 */
+
+	int  nFields;            /* Calendar fields in time output, 1 to 6     */
+	int  nTrail;             /* Trailing spaces after a time               */
+	bool bPrefix;            /* True if the cached prefix below is valid   */
+	int  aKey[5];            /* Year, month, day, hour, minute of sPrefix  */
+	int  nPrefix;            /* Bytes in the cached prefix                 */
+	char sPrefix[20];        /* Time text before the seconds               */
+} das_fmt;
+
+/** Initialize or re-target a value writer
+ *
+ * @param pThis The writer to initialize
+ * @param sFmt A printf format for one double, or for the year, month, day,
+ *        hour, minute and seconds of a time stamp.  Formats longer than
+ *        DAS_FMT_LEN - 1 bytes are truncated.
+ *
+ * @memberof das_fmt
+ */
+DAS_API void das_fmt_init(das_fmt* pThis, const char* sFmt);
+
+/** Write one real value
+ *
+ * @param pThis The writer
+ * @param sBuf The output buffer, always null terminated if uLen > 0
+ * @param uLen The size of the output buffer
+ * @param rVal The value to write
+ *
+ * @returns The number of characters the full value takes, not counting the
+ *          terminating null, same as snprintf.
+ * @memberof das_fmt
+ */
+DAS_API int das_fmt_real(das_fmt* pThis, char* sBuf, size_t uLen, double rVal);
+
+/** Write one time stamp
+ *
+ * @param pThis The writer
+ * @param sBuf The output buffer, always null terminated if uLen > 0
+ * @param uLen The size of the output buffer
+ * @param pDt The time to write, the yday field is not used
+ *
+ * @returns The number of characters the full value takes, not counting the
+ *          terminating null, same as snprintf.
+ * @memberof das_fmt
+ */
+DAS_API int das_fmt_time(
+	das_fmt* pThis, char* sBuf, size_t uLen, const das_time* pDt
+);
+
+/** Write the shortest text that reads back as the same value
+ *
+ * The output is the same as snprintf("%.*e") for the smallest precision
+ * that round trips through strtod() (or strtof() for floats), for example
+ * 0.1 is written as "1e-01" and not "1.0000000000000001e-01".  Only the
+ * rounding is checked at each precision, no text is parsed, except for
+ * values too large or small to scale exactly.  At the lower edge of each
+ * binary exponent the result may occasionally be one digit longer than
+ * strictly required, it always reads back exactly.
+ *
+ * @param sBuf The output buffer, always null terminated if uLen > 0
+ * @param uLen The size of the output buffer, 32 bytes is always enough
+ * @param rVal The value to write
+ * @param bFloat If true the value is a 32-bit float, fewer digits are needed
+ *
+ * @returns The number of characters the full value takes, not counting the
+ *          terminating null, same as snprintf.
+ */
+DAS_API int das_fmt_shortest(char* sBuf, size_t uLen, double rVal, bool bFloat);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _das_fmt_h_ */
@@ -0,0 +1,457 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "util.h"
+#include "histo.h"
+
+#define _HISTO_MIN_BINS  1024
+#define _QUANT_DEF_CAP   256
+
+/* ************************************************************************* */
+/* Histogram construction */
+
+DasHisto* new_DasHisto(
+	int nMode, size_t uItems, double rMin, double rMax, size_t uBins
+){
+	if(uItems == 0){
+		das_error(DASERR_HISTO, "Histograms need at least one item");
+		return NULL;
+	}
+	if(nMode != DAS_HISTO_EXACT){
+		if((nMode != DAS_HISTO_LINEAR)&&(nMode != DAS_HISTO_LOG)){
+			das_error(DASERR_HISTO, "Unknown histogram mode %d", nMode);
+			return NULL;
+		}
+		if((uBins == 0)||!(rMax > rMin)||((nMode == DAS_HISTO_LOG)&&!(rMin > 0.0))){
+			das_error(DASERR_HISTO, "Invalid histogram edges, %g to %g in %zu bins%s",
+				rMin, rMax, uBins, (nMode == DAS_HISTO_LOG) ? " (log)" : ""
+			);
+			return NULL;
+		}
+	}
+
+	DasHisto* pThis = (DasHisto*)calloc(1, sizeof(DasHisto));
+	pThis->nMode = nMode;
+	pThis->uItems = uItems;
+
+	if(nMode == DAS_HISTO_EXACT){
+		pThis->uBinsAlloc = _HISTO_MIN_BINS;
+		pThis->uSlots = 2*_HISTO_MIN_BINS;
+		pThis->pSlots = (size_t*)calloc(pThis->uSlots, sizeof(size_t));
+		pThis->bSorted = true;
+	}
+	else{
+		pThis->uBins = uBins;
+		pThis->uBinsAlloc = uBins;
+		if(nMode == DAS_HISTO_LOG){
+			rMin = log10(rMin);
+			rMax = log10(rMax);
+		}
+		pThis->rMin = rMin;
+		pThis->rScale = uBins / (rMax - rMin);
+		pThis->bSorted = true;
+	}
+
+	pThis->pVals = (double*)malloc(pThis->uBinsAlloc * sizeof(double));
+	pThis->pCounts = (double*)calloc(pThis->uBinsAlloc * uItems, sizeof(double));
+	if((pThis->pVals == NULL)||(pThis->pCounts == NULL)){
+		del_DasHisto(pThis);
+		das_error(DASERR_HISTO, "Couldn't allocate %zu bins of %zu items",
+			pThis->uBinsAlloc, uItems);
+		return NULL;
+	}
+
+	/* Bin centers, geometric centers for log bins */
+	if(nMode != DAS_HISTO_EXACT){
+		for(size_t u = 0; u < uBins; ++u){
+			pThis->pVals[u] = pThis->rMin + (u + 0.5)/pThis->rScale;
+			if(nMode == DAS_HISTO_LOG) pThis->pVals[u] = pow(10.0, pThis->pVals[u]);
+		}
+	}
+	return pThis;
+}
+
+void del_DasHisto(DasHisto* pThis)
+{
+	if(pThis == NULL) return;
+	free(pThis->pVals);
+	free(pThis->pCounts);
+	free(pThis->pSlots);
+	free(pThis);
+}
+
+/* ************************************************************************* */
+/* Exact mode hash table */
+
+static size_t _histo_hash(double rVal)
+{
+	/* 0.0 == -0.0, so they have to hash the same */
+	if(rVal == 0.0) rVal = 0.0;
+	uint64_t u;
+	memcpy(&u, &rVal, sizeof(u));
+	u ^= u >> 33;
+	u *= 0xff51afd7ed558ccdULL;
+	u ^= u >> 33;
+	u *= 0xc4ceb9fe1a85ec53ULL;
+	u ^= u >> 33;
+	return (size_t)u;
+}
+
+static void _histo_rehash(DasHisto* pThis, size_t uSlots)
+{
+	free(pThis->pSlots);
+	pThis->pSlots = (size_t*)calloc(uSlots, sizeof(size_t));
+	pThis->uSlots = uSlots;
+	for(size_t uBin = 0; uBin < pThis->uBins; ++uBin){
+		size_t i = _histo_hash(pThis->pVals[uBin]) & (uSlots - 1);
+		while(pThis->pSlots[i] != 0) i = (i + 1) & (uSlots - 1);
+		pThis->pSlots[i] = uBin + 1;
+	}
+}
+
+/* Get the bin for a value, adding one if needed.  Returns uBinsAlloc if
+   memory runs out */
+static size_t _histo_exactBin(DasHisto* pThis, double rVal)
+{
+	size_t uMask = pThis->uSlots - 1;
+	size_t i = _histo_hash(rVal) & uMask;
+	size_t uBin;
+	while((uBin = pThis->pSlots[i]) != 0){
+		if(pThis->pVals[uBin - 1] == rVal) return uBin - 1;
+		i = (i + 1) & uMask;
+	}
+
+	/* New distinct value, grow storage first */
+	if(pThis->uBins == pThis->uBinsAlloc){
+		size_t uNew = pThis->uBinsAlloc * 2;
+		double* pVals = (double*)realloc(pThis->pVals, uNew*sizeof(double));
+		if(pVals == NULL) return pThis->uBinsAlloc;
+		pThis->pVals = pVals;
+		double* pCounts = (double*)realloc(
+			pThis->pCounts, uNew * pThis->uItems * sizeof(double)
+		);
+		if(pCounts == NULL) return pThis->uBinsAlloc;
+		memset(pCounts + pThis->uBinsAlloc*pThis->uItems, 0,
+			(uNew - pThis->uBinsAlloc) * pThis->uItems * sizeof(double));
+		pThis->pCounts = pCounts;
+		pThis->uBinsAlloc = uNew;
+	}
+
+	uBin = pThis->uBins++;
+	pThis->pVals[uBin] = (rVal == 0.0) ? 0.0 : rVal;
+	pThis->bSorted = false;
+
+	/* Keep the table at most half full */
+	if(2*pThis->uBins > pThis->uSlots)
+		_histo_rehash(pThis, pThis->uSlots * 2);
+	else
+		pThis->pSlots[i] = uBin + 1;
+
+	return uBin;
+}
+
+/* ************************************************************************* */
+/* Counting */
+
+DasErrCode DasHisto_add(DasHisto* pThis, size_t uItem, double rVal)
+{
+	if(uItem >= pThis->uItems)
+		return das_error(DASERR_HISTO, "Item %zu is out of range, histogram has "
+			"%zu items", uItem, pThis->uItems);
+	if(isnan(rVal)) return DAS_OKAY;
+
+	size_t uBin;
+	double rPos;
+	switch(pThis->nMode){
+	case DAS_HISTO_EXACT:
+		uBin = _histo_exactBin(pThis, rVal);
+		if(uBin == pThis->uBinsAlloc)
+			return das_error(DASERR_HISTO, "Out of memory at %zu distinct values",
+				pThis->uBins);
+		break;
+
+	case DAS_HISTO_LOG:
+		if(!(rVal > 0.0)){ pThis->uDropped += 1;  return DAS_OKAY; }
+		rVal = log10(rVal);
+		/* Fall through */
+	default:
+		rPos = (rVal - pThis->rMin) * pThis->rScale;
+		if(!(rPos >= 0.0) || (rPos > (double)pThis->uBins)){
+			pThis->uDropped += 1;
+			return DAS_OKAY;
+		}
+		uBin = (size_t)rPos;
+		if(uBin == pThis->uBins) uBin -= 1;   /* The top edge is inclusive */
+		break;
+	}
+
+	double* pCount = pThis->pCounts + uBin*pThis->uItems + uItem;
+	*pCount += 1;
+	if(*pCount > pThis->rMaxCount) pThis->rMaxCount = *pCount;
+	return DAS_OKAY;
+}
+
+/* ************************************************************************* */
+/* Output */
+
+typedef struct histo_key {
+	double rVal;
+	size_t uBin;
+} histo_key_t;
+
+static int _histo_keyCmp(const void* vp1, const void* vp2)
+{
+	double r1 = ((const histo_key_t*)vp1)->rVal;
+	double r2 = ((const histo_key_t*)vp2)->rVal;
+	return (r1 < r2) ? -1 : ((r1 > r2) ? 1 : 0);
+}
+
+size_t DasHisto_finish(DasHisto* pThis)
+{
+	if(pThis->bSorted) return pThis->uBins;
+
+	size_t uBins = pThis->uBins;
+	size_t uItems = pThis->uItems;
+	histo_key_t* pKeys = (histo_key_t*)malloc(uBins * sizeof(histo_key_t));
+	double* pCounts = (double*)calloc(pThis->uBinsAlloc * uItems, sizeof(double));
+	if((pKeys == NULL)||(pCounts == NULL)){
+		free(pKeys);
+		free(pCounts);
+		das_error(DASERR_HISTO, "Couldn't allocate memory to sort %zu bins", uBins);
+		return 0;
+	}
+
+	size_t u;
+	for(u = 0; u < uBins; ++u){
+		pKeys[u].rVal = pThis->pVals[u];
+		pKeys[u].uBin = u;
+	}
+	qsort(pKeys, uBins, sizeof(histo_key_t), _histo_keyCmp);
+
+	for(u = 0; u < uBins; ++u){
+		pThis->pVals[u] = pKeys[u].rVal;
+		memcpy(pCounts + u*uItems, pThis->pCounts + pKeys[u].uBin*uItems,
+			uItems*sizeof(double));
+	}
+	free(pKeys);
+	free(pThis->pCounts);
+	pThis->pCounts = pCounts;
+
+	_histo_rehash(pThis, pThis->uSlots);
+	pThis->bSorted = true;
+	return uBins;
+}
+
+double* DasHisto_bin(DasHisto* pThis, size_t uBin, double* pVal)
+{
+	if(uBin >= pThis->uBins) return NULL;
+	if(pVal) *pVal = pThis->pVals[uBin];
+	return pThis->pCounts + uBin*pThis->uItems;
+}
+
+/* ************************************************************************* */
+/* Quantile sketch */
+
+DasQuantile* new_DasQuantile(size_t uCap)
+{
+	if(uCap == 0) uCap = _QUANT_DEF_CAP;
+	if(uCap < 2) uCap = 2;
+
+	DasQuantile* pThis = (DasQuantile*)calloc(1, sizeof(DasQuantile));
+	pThis->uCap = uCap;
+	pThis->rMin = NAN;
+	pThis->rMax = NAN;
+	return pThis;
+}
+
+void del_DasQuantile(DasQuantile* pThis)
+{
+	if(pThis == NULL) return;
+	for(int i = 0; i < DAS_QUANT_LEVELS; ++i) free(pThis->aLevel[i]);
+	free(pThis->pSorted);
+	free(pThis->pCumWt);
+	free(pThis);
+}
+
+void DasQuantile_clear(DasQuantile* pThis)
+{
+	for(int i = 0; i < DAS_QUANT_LEVELS; ++i) pThis->aUsed[i] = 0;
+	pThis->uCount = 0;
+	pThis->rMin = NAN;
+	pThis->rMax = NAN;
+	pThis->bDirty = true;
+}
+
+uint64_t DasQuantile_count(const DasQuantile* pThis)
+{
+	return pThis->uCount;
+}
+
+static int _quant_dblCmp(const void* vp1, const void* vp2)
+{
+	double r1 = *((const double*)vp1);
+	double r2 = *((const double*)vp2);
+	return (r1 < r2) ? -1 : ((r1 > r2) ? 1 : 0);
+}
+
+/* Levels hold up to 2*uCap values so that a compaction from below always
+   fits, they are compacted once they reach uCap */
+static void _quant_compact(DasQuantile* pThis, int nLevel)
+{
+	/* The top level just keeps growing, which takes 2^48 * uCap values */
+	if(nLevel == DAS_QUANT_LEVELS - 1){
+		size_t uCap = 2*pThis->aUsed[nLevel];
+		pThis->aLevel[nLevel] = (double*)realloc(pThis->aLevel[nLevel],
+			2*uCap*sizeof(double));
+		return;
+	}
+
+	double* pLvl = pThis->aLevel[nLevel];
+	size_t uUsed = pThis->aUsed[nLevel];
+	qsort(pLvl, uUsed, sizeof(double), _quant_dblCmp);
+
+	int nUp = nLevel + 1;
+	if(pThis->aLevel[nUp] == NULL)
+		pThis->aLevel[nUp] = (double*)malloc(2*pThis->uCap*sizeof(double));
+	if(nUp >= pThis->nLevels) pThis->nLevels = nUp + 1;
+
+	/* Each pair becomes one value of twice the weight, an odd value out
+	   (the largest) stays behind */
+	size_t uPairs = uUsed / 2;
+	size_t uOff = pThis->bOdd ? 1 : 0;
+	double* pDest = pThis->aLevel[nUp] + pThis->aUsed[nUp];
+	for(size_t u = 0; u < uPairs; ++u) pDest[u] = pLvl[2*u + uOff];
+	pThis->aUsed[nUp] += uPairs;
+	pThis->bOdd = !pThis->bOdd;
+
+	if(uUsed % 2){
+		pLvl[0] = pLvl[uUsed - 1];
+		pThis->aUsed[nLevel] = 1;
+	}
+	else{
+		pThis->aUsed[nLevel] = 0;
+	}
+
+	if(pThis->aUsed[nUp] >= pThis->uCap) _quant_compact(pThis, nUp);
+}
+
+void DasQuantile_add(DasQuantile* pThis, double rVal)
+{
+	if(isnan(rVal)) return;
+
+	if(pThis->uCount == 0){
+		pThis->rMin = rVal;
+		pThis->rMax = rVal;
+	}
+	else{
+		if(rVal < pThis->rMin) pThis->rMin = rVal;
+		if(rVal > pThis->rMax) pThis->rMax = rVal;
+	}
+	pThis->uCount += 1;
+	pThis->bDirty = true;
+
+	if(pThis->aLevel[0] == NULL){
+		pThis->aLevel[0] = (double*)malloc(2*pThis->uCap*sizeof(double));
+		pThis->nLevels = 1;
+	}
+	pThis->aLevel[0][pThis->aUsed[0]++] = rVal;
+	if(pThis->aUsed[0] >= pThis->uCap) _quant_compact(pThis, 0);
+}
+
+typedef struct quant_item {
+	double rVal;
+	double rWt;
+} quant_item_t;
+
+static int _quant_itemCmp(const void* vp1, const void* vp2)
+{
+	return _quant_dblCmp(vp1, vp2);  /* value is the first member */
+}
+
+/* Merge all levels into one sorted list with cumulative weights */
+static void _quant_prep(DasQuantile* pThis)
+{
+	if(!pThis->bDirty) return;
+
+	size_t uTotal = 0;
+	int i;
+	for(i = 0; i < pThis->nLevels; ++i) uTotal += pThis->aUsed[i];
+
+	quant_item_t* pItems = (quant_item_t*)malloc((uTotal+1)*sizeof(quant_item_t));
+	size_t n = 0;
+	double rWt = 1.0;
+	for(i = 0; i < pThis->nLevels; ++i, rWt *= 2.0){
+		for(size_t u = 0; u < pThis->aUsed[i]; ++u, ++n){
+			pItems[n].rVal = pThis->aLevel[i][u];
+			pItems[n].rWt = rWt;
+		}
+	}
+	qsort(pItems, uTotal, sizeof(quant_item_t), _quant_itemCmp);
+
+	pThis->pSorted = (double*)realloc(pThis->pSorted, (uTotal+1)*sizeof(double));
+	pThis->pCumWt = (double*)realloc(pThis->pCumWt, (uTotal+1)*sizeof(double));
+	double rSum = 0.0;
+	for(n = 0; n < uTotal; ++n){
+		rSum += pItems[n].rWt;
+		pThis->pSorted[n] = pItems[n].rVal;
+		pThis->pCumWt[n] = rSum;
+	}
+	free(pItems);
+	pThis->uSorted = uTotal;
+	pThis->bDirty = false;
+}
+
+double DasQuantile_rank(DasQuantile* pThis, double rVal, bool bInclusive)
+{
+	if(pThis->uCount == 0) return NAN;
+	_quant_prep(pThis);
+
+	/* Number of retained values below (or at) the limit */
+	size_t iLo = 0, iHi = pThis->uSorted, iMid;
+	while(iLo < iHi){
+		iMid = iLo + (iHi - iLo)/2;
+		if(bInclusive ? (pThis->pSorted[iMid] <= rVal) : (pThis->pSorted[iMid] < rVal))
+			iLo = iMid + 1;
+		else
+			iHi = iMid;
+	}
+	if(iLo == 0) return 0.0;
+	return pThis->pCumWt[iLo - 1] / (double)pThis->uCount;
+}
+
+double DasQuantile_value(DasQuantile* pThis, double rFrac)
+{
+	if(pThis->uCount == 0) return NAN;
+	if(rFrac <= 0.0) return pThis->rMin;
+	if(rFrac >= 1.0) return pThis->rMax;
+	_quant_prep(pThis);
+
+	double rTarget = rFrac * (double)pThis->uCount;
+	size_t iLo = 0, iHi = pThis->uSorted - 1, iMid;
+	while(iLo < iHi){
+		iMid = iLo + (iHi - iLo)/2;
+		if(pThis->pCumWt[iMid] < rTarget) iLo = iMid + 1;
+		else iHi = iMid;
+	}
+	return pThis->pSorted[iLo];
+}
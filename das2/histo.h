@@ -0,0 +1,216 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file histo.h Value histograms and streaming quantile sketches */
+
+#ifndef _das_histo_h_
+#define _das_histo_h_
+
+#include <stdint.h>
+
+#include <das2/defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup DM
+ * @{
+ */
+
+/* Histogram binning modes */
+#define DAS_HISTO_EXACT  0   /* One bin per distinct value */
+#define DAS_HISTO_LINEAR 1   /* Fixed width bins between two edges */
+#define DAS_HISTO_LOG    2   /* Fixed width bins in log10 space */
+
+/** Counts of values for a set of independent items
+ *
+ * Each item, for example each frequency of a yscan, gets its own counts but
+ * all items share the same bins.  In exact mode each distinct value gets a
+ * bin.  Bins are found by hashing the value so adding is constant time no
+ * matter how many distinct values there are, bins are only put in order
+ * by DasHisto_finish().  In the linear and log modes bin positions are
+ * calculated directly and values outside the edges are dropped.
+ *
+ * Counts are stored row major, one row of uItems counts per bin.
+ */
+typedef struct das_histo {
+	int nMode;
+	size_t uItems;
+
+	/* Binned modes */
+	double rMin;        /* Lower edge, log10 of the edge for log mode */
+	double rScale;      /* Bins per unit (or per decade for log mode) */
+	size_t uDropped;    /* Values outside the edges */
+
+	/* Bin values, distinct values for exact mode or bin centers */
+	double* pVals;
+	size_t uBins;
+	size_t uBinsAlloc;
+
+	/* Counts, uBinsAlloc rows of uItems each */
+	double* pCounts;
+	double rMaxCount;
+
+	/* Exact mode open addressing table of bin index + 1, 0 is empty */
+	size_t* pSlots;
+	size_t uSlots;
+
+	bool bSorted;
+} DasHisto;
+
+/** Create a new histogram
+ *
+ * @param nMode One of DAS_HISTO_EXACT, DAS_HISTO_LINEAR or DAS_HISTO_LOG
+ * @param uItems The number of independent items counted, at least 1
+ * @param rMin The lower edge of the first bin, ignored for exact mode.
+ *        Must be greater than 0 for log mode.
+ * @param rMax The upper edge of the last bin, ignored for exact mode
+ * @param uBins The number of bins, ignored for exact mode
+ * @returns A new histogram or NULL on an error
+ * @memberof DasHisto
+ */
+DAS_API DasHisto* new_DasHisto(
+	int nMode, size_t uItems, double rMin, double rMax, size_t uBins
+);
+
+/** Free a histogram and all it's arrays
+ * @memberof DasHisto
+ */
+DAS_API void del_DasHisto(DasHisto* pThis);
+
+/** Count one value for one item
+ *
+ * NaNs are ignored, as are values outside the edges in the binned modes.
+ *
+ * @returns 0 on success or a positive error code if the item is out of range
+ *          or memory could not be allocated.
+ * @memberof DasHisto
+ */
+DAS_API DasErrCode DasHisto_add(DasHisto* pThis, size_t uItem, double rVal);
+
+/** Put the bins in ascending value order
+ *
+ * Only needed for exact mode, but harmless for the others.  More values may
+ * be added afterwards, though new distinct values will again be out of
+ * order until the next call.
+ *
+ * @returns The number of bins
+ * @memberof DasHisto
+ */
+DAS_API size_t DasHisto_finish(DasHisto* pThis);
+
+/** Get the value and counts for one bin
+ *
+ * @param pThis The histogram
+ * @param uBin The bin index, less than the value returned by
+ *        DasHisto_finish().
+ * @param pVal Set to the distinct value or bin center
+ * @returns A pointer to uItems counts, which may be modified by the caller,
+ *        or NULL if the bin is out of range.
+ * @memberof DasHisto
+ */
+DAS_API double* DasHisto_bin(DasHisto* pThis, size_t uBin, double* pVal);
+
+
+/** A streaming quantile sketch
+ *
+ * Holds a bounded number of values no matter how many are added, and
+ * answers rank and quantile queries with an error that shrinks as the
+ * capacity grows.  Values are kept in a stack of compactors.  When a level
+ * fills it is sorted and every other value moves to the next level with
+ * twice the weight, alternating which half is kept so that the rank errors
+ * cancel.  With the default capacity of 256, rank errors are typically
+ * well under 1%.  While fewer values than the capacity have been added the
+ * sketch is exact.
+ */
+#define DAS_QUANT_LEVELS 48
+
+typedef struct das_quantile {
+	size_t uCap;                          /* Values per level */
+	int nLevels;                          /* Levels in use */
+	double* aLevel[DAS_QUANT_LEVELS];
+	size_t aUsed[DAS_QUANT_LEVELS];
+	uint64_t uCount;                      /* Total values added */
+	bool bOdd;                            /* Next compaction keeps odd items */
+	double rMin;
+	double rMax;
+
+	/* Query cache, sorted values and cumulative weights */
+	double* pSorted;
+	double* pCumWt;
+	size_t uSorted;
+	bool bDirty;
+} DasQuantile;
+
+/** Create a new quantile sketch
+ *
+ * @param uCap Values held per level, 0 for the default of 256.  Memory use
+ *        is about uCap * log2(N/uCap) doubles for N values.
+ * @memberof DasQuantile
+ */
+DAS_API DasQuantile* new_DasQuantile(size_t uCap);
+
+/** Free a quantile sketch
+ * @memberof DasQuantile
+ */
+DAS_API void del_DasQuantile(DasQuantile* pThis);
+
+/** Add a value to the sketch, NaNs are ignored
+ * @memberof DasQuantile
+ */
+DAS_API void DasQuantile_add(DasQuantile* pThis, double rVal);
+
+/** Get the number of values added
+ * @memberof DasQuantile
+ */
+DAS_API uint64_t DasQuantile_count(const DasQuantile* pThis);
+
+/** Estimate the fraction of values below a limit
+ *
+ * @param pThis The sketch
+ * @param rVal The limit
+ * @param bInclusive If true count values at or below the limit, otherwise
+ *        only those strictly below.
+ * @returns A fraction from 0 to 1, or NaN if no values have been added
+ * @memberof DasQuantile
+ */
+DAS_API double DasQuantile_rank(DasQuantile* pThis, double rVal, bool bInclusive);
+
+/** Estimate the value at a quantile
+ *
+ * @param pThis The sketch
+ * @param rFrac The quantile from 0 to 1, 0 returns the exact minimum and
+ *        1 the exact maximum.
+ * @returns The smallest retained value with an estimated rank of at least
+ *        rFrac, or NaN if no values have been added
+ * @memberof DasQuantile
+ */
+DAS_API double DasQuantile_value(DasQuantile* pThis, double rFrac);
+
+/** Empty the sketch for re-use
+ * @memberof DasQuantile
+ */
+DAS_API void DasQuantile_clear(DasQuantile* pThis);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _das_histo_h_ */
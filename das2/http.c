@@ -34,10 +34,12 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <netdb.h>
+#include <poll.h>
 #include <time.h>
 #else
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <time.h>
 #define gai_strerror gai_strerrorA
 #endif
 
@@ -78,8 +80,10 @@ char html5[256] = {
 #define LIBDAS2_USER_AGENT "libdas2/2.3"
 
 #define HTTP_OK        200
+#define HTTP_NoContent 204
 #define HTTP_MovedPerm 301
 #define HTTP_Found     302
+#define HTTP_NotMod    304
 #define HTTP_TempRedir 307   /* Treat as 307 */
 #define HTTP_PermRedir 308   /* Treat as 301 */
 #define HTTP_BadReq    400
@@ -104,6 +108,32 @@ pthread_mutex_t g_mtxAddrArys;
 DasAry* g_pHostAry = NULL;
 DasAry* g_pAddrAry = NULL;
 
+/* Idle keep-alive connections and remembered TLS sessions, keyed by
+ * scheme://host:port.  Don't alter or use these without owning the mutex */
+#define DASHTTP_KEY_SZ (DASURL_SZ_SCHEME + DASURL_SZ_HOST + DASURL_SZ_PORT + 8)
+
+/* Idle connections older than this are assumed to have been dropped by the
+ * server and are closed instead of re-used */
+#define DASHTTP_IDLE_SEC 15
+
+typedef struct das_http_conn_t{
+	char sKey[DASHTTP_KEY_SZ];  /* Empty if the slot is free */
+	int nFd;
+	SSL* pSsl;
+	time_t nParked;
+} das_http_conn_t;
+
+typedef struct das_http_sess_t{
+	char sKey[DASHTTP_KEY_SZ];
+	SSL_SESSION* pSess;
+} das_http_sess_t;
+
+pthread_mutex_t g_mtxPool;
+int g_nPoolSz = DASHTTP_POOL_DEF;
+das_http_conn_t g_aPool[DASHTTP_POOL_MAX];
+das_http_sess_t g_aSess[DASHTTP_POOL_MAX];
+int g_iNextSess = 0;
+
 
 bool das_http_init(const char* sProgName){
 
@@ -116,6 +146,10 @@ bool das_http_init(const char* sProgName){
     /* Init SSL context and address info and mutexes */
 	if( pthread_mutex_init(&g_mtxHttp, &attr) != 0) return false;
 	if( pthread_mutex_init(&g_mtxAddrArys, &attr) != 0) return false;
+	if( pthread_mutex_init(&g_mtxPool, &attr) != 0) return false;
+
+	memset(g_aPool, 0, sizeof(g_aPool));
+	memset(g_aSess, 0, sizeof(g_aSess));
 
 	g_pSslCtx = NULL;  /* Don't alter or use this without owning the mutext */
    
@@ -149,9 +183,21 @@ bool das_http_init(const char* sProgName){
 	return true;
 }
 
-/* Clean up address arrays, closes network socket facility on windows */
+void _das_http_closeIdle(void);
+
+/* Clean up address arrays and idle connections, closes network socket
+ * facility on windows */
 void das_http_finish()
 {
+	pthread_mutex_lock(&g_mtxPool);
+	_das_http_closeIdle();
+	for(int i = 0; i < DASHTTP_POOL_MAX; ++i){
+		if(g_aSess[i].pSess) SSL_SESSION_free(g_aSess[i].pSess);
+		g_aSess[i].pSess = NULL;
+		g_aSess[i].sKey[0] = '\0';
+	}
+	pthread_mutex_unlock(&g_mtxPool);
+
 	if(g_pHostAry) dec_DasAry(g_pHostAry);
 	
 	if(g_pAddrAry){
@@ -266,6 +312,234 @@ char* das_ssl_getErr(const void* vpSsl, int nRet)
 	}
 }
 
+/* ************************************************************************* */
+/* Keep-alive connection pool.  Connections whose last message body was read
+ * to the end, and that the server agreed to leave open, are parked here so
+ * that the next request to the same scheme, host and port can skip DNS, the
+ * TCP connect and the TLS handshake.  TLS sessions are also remembered per
+ * host so that new connections can use an abbreviated handshake. */
+
+void _das_http_key(const struct das_url* pUrl, char* sKey)
+{
+	snprintf(sKey, DASHTTP_KEY_SZ, "%s://%s:%s", pUrl->sScheme, pUrl->sHost,
+	         pUrl->sPort);
+}
+
+/* Close a connection without sending a TLS close notify.  Marks the TLS
+ * shutdown as complete first, otherwise OpenSSL flags the session as not
+ * resumable when the SSL object is freed. */
+void _das_http_closeQuiet(int nFd, SSL* pSsl)
+{
+	if(pSsl != NULL){
+		nFd = SSL_get_fd(pSsl);
+		SSL_set_quiet_shutdown(pSsl, 1);
+		SSL_shutdown(pSsl);
+		SSL_free(pSsl);
+	}
+	if(nFd > -1){
+#ifndef _WIN32
+		close(nFd);
+#else
+		closesocket(nFd);
+#endif
+	}
+}
+
+/* Use under pool mutex lock */
+void _das_http_closeIdle(void)
+{
+	for(int i = 0; i < DASHTTP_POOL_MAX; ++i){
+		if(g_aPool[i].sKey[0] == '\0') continue;
+		_das_http_closeQuiet(g_aPool[i].nFd, g_aPool[i].pSsl);
+		g_aPool[i].sKey[0] = '\0';
+	}
+}
+
+int das_http_setPoolSize(int nConns)
+{
+	if(nConns < 0) nConns = 0;
+	if(nConns > DASHTTP_POOL_MAX) nConns = DASHTTP_POOL_MAX;
+
+	pthread_mutex_lock(&g_mtxPool);
+	int nPrev = g_nPoolSz;
+	g_nPoolSz = nConns;
+	if(nConns < nPrev) _das_http_closeIdle();
+	pthread_mutex_unlock(&g_mtxPool);
+	return nPrev;
+}
+
+int _das_http_poolSize(void)
+{
+	pthread_mutex_lock(&g_mtxPool);
+	int nSz = g_nPoolSz;
+	pthread_mutex_unlock(&g_mtxPool);
+	return nSz;
+}
+
+/* Remember the TLS session from a connection for later resumption */
+void _das_http_saveSess(const struct das_url* pUrl, SSL* pSsl)
+{
+	SSL_SESSION* pSess = SSL_get1_session(pSsl);
+	if(pSess == NULL) return;
+	if(!SSL_SESSION_is_resumable(pSess)){
+		SSL_SESSION_free(pSess);
+		return;
+	}
+
+	char sKey[DASHTTP_KEY_SZ];
+	_das_http_key(pUrl, sKey);
+
+	pthread_mutex_lock(&g_mtxPool);
+	int iSlot = -1;
+	for(int i = 0; i < DASHTTP_POOL_MAX; ++i){
+		if(strcmp(g_aSess[i].sKey, sKey) == 0){ iSlot = i; break; }
+	}
+	if(iSlot < 0){
+		iSlot = g_iNextSess;
+		g_iNextSess = (g_iNextSess + 1) % DASHTTP_POOL_MAX;
+		strncpy(g_aSess[iSlot].sKey, sKey, DASHTTP_KEY_SZ - 1);
+	}
+	if(g_aSess[iSlot].pSess) SSL_SESSION_free(g_aSess[iSlot].pSess);
+	g_aSess[iSlot].pSess = pSess;
+	pthread_mutex_unlock(&g_mtxPool);
+}
+
+/* Offer a remembered TLS session to a new connection */
+void _das_http_loadSess(const struct das_url* pUrl, SSL* pSsl)
+{
+	char sKey[DASHTTP_KEY_SZ];
+	_das_http_key(pUrl, sKey);
+
+	pthread_mutex_lock(&g_mtxPool);
+	for(int i = 0; i < DASHTTP_POOL_MAX; ++i){
+		if((g_aSess[i].pSess != NULL)&&(strcmp(g_aSess[i].sKey, sKey) == 0)){
+			SSL_set_session(pSsl, g_aSess[i].pSess);  /* Takes it's own ref */
+			break;
+		}
+	}
+	pthread_mutex_unlock(&g_mtxPool);
+}
+
+/* An idle connection should have nothing to read.  If it polls readable the
+ * server has closed it, or sent something unexpected, either way it's done */
+bool _das_http_idleOk(int nFd, SSL* pSsl)
+{
+	if(pSsl != NULL){
+		if(SSL_pending(pSsl) > 0) return false;
+		nFd = SSL_get_fd(pSsl);
+	}
+#ifndef _WIN32
+	struct pollfd pfd;
+	pfd.fd = nFd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return (poll(&pfd, 1, 0) == 0);
+#else
+	fd_set rfds;
+	FD_ZERO(&rfds);
+	FD_SET(nFd, &rfds);
+	struct timeval tv = {0, 0};
+	return (select(nFd + 1, &rfds, NULL, NULL, &tv) == 0);
+#endif
+}
+
+/* Close the connection in a response, sending a TLS close notify if needed */
+void _das_http_hangup(DasHttpResp* pRes)
+{
+	if(pRes->pSsl != NULL){
+		SSL* pSsl = (SSL*)pRes->pSsl;
+		_das_http_saveSess(&(pRes->url), pSsl);
+		pRes->nSockFd = SSL_get_fd(pSsl);
+		if(SSL_shutdown(pSsl) == 0)  /* If 0 needs 2-stage shutdown */
+			SSL_shutdown(pSsl);
+		SSL_free(pSsl);
+		pRes->pSsl = NULL;
+	}
+	if(pRes->nSockFd > -1){
+		daslog_debug_v("Shutting down socket %d", pRes->nSockFd);
+#ifndef _WIN32
+		shutdown(pRes->nSockFd, SHUT_RDWR);
+		close(pRes->nSockFd);
+#else
+		shutdown(pRes->nSockFd, SD_BOTH);
+		closesocket(pRes->nSockFd);
+#endif
+	}
+	pRes->nSockFd = -1;
+}
+
+/* Park the connection in a response for re-use, closing the oldest idle
+ * connection if the pool is full */
+void _das_http_poolPut(DasHttpResp* pRes)
+{
+	if(pRes->pSsl) _das_http_saveSess(&(pRes->url), (SSL*)pRes->pSsl);
+
+	char sKey[DASHTTP_KEY_SZ];
+	_das_http_key(&(pRes->url), sKey);
+
+	pthread_mutex_lock(&g_mtxPool);
+	if(g_nPoolSz < 1){
+		pthread_mutex_unlock(&g_mtxPool);
+		_das_http_hangup(pRes);
+		return;
+	}
+
+	int nUsed = 0, iFree = -1, iOld = -1;
+	for(int i = 0; i < DASHTTP_POOL_MAX; ++i){
+		if(g_aPool[i].sKey[0] == '\0'){
+			if(iFree < 0) iFree = i;
+			continue;
+		}
+		++nUsed;
+		if((iOld < 0)||(g_aPool[i].nParked < g_aPool[iOld].nParked)) iOld = i;
+	}
+	if((nUsed >= g_nPoolSz)||(iFree < 0)){
+		_das_http_closeQuiet(g_aPool[iOld].nFd, g_aPool[iOld].pSsl);
+		g_aPool[iOld].sKey[0] = '\0';
+		iFree = iOld;
+	}
+
+	strncpy(g_aPool[iFree].sKey, sKey, DASHTTP_KEY_SZ - 1);
+	g_aPool[iFree].nFd = pRes->nSockFd;
+	g_aPool[iFree].pSsl = (SSL*)pRes->pSsl;
+	g_aPool[iFree].nParked = time(NULL);
+	pthread_mutex_unlock(&g_mtxPool);
+
+	daslog_debug_v("Parked connection to %s", sKey);
+	pRes->pSsl = NULL;
+	pRes->nSockFd = -1;
+}
+
+/* Pick up a parked connection for the response URL, if there is one */
+bool _das_http_poolTake(DasHttpResp* pRes)
+{
+	char sKey[DASHTTP_KEY_SZ];
+	_das_http_key(&(pRes->url), sKey);
+	time_t nNow = time(NULL);
+	bool bFound = false;
+
+	pthread_mutex_lock(&g_mtxPool);
+	for(int i = 0; i < DASHTTP_POOL_MAX; ++i){
+		das_http_conn_t* pConn = g_aPool + i;
+		if(strcmp(pConn->sKey, sKey) != 0) continue;
+
+		pConn->sKey[0] = '\0';
+		if(((nNow - pConn->nParked) > DASHTTP_IDLE_SEC)||
+		   (!_das_http_idleOk(pConn->nFd, pConn->pSsl))){
+			_das_http_closeQuiet(pConn->nFd, pConn->pSsl);
+			continue;
+		}
+		pRes->nSockFd = pConn->nFd;
+		pRes->pSsl = pConn->pSsl;
+		bFound = true;
+		break;
+	}
+	pthread_mutex_unlock(&g_mtxPool);
+
+	if(bFound) daslog_debug_v("Re-using connection to %s", sKey);
+	return bFound;
+}
+
 /* ************************************************************************* */
 /* Parsing a URL */
 
@@ -315,7 +589,8 @@ bool DasHttpResp_init(DasHttpResp* pRes, const char* sUrl)
 	pOut = sPort;
 	int nPort;
 	if(*pIn == ':'){
-		while( (*pIn != '\0')&&(*pIn != '/')&&((pOut - sPort) < 32) ){
+		++pIn;
+		while( (*pIn != '\0')&&(*pIn != '/')&&(*pIn != '?')&&((pOut - sPort) < 31) ){
 			*pOut = *pIn; ++pOut; ++pIn;
 		}
 		nPort = 0;
@@ -375,7 +650,8 @@ bool das_url_toStr(const struct das_url* pUrl, char* sBuf, size_t uLen)
 	}
 
 	int nChunk;
-	nChunk = snprintf(sBuf, uLen, "%s://%s%s",pUrl->sScheme,pUrl->sHost,sPort);
+	nChunk = snprintf(sBuf, uLen, "%s://%s%s%s", pUrl->sScheme, pUrl->sHost,
+	                  (sPort[0] != '\0') ? ":" : "", sPort);
 	if(nChunk >= uLen) return false;
 	uLen -= nChunk;
 	sBuf += nChunk;
@@ -719,6 +995,7 @@ bool _das_http_connect(DasHttpResp* pRes, struct timeval* pTimeOut)
 		}
 
 		SSL_set_mode(pSsl, SSL_MODE_AUTO_RETRY);
+		_das_http_loadSess(pUrl, pSsl);
 
 		int nRet = SSL_connect(pSsl);
 		if(nRet != 1){
@@ -733,6 +1010,8 @@ bool _das_http_connect(DasHttpResp* pRes, struct timeval* pTimeOut)
 #endif
 			return false;
 		}
+		daslog_debug_v("TLS session %s for %s",
+			SSL_session_reused(pSsl) ? "resumed" : "negotiated", pUrl->sHost);
 
 		pRes->pSsl = pSsl;
 		pRes->nSockFd = -1;
@@ -745,7 +1024,8 @@ bool _das_http_connect(DasHttpResp* pRes, struct timeval* pTimeOut)
 
 
 bool _das_http_getRequest(
-	DasHttpResp* pRes, const char* sAgent, const char* sAuth, DasBuf* pBuf
+	DasHttpResp* pRes, const char* sAgent, const char* sAuth, bool bKeep,
+	DasBuf* pBuf
 ){
 /* Have to handle the fact that blocking SIGPIPE is different on Apple */
 #if defined(__APPLE__) || defined(_WIN32) || defined(__sun)
@@ -758,8 +1038,20 @@ bool _das_http_getRequest(
 	* sub buffers.  Should probably refactor to rememeber offsets and a parent
 	* buffer pointer instead of storing data buffer pointers directly */
 	DasBuf_reinit(pBuf);
-	DasBuf_printf(pBuf, "GET %s?%s HTTP/1.0\r\n", pUrl->sPath, pUrl->sQuery);
-	DasBuf_printf(pBuf, "Host: %s\r\n", pUrl->sHost);
+	DasBuf_printf(pBuf, "GET %s?%s HTTP/1.%d\r\n", pUrl->sPath, pUrl->sQuery,
+	              bKeep ? 1 : 0);
+
+	/* Virtual hosts route on host:port, so name the port unless it's the
+	   scheme default */
+	const char* sPort = pUrl->sPort;
+	if(strcmp(pUrl->sScheme, "https") == 0){
+		if(strcmp(sPort, "443") == 0) sPort = "";
+	}
+	else{
+		if(strcmp(sPort, "80") == 0) sPort = "";
+	}
+	DasBuf_printf(pBuf, "Host: %s%s%s\r\n", pUrl->sHost,
+	              (sPort[0] != '\0') ? ":" : "", sPort);
 
 	if((sAgent != NULL)&&(sAgent[0] != '\0'))
 		DasBuf_printf(pBuf, "User-Agent: %s\r\n", sAgent);
@@ -770,7 +1062,7 @@ bool _das_http_getRequest(
 		/* fprintf(stderr, "Authorization: Basic %s\r\n", sAuth); */
 		DasBuf_printf(pBuf, "Authorization: Basic %s\r\n", sAuth);
 	}
-	DasBuf_printf(pBuf, "Connection: close\r\n\r\n");
+	DasBuf_printf(pBuf, "Connection: %s\r\n\r\n", bKeep ? "keep-alive" : "close");
 
 	size_t uSent = 0;
 	ptrdiff_t nRet = 0;
@@ -781,7 +1073,9 @@ bool _das_http_getRequest(
 		/* Plain ole socket, may take multiple calls to get the data out */
 		while(uSent < uToSend){
 			errno = 0;
-			nRet = send(pRes->nSockFd, pBuf->pReadBeg+uSent, uToSend, MSG_NOSIGNAL);
+			nRet = send(
+				pRes->nSockFd, pBuf->pReadBeg+uSent, uToSend - uSent, MSG_NOSIGNAL
+			);
 			nErr = errno;
 			if(nRet < 0){
 				pRes->sError = das_string("Error sending to host %s, %s",
@@ -799,7 +1093,10 @@ bool _das_http_getRequest(
 
 		nRet = SSL_write((SSL*)pRes->pSsl, pBuf->pReadBeg, uToSend);
 		if(nRet <= 0){
-			nErr = SSL_get_error((SSL*)pRes->pSsl, nRet);
+			char* sErr = das_ssl_getErr(pRes->pSsl, nRet);
+			pRes->sError = das_string("Error sending to host %s, %s",
+			                           pRes->url.sHost, sErr);
+			free(sErr);
 			return false;
 		}
 	}
@@ -831,8 +1128,8 @@ bool _das_http_hdrSearch(DasBuf* pBuf, const char* sField, char* sBuf, size_t uL
 		if(iSep != uFieldLen) continue; /* Can't be it if length mismatch */
 
 		bCont = false;
-		for(u = 0; u < uFieldLen; ++u){
-			if(pLine[u] != sField[u]){	bCont = true; break;	}
+		for(u = 0; u < uFieldLen; ++u){  /* Field names are case insensitive */
+			if(tolower(pLine[u]) != tolower(sField[u])){	bCont = true; break;	}
 		}
 		if(bCont) continue;
 
@@ -920,13 +1217,12 @@ bool _das_http_readHdrs(DasHttpResp* pRes, DasBuf* pBuf)
 			/* nRead + nLen will not go past the end of sBuf */
 
 			if(nRead == -1){
-				errno = 0;
 				pRes->sError = das_string("Error reading from host %s, %s",
 				                           pRes->url.sHost, strerror(errno));
 				return false;
 			}
 			if(nRead == 0){
-				pRes->sError = das_string("Host % closed connection before sending "
+				pRes->sError = das_string("Host %s closed connection before sending "
 						  "any headers", pRes->url.sHost);
 				return false;
 			}
@@ -991,7 +1287,210 @@ void _das_http_drain_socket(DasHttpResp* pRes){
 }
 
 /* ************************************************************************* */
-bool _das_http_redirect(DasHttpResp* pRes, DasBuf* pBuf)
+/* Message body framing.  HTTP/1.0 bodies end when the server closes the
+ * connection, but on a connection that stays open the end has to come from
+ * the Content-Length header or from chunked transfer encoding. */
+
+#define D2CHAR_CHUNK_SZ 16384
+
+typedef struct das_http_body_t{
+	DasHttpResp* pRes;
+	bool bChunked;   /* Transfer-Encoding: chunked */
+	bool bReuse;     /* Server will keep the connection open after the body */
+	bool bDone;      /* The whole body has been read */
+	int64_t nLeft;   /* Bytes left in the body or current chunk, -1 = to EOF */
+	size_t uBeg;     /* Unread data in aBuf */
+	size_t uEnd;
+	char aBuf[D2CHAR_CHUNK_SZ];
+} das_http_body_t;
+
+void _das_http_frame(
+	DasHttpResp* pRes, DasBuf* pBuf, bool bKeep, das_http_body_t* pBody
+){
+	char sVal[64] = {'\0'};
+
+	pBody->pRes = pRes;
+	pBody->bChunked = false;
+	pBody->bDone = false;
+	pBody->nLeft = -1;
+	pBody->uBeg = 0;
+	pBody->uEnd = 0;
+
+	/* These never have a body, whatever the headers say.  Only GET requests
+	 * are sent, so there are no HEAD responses to worry about */
+	if(((pRes->nCode >= 100)&&(pRes->nCode < 200))||
+	   (pRes->nCode == HTTP_NoContent)||(pRes->nCode == HTTP_NotMod)){
+		pBody->nLeft = 0;
+		pBody->bDone = true;
+	}
+	else if(_das_http_hdrSearch(pBuf, "Transfer-Encoding", sVal, 63)){
+		for(char* p = sVal; *p != '\0'; ++p) *p = tolower(*p);
+		if(strstr(sVal, "chunked") != NULL){
+			pBody->bChunked = true;
+			pBody->nLeft = 0;
+		}
+	}
+	if(!pBody->bDone && !pBody->bChunked &&
+	   _das_http_hdrSearch(pBuf, "Content-Length", sVal, 63)){
+		pBody->nLeft = strtoll(sVal, NULL, 10);
+		if(pBody->nLeft < 0) pBody->nLeft = -1;
+		if(pBody->nLeft == 0) pBody->bDone = true;
+	}
+
+	/* Only HTTP/1.1 connections persist by default, and only if we can tell
+	 * where the body ends.  Bodies that run to EOF can't be followed by
+	 * another response, so those connections are never parked */
+	char sVer[9] = {'\0'};
+	DasBuf_setReadOffset(pBuf, 0);
+	DasBuf_peek(pBuf, sVer, 8);
+	pBody->bReuse = bKeep && (pBody->nLeft > -1) && (strcmp(sVer, "HTTP/1.1") == 0);
+
+	if(pBody->bReuse && _das_http_hdrSearch(pBuf, "Connection", sVal, 63)){
+		for(char* p = sVal; *p != '\0'; ++p) *p = tolower(*p);
+		if(strstr(sVal, "close") != NULL) pBody->bReuse = false;
+	}
+}
+
+/* Returns bytes read, 0 if the connection was closed or -1 on an error */
+ssize_t _das_http_recv(DasHttpResp* pRes, char* pBuf, size_t uLen)
+{
+	ssize_t nRead = 0;
+	if(pRes->pSsl){
+		nRead = SSL_read((SSL*)pRes->pSsl, pBuf, (int)uLen);
+		if(nRead >= 0) return nRead;
+
+		char* sErr = das_ssl_getErr(pRes->pSsl, nRead);
+		pRes->sError = das_string("Error reading from host %s, %s",
+		                           pRes->url.sHost, sErr);
+		free(sErr);
+		return -1;
+	}
+
+	errno = 0;
+	nRead = recv(pRes->nSockFd, pBuf, uLen, 0);
+	if(nRead < 0){
+		pRes->sError = das_string("Error reading from host %s, %s",
+		                           pRes->url.sHost, strerror(errno));
+		return -1;
+	}
+	return nRead;
+}
+
+/* Read a CRLF terminated line, such as a chunk size, from the body */
+bool _das_http_bodyLine(das_http_body_t* pBody, char* sLine, size_t uLen)
+{
+	ssize_t nRead;
+	size_t u = 0;
+	char c;
+	while(true){
+		if(pBody->uBeg == pBody->uEnd){
+			nRead = _das_http_recv(pBody->pRes, pBody->aBuf, D2CHAR_CHUNK_SZ);
+			if(nRead < 0) return false;
+			if(nRead == 0){
+				pBody->pRes->sError = das_string("Host %s closed connection inside "
+					"a chunked message body", pBody->pRes->url.sHost);
+				return false;
+			}
+			pBody->uBeg = 0;
+			pBody->uEnd = nRead;
+		}
+		c = pBody->aBuf[pBody->uBeg];
+		++(pBody->uBeg);
+		if(c == '\n') break;
+		if((c != '\r')&&(u < (uLen - 1))){ sLine[u] = c; ++u; }
+	}
+	sLine[u] = '\0';
+	return true;
+}
+
+/* Read up to uLen bytes of the message body, returns 0 at the end of the
+ * body or -1 on an error, in which case pRes->sError is set */
+ssize_t _das_http_bodyRead(das_http_body_t* pBody, char* pOut, size_t uLen)
+{
+	if(pBody->bDone) return 0;
+
+	char sLine[80];
+	if(pBody->bChunked && (pBody->nLeft == 0)){
+
+		/* Chunk header, hex size possibly followed by ;extensions */
+		if(!_das_http_bodyLine(pBody, sLine, 80)) return -1;
+		char* pEnd = NULL;
+		long long nSz = strtoll(sLine, &pEnd, 16);
+		if((pEnd == sLine)||(nSz < 0)){
+			pBody->pRes->sError = das_string("Malformed chunk size '%s' from "
+				"host %s", sLine, pBody->pRes->url.sHost);
+			return -1;
+		}
+		if(nSz == 0){
+			/* Last chunk, skip any trailer fields up to the blank line */
+			do{
+				if(!_das_http_bodyLine(pBody, sLine, 80)) return -1;
+			} while(sLine[0] != '\0');
+			pBody->bDone = true;
+			return 0;
+		}
+		pBody->nLeft = nSz;
+	}
+
+	if(pBody->uBeg == pBody->uEnd){
+		ssize_t nRead = _das_http_recv(pBody->pRes, pBody->aBuf, D2CHAR_CHUNK_SZ);
+		if(nRead < 0) return -1;
+		if(nRead == 0){
+			if(pBody->nLeft < 0){ pBody->bDone = true; return 0; }  /* Read to EOF */
+
+			pBody->pRes->sError = das_string("Host %s closed connection before "
+				"the end of the message body", pBody->pRes->url.sHost);
+			return -1;
+		}
+		pBody->uBeg = 0;
+		pBody->uEnd = nRead;
+	}
+
+	size_t uCopy = pBody->uEnd - pBody->uBeg;
+	if(uCopy > uLen) uCopy = uLen;
+	if((pBody->nLeft > -1)&&((int64_t)uCopy > pBody->nLeft)) uCopy = pBody->nLeft;
+
+	memcpy(pOut, pBody->aBuf + pBody->uBeg, uCopy);
+	pBody->uBeg += uCopy;
+
+	if(pBody->nLeft > -1){
+		pBody->nLeft -= uCopy;
+		if(pBody->nLeft == 0){
+			if(pBody->bChunked){   /* Eat the CRLF after the chunk data */
+				if(!_das_http_bodyLine(pBody, sLine, 80)) return -1;
+			}
+			else
+				pBody->bDone = true;
+		}
+	}
+	return uCopy;
+}
+
+/* Done with the current response on this connection.  Keep-alive connections
+ * have the rest of the body skipped and are parked, others are drained and
+ * closed */
+void _das_http_release(DasHttpResp* pRes, das_http_body_t* pBody)
+{
+	if(pBody->bReuse){
+		char sBuf[1024];
+		ssize_t nRead;
+		while((nRead = _das_http_bodyRead(pBody, sBuf, 1024)) > 0);
+
+		if(nRead == 0){
+			_das_http_poolPut(pRes);
+			return;
+		}
+		free(pRes->sError);  /* Not fatal, just can't re-use the connection */
+		pRes->sError = NULL;
+	}
+	else{
+		_das_http_drain_socket(pRes); // Read and toss any remaining data...
+	}
+	_das_http_hangup(pRes);
+}
+
+/* ************************************************************************* */
+bool _das_http_redirect(DasHttpResp* pRes, DasBuf* pBuf, das_http_body_t* pBody)
 {
 	char sNewUrl[1024];
 	if(!_das_http_hdrSearch(pBuf, "Location", sNewUrl, 1023)){
@@ -1007,28 +1506,10 @@ bool _das_http_redirect(DasHttpResp* pRes, DasBuf* pBuf)
 	//		sNewUrl[uEnd] = '\0';
 	//}
 	daslog_debug_v("Redirected to: %s", sNewUrl);
-	_das_http_drain_socket(pRes); // Read and toss any remaining data...
 
-	// Tear down the existing SSL socket if needed
-	if(pRes->pSsl){
-		daslog_debug("Old SSL socket teardown");
-		pRes->nSockFd = SSL_get_fd((SSL*)pRes->pSsl);
-		if(SSL_shutdown((SSL*)pRes->pSsl) == 0){
-			SSL_shutdown((SSL*)pRes->pSsl);
-		}
-		SSL_free((SSL*)pRes->pSsl);
-		pRes->pSsl = NULL;
-	}
-
-	daslog_debug_v("Shutting down socket: %d", pRes->nSockFd);
-#ifndef _WIN32
-	shutdown(pRes->nSockFd, SHUT_RDWR);
-	close(pRes->nSockFd);
-#else
-	shutdown(pRes->nSockFd, SD_BOTH);
-	closesocket(pRes->nSockFd);
-#endif	
-	pRes->nSockFd = -1;
+	// Park or tear down the existing socket, the new location may be
+	// on a different host.
+	_das_http_release(pRes, pBody);
 
 	/* Parse a new URL into the url structure */
 	if(!DasHttpResp_init(pRes, sNewUrl)) return false;
@@ -1043,10 +1524,14 @@ void DasHttpResp_freeFields(DasHttpResp* pRes){
 /* ************************************************************************* */
 /* Get a message body socket, involves quite a few steps */
 
-bool das_http_getBody(
+/* If pBody is NULL the final request is sent as HTTP/1.0 so that the body
+ * ends when the socket closes, as callers of das_http_getBody() expect.
+ * Otherwise HTTP/1.1 keep-alive is used when the pool is enabled and pBody
+ * is set up to find the end of the body. */
+bool _das_http_getBody(
 	const char* sUrl, const char* sAgent, DasCredMngr* pMgr, DasHttpResp* pRes,
-	float rConSec
- ){
+	float rConSec, das_http_body_t* pBody
+){
 
 	DasHttpResp_clear(pRes);  /* Sets nSockFd to -1 */
 
@@ -1063,29 +1548,49 @@ bool das_http_getBody(
 
 	if(! DasHttpResp_init(pRes, sUrl)) return false;
 
+	das_http_body_t* pMyBody = NULL;
+	if(pBody == NULL){
+		pMyBody = (das_http_body_t*)calloc(1, sizeof(das_http_body_t));
+		pBody = pMyBody;
+	}
+	bool bKeep = (pMyBody == NULL) && (_das_http_poolSize() > 0);
+
 	DasBuf* pBuf = new_DasBuf(2048);
 	const char* sAuth = NULL;
 	char sServer[512] = {'\0'};
 	char sRealmHdr[512] = {'\0'};
 	const char* pRealm = NULL;  /* Used to dig realm out of header */
 	char* pWrite = NULL; /* Used to null out ending realm quote */
+	bool bReused = false;
 	while(true){
 
-		/* Try to connect */
-		if(! _das_http_connect(pRes, &tv) ){ 
-			goto CLEANUP_ERROR;
-		}
+		/* Try to re-use a parked connection, then try to connect.  A parked
+		 * connection may have been dropped by the server without us noticing
+		 * yet, so if it fails give a fresh one a go. */
+		bReused = _das_http_poolTake(pRes);
+		while(true){
+			if((! bReused) && (! _das_http_connect(pRes, &tv)) ){
+				goto CLEANUP_ERROR;
+			}
 
-		/* Send the request */
-		if(! _das_http_getRequest(pRes, sAgent, sAuth, pBuf) ){
-			goto CLEANUP_ERROR;
-		}
+			/* Send the request, and get the response and save the headers */
+			if(_das_http_getRequest(pRes, sAgent, sAuth, bKeep, pBuf)){
+				DasBuf_reinit(pBuf);  /* buffer will be used to write headers */
+				if(_das_http_readHdrs(pRes, pBuf)) break;
+			}
 
-		/* Get the response and save the headers */
-		DasBuf_reinit(pBuf);  /* buffer will be used to write headers */
-		if(! _das_http_readHdrs(pRes, pBuf)){
-			goto CLEANUP_ERROR;
+			if(! bReused) goto CLEANUP_ERROR;
+
+			daslog_debug_v("Parked connection to %s was dropped, reconnecting",
+			               pRes->url.sHost);
+			free(pRes->sError);
+			pRes->sError = NULL;
+			_das_http_closeQuiet(pRes->nSockFd, (SSL*)pRes->pSsl);
+			pRes->nSockFd = -1;
+			pRes->pSsl = NULL;
+			bReused = false;
 		}
+		_das_http_frame(pRes, pBuf, bKeep, pBody);
 
 		if((strcmp(pRes->url.sPort, "80") != 0)&&
 		   (strcmp(pRes->url.sPort, "443") != 0))
@@ -1102,6 +1607,7 @@ bool das_http_getBody(
 			_das_http_setFileName(pBuf, pRes);
 			_das_http_setMime(pBuf, pRes);
 			del_DasBuf(pBuf);
+			if(pMyBody) free(pMyBody);
 			return true;
 			break;
 		case HTTP_MovedPerm:
@@ -1109,27 +1615,11 @@ bool das_http_getBody(
 		case HTTP_TempRedir:
 		case HTTP_PermRedir:
 			// uses the existing socket to pull down the redirect, then
-			// tears it down so the SSL context can be re-used.
-			if(! _das_http_redirect(pRes, pBuf)) goto CLEANUP_ERROR;
+			// parks or tears it down so the SSL context can be re-used.
+			if(! _das_http_redirect(pRes, pBuf, pBody)) goto CLEANUP_ERROR;
 			break;
 		case HTTP_AuthReq:
-			_das_http_drain_socket(pRes); // Read and toss any remaining data...
-			if(pRes->pSsl){
-				pRes->nSockFd = SSL_get_fd((SSL*)pRes->pSsl);
-				if(SSL_shutdown((SSL*)pRes->pSsl) == 0){
-					SSL_shutdown((SSL*)pRes->pSsl);
-					SSL_free((SSL*)pRes->pSsl);
-					pRes->pSsl = NULL;
-				}
-			}
-#ifndef _WIN32		
-			shutdown(pRes->nSockFd, SHUT_RDWR);
-			close(pRes->nSockFd);
-#else
-			shutdown(pRes->nSockFd, SD_BOTH);
-			closesocket(pRes->nSockFd);
-#endif	
-			pRes->nSockFd = -1;
+			_das_http_release(pRes, pBody);
 
 			/* Dig out the realm */
 			_das_http_hdrSearch(pBuf, "WWW-Authenticate", sRealmHdr, 512);
@@ -1166,24 +1656,30 @@ bool das_http_getBody(
 			}
 			break;
 		case HTTP_Forbidden:
+			if(pBody->bReuse) _das_http_release(pRes, pBody);
 			pRes->sError = das_string("Access to dataset '%s' on server '%s' was "
 			                           "forbidden", pRes->url.sDataset, sServer);
 			goto CLEANUP_ERROR;
 			break;
 
 		case HTTP_NotFound:
+			if(pBody->bReuse) _das_http_release(pRes, pBody);
 			pRes->sError = das_string("Error in request path '%s' for host '%s'",
 					pRes->url.sPath, pRes->url.sHost);
 			goto CLEANUP_ERROR;
 			break;
 
 		case HTTP_BadReq:
+			if(pBody->bReuse) _das_http_release(pRes, pBody);
 			pRes->sError = das_string("Error in query parameters '%s'",
 			                           pRes->url.sQuery);
 			goto CLEANUP_ERROR;
 			break;
 
 		default:
+			/* Keep the connection if the response was framed, draining one that
+			   isn't would wait on the server to hang up */
+			if(pBody->bReuse) _das_http_release(pRes, pBody);
 			pRes->sError = das_string("Server returned HTTP status %d when "
 					         "accessing %s", pRes->nCode, sUrl);
 			goto CLEANUP_ERROR;
@@ -1192,41 +1688,35 @@ bool das_http_getBody(
 	}
 
 	del_DasBuf(pBuf);
+	if(pMyBody) free(pMyBody);
 	return true;
 
 CLEANUP_ERROR:
 	del_DasBuf(pBuf);
-	if(pRes->pSsl != NULL){
-		pRes->nSockFd = SSL_get_fd((SSL*)pRes->pSsl);
-		if(SSL_shutdown((SSL*)pRes->pSsl) == 0){
-			SSL_shutdown((SSL*)pRes->pSsl);
-			SSL_free((SSL*)pRes->pSsl);
-		}
-	}
-	if(pRes->nSockFd > -1){
-#ifndef _WIN32		
-		shutdown(pRes->nSockFd, SHUT_RDWR);
-		close(pRes->nSockFd);
-#else
-		shutdown(pRes->nSockFd, SD_BOTH);
-		closesocket(pRes->nSockFd);
-#endif			
-		pRes->nSockFd = -1;
-	}
+	if(pMyBody) free(pMyBody);
+	_das_http_hangup(pRes);
 	return false;
 }
 
+bool das_http_getBody(
+	const char* sUrl, const char* sAgent, DasCredMngr* pMgr, DasHttpResp* pRes,
+	float rConSec
+){
+	return _das_http_getBody(sUrl, sAgent, pMgr, pRes, rConSec, NULL);
+}
+
 
 /* ************************************************************************* */
 /* A just-give-me-a-bag-of-bytes convenience function */
 
-#define D2CHAR_CHUNK_SZ 16384
-
 DasAry* das_http_readUrl(
 	const char* sUrl, const char* sAgent, DasCredMngr* pMgr, DasHttpResp* pRes,
 	int64_t nLimit, float rConSec
 ){
-	if( ! das_http_getBody(sUrl, sAgent, pMgr, pRes, rConSec)){
+	das_http_body_t* pBody = (das_http_body_t*)calloc(1, sizeof(das_http_body_t));
+
+	if( ! _das_http_getBody(sUrl, sAgent, pMgr, pRes, rConSec, pBody)){
+		free(pBody);
 		return NULL;
 	}
 	if(nLimit < 1) nLimit = -1;
@@ -1234,68 +1724,46 @@ DasAry* das_http_readUrl(
 
 	DasAry* pAry = new_DasAry("http_body", vtUByte, 1, NULL, RANK_1(0), UNIT_DIMENSIONLESS);
 
-	SSL* pSsl = (SSL*)pRes->pSsl;
 	char buf[D2CHAR_CHUNK_SZ];
-	int nRead = 0;
-
-	if(DasHttpResp_useSsl(pRes)){
-		while((nLimit == -1)||(nTotal < nLimit)){
-			nRead = SSL_read(pSsl, buf, D2CHAR_CHUNK_SZ);
+	ssize_t nRead = 0;
 
-			if(nRead == 0) break;  /* Socket is done */
+	while((nLimit == -1)||(nTotal < nLimit)){
+		nRead = _das_http_bodyRead(pBody, buf, D2CHAR_CHUNK_SZ);
 
-			if(nRead < 1){         /* Socket is broke */
-				char* sErr = das_ssl_getErr(pSsl, nRead);
-				daslog_error_v("Error reading from SSL socket, %s", sErr);
-				free(sErr);
-				dec_DasAry(pAry);
-				return false;
-			}
+		if(nRead == 0) break;  /* Body is done */
 
-			nTotal += nRead;
-			if(!DasAry_append(pAry, (const ubyte*) buf, nRead)) return false; /* Yay data! */
+		if(nRead < 0){         /* Socket is broke */
+			daslog_error(pRes->sError);
+			break;
 		}
 
-		pRes->nSockFd = SSL_get_fd((SSL*)pRes->pSsl);
-		if(SSL_shutdown((SSL*)pRes->pSsl) == 0)  // If 0 needs 2-stage shutdown
-			SSL_shutdown((SSL*)pRes->pSsl);
-		
-		SSL_free((SSL*)pRes->pSsl);
-		pRes->pSsl = NULL;
+		nTotal += nRead;
+		if(!DasAry_append(pAry, (const ubyte*) buf, nRead)){ /* Yay data! */
+			nRead = -1;
+			break;
+		}
 	}
-	else{
-		while((nLimit == -1)||(nTotal < nLimit)){
-			errno = 0;
-			nRead = recv(pRes->nSockFd, buf, D2CHAR_CHUNK_SZ, 0);
 
-			if(nRead == 0) break;  /* Socket is done */
-
-			if(nRead < 0){         /* Socket is broke */
-				daslog_error_v("Error reading from socket, %s", strerror(errno));
-				dec_DasAry(pAry);
-				return false;
-			}
-
-			nTotal += nRead;
-			if(!DasAry_append(pAry, (const ubyte*) buf, nRead)) return false; /* Yay data! */
-		}
+	if(nRead < 0){
+		_das_http_hangup(pRes);
+		free(pBody);
+		dec_DasAry(pAry);
+		return NULL;
 	}
-	if(nTotal > nLimit){
+
+	if(!pBody->bDone){
 		daslog_warn_v("Limit of %ld bytes hit, almost certainly returning a "
 				      "partial download", nLimit);
 	}
 	else
 		daslog_debug_v("%ld bytes read from %s", DasAry_size(pAry), sUrl);
 
-	daslog_debug_v("Shutting down socket %d", pRes->nSockFd);
-#ifndef _WIN32
-	shutdown(pRes->nSockFd, SHUT_RDWR);
-	close(pRes->nSockFd);
-#else
-	shutdown(pRes->nSockFd, SD_BOTH);
-	closesocket(pRes->nSockFd);
-#endif	
-	pRes->nSockFd = -1;
+	/* Keep the connection for the next request if the server will */
+	if(pBody->bDone && pBody->bReuse)
+		_das_http_poolPut(pRes);
+	else
+		_das_http_hangup(pRes);
 
+	free(pBody);
 	return pAry;
 }
@@ -59,6 +59,35 @@ DAS_API char* das_ssl_getErr(const void* vpSsl, int nRet);
 #define DASHTTP_TO_MULTI   3.0
 #define DASHTTP_TO_MAX    18.0
 
+/* Default and maximum number of idle keep-alive connections, see
+ * das_http_setPoolSize() */
+#define DASHTTP_POOL_DEF   4
+#define DASHTTP_POOL_MAX  16
+
+/** Set the number of idle connections kept open for re-use
+ *
+ * das_http_readUrl() sends HTTP/1.1 requests and reads the message body up
+ * to the end given by the Content-Length header or chunked transfer encoding.
+ * If the server agrees to keep the connection open it is then parked in a
+ * pool.  Later requests to the same scheme, host and port, including
+ * das_http_getBody(), pick up a parked connection instead of connecting
+ * again, so walking a catalog tree costs one TCP connection and one TLS
+ * handshake per host instead of one per node.  TLS sessions are remembered
+ * per host too, so new connections to a known host can resume the session.
+ *
+ * The pool is shared by all threads.  Idle connections are dropped after
+ * a few seconds, and if a parked connection turns out to have been closed
+ * by the server the request is retried on a new one.
+ *
+ * @param nConns The number of idle connections to keep, from 0 to
+ *        DASHTTP_POOL_MAX.  The default is DASHTTP_POOL_DEF.  If 0, requests
+ *        are sent as HTTP/1.0 with "Connection: close".  Lowering the size
+ *        closes all currently idle connections.
+ *
+ * @returns The previous pool size
+ */
+DAS_API int das_http_setPoolSize(int nConns);
+
 
 /** A parsed URL structure */
 struct das_url {
@@ -175,7 +204,10 @@ DAS_API bool DasHttpResp_useSsl(DasHttpResp* pRes);
  * 
  * It is the caller's responsibility to call shutdown for the provided
  * socket descriptor or the SSL connection when it is finished reading the
- * message body.
+ * message body.  The final request is sent as HTTP/1.0 with
+ * "Connection: close", so the message body ends when the socket closes,
+ * though the connection it's sent on may be an idle one from the pool
+ * described in das_http_setPoolSize().
  * 
  * <b>Das2 Note:</b>  Since das2 servers can request different authentication for
  * each dataset, the get string is inpected for the 'server=dataset' pair.  If
@@ -216,6 +248,10 @@ DAS_API bool das_http_getBody(
  * Since network operations are presumed to fail often, all errors are 
  * logged using the functions in log.h, das_error is not called unless a memory
  * allocation error occurs.
+ *
+ * Unless the connection pool has been disabled, HTTP/1.1 keep-alive is used
+ * and the connection is left open for the next request to the same host if
+ * the whole message body was read, see das_http_setPoolSize().
  * 
  * @param sUrl - The URL to read, may be http or https contain alternate port
  *               numbers etc.
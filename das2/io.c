@@ -29,9 +29,15 @@
 #include <stdarg.h>
 #include <assert.h>
 
+#include <sys/stat.h>
+#include <pthread.h>
+
 #ifndef _WIN32
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #else
 #include <winsock2.h>
 #define popen _popen
@@ -57,6 +63,10 @@ typedef ptrdiff_t ssize_t;
 /* output buffer length */
 #define CMPR_OUT_BUF_SZ 262144
 
+/* read-ahead buffer length, must not exceed CMPR_IN_BUF_SZ since left over
+   bytes are handed to inflate when a stream switches to compressed mode */
+#define READ_AHEAD_SZ CMPR_IN_BUF_SZ
+
 /* used internally for implementing stream inflate/deflate, etc/ */
 #define STREAM_MODE_STRING 0
 
@@ -72,6 +82,14 @@ typedef ptrdiff_t ssize_t;
 /* stream is coming from a sub command */
 #define STREAM_MODE_CMD    4
 
+/* stream is coming from a memory mapped file */
+#define STREAM_MODE_MMAP   5
+
+/* Modes that read straight out of memory, sBuffer and nLength track the
+   unread portion */
+#define _DasIO_inMemory(P) \
+	(((P)->mode == STREAM_MODE_STRING)||((P)->mode == STREAM_MODE_MMAP))
+
 /* ************************************************************************** */
 /* Constructors/Destructors */
 
@@ -104,6 +122,15 @@ static DasErrCode _DasIO_setMode(DasIO* pThis, const char* mode)
 	return DAS_OKAY;
 }
 
+/* Only regular files can be read ahead with fread, pipes and terminals would
+ * block until the whole read-ahead buffer fills */
+static bool _DasIO_isRegFile(FILE* file)
+{
+	struct stat info;
+	if(fstat(fileno(file), &info) != 0) return false;
+	return S_ISREG(info.st_mode);
+}
+
 DasIO* new_DasIO_cfile(const char* sProg,  FILE * file, const char* mode ) 
 {
 	if(file == NULL){
@@ -126,6 +153,8 @@ DasIO* new_DasIO_cfile(const char* sProg,  FILE * file, const char* mode )
 		free(pThis);
 		return NULL;
 	}
+	if(pThis->rw == 'r')
+		pThis->bRegFile = _DasIO_isRegFile(file);
 	 	 
 	/* Init an I/O buffer that we can re-use during the life of the object,
 	 * This buffer is 1 byte more than the maximum Das Packet size, we may
@@ -186,6 +215,8 @@ DasIO* new_DasIO_file(const char* sProg, const char* sFile, const char* mode)
 		das_error(DASERR_IO, "Error opening %s", sFile);
 		return NULL;
 	}
+	if(pThis->rw == 'r')
+		pThis->bRegFile = _DasIO_isRegFile(pThis->file);
 	
 	/* Init an I/O buffer that we can re-use during the life of the object,
 	  * This buffer is 1 byte more than the maximum Das Packet size, we may
@@ -195,6 +226,65 @@ DasIO* new_DasIO_file(const char* sProg, const char* sFile, const char* mode)
 	return pThis;
 }
 
+DasIO* new_DasIO_mmap(const char* sProg, const char* sFile, const char* mode)
+{
+#ifdef _WIN32
+	return new_DasIO_file(sProg, sFile, mode);
+#else
+	DasIO* pThis = (DasIO*)calloc(1, sizeof( DasIO ) );
+	pThis->mode = STREAM_MODE_MMAP;
+	pThis->model = STREAM_MODEL_V2;
+	pThis->taskSize= -1;  /* for progress indication */
+	pThis->logLevel=LOGLVL_WARNING;
+	pThis->nSockFd = -1;
+	strncpy(pThis->sName, sProg, DASIO_NAME_SZ - 1);
+	OobComment_init(&(pThis->cmt));
+	das_store_str(&(pThis->cmt.sSrc), &(pThis->cmt.uSrcLen), pThis->sName);
+	
+	if(_DasIO_setMode(pThis, mode) != DAS_OKAY){
+		free(pThis);
+		return NULL;
+	}
+	if(pThis->rw != 'r'){
+		free(pThis);
+		das_error(DASERR_IO, "Memory mapped streams are read-only");
+		return NULL;
+	}
+
+	int nFd = open(sFile, O_RDONLY);
+	struct stat info;
+	if((nFd < 0)||(fstat(nFd, &info) != 0)){
+		if(nFd >= 0) close(nFd);
+		free(pThis);
+		das_error(DASERR_IO, "Error opening %s, %s", sFile, strerror(errno));
+		return NULL;
+	}
+	
+	/* Zero length files can't be mapped, leave them as an empty buffer */
+	if(info.st_size > 0){
+		void* pMap = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, nFd, 0);
+		if(pMap == MAP_FAILED){
+			close(nFd);
+			free(pThis);
+			das_error(DASERR_IO, "Error mapping %s, %s", sFile, strerror(errno));
+			return NULL;
+		}
+		posix_madvise(pMap, info.st_size, POSIX_MADV_SEQUENTIAL);
+		pThis->pMap = (char*)pMap;
+		pThis->uMapLen = info.st_size;
+	}
+	close(nFd);  /* The mapping stays valid */
+	
+	pThis->sBuffer = pThis->pMap;
+	pThis->nLength = pThis->uMapLen;
+	
+	/* Still needed for headers and for inflated packets */
+	pThis->pDb = new_DasBuf(CMPR_OUT_BUF_SZ);
+	
+	return pThis;
+#endif
+}
+
 DasIO* new_DasIO_socket(const char* sProg, int nSockFd, const char* mode)
 {
 	DasIO* pThis = (DasIO*)calloc(1, sizeof( DasIO ) );
@@ -272,6 +362,15 @@ void DasIO_embedAsBytes(DasIO* pThis, bool bEnable){
 	pThis->bEmbedAsBytes = bEnable;
 }
 
+DasErrCode DasIO_pipeline(DasIO* pThis, int nSlots){
+	if(pThis->rw != 'r')
+		return das_error(DASERR_IO, "Pipelined reads are only available for input streams");
+	if(nSlots < 0)
+		return das_error(DASERR_IO, "Invalid pipeline depth: %d", nSlots);
+	pThis->nPipeSlots = nSlots;
+	return DAS_OKAY;
+}
+
 DasErrCode DasIO_model(DasIO* pThis, int nModel){
 	if(nModel == 2)
 		pThis->model = STREAM_MODEL_V2;
@@ -375,6 +474,13 @@ DasErrCode _DasIO_enterDecompressMode(DasIO* sid ) {
     sid->inbuf = (Byte *)malloc(sizeof(Byte) * CMPR_IN_BUF_SZ);
     sid->zstrm->next_in = sid->inbuf;
     sid->zstrm->avail_in = 0;
+
+    /* Anything read ahead past the stream header is compressed data */
+    if(sid->uRdEnd > sid->uRdBeg){
+        sid->zstrm->avail_in = sid->uRdEnd - sid->uRdBeg;
+        memcpy(sid->inbuf, sid->pRdBuf + sid->uRdBeg, sid->zstrm->avail_in);
+        sid->uRdBeg = sid->uRdEnd = 0;
+    }
     return DAS_OKAY;
 }
 
@@ -390,14 +496,24 @@ int _DasIO_inflate_read(DasIO* pThis, char* data, size_t uLen)
 	zstrm->next_out = (unsigned char*)data;
 	zstrm->avail_out = uLen;
 
-	/* This looks like a bug, shouldn't we loop until we get uLen? */
 	while(zstrm->avail_out != 0) {
 		if(zstrm->avail_in == 0 && !pThis->eof) {
-			if((pThis->mode == STREAM_MODE_FILE)||(pThis->mode == STREAM_MODE_CMD)){
-				zstrm->avail_in = fread(pThis->inbuf, 1, CMPR_IN_BUF_SZ, pThis->file);
+			/* Hand back what we have instead of blocking for more input */
+			if(zstrm->avail_out < uLen) break;
+
+			if(_DasIO_inMemory(pThis)){
+				/* Inflate straight from the source, no staging copy needed */
+				zstrm->avail_in = pThis->nLength < CMPR_IN_BUF_SZ ? 
+				                  pThis->nLength : CMPR_IN_BUF_SZ;
+				zstrm->next_in = (Bytef*)pThis->sBuffer;
+				pThis->sBuffer += zstrm->avail_in;
+				pThis->nLength -= zstrm->avail_in;
 			}
 			else{
-				if(pThis->mode == STREAM_MODE_SOCKET){
+				if((pThis->mode == STREAM_MODE_FILE)||(pThis->mode == STREAM_MODE_CMD)){
+					zstrm->avail_in = fread(pThis->inbuf, 1, CMPR_IN_BUF_SZ, pThis->file);
+				}
+				else if(pThis->mode == STREAM_MODE_SOCKET){
 					errno = 0;
 					/* looks like a bug below, read doesn't itterate */
 					nRec = recv(pThis->nSockFd, pThis->inbuf, CMPR_IN_BUF_SZ, 0);
@@ -421,17 +537,18 @@ int _DasIO_inflate_read(DasIO* pThis, char* data, size_t uLen)
 					}
 					zstrm->avail_in = nRec;
 				}
+				zstrm->next_in = pThis->inbuf;
 			}
-						  
-			pThis->offset+= zstrm->avail_in;
+
+			/* offset counts decompressed bytes, it's advanced by the callers
+			   as they consume output, not here */
 			if(zstrm->avail_in == 0){
 				pThis->eof = 1;
-				if(ferror(pThis->file)){
+				if((pThis->file != NULL)&&(ferror(pThis->file))){
 					pThis->zerr = Z_ERRNO;
 					break;
 				}
 			}
-			zstrm->next_in = pThis->inbuf;
 		}
 		pThis->zerr = inflate(zstrm, Z_NO_FLUSH);
 		if(pThis->zerr != Z_OK || pThis->eof) break;
@@ -439,13 +556,6 @@ int _DasIO_inflate_read(DasIO* pThis, char* data, size_t uLen)
 	return (uLen - pThis->zstrm->avail_out);
 }
 
-int _DasIO_inflate_getc(DasIO* pThis )
-{
-    unsigned char c;
-    if (_DasIO_inflate_read(pThis, (char*) (&c), 1) == 1) return c;
-    else return -1;
-}
-
 /** @todo: This function has multiple problems.  Partial writes are not 
  *          accounted for, and it can't write to a socket */
 /* check for compressed != 1 and rw != 'w' */
@@ -545,109 +655,147 @@ DasErrCode _DasIO_deflate_flush( DasIO* pThis )
 }
 
 
+/* ************************************************************************ */
+/* Read-ahead, input is pulled in large chunks so that tag and header       */
+/* scanning happens in memory instead of one system call per byte          */
+
+static bool _DasIO_readAhead(const DasIO* pThis)
+{
+	if(pThis->compressed) return true;
+	switch(pThis->mode){
+	case STREAM_MODE_SOCKET:
+	case STREAM_MODE_SSL:
+		return true;
+	case STREAM_MODE_FILE:
+		return pThis->bRegFile;
+	default:
+		return false;
+	}
+}
+
+/* Refill an empty read-ahead buffer.  Returns the number of bytes now
+ * available, 0 at the end of input, or a negative error code */
+static int _DasIO_fill(DasIO* pThis)
+{
+	ssize_t nRead = 0;
+	char* sErr = NULL;
+	
+	if(pThis->pRdBuf == NULL)
+		pThis->pRdBuf = (char*)malloc(READ_AHEAD_SZ);
+	
+	pThis->uRdBeg = 0;
+	pThis->uRdEnd = 0;
+	
+	if(pThis->compressed){
+		nRead = _DasIO_inflate_read(pThis, pThis->pRdBuf, READ_AHEAD_SZ);
+	}
+	else{
+		switch(pThis->mode){
+		case STREAM_MODE_FILE:
+		case STREAM_MODE_CMD:
+			nRead = fread(pThis->pRdBuf, sizeof(char), READ_AHEAD_SZ, pThis->file);
+			if((nRead == 0)&&(ferror(pThis->file)))
+				return -1 * das_error(DASERR_IO, "Error reading from input file");
+			break;
+		
+		case STREAM_MODE_SOCKET:
+			errno = 0;
+			nRead = recv(pThis->nSockFd, pThis->pRdBuf, READ_AHEAD_SZ, 0);
+			if(nRead < 0)
+				return -1 * das_error(DASERR_IO, "Error reading from host %s", strerror(errno));
+			break;
+		
+		case STREAM_MODE_SSL:
+			nRead = SSL_read((SSL*)pThis->pSsl, pThis->pRdBuf, READ_AHEAD_SZ);
+			if(nRead < 0){
+				sErr = das_ssl_getErr((SSL*)pThis->pSsl, nRead);
+				das_error(DASERR_IO, "SSL read error %s", sErr);
+				free(sErr);
+				return -1 * DASERR_IO;
+			}
+			break;
+		
+		default:
+			return -1 * das_error(DASERR_NOTIMP, "Read ahead not supported for mode %d",
+			                      pThis->mode);
+		}
+	}
+	
+	pThis->uRdEnd = (size_t)nRead;
+	return (int)nRead;
+}
+
 /* ************************************************************************ */
 /* Public IO functions, hide compression from user                          */
 
 int DasIO_getc(DasIO* pThis)
 {	
-	ssize_t nRet = 0;
-	char c;
 	int i = 0;
-	char* sErr = NULL;
-	switch(pThis->mode){
-	case STREAM_MODE_STRING:
-		if(pThis->nLength == 0){
-			i = -1;
-		}
-		else{
-			i = pThis->sBuffer[0];
-			pThis->sBuffer++;
-			pThis->nLength--;
-		}
-		break;
-	case STREAM_MODE_FILE:
-	case STREAM_MODE_CMD:
-		if(pThis->compressed) {
-			i = _DasIO_inflate_getc(pThis);
-		}
-		else{
-			i = fgetc( pThis->file );
-			pThis->offset++;
-		}
-		break;
-	case STREAM_MODE_SOCKET:
-		errno = 0;
-		nRet = recv(pThis->nSockFd, &c, 1, 0);
-		if(nRet == -1){
-			das_error(DASERR_IO, "Error reading from host %s", strerror(errno));
+	
+	if(!pThis->compressed && _DasIO_inMemory(pThis)){
+		if(pThis->nLength == 0)
 			return -1;
-		}
-		i = c;
-		break;
-	case STREAM_MODE_SSL:
-		/* Single character read, don't have to go round multiple times */
-		nRet = SSL_read((SSL*)pThis->pSsl, &c, 1);
-		if(nRet == 0){
-			if(SSL_get_shutdown((SSL*)pThis->pSsl) != 0) return 0;
-			if(SSL_get_error((SSL*)pThis->pSsl, 0) == SSL_ERROR_ZERO_RETURN) 
-				return -1;
-		}
-		if(nRet < 0){
-			sErr = das_ssl_getErr((SSL*)pThis->pSsl, nRet);
-			das_error(DASERR_IO, "SSL read error %s", sErr);
-			free(sErr);
+		i = (ubyte)(pThis->sBuffer[0]);
+		pThis->sBuffer++;
+		pThis->nLength--;
+		pThis->offset++;
+		return i;
+	}
+	
+	if(_DasIO_readAhead(pThis)){
+		if((pThis->uRdBeg == pThis->uRdEnd)&&(_DasIO_fill(pThis) < 1))
 			return -1;
-		}
-		i = c;
-		break;
 		
-	default:
-		das_error(DASERR_IO, "not implemented\n" ); abort();
-		break;
+		pThis->offset++;
+		return (ubyte)(pThis->pRdBuf[pThis->uRdBeg++]);
+	}
+	
+	if((pThis->mode == STREAM_MODE_FILE)||(pThis->mode == STREAM_MODE_CMD)){
+		i = fgetc( pThis->file );
+		pThis->offset++;
+		return i;
 	}
-	  
-    return i;
+	
+	das_error(DASERR_IO, "not implemented\n" ); abort();
+	return -1;
 }
 
 int DasIO_read(DasIO* pThis, DasBuf* pBuf, size_t uLen)
 {
 	int nRead = 0;
-	
-	if(pThis->compressed ){
-		/* PITA: Breaking encapsalation.  Zlib stuff should move into the
-		 * Buffer class itself */
+	int nFill = 0;
+	size_t uCopy = 0;
+	
+	if(!pThis->compressed && _DasIO_inMemory(pThis)){
+		nRead = uLen < pThis->nLength ? uLen : pThis->nLength;
+		DasBuf_write(pBuf, pThis->sBuffer, nRead);
+		pThis->sBuffer += nRead;
+		pThis->nLength -= nRead;
+	}
+	else if(_DasIO_readAhead(pThis)){
 		if(uLen > DasBuf_writeSpace(pBuf)) 
-			das_error(DASERR_IO, "Buffer has %zu bytes of space left, can't write "
-			                "%zu bytes.", DasBuf_writeSpace(pBuf), uLen);
-			
-		nRead = _DasIO_inflate_read(pThis, pBuf->pWrite, uLen);
+			return -1 * das_error(DASERR_IO, "Buffer has %zu bytes of space left, "
+			                      "can't write %zu bytes.", DasBuf_writeSpace(pBuf), uLen);
+		
+		while(nRead < uLen){
+			if(pThis->uRdBeg == pThis->uRdEnd){
+				if((nFill = _DasIO_fill(pThis)) < 0) return nFill;
+				if(nFill == 0) break;
+			}
+			uCopy = pThis->uRdEnd - pThis->uRdBeg;
+			if(uCopy > uLen - nRead) uCopy = uLen - nRead;
 			
-		/* Definitely shouldn't do this here... */
-		pBuf->pWrite += nRead;
-		pBuf->pReadEnd = pBuf->pWrite;
+			DasBuf_write(pBuf, pThis->pRdBuf + pThis->uRdBeg, uCopy);
+			pThis->uRdBeg += uCopy;
+			nRead += uCopy;
+		}
 	}
 	else{
-	
 		switch(pThis->mode){
-		case STREAM_MODE_STRING:	
-			nRead = uLen < pThis->nLength ? uLen : pThis->nLength;
-			DasBuf_write(pBuf, pThis->sBuffer, nRead);
-			pThis->sBuffer += nRead;
-			pThis->nLength -= nRead;
-			break;
-	
 		case STREAM_MODE_FILE:
 		case STREAM_MODE_CMD:
 			nRead = DasBuf_writeFrom(pBuf, pThis->file, uLen);
 			break;
-		
-		case STREAM_MODE_SOCKET:
-			nRead = DasBuf_writeFromSock(pBuf, pThis->nSockFd, uLen);
-			break;
-		
-		case STREAM_MODE_SSL:
-			nRead = DasBuf_writeFromSSL(pBuf, pThis->pSsl, uLen);
-			break;
 	
 		default:
 			das_error(DASERR_NOTIMP, "not implemented\n" ); abort();
@@ -660,14 +808,52 @@ int DasIO_read(DasIO* pThis, DasBuf* pBuf, size_t uLen)
 	return nRead;
 }
 
-
-// TODO: Support this with specialized version of the DasBuf_write* 
-//       functions for faster results
 int DasIO_readUntil(DasIO* pThis, DasBuf* pBuf, size_t uMax, char cStop)
 {
 	int c;
 	int nTotalRead = 0;
 	int nRead = 0;
+	
+	if(_DasIO_readAhead(pThis)){
+		const char* pBeg = NULL;
+		const char* pStop = NULL;
+		size_t uScan = 0;
+		
+		while(nTotalRead < uMax){
+			if(pThis->uRdBeg == pThis->uRdEnd){
+				if((nRead = _DasIO_fill(pThis)) < 1)
+					return nRead;
+			}
+			pBeg = pThis->pRdBuf + pThis->uRdBeg;
+			uScan = pThis->uRdEnd - pThis->uRdBeg;
+			if(uScan > uMax - nTotalRead) uScan = uMax - nTotalRead;
+			
+			if((pStop = memchr(pBeg, cStop, uScan)) != NULL)
+				uScan = (pStop - pBeg) + 1;
+			
+			if(DasBuf_write(pBuf, pBeg, uScan) != DAS_OKAY)
+				return -1 * DASERR_IO;
+			
+			pThis->uRdBeg += uScan;
+			pThis->offset += uScan;
+			nTotalRead += uScan;
+			
+			if(pStop != NULL)
+				return nTotalRead;
+		}
+		return -1 * das_error(DASERR_IO, "Couldn't find %c within %zu bytes", cStop, uMax);
+	}
+	
+	if(!pThis->compressed && _DasIO_inMemory(pThis)){
+		size_t uScan = uMax < pThis->nLength ? uMax : pThis->nLength;
+		const char* pStop = memchr(pThis->sBuffer, cStop, uScan);
+		if(pStop == NULL){
+			if(uScan < uMax) return 0;  /* Input ended first */
+			return -1 * das_error(DASERR_IO, "Couldn't find %c within %zu bytes", cStop, uMax);
+		}
+		return DasIO_read(pThis, pBuf, (pStop - pThis->sBuffer) + 1);
+	}
+	
 	for(size_t u = 0; u < uMax; ++u){
 		nRead = DasIO_read(pThis, pBuf, 1);
 		if(nRead < 1)
@@ -782,6 +968,16 @@ void DasIO_close(DasIO* pThis) {
 		pThis->file = NULL;
 		break;
 	
+#ifndef _WIN32
+	case STREAM_MODE_MMAP:
+		if(pThis->pMap != NULL)
+			munmap(pThis->pMap, pThis->uMapLen);
+		pThis->pMap = NULL;
+		pThis->sBuffer = NULL;
+		pThis->nLength = 0;
+		break;
+#endif
+	
 	case STREAM_MODE_SSL:
 		pThis->nSockFd = SSL_get_fd((SSL*)pThis->pSsl);
 		nRet = SSL_shutdown((SSL*)pThis->pSsl);
@@ -814,11 +1010,12 @@ void DasIO_close(DasIO* pThis) {
 
 void del_DasIO(DasIO* pThis){
 	if((pThis->file != NULL)||(pThis->zstrm != NULL)||(pThis->nSockFd != -1)||
-		(pThis->pSsl != NULL)){
+		(pThis->pSsl != NULL)||(pThis->pMap != NULL)){
 		DasIO_close(pThis);
 	}
 	/* Close out the write buffer here */
 	del_DasBuf(pThis->pDb);
+	if(pThis->pRdBuf != NULL) free(pThis->pRdBuf);
 	OutOfBand_clean((OutOfBand*)&pThis->cmt);
 	free(pThis);
 }
@@ -1080,8 +1277,43 @@ TAG_ERROR:
 	);	
 }
 
+/* Das2 data packets don't carry a length, so it comes from the packet's
+ * descriptor.  Problems are returned as one of the codes below instead of
+ * being reported so that sizes can be looked up ahead of time for every
+ * packet ID, see _DasIO_snapRecBytes() */
+#define IO_RECSZ_NODESC    0
+#define IO_RECSZ_NOCODEC  -1
+#define IO_RECSZ_VARLEN   -2
+#define IO_RECSZ_LOGIC    -3
+
+/* Old das2 packet IDs are two digits */
+#define IO_D2_PKTIDS     100
+
+static int _DasIO_recBytes(DasStream* pSd, int nPktId)
+{
+	int nPktSz;
+	DasDesc* pDesc = DasStream_getDesc(pSd, nPktId);
+	if(pDesc == NULL)
+		return IO_RECSZ_NODESC;
+
+	if(pDesc->type == DATASET){
+		nPktSz = DasDs_recBytes((DasDs*)pDesc);
+		if(nPktSz == 0)
+			return (DasDs_numCodecs((DasDs*)pDesc) == 0) ? IO_RECSZ_NOCODEC : IO_RECSZ_LOGIC;
+		if(nPktSz < 0)
+			return IO_RECSZ_VARLEN;
+		return nPktSz;
+	}
+	if(pDesc->type == PACKET){
+		nPktSz = (int)PktDesc_recBytes((PktDesc*)pDesc);
+		return (nPktSz > 0) ? nPktSz : IO_RECSZ_LOGIC;
+	}
+	return IO_RECSZ_LOGIC;
+}
+
 int _DasIO_sizeOrErr(
-	DasIO* pThis, DasBuf* pBuf, int nContent, DasStream* pSd, int nPktId
+	DasIO* pThis, DasBuf* pBuf, int nContent, DasStream* pSd, const int* pRecSz,
+	int nPktId
 ){
 	int nPktSz; 
 	char sLen[12] = {'\0'};
@@ -1122,36 +1354,31 @@ int _DasIO_sizeOrErr(
 			if(sscanf(sLen, "%d", &nPktSz) != 1)
 				return -1 * das_error(DASERR_IO, "Can't get packet syze from bytes %s", sLen);
 		}
+		return nPktSz;
 	}
-	else{
-		/* ...Old das2 data packets don't */
-		if(pSd == NULL)
-			return -1 * das_error(DASERR_IO, "Data packets received before stream header");
-	
-		DasDesc* pDesc = pSd->descriptors[nPktId];
-		if(pDesc == NULL)
-			return -1 * das_error(DASERR_IO, "Packet type %02d data received before packet "
-						            	"type %02d header", nPktId, nPktId);
-
-		if(pDesc->type == DATASET){
-			nPktSz = DasDs_recBytes((DasDs*)pDesc);
-			if(nPktSz == 0){
-				if(DasDs_numCodecs((DasDs*)pDesc) == 0)
-					return -1 * das_error(DASERR_IO, "No codecs are defined for the dataset");
-				else
-					return -1 * das_error(DASERR_IO, "Logic error in io.c");
-			}
-			if(nPktSz < 0)
-				return -1 * das_error(DASERR_IO, "Das2 streams do not support variable length packets");
-		}
-		else{ 
-			if(pDesc->type == PACKET)
-				nPktSz = PktDesc_recBytes((PktDesc*)pDesc);
-			else
-				return -1 * das_error(DASERR_IO, "Logic error in io.c");
-		}
+
+	/* ...Old das2 data packets don't.  Use the sizes snapshot if given */
+	if((pSd == NULL) && (pRecSz == NULL))
+		return -1 * das_error(DASERR_IO, "Data packets received before stream header");
+
+	if((nPktId < 1)||(nPktId >= IO_D2_PKTIDS))
+		return -1 * das_error(DASERR_IO, "Invalid das2 packet ID %d", nPktId);
+
+	nPktSz = (pRecSz != NULL) ? pRecSz[nPktId] : _DasIO_recBytes(pSd, nPktId);
+
+	switch(nPktSz){
+	case IO_RECSZ_NODESC:
+		return -1 * das_error(DASERR_IO, "Packet type %02d data received before packet "
+		                      "type %02d header", nPktId, nPktId);
+	case IO_RECSZ_NOCODEC:
+		return -1 * das_error(DASERR_IO, "No codecs are defined for the dataset");
+	case IO_RECSZ_VARLEN:
+		return -1 * das_error(DASERR_IO, "Das2 streams do not support variable length packets");
+	case IO_RECSZ_LOGIC:
+		return -1 * das_error(DASERR_IO, "Logic error in io.c");
+	default:
+		return nPktSz;
 	}
-	return nPktSz;
 }
 
 DasErrCode _DasIO_handleDesc(
@@ -1189,7 +1416,7 @@ DasErrCode _DasIO_handleDesc(
 				);
 		
 			/* Handle packet redefinitions. */
-			if(pSd->descriptors[nPktId] != NULL){
+			if(DasStream_isValidId(pSd, nPktId)){
 				
 				/* Let any stream processors know that this packet desc is about
 				 * to be deleted so that they can do stuff with the old one 1st */
@@ -1197,7 +1424,7 @@ DasErrCode _DasIO_handleDesc(
 					pHndlr = pThis->pProcs[u];
 					if(pHndlr->pktRedefHandler != NULL)
 						nRet = pHndlr->pktRedefHandler(
-							pSd, pSd->descriptors[nPktId], pHndlr->userData
+							pSd, DasStream_getDesc(pSd, nPktId), pHndlr->userData
 						);
 
 					if(nRet != 0) break;
@@ -1234,12 +1461,12 @@ DasErrCode _DasIO_handleDesc(
 			break;
 		case PACKET:
 			if(pHndlr->pktDescHandler != NULL)
-				nRet = pHndlr->pktDescHandler(pSd, (PktDesc*)pSd->descriptors[nPktId], pHndlr->userData);
+				nRet = pHndlr->pktDescHandler(pSd, (PktDesc*)pDesc, pHndlr->userData);
 			break;
 		case DATASET:
 			if(pHndlr->dsDescHandler != NULL)
 				nRet = pHndlr->dsDescHandler(
-					pSd, nPktId, (DasDs*)pSd->descriptors[nPktId], pHndlr->userData
+					pSd, nPktId, (DasDs*)pDesc, pHndlr->userData
 				);
 			break;
 		default:
@@ -1258,7 +1485,10 @@ DasErrCode _DasIO_handleData(
 	int nRet = 0;
 	StreamHandler* pHndlr = NULL;
 	
-	DasDesc* pDesc = pSd->descriptors[nPktId];
+	DasDesc* pDesc = DasStream_getDesc(pSd, nPktId);
+	if(pDesc == NULL)
+		return das_error(DASERR_IO, "Packet type %02d data received before packet "
+		                 "type %02d header", nPktId, nPktId);
 	
 	if(pDesc->type == PACKET)
 		nRet = PktDesc_decodeData((PktDesc*)pDesc, pBuf);
@@ -1324,6 +1554,258 @@ DasErrCode _DasIO_handleOOB(DasIO* pThis, DasBuf* pBuf, OutOfBand** ppObjs)
 	return nRet;
 }
 
+/* Read and frame the next packet.  Returns the content flags of the packet,
+ * 0 at the normal end of input, or a negative error code.  On success *ppPkt
+ * points at the packet bytes, which are either pBuf or, for in-memory input
+ * when pView is not NULL, a read-only view straight into the input.  Das2
+ * data packet sizes come from pRecSz if it's not NULL, otherwise from pSd. */
+static int _DasIO_nextPkt(
+	DasIO* pThis, DasBuf* pBuf, DasBuf* pView, bool bFirstRead, DasStream* pSd,
+	const int* pRecSz, int* pPktId, DasBuf** ppPkt
+){
+	int nContent, nBytes;
+
+	DasBuf_reinit(pBuf);
+		
+	/* What Kind of Packet do we have? */
+	*pPktId = -1;
+	if((nContent = _DasIO_dataTypeOrErr(pThis, pBuf, bFirstRead, pPktId)) < 1)
+		return nContent;
+		
+	/* Get the number of bytes to read next */
+	if((nContent & IO_CHUNK_MASK) != IO_CHUNK_PKT)
+		return -1 * das_error(DASERR_IO, "Un-packetized documents are not yet supported");
+
+	nBytes = _DasIO_sizeOrErr(pThis, pBuf, nContent, pSd, pRecSz, *pPktId);
+	if(nBytes < 0)
+		return nBytes;
+	if(nBytes == 0){
+		/* Wow, a null packet, let's call those illegal */
+		return -1 * das_error(DASERR_IO, "0-length input packet.");
+	}
+		
+	/* Data packets from in-memory input are decoded in place */
+	if((pView != NULL) && !pThis->compressed && _DasIO_inMemory(pThis) && 
+		((nContent & IO_ENC_MASK) == IO_ENC_DATA)
+	){
+		if(nBytes > pThis->nLength)
+			return -1 * das_error(DASERR_IO, "Partial packet on input at offset %ld", pThis->offset);
+
+		DasBuf_initReadOnly(pView, pThis->sBuffer, nBytes);
+		pThis->sBuffer += nBytes;
+		pThis->nLength -= nBytes;
+		pThis->offset += nBytes;
+		*ppPkt = pView;
+		return nContent;
+	}
+
+	/* Read the bytes */
+	if(nBytes > pBuf->uLen)
+		return -1 * das_error(DASERR_IO, "Packet's length is %d, library buffer is only"
+		                      "%zu bytes long", nBytes, pBuf->uLen);
+			
+	if( DasIO_read(pThis, pBuf, nBytes) != nBytes)
+		return -1 * das_error(DASERR_IO, "Partial packet on input at offset %ld", pThis->offset);
+
+	*ppPkt = pBuf;
+	return nContent;
+}
+
+/* Send one framed packet to the decoders and stream handlers */
+static DasErrCode _DasIO_dispatch(
+	DasIO* pThis, int nContent, DasBuf* pPkt, DasStream** ppSd, int nPktId,
+	OutOfBand** ppObjs
+){
+	switch(nContent & IO_ENC_MASK){
+	case IO_ENC_JSON:
+		return das_error(DASERR_IO, "JSON stream parsing is not yet supported");
+	case IO_ENC_EXT:
+		return das_error(DASERR_IO, "Extension formats are not yet supported");
+	case IO_ENC_XML:
+		if((nContent & IO_USAGE_MASK) == IO_USAGE_CNT)
+			return _DasIO_handleDesc(pThis, pPkt, ppSd, nPktId); 
+		if((nContent & IO_USAGE_MASK) == IO_USAGE_OOB)
+			return _DasIO_handleOOB(pThis, pPkt, ppObjs);
+		return das_error(DASERR_IO, "XML pass through is not yet supported");
+	case IO_ENC_DATA:
+		return _DasIO_handleData(pThis, pPkt, *ppSd, nPktId);  
+	default:
+		return das_error(DASERR_IO, "Logic error in stream parser");
+	}
+}
+
+/* Descriptor packets change how the following packets are framed */
+#define _DasIO_isHeader(C) \
+	((((C) & IO_ENC_MASK) == IO_ENC_XML) && (((C) & IO_USAGE_MASK) == IO_USAGE_CNT))
+
+/* ************************************************************************* */
+/* Pipelined reading */
+
+/* The reader thread owns all I/O state in the DasIO while running.  The
+ * handler thread owns the stream and descriptors.  The reader never looks at
+ * the stream, instead the handler copies the das2 record sizes into the pipe
+ * after each header and the reader frames packets using that copy. */
+
+typedef struct das_io_slot{
+	DasBuf* pBuf;
+	int nContent;
+	int nPktId;
+} DasIOSlot;
+
+typedef struct das_io_pipe{
+	DasIO* pIo;
+	pthread_mutex_t mtx;
+	pthread_cond_t cvReady;  /* signaled when a slot is filled or input ends */
+	pthread_cond_t cvFree;   /* signaled when a slot is released */
+	
+	int nSlots;
+	DasIOSlot* aSlots;
+	size_t uHead;      /* Next slot for the handler thread */
+	size_t uTail;      /* Next slot for the reader thread */
+
+	bool bHdrWait;     /* reader is waiting for a header to be handled */
+	bool bStop;        /* handler thread is done, reader should quit */
+	bool bEnd;         /* reader is done */
+	int nReadRet;      /* reader's final status, 0 or a negative error */
+	bool bHaveSd;      /* a stream header has been handled */
+	int aRecSz[IO_D2_PKTIDS];  /* record sizes as of the last handled header */
+} DasIOPipe;
+
+/* Called by the handler thread with the pipe mutex held */
+static void _DasIO_snapRecBytes(DasIOPipe* pPipe, DasStream* pSd)
+{
+	pPipe->bHaveSd = (pSd != NULL);
+	pPipe->aRecSz[0] = IO_RECSZ_NODESC;  /* 0 is the stream header */
+	for(int i = 1; i < IO_D2_PKTIDS; ++i)
+		pPipe->aRecSz[i] = (pSd != NULL) ? _DasIO_recBytes(pSd, i) : IO_RECSZ_NODESC;
+}
+
+static void* _DasIO_readerThread(void* pArg)
+{
+	DasIOPipe* pPipe = (DasIOPipe*)pArg;
+	DasIO* pIo = pPipe->pIo;
+	int aRecSz[IO_D2_PKTIDS];
+	bool bHaveSd = false;
+	DasIOSlot* pSlot = NULL;
+	DasBuf* pPkt = NULL;
+	bool bFirstRead = true;
+	int nContent = 0;
+
+	while(true){
+		pthread_mutex_lock(&pPipe->mtx);
+		while((pPipe->uTail - pPipe->uHead == (size_t)pPipe->nSlots) && !pPipe->bStop)
+			pthread_cond_wait(&pPipe->cvFree, &pPipe->mtx);
+		if(pPipe->bStop){
+			pthread_mutex_unlock(&pPipe->mtx);
+			nContent = 0;
+			break;
+		}
+		pSlot = pPipe->aSlots + (pPipe->uTail % pPipe->nSlots);
+		pthread_mutex_unlock(&pPipe->mtx);
+
+		nContent = _DasIO_nextPkt(
+			pIo, pSlot->pBuf, NULL, bFirstRead, NULL, bHaveSd ? aRecSz : NULL,
+			&(pSlot->nPktId), &pPkt
+		);
+		if(nContent < 1) break;
+		bFirstRead = false;
+		pSlot->nContent = nContent;
+
+		pthread_mutex_lock(&pPipe->mtx);
+		++(pPipe->uTail);
+		pthread_cond_signal(&pPipe->cvReady);
+
+		if(_DasIO_isHeader(nContent)){
+			pPipe->bHdrWait = true;
+			while(pPipe->bHdrWait && !pPipe->bStop)
+				pthread_cond_wait(&pPipe->cvFree, &pPipe->mtx);
+			bHaveSd = pPipe->bHaveSd;
+			memcpy(aRecSz, pPipe->aRecSz, sizeof(aRecSz));
+		}
+		pthread_mutex_unlock(&pPipe->mtx);
+	}
+
+	pthread_mutex_lock(&pPipe->mtx);
+	pPipe->bEnd = true;
+	pPipe->nReadRet = nContent;
+	pthread_cond_signal(&pPipe->cvReady);
+	pthread_mutex_unlock(&pPipe->mtx);
+	return NULL;
+}
+
+static DasErrCode _DasIO_readPiped(
+	DasIO* pThis, DasStream** ppSd, OutOfBand** ppObjs
+){
+	DasErrCode nRet = DAS_OKAY;
+	DasIOPipe pipe;
+	memset(&pipe, 0, sizeof(DasIOPipe));
+	pipe.pIo = pThis;
+	pipe.nSlots = pThis->nPipeSlots;
+
+	pipe.aSlots = (DasIOSlot*)calloc(pipe.nSlots, sizeof(DasIOSlot));
+	if(pipe.aSlots == NULL)
+		return das_error(DASERR_IO, "Couldn't allocate %d packet slots", pipe.nSlots);
+
+	for(int i = 0; i < pipe.nSlots; ++i){
+		if((pipe.aSlots[i].pBuf = new_DasBuf(pThis->pDb->uLen)) == NULL){
+			nRet = das_error(DASERR_IO, "Couldn't allocate packet buffers");
+			goto PIPE_FREE;
+		}
+	}
+
+	pthread_mutex_init(&pipe.mtx, NULL);
+	pthread_cond_init(&pipe.cvReady, NULL);
+	pthread_cond_init(&pipe.cvFree, NULL);
+
+	pthread_t reader;
+	if(pthread_create(&reader, NULL, _DasIO_readerThread, &pipe) != 0){
+		nRet = das_error(DASERR_IO, "Couldn't start the input reader thread");
+		goto PIPE_DESTROY;
+	}
+
+	DasIOSlot* pSlot = NULL;
+	while(nRet == DAS_OKAY){
+		pthread_mutex_lock(&pipe.mtx);
+		while((pipe.uHead == pipe.uTail) && !pipe.bEnd)
+			pthread_cond_wait(&pipe.cvReady, &pipe.mtx);
+		if(pipe.uHead == pipe.uTail){
+			nRet = -1 * pipe.nReadRet;   /* end of input, or a read error */
+			pthread_mutex_unlock(&pipe.mtx);
+			break;
+		}
+		pSlot = pipe.aSlots + (pipe.uHead % pipe.nSlots);
+		pthread_mutex_unlock(&pipe.mtx);
+
+		nRet = _DasIO_dispatch(
+			pThis, pSlot->nContent, pSlot->pBuf, ppSd, pSlot->nPktId, ppObjs
+		);
+
+		pthread_mutex_lock(&pipe.mtx);
+		++(pipe.uHead);
+		if(_DasIO_isHeader(pSlot->nContent)){
+			_DasIO_snapRecBytes(&pipe, *ppSd);
+			pipe.bHdrWait = false;
+		}
+		if(nRet != DAS_OKAY) pipe.bStop = true;
+		pthread_cond_signal(&pipe.cvFree);
+		pthread_mutex_unlock(&pipe.mtx);
+	}
+
+	/* A reader blocked in a system read finishes that read before it sees
+	   the stop flag */
+	pthread_join(reader, NULL);
+
+PIPE_DESTROY:
+	pthread_cond_destroy(&pipe.cvFree);
+	pthread_cond_destroy(&pipe.cvReady);
+	pthread_mutex_destroy(&pipe.mtx);
+PIPE_FREE:
+	for(int i = 0; i < pipe.nSlots; ++i)
+		if(pipe.aSlots[i].pBuf != NULL) del_DasBuf(pipe.aSlots[i].pBuf);
+	free(pipe.aSlots);
+	return nRet;
+}
+
 DasErrCode DasIO_readAll(DasIO* pThis)
 {
 	DasErrCode nRet = 0;
@@ -1335,10 +1817,11 @@ DasErrCode DasIO_readAll(DasIO* pThis)
 	OobExcept_init(&ex);
 	OutOfBand* oobs[3] = {(OutOfBand*)&sc, (OutOfBand*)&ex, NULL};
 	
-	int nPktId, nBytes;
+	int nPktId;
 	int nContent;
 	
-	DasBuf* pBuf = pThis->pDb;
+	DasBuf* pPkt = NULL;  /* pThis->pDb, or a view straight into in-memory input */
+	DasBuf view;
 	bool bFirstRead = true;
 	
 	if(pThis->rw == 'w'){
@@ -1348,74 +1831,23 @@ DasErrCode DasIO_readAll(DasIO* pThis)
 	/* Loop over all the input packets, make sure to break out of the loop
 	 * instead of just returning so that the stream close handlers can be called. 
 	 */
-	while(nRet == 0){
-		DasBuf_reinit(pBuf);
-		
-		/* What Kind of Packet do we have? */
-		nPktId = -1;
-		if((nContent = _DasIO_dataTypeOrErr(pThis, pBuf, bFirstRead, &nPktId)) < 1){
-			nRet = -1 * nContent;
-			break;
-		}
-		bFirstRead = false;
-		
-		/* Get the number of bytes to read next */
-		if((nContent & IO_CHUNK_MASK) == IO_CHUNK_PKT){
-
-			nBytes = _DasIO_sizeOrErr(pThis, pBuf, nContent, pSd, nPktId);
-			if(nBytes < 0){ 
-				nRet = -1 * nBytes;
-				break;
-			}
-			if(nBytes == 0){
-				/* Wow, a null packet, let's call those illegal */
-				nRet = das_error(DASERR_IO, "0-length input packet.");
-				break;
-			}
-		
-			/* Read the bytes */
-			if(nBytes > pBuf->uLen){
-				nRet = das_error(DASERR_IO, "Packet's length is %d, library buffer is only"
-					            	"%zu bytes long", nBytes, pThis->pDb->uLen);
-				break;
-			}
-		
-			if( DasIO_read(pThis, pBuf, nBytes) != nBytes){
-				nRet = das_error(DASERR_IO, "Partial packet on input at offset %ld", pThis->offset);
+	if((pThis->nPipeSlots > 0) && !_DasIO_inMemory(pThis)){
+		nRet = _DasIO_readPiped(pThis, &pSd, oobs);
+	}
+	else{
+		while(nRet == 0){
+			nContent = _DasIO_nextPkt(
+				pThis, pThis->pDb, &view, bFirstRead, pSd, NULL, &nPktId, &pPkt
+			);
+			if(nContent < 1){
+				nRet = -1 * nContent;
 				break;
 			}
-		}
-		else{
-			nRet = das_error(DASERR_IO, "Un-packetized documents are not yet supported");
-			break;
-		}
-
-		switch(nContent & IO_ENC_MASK){
-		case IO_ENC_JSON:
-			nRet = das_error(DASERR_IO, "JSON stream parsing is not yet supported");
-			break;
-		case IO_ENC_EXT:
-			nRet = das_error(DASERR_IO, "Extension formats are not yet supported");
-			break;
-		case IO_ENC_XML:
-			if((nContent & IO_USAGE_MASK) == IO_USAGE_CNT)
-				nRet = _DasIO_handleDesc(pThis, pBuf, &pSd, nPktId); 
-			else if((nContent & IO_USAGE_MASK) == IO_USAGE_OOB)
-				nRet = _DasIO_handleOOB(pThis, pBuf, oobs);
-			else
-				nRet = das_error(DASERR_IO, "XML pass through is not yet supported");
+			bFirstRead = false;
 
-			break;
-		case IO_ENC_DATA:
-			nRet = _DasIO_handleData(pThis, pBuf, pSd, nPktId);  
-			break;
-		default:
-			nRet = das_error(DASERR_IO, "Logic error in stream parser");
-			break;
-		}
-		if(nRet != 0) break;
-		
-	}/* repeat until endOfStream */
+			nRet = _DasIO_dispatch(pThis, nContent, pPkt, &pSd, nPktId, oobs);
+		}/* repeat until endOfStream */
+	}
 
 	/* Now for the close handlers, *if* I ever got a proper opening */
 	int nHdlrRet = 0;
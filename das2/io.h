@@ -62,7 +62,8 @@ typedef struct das_io_struct {
 	                           opaque bytes instead of failing (DasIO_embedAsBytes) */
 
 	int      mode;       /* STREAM_MODE_STRING, STREAM_MODE_FILE,
-								 * STREAM_MODE_SOCKET, STREAM_MODE_SSL */
+								 * STREAM_MODE_SOCKET, STREAM_MODE_SSL,
+								 * STREAM_MODE_MMAP */
 
 	char     sName[DASIO_NAME_SZ]; /* A human readable name for data source or sink */
 	
@@ -81,7 +82,11 @@ typedef struct das_io_struct {
 	
 	/* Buffer IO */
 	char     *sBuffer;   /* buffer for string input/output */
-	int      nLength;    /* length of buffer pointed to by sbuffer */
+	size_t   nLength;    /* length of buffer pointed to by sbuffer */
+	
+	/* Memory mapped file I/O */
+	char     *pMap;      /* start of the mapped file, sBuffer walks through it */
+	size_t   uMapLen;    /* length of the mapping */
 	
 	/* Compressed I/O */
 	z_stream *zstrm;     /* z_stream for inflate/deflate operations */
@@ -90,6 +95,13 @@ typedef struct das_io_struct {
 	int      zerr;       /* error code for last stream operation */
 	int      eof;        /* set if end of input file */
 	
+	/* Read-ahead (input) */
+	bool     bRegFile;   /* input FILE is a regular file, safe to read ahead */
+	char     *pRdBuf;    /* read-ahead buffer, allocated on first fill */
+	size_t   uRdBeg;     /* offset of next unconsumed read-ahead byte */
+	size_t   uRdEnd;     /* one past the last valid read-ahead byte */
+	int      nPipeSlots; /* if > 0 read packets on a separate thread (DasIO_pipeline) */
+	
 	/* data object processor's with callbacks  (Input / Output) */
 	StreamHandler* pProcs[DAS2_MAX_PROCESSORS+1];
 	bool bSentHeader;
@@ -176,6 +188,34 @@ DAS_API DasErrCode DasIO_model(DasIO* pThis, int nModel);
  */
 DAS_API void DasIO_embedAsBytes(DasIO* pThis, bool bEnable);
 
+/** Read and frame input packets on a separate thread.
+ *
+ * By default DasIO_readAll() reads bytes, splits them into packets, decodes
+ * data and calls every handler one after the other on the calling thread.
+ * When pipelining is enabled a reader thread does the I/O, decompression and
+ * packet framing into a bounded ring of packet buffers while the calling
+ * thread decodes packets and invokes the ::StreamHandler callbacks.  Handlers
+ * still see every packet in stream order and are always called from the
+ * thread that called DasIO_readAll(), so existing handlers need no locking.
+ *
+ * Decoding stays on the handler thread since decoders write into the same
+ * descriptor that handlers read.  When a header packet arrives the reader
+ * waits for it to be processed before framing more input, since later packet
+ * lengths may depend on it.
+ *
+ * In-memory inputs (strings and memory maps) have no I/O to overlap and are
+ * always read serially.
+ *
+ * @param pThis The DasIO object to configure, must be in read mode
+ * @param nSlots The number of packets the reader may run ahead of the
+ *        handlers, 0 disables pipelining (the default).
+ *
+ * @returns DAS_OKAY if successful or an error code if not.
+ *
+ * @memberof DasIO
+ */
+DAS_API DasErrCode DasIO_pipeline(DasIO* pThis, int nSlots);
+
 
 /** Create a new DasIO object from a shell command
  * 
@@ -215,6 +255,35 @@ DAS_API DasIO* new_DasIO_cmd(const char* sProg, const char* sCmd);
  */
 DAS_API DasIO* new_DasIO_file(const char* sProg, const char* sFile, const char* mode);
 
+/** Create a new DasIO object that reads a memory mapped disk file.
+ *
+ * The whole file is mapped read-only and packets are handed to the stream
+ * handlers as views into the mapping instead of being copied through an 
+ * intermediate buffer.  This is the fastest way to re-read large local
+ * stream files, such as cache blocks.
+ * 
+ * Deflate compressed streams are supported, but only the compressed bytes
+ * are read from the mapping, packets are still inflated into a buffer.
+ * 
+ * On platforms without mmap, this is the same as calling new_DasIO_file().
+ *
+ * @param sProg A spot to store the name of the program reading the file
+ *        this is useful for automatically generated error and log messages
+ *
+ * @param sFile the name of a file on disk.
+ *        
+ * @param mode A string containing the mode, one of:
+ *        - 'r' read either tag type
+ *        - 'r2' read only das v2 packet tags (error on anything else)
+ *        - 'r3' read only das v3 packet tags (error on anything else)
+ * 
+ * @returns A new DasIO object allocated on the heap, or NULL if the file
+ *        could not be mapped or a write mode was requested.
+ * 
+ * @memberof DasIO
+ */
+DAS_API DasIO* new_DasIO_mmap(const char* sProg, const char* sFile, const char* mode);
+
 /** Create a new DasIO object from a socket
  * 
  * @param sProg A spot to store the name of the program creating the file
@@ -1104,8 +1104,31 @@ DasErrCode PlaneDesc_decodeData(const PlaneDesc* pThis, DasBuf* pBuf)
 		pVarThis->_bFillSet = true;
 	}
 	
+	/* Time columns go through the plane's cached parser, values it doesn't
+	   recognize take the general route in DasEnc_read */
+	const DasEncoding* pEnc = pThis->pEncoding;
+	if(pEnc->nCat == DAS2DT_TIME){
+		PlaneDesc* pVarThis = (PlaneDesc*)pThis;
+		if(pVarThis->tparser.units != pThis->units)
+			das_tparser_init(&(pVarThis->tparser), pThis->units);
+
+		for(u = 0; u < pThis->uItems; u++){
+			size_t uUnread = 0;
+			const char* pField = (const char*)DasBuf_direct(pBuf, &uUnread);
+			if((pField != NULL)&&(uUnread >= pEnc->nWidth)&&
+			   das_tparser_toDouble(&(pVarThis->tparser), pField, pEnc->nWidth, pThis->pData + u)
+			){
+				DasBuf_setReadOffset(pBuf, DasBuf_readOffset(pBuf) + pEnc->nWidth);
+				continue;
+			}
+			nRet = DasEnc_read(pEnc, pBuf, pThis->units, pThis->pData + u);
+			if(nRet != 0) return nRet;
+		}
+		return nRet;
+	}
+
 	for(u = 0; u < pThis->uItems; u++){
-		nRet = DasEnc_read(pThis->pEncoding, pBuf, pThis->units, pThis->pData + u);
+		nRet = DasEnc_read(pEnc, pBuf, pThis->units, pThis->pData + u);
 		if(nRet != 0) return nRet;
 	}
 	return nRet;
@@ -162,6 +162,9 @@ typedef struct plane_descriptor{
 	/* set to true setValues or decode is called, set to false when encode is 
 	 * called */
 	bool bPlaneDataValid;
+
+	/* Caches the layout and current date of time strings for the decoder */
+	das_tparser tparser;
 	 
 	/* User data pointer.
 	 * The stream->packet->plane hierarchy provides a good organizational
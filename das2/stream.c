@@ -24,6 +24,7 @@
 #include <time.h>
 #include <limits.h>
 #include <stdio.h>
+#include <stdint.h>
 #ifdef __unix
 #include <sys/types.h>
 #include <unistd.h>
@@ -40,6 +41,161 @@
 #include "stream.h"
 #include "log.h"
 
+/* ************************************************************************** */
+/* Descriptor table and reverse index */
+
+struct das_desc_slot {
+	const DasDesc* pDesc;
+	int id;
+};
+
+#define _DAS_REVIDX_MIN 64
+
+static size_t _DasStream_hashPtr(const DasDesc* pDesc, size_t uMask)
+{
+	/* Allocations are aligned, so mix the high bits down before masking */
+	uint64_t u = (uint64_t)(uintptr_t)pDesc;
+	u ^= u >> 33;
+	u *= 0xff51afd7ed558ccdULL;
+	u ^= u >> 33;
+	return (size_t)u & uMask;
+}
+
+static int _DasStream_revFind(const DasStream* pThis, const DasDesc* pDesc)
+{
+	if(pThis->uRevSz == 0) return -1;
+
+	size_t uMask = pThis->uRevSz - 1;
+	size_t u = _DasStream_hashPtr(pDesc, uMask);
+	while(pThis->lRevIdx[u].pDesc != NULL){
+		if(pThis->lRevIdx[u].pDesc == pDesc)
+			return pThis->lRevIdx[u].id;
+		u = (u + 1) & uMask;
+	}
+	return -1;
+}
+
+static void _DasStream_revPut(
+	struct das_desc_slot* lIdx, size_t uSz, const DasDesc* pDesc, int id
+){
+	size_t uMask = uSz - 1;
+	size_t u = _DasStream_hashPtr(pDesc, uMask);
+	while((lIdx[u].pDesc != NULL)&&(lIdx[u].pDesc != pDesc))
+		u = (u + 1) & uMask;
+	lIdx[u].pDesc = pDesc;
+	lIdx[u].id = id;
+}
+
+static DasErrCode _DasStream_revAdd(DasStream* pThis, const DasDesc* pDesc, int id)
+{
+	/* Keep the load factor at or below 1/2 so probe runs stay short */
+	if((pThis->uDescs + 1) * 2 > pThis->uRevSz){
+		size_t uNewSz = pThis->uRevSz ? pThis->uRevSz * 2 : _DAS_REVIDX_MIN;
+		struct das_desc_slot* lNew = (struct das_desc_slot*)calloc(
+			uNewSz, sizeof(struct das_desc_slot)
+		);
+		if(lNew == NULL)
+			return das_error(DASERR_STREAM, "Couldn't grow descriptor index to %zu "
+			                 "entries", uNewSz);
+
+		for(size_t u = 0; u < pThis->uRevSz; ++u){
+			if(pThis->lRevIdx[u].pDesc != NULL)
+				_DasStream_revPut(lNew, uNewSz, pThis->lRevIdx[u].pDesc, pThis->lRevIdx[u].id);
+		}
+		free(pThis->lRevIdx);
+		pThis->lRevIdx = lNew;
+		pThis->uRevSz = uNewSz;
+	}
+	_DasStream_revPut(pThis->lRevIdx, pThis->uRevSz, pDesc, id);
+	return DAS_OKAY;
+}
+
+static void _DasStream_revDel(DasStream* pThis, const DasDesc* pDesc)
+{
+	if(pThis->uRevSz == 0) return;
+
+	struct das_desc_slot* lIdx = pThis->lRevIdx;
+	size_t uMask = pThis->uRevSz - 1;
+	size_t i = _DasStream_hashPtr(pDesc, uMask);
+	while(lIdx[i].pDesc != pDesc){
+		if(lIdx[i].pDesc == NULL) return;
+		i = (i + 1) & uMask;
+	}
+
+	/* Backward shift deletion, pull later members of the probe run into the
+	   hole unless their home slot lies cyclically in (i, j] */
+	size_t j = i;
+	for(;;){
+		j = (j + 1) & uMask;
+		if(lIdx[j].pDesc == NULL) break;
+		size_t k = _DasStream_hashPtr(lIdx[j].pDesc, uMask);
+		if( (i <= j) ? ((i < k)&&(k <= j)) : ((i < k)||(k <= j)) )
+			continue;
+		lIdx[i] = lIdx[j];
+		i = j;
+	}
+	lIdx[i].pDesc = NULL;
+	lIdx[i].id = 0;
+}
+
+/* Fast slot read, callers must have validated the ID range if they care */
+static DasDesc* _DasStream_slot(const DasStream* pThis, int nPktId)
+{
+	if((nPktId < 1)||(nPktId >= pThis->nDescSz)) return NULL;
+	return pThis->lDescs[nPktId];
+}
+
+/* Put a descriptor in an empty slot, growing the table as needed */
+static DasErrCode _DasStream_setSlot(DasStream* pThis, int nPktId, DasDesc* pDesc)
+{
+	assert((nPktId > 0)&&(nPktId < MAX_PKTIDS));
+	assert(_DasStream_slot(pThis, nPktId) == NULL);
+
+	int nPrev = _DasStream_revFind(pThis, pDesc);
+	if(nPrev > 0)
+		return das_error(DASERR_STREAM, "Descriptor is already attached to the "
+		                 "stream with ID %d", nPrev);
+
+	if(nPktId >= pThis->nDescSz){
+		int nNewSz = pThis->nDescSz ? pThis->nDescSz : 16;
+		while(nNewSz <= nPktId) nNewSz *= 2;
+		if(nNewSz > MAX_PKTIDS) nNewSz = MAX_PKTIDS;
+
+		DasDesc** lNew = (DasDesc**)realloc(pThis->lDescs, nNewSz * sizeof(DasDesc*));
+		if(lNew == NULL)
+			return das_error(DASERR_STREAM, "Couldn't grow descriptor table to %d "
+			                 "entries", nNewSz);
+		memset(lNew + pThis->nDescSz, 0, (nNewSz - pThis->nDescSz)*sizeof(DasDesc*));
+		pThis->lDescs = lNew;
+		pThis->nDescSz = nNewSz;
+	}
+
+	DasErrCode nRet = _DasStream_revAdd(pThis, pDesc, nPktId);
+	if(nRet != DAS_OKAY) return nRet;
+
+	pThis->lDescs[nPktId] = pDesc;
+	++(pThis->uDescs);
+	return DAS_OKAY;
+}
+
+/* Empty a slot, returning whatever was there */
+static DasDesc* _DasStream_clearSlot(DasStream* pThis, int nPktId)
+{
+	DasDesc* pDesc = _DasStream_slot(pThis, nPktId);
+	if(pDesc == NULL) return NULL;
+
+	_DasStream_revDel(pThis, pDesc);
+	pThis->lDescs[nPktId] = NULL;
+	--(pThis->uDescs);
+	return pDesc;
+}
+
+/* das2 headers carry two digit IDs, das3 datasets can use the whole range */
+static int _DasStream_maxId(const DasDesc* pDesc)
+{
+	return (pDesc->type == PACKET) ? 99 : (MAX_PKTIDS - 1);
+}
+
 /* ************************************************************************** */
 /* Construction */
 
@@ -93,8 +249,8 @@ void del_DasStream(DasStream* pThis){
 
 	// Only delete the items I own! 
 
-	for(size_t u = 1; u < MAX_PKTIDS; u++){
-		DasDesc* pDesc = pThis->descriptors[u];
+	for(int i = 1; i < pThis->nDescSz; ++i){
+		DasDesc* pDesc = pThis->lDescs[i];
 		if(pDesc == NULL)
 			continue;
 		if(pDesc->type == PACKET){
@@ -107,6 +263,8 @@ void del_DasStream(DasStream* pThis){
 				del_DasDs((DasDs*)pDesc);
 		}
 	}
+	free(pThis->lDescs);
+	free(pThis->lRevIdx);
 	free(pThis);
 }
 
@@ -184,18 +342,20 @@ void DasStream_setMonotonic(DasStream* pThis, bool isMonotonic )
 
 size_t DasStream_getNPktDesc(const DasStream* pThis)
 {
-	size_t nRet = 0;
-	for(size_t u = 1; u < MAX_PKTIDS; u++) if(pThis->descriptors[u]) nRet++;
-	return nRet;
+	return pThis->uDescs;
 }
 
 int DasStream_nextPktId(DasStream* pThis)
 {
-	for (int i = 1; i < MAX_PKTIDS; ++i){ /* 00 is reserved for stream descriptor */
-		if(pThis->descriptors[i] == NULL) 
+	for (int i = 1; i < pThis->nDescSz; ++i){ /* 00 is reserved for stream descriptor */
+		if(pThis->lDescs[i] == NULL) 
 			return i;
 	}
-	return -1 * das_error(DASERR_STREAM, "Ran out of Packet IDs only 99 allowed!" );
+	if(pThis->nDescSz < MAX_PKTIDS)
+		return (pThis->nDescSz < 1) ? 1 : pThis->nDescSz;
+
+	return -1 * das_error(DASERR_STREAM, "Ran out of Packet IDs only %d allowed!",
+	                      MAX_PKTIDS - 1);
 }
 
 PktDesc* DasStream_createPktDesc(
@@ -203,13 +363,22 @@ PktDesc* DasStream_createPktDesc(
 ){
 	PktDesc* pPkt;
 
+	int id = DasStream_nextPktId(pThis);
+	if((id < 1)||(id > 99)){
+		das_error(DASERR_STREAM, "Ran out of das2 packet IDs, only 99 allowed!");
+		return NULL;
+	}
+
 	pPkt= new_PktDesc();
-	pPkt->id= DasStream_nextPktId(pThis);
+	pPkt->id= id;
 	pPkt->base.parent=(DasDesc*)pThis;
 	 
 	PlaneDesc* pX = new_PlaneDesc(X, "", pXEncoder, xUnits);
 	PktDesc_addPlane(pPkt, pX);
-	pThis->descriptors[pPkt->id] = (DasDesc*) pPkt;
+	if(_DasStream_setSlot(pThis, id, (DasDesc*) pPkt) != DAS_OKAY){
+		del_PktDesc(pPkt);
+		return NULL;
+	}
 	
 	return pPkt;
 }
@@ -220,12 +389,11 @@ DasErrCode DasStream_freeDatDesc(DasStream* pThis, int nPktId)
 		return das_error(DASERR_STREAM, "%s: stream contains no descriptor for packets "
 		                  "with id %d", __func__, nPktId);
 
-	DasDesc* pDesc = pThis->descriptors[nPktId];
+	DasDesc* pDesc = _DasStream_clearSlot(pThis, nPktId);
 	if(pDesc->type == PACKET)
 		del_PktDesc((PktDesc*)pDesc);
 	else
 		del_DasDs((DasDs*)pDesc);
-	pThis->descriptors[nPktId]= NULL;
 	
 	return DAS_OKAY;
 }
@@ -238,7 +406,7 @@ PktDesc* DasStream_getPktDesc(const DasStream* pThis, int nPacketId)
 		);
 		return NULL;
 	}
-	DasDesc* pDesc = pThis->descriptors[nPacketId];
+	DasDesc* pDesc = _DasStream_slot(pThis, nPacketId);
 	return (pDesc == NULL)||(pDesc->type != PACKET) ? NULL : (PktDesc*)pDesc;
 }
 
@@ -250,20 +418,13 @@ DasDesc* DasStream_getDesc(const DasStream* pThis, int nPacketId)
 		);
 		return NULL;
 	}
-	return pThis->descriptors[nPacketId]; /* any type is okay */
+	return _DasStream_slot(pThis, nPacketId); /* any type is okay */
 }
 
 int DasStream_getPktId(DasStream* pThis, const DasDesc* pDesc)
 {
-	/* Linear search for now, but small vector assumption may no always hold
-	   in the future */
-
-	/* 0 is never a container ID */
-	for(int i = 1; i < MAX_PKTIDS; ++i){
-		if((pThis->descriptors[i] != NULL)&&(pThis->descriptors[i] == pDesc))
-			return i;
-	}
-	return -1;
+	/* 0 is never a container ID, so a miss is always negative */
+	return _DasStream_revFind(pThis, pDesc);
 }
 
 
@@ -274,10 +435,10 @@ DasDesc* DasStream_nextDesc(const DasStream* pThis, int* pPrevPktId)
 		das_error(DASERR_STREAM, "Illegal descriptor value %d", nBeg);
 		return NULL;
 	}
-	for(int i = nBeg; i < MAX_PKTIDS; ++i){
-		if(pThis->descriptors[i] != NULL){
+	for(int i = nBeg; i < pThis->nDescSz; ++i){
+		if(pThis->lDescs[i] != NULL){
 			*pPrevPktId = i;
-			return pThis->descriptors[i];
+			return pThis->lDescs[i];
 		}
 	}
 	return NULL;
@@ -316,13 +477,22 @@ PktDesc* DasStream_clonePktDesc(DasStream* pThis, const PktDesc* pPdIn)
 {
 	PktDesc* pPdOut;
 
+	int id = DasStream_nextPktId( pThis );
+	if((id < 1)||(id > 99)){
+		das_error(DASERR_STREAM, "Ran out of das2 packet IDs, only 99 allowed!");
+		return NULL;
+	}
+
 	pPdOut= (PktDesc*)calloc(1, sizeof(PktDesc));
 	pPdOut->base.type = pPdIn->base.type;
 	 
 	DasDesc_copyIn((DasDesc*)pPdOut, (DasDesc*)pPdIn);
 	 
-	int id = DasStream_nextPktId( pThis );
-	pThis->descriptors[id] = (DasDesc*)pPdOut;
+	if(_DasStream_setSlot(pThis, id, (DasDesc*)pPdOut) != DAS_OKAY){
+		DasDesc_freeProps((DasDesc*)pPdOut);
+		free(pPdOut);
+		return NULL;
+	}
 
 	pPdOut->id = id;
 	 
@@ -333,10 +503,7 @@ PktDesc* DasStream_clonePktDesc(DasStream* pThis, const PktDesc* pPdIn)
 
 bool DasStream_isValidId(const DasStream* pThis, int nPktId)
 {
-	if(nPktId > 0 && nPktId < MAX_PKTIDS){
-		if(pThis->descriptors[nPktId] != NULL) return true;
-	}
-	return false;
+	return (_DasStream_slot(pThis, nPktId) != NULL);
 }
 
 PktDesc* DasStream_clonePktDescById(
@@ -346,7 +513,9 @@ PktDesc* DasStream_clonePktDescById(
 
 	pIn = DasStream_getPktDesc(pOther, nPacketId);
 
-	if(pThis->descriptors[pIn->id] != NULL){
+	if(pIn == NULL) return NULL;
+
+	if(_DasStream_slot(pThis, pIn->id) != NULL){
 		das_error(DASERR_STREAM, "ERROR: Stream descriptor already has a packet "
 		                "descriptor with id %d", nPacketId); 
 		return NULL;
@@ -358,7 +527,10 @@ PktDesc* DasStream_clonePktDescById(
 	DasDesc_copyIn((DasDesc*)pOut, (DasDesc*)pIn);
 	
 	pOut->id = pIn->id;
-	pThis->descriptors[pIn->id] = (DasDesc*)pOut;
+	if(_DasStream_setSlot(pThis, pIn->id, (DasDesc*)pOut) != DAS_OKAY){
+		del_PktDesc(pOut);
+		return NULL;
+	}
 	
 	PktDesc_copyPlanes(pOut, pIn); /* Realloc's the data buffer */
 		
@@ -388,23 +560,24 @@ DasErrCode DasStream_addDesc(DasStream* pThis, DasDesc* pDesc, int nPktId)
 	
 	/* Check uniqueness */
 	if(pDesc->parent == (DasDesc*)pThis){
-		for(int i = 0; i < MAX_PKTIDS; ++i)
-			if(pThis->descriptors[i] != NULL)
-				if(pThis->descriptors[i]->type == PACKET)
-					if(PktDesc_equalFormat((PktDesc*)pDesc, (PktDesc*)(pThis->descriptors[i])))
+		for(int i = 1; i < pThis->nDescSz; ++i)
+			if(pThis->lDescs[i] != NULL)
+				if(pThis->lDescs[i]->type == PACKET)
+					if(PktDesc_equalFormat((PktDesc*)pDesc, (PktDesc*)(pThis->lDescs[i])))
 						return das_error(DASERR_STREAM, 
 							"Packet Descriptor is already part of the stream"
 						);
 	}
 	
-	if(nPktId < 1 || nPktId > 99)
+	if(nPktId < 1 || nPktId > _DasStream_maxId(pDesc))
 		return das_error(DASERR_STREAM, "Illegal packet id: %02d", nPktId);
 	
-	if(pThis->descriptors[nPktId] != NULL) 
+	if(_DasStream_slot(pThis, nPktId) != NULL) 
 		return das_error(DASERR_STREAM, "DasStream already has a packet descriptor with ID"
 				" %02d", nPktId);
 	
-	pThis->descriptors[nPktId] = pDesc;
+	DasErrCode nRet = _DasStream_setSlot(pThis, nPktId, pDesc);
+	if(nRet != DAS_OKAY) return nRet;
 
 	/* If this is an old-sckool packet descriptor, set it's ID */
 	if(pDesc->type == PACKET)
@@ -425,23 +598,24 @@ DasErrCode DasStream_shadowPktDesc(DasStream* pThis, DasDesc* pDesc, int nPktId)
 	
 	/* Check uniqueness */
 	if(pDesc->parent == (DasDesc*)pThis){
-		for(int i = 0; i < MAX_PKTIDS; ++i)
-			if(pThis->descriptors[i] != NULL)
-				if(pThis->descriptors[i]->type == PACKET)
-					if(PktDesc_equalFormat((PktDesc*)pDesc, (PktDesc*)(pThis->descriptors[i])))
+		for(int i = 1; i < pThis->nDescSz; ++i)
+			if(pThis->lDescs[i] != NULL)
+				if(pThis->lDescs[i]->type == PACKET)
+					if(PktDesc_equalFormat((PktDesc*)pDesc, (PktDesc*)(pThis->lDescs[i])))
 						return das_error(DASERR_STREAM, 
 							"Packet Descriptor is already part of the stream"
 						);
 	}
 	
-	if(nPktId < 1 || nPktId > 99)
+	if(nPktId < 1 || nPktId > _DasStream_maxId(pDesc))
 		return das_error(DASERR_STREAM, "Illegal packet id: %02d", nPktId);
 	
-	if(pThis->descriptors[nPktId] != NULL) 
+	if(_DasStream_slot(pThis, nPktId) != NULL) 
 		return das_error(DASERR_STREAM, "DasStream already has a packet descriptor with ID"
 				" %02d", nPktId);
 	
-	pThis->descriptors[nPktId] = pDesc;
+	DasErrCode nRet = _DasStream_setSlot(pThis, nPktId, pDesc);
+	if(nRet != DAS_OKAY) return nRet;
 
 	return 0;
 }
@@ -453,24 +627,20 @@ DasErrCode DasStream_takePktDesc(DasStream* pThis, DasDesc* pDesc, int nPktId)
 	// Try lookup by address
 	if(pDesc != NULL){
 
-		// More unnecessary loops, need to erradicate this way of tracking owned objects!
-		// I inherited it, but it's way past it sale date.  --cwp
-		for(int i = 0; i < MAX_PKTIDS; ++i){
-			if(pThis->descriptors[i] == pDesc){
-				pDesc->parent = (DasDesc*) pThis;
-				return 0;
-			}
+		if(_DasStream_revFind(pThis, pDesc) > 0){
+			pDesc->parent = (DasDesc*) pThis;
+			return 0;
 		}
 		return das_error(DASERR_STREAM, "Could not find packet descriptor in tracking array");
 	}
 
-	if(nPktId < 1 || nPktId > 99)
+	if(nPktId < 1 || nPktId > (MAX_PKTIDS-1))
 		return das_error(DASERR_STREAM, "Illegal packet id: %02d", nPktId);
 
-	if(pThis->descriptors[nPktId] == NULL)
+	if(_DasStream_slot(pThis, nPktId) == NULL)
 		return das_error(DASERR_STREAM, "Packet ID slot %02d points to nothing", nPktId);
 
-	pThis->descriptors[nPktId]->parent = (DasDesc*) pThis;
+	pThis->lDescs[nPktId]->parent = (DasDesc*) pThis;
 
 	return 0;
 }
@@ -487,26 +657,24 @@ DasErrCode DasStream_rmPktDesc(DasStream* pThis, DasDesc* pDesc, int nPktId)
 		if((pDesc->parent != (DasDesc*)pThis))
 			return das_error(DASERR_STREAM, "Descriptor dosen't belong to this stream");
 
-		for(int i = 0; i < MAX_PKTIDS; ++i){
-			if(pThis->descriptors[i] == pDesc){
-				pThis->descriptors[i] = NULL;  /* Detach both ways */
-				pDesc->parent = NULL;
-				return DAS_OKAY;
-			}
+		int nId = _DasStream_revFind(pThis, pDesc);
+		if(nId > 0){
+			_DasStream_clearSlot(pThis, nId);  /* Detach both ways */
+			pDesc->parent = NULL;
+			return DAS_OKAY;
 		}
 
 		return das_error(DASERR_STREAM, "Descriptor is not part of this stream");
 	}
 
-	if(nPktId < 1 || nPktId > 99)
+	if(nPktId < 1 || nPktId > (MAX_PKTIDS-1))
 		return das_error(DASERR_STREAM, "Illegal packet id: %02d", nPktId);
 
-	if(pThis->descriptors[nPktId] == NULL)
+	if(_DasStream_slot(pThis, nPktId) == NULL)
 		return das_error(DASERR_STREAM, "Stream has not descriptor for packet id: %02d", nPktId);
 	
-	pDesc = pThis->descriptors[nPktId];
+	pDesc = _DasStream_clearSlot(pThis, nPktId);
 	pDesc->parent = NULL;
-	pThis->descriptors[nPktId] = NULL;
 
 	return DAS_OKAY;
 }
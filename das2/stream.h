@@ -39,7 +39,12 @@ extern "C" {
 #define STREAMDESC_VER_SZ 48
 #define STREAMDESC_TYPE_SZ 48
 
-#define MAX_PKTIDS 100
+/** One more than the largest legal descriptor ID on any stream.
+ *
+ * The descriptor table inside DasStream grows on demand, so this is only
+ * an upper bound on the ID space, not a storage size.  das2 serializations
+ * still restrict IDs to 1 to 99 since headers carry two digits. */
+#define MAX_PKTIDS 65536
 #define MAX_FRAMES 12  /* <-- if drastically increased, update _newFrameId() */
 
 
@@ -93,16 +98,17 @@ typedef struct das_stream{
 	/** The base structure */
 	DasDesc base;
 
-   /* TODO: Replace this with a sorted array of structures of the type
-
-         {int id, DasDesc* pDesc}
+	/* Descriptor table, indexed by packet ID.  Grows on demand so that
+	   streams with hundreds of packet types don't pay for a fixed maximum,
+	   use DasStream_getDesc() or DasStream_nextDesc() to read it. */
+	DasDesc** lDescs;
+	int nDescSz;         /* Allocated slots in lDescs */
+	size_t uDescs;       /* Number of non-NULL slots in lDescs */
 
-      and use sorted insert and binary search to retrieve packet IDs 
-      if greater then say 10.  For 10 or less the "small vector" 
-      assumption applies and we just an embedded 10-element array 
-      and loops.
-   */
-	DasDesc* descriptors[MAX_PKTIDS];
+	/* Reverse index, descriptor address to packet ID.  Open addressing with
+	   linear probing, always a power of 2 in size and at most half full. */
+	struct das_desc_slot* lRevIdx;
+	size_t uRevSz;
 
    /** List of defined coordinate frames */
    DasFrame* frames[MAX_FRAMES];
@@ -212,9 +218,8 @@ DAS_API void del_DasStream(DasStream* pThis);
  * @param pThis The stream descriptor to query
  * 
  * @return Then number of packet descriptors attached to this stream
- *         descriptor.  For better performance the caller should reused the 
- *         return value as all possible packet ID's are tested to see home many
- *         are defined.
+ *         descriptor.  The count is maintained as descriptors are added and
+ *         removed so this call is cheap.
  * 
  * @memberof DasStream
  */
@@ -476,7 +481,7 @@ DAS_API bool DasStream_isValidId(const DasStream* pThis, int nPktId);
 /** Get the packet descriptor associated with an ID.
  *
  * @param pThis The stream object which contains the packet descriptors.
- * @param id The numeric packet ID, a value from 1 to 99 inclusive.
+ * @param id The numeric packet ID, a value from 1 to MAX_PKTIDS - 1.
  *
  * @returns NULL if there is no packet descriptor associated with the
  *          given Packet ID
@@ -489,8 +494,7 @@ DAS_API PktDesc* DasStream_getPktDesc(const DasStream* pThis, int id);
 /** Get any descriptor associated with a packet ID.
  * 
  * @param pThis The stream object which contains the packet descriptors.
- * @param id The numberic packet ID, currently a value from 1 to 99 inclusive
- * @todo: Increase packet ID spice to ushort (1 to 2^16)
+ * @param id The numberic packet ID, a value from 1 to MAX_PKTIDS - 1
  * @returns NULL if there is no descriptor associated with the
  *          given Packet ID.  It is up to the caller to determin the 
  *          descriptor type
@@ -504,8 +508,8 @@ DAS_API DasDesc* DasStream_getDesc(const DasStream* pThis, int id);
  * 
  * @param pDesc The owned object descriptor
  * 
- * @returns A number between 1 and MAX_PKTIDS, or -1 if the object is not
- *        owned by this stream.  The returned object may be a PktDesc or 
+ * @returns A number between 1 and MAX_PKTIDS - 1, or -1 if the object is not
+ *        owned by this stream.  This is a constant time hash lookup.  The returned object may be a PktDesc or 
  *        a DasDs.
  * 
  * @membefof DasStream
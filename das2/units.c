@@ -29,6 +29,7 @@
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #ifdef _WIN32
 #define strcasecmp _stricmp
@@ -155,18 +156,159 @@ const char* g_sSiSymbol[] = {
 /* ******************************************************************** */
 /* Global units array initialization */
 
-/* This is the global units array.  */
+/* The global unit registry.  Units are singleton strings, kept in order of
+ * first definition in a list of segments that never move, and found by string
+ * through a hash table of keys.  Keys may be a unit's own string or an alias
+ * string that Units_fromStr() found to be equivalent.
+ *
+ * Lookups take no lock.  Writers hold g_mtxUnits, fill in new entries first
+ * and then publish them with release stores, so a reader either sees a
+ * complete entry or no entry.  A reader that misses retries under the lock.
+ * Hash tables are replaced when they grow, old tables and all strings are
+ * kept for the life of the program since readers may still be using them.
+ */
 
 /* WARNING: Units are not necessarily stored in the most reduced form.  It is
  * first come, first serve, on defining the arrangement of components in a unit
  * string. */
-#define NUM_UNITS 127
-const char* g_lUnits[NUM_UNITS+1] = {NULL};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _UNIT_LOAD(X)     __atomic_load_n(&(X), __ATOMIC_ACQUIRE)
+#define _UNIT_STORE(X, V) __atomic_store_n(&(X), (V), __ATOMIC_RELEASE)
+#else
+/* Other compilers target x86/x64 here, which doesn't reorder stores with
+   other stores or loads with other loads */
+#define _UNIT_LOAD(X)     (X)
+#define _UNIT_STORE(X, V) ((X) = (V))
+#endif
+
+#define _UNIT_SEG0   64   /* Size of the first list segment, each one doubles */
+#define _UNIT_NSEG   24
+
+static das_units* g_aUnitSeg[_UNIT_NSEG] = {NULL};
+static size_t g_uUnits = 0;
+
+typedef struct unit_key {
+	const char* sKey;
+	int iUnit;
+} unit_key;
+
+typedef struct unit_tbl {
+	size_t uMask;
+	size_t uUsed;
+	const unit_key* aSlot[];
+} unit_tbl;
+
+static unit_tbl* g_pUnitTbl = NULL;
 
 pthread_mutex_t g_mtxUnits;
 
+static size_t _Units_hash(const char* sKey)
+{
+	size_t uHash = 2166136261u;
+	for(const unsigned char* p = (const unsigned char*)sKey; *p != '\0'; ++p){
+		uHash ^= *p;
+		uHash *= 16777619u;
+	}
+	return uHash;
+}
+
+/* Get a unit by definition order, i must be less than the published count */
+static das_units _Units_at(int i)
+{
+	size_t uBeg = 0, uSz = _UNIT_SEG0;
+	int k = 0;
+	while((size_t)i >= uBeg + uSz){ uBeg += uSz; uSz <<= 1; ++k; }
+	das_units* pSeg = _UNIT_LOAD(g_aUnitSeg[k]);
+	return pSeg[i - uBeg];
+}
+
+/* Lock free key lookup, returns the unit index or -1 */
+static int _Units_find(const char* sKey)
+{
+	unit_tbl* pTbl = _UNIT_LOAD(g_pUnitTbl);
+	if(pTbl == NULL) return -1;
+
+	const unit_key* pKey;
+	for(size_t i = _Units_hash(sKey) & pTbl->uMask; ; i = (i + 1) & pTbl->uMask){
+		if((pKey = _UNIT_LOAD(pTbl->aSlot[i])) == NULL) return -1;
+		if(strcmp(pKey->sKey, sKey) == 0) return pKey->iUnit;
+	}
+}
+
+/* Append a unit to the ordered list, call with the lock held */
+static int _Units_append(das_units units)
+{
+	size_t uIdx = g_uUnits;
+	size_t uBeg = 0, uSz = _UNIT_SEG0;
+	int k = 0;
+	while(uIdx >= uBeg + uSz){ uBeg += uSz; uSz <<= 1; ++k; }
+	if((k >= _UNIT_NSEG)||(uIdx > 0x7FFFFFFF)){
+		das_error(DASERR_UNITS, "Unit registry is full");
+		return -1*DASERR_UNITS;
+	}
+
+	if(g_aUnitSeg[k] == NULL){
+		das_units* pSeg = (das_units*)calloc(uSz, sizeof(das_units));
+		if(pSeg == NULL){
+			das_error(DASERR_UNITS, "Couldn't allocate unit registry memory");
+			return -1*DASERR_UNITS;
+		}
+		_UNIT_STORE(g_aUnitSeg[k], pSeg);
+	}
+	g_aUnitSeg[k][uIdx - uBeg] = units;
+	_UNIT_STORE(g_uUnits, uIdx + 1);
+	return (int)uIdx;
+}
+
+/* Add a lookup key for a unit, call with the lock held.  The key string must
+ * live for the life of the program. */
+static bool _Units_addKey(const char* sKey, int iUnit)
+{
+	unit_tbl* pTbl = g_pUnitTbl;
+	size_t i;
+
+	/* Grow at half full, short probe runs matter more than memory here */
+	if((pTbl == NULL)||((pTbl->uUsed + 1)*2 > pTbl->uMask + 1)){
+		size_t uSz = (pTbl == NULL) ? 128 : (pTbl->uMask + 1)*2;
+		unit_tbl* pNew = (unit_tbl*)calloc(1, sizeof(unit_tbl) + uSz*sizeof(unit_key*));
+		if(pNew == NULL){
+			das_error(DASERR_UNITS, "Couldn't allocate unit registry memory");
+			return false;
+		}
+		pNew->uMask = uSz - 1;
+		if(pTbl != NULL){
+			for(size_t u = 0; u <= pTbl->uMask; ++u){
+				if(pTbl->aSlot[u] == NULL) continue;
+				i = _Units_hash(pTbl->aSlot[u]->sKey) & pNew->uMask;
+				while(pNew->aSlot[i] != NULL) i = (i + 1) & pNew->uMask;
+				pNew->aSlot[i] = pTbl->aSlot[u];
+			}
+			pNew->uUsed = pTbl->uUsed;
+		}
+		_UNIT_STORE(g_pUnitTbl, pNew);   /* old table is left for readers */
+		pTbl = pNew;
+	}
+
+	unit_key* pKey = (unit_key*)malloc(sizeof(unit_key));
+	if(pKey == NULL){
+		das_error(DASERR_UNITS, "Couldn't allocate unit registry memory");
+		return false;
+	}
+	pKey->sKey = sKey;
+	pKey->iUnit = iUnit;
+
+	i = _Units_hash(sKey) & pTbl->uMask;
+	while(pTbl->aSlot[i] != NULL) i = (i + 1) & pTbl->uMask;
+	++(pTbl->uUsed);
+	_UNIT_STORE(pTbl->aSlot[i], (const unit_key*)pKey);
+	return true;
+}
+
 bool units_init(const char* sProgName)
 {
+	if(_UNIT_LOAD(g_uUnits) > 0) return true;   /* Already initialized */
+
 	pthread_mutexattr_t attr;
 	pthread_mutexattr_init(&attr);
 #ifndef NDEBUG
@@ -174,67 +316,71 @@ bool units_init(const char* sProgName)
 #endif
 	if( pthread_mutex_init(&g_mtxUnits, &attr) != 0) return false;
 
-	g_lUnits[0] = UNIT_US2000;
-	g_lUnits[1] = UNIT_MJ1958;
-	g_lUnits[2] = UNIT_T2000;
-	g_lUnits[3] = UNIT_T1970;
-	g_lUnits[4] = UNIT_NS1970;
-	g_lUnits[5] = UNIT_UTC;
-	g_lUnits[6] = UNIT_TT2000;
-	g_lUnits[7] = UNIT_ET2000;
-	g_lUnits[8] = UNIT_MILLISECONDS;
-	g_lUnits[9] = UNIT_MICROSECONDS;
-	g_lUnits[10] = UNIT_NANOSECONDS;
-	g_lUnits[11] = UNIT_SECONDS;
-	g_lUnits[12] = UNIT_HOURS;
-	g_lUnits[13] = UNIT_DAYS;
-	g_lUnits[14] = UNIT_HERTZ;
-	g_lUnits[15] = UNIT_KILO_HERTZ;
-	g_lUnits[16] = UNIT_MEGA_HERTZ;
-	g_lUnits[17] = UNIT_E_SPECDENS;
-	g_lUnits[18] = UNIT_B_SPECDENS;
-	g_lUnits[19] = UNIT_NT;
-	g_lUnits[20] = UNIT_NUMBER_DENS;
-	g_lUnits[21] = UNIT_DB;
-	g_lUnits[22] = UNIT_KM;
-	g_lUnits[23] = UNIT_EV;
-	g_lUnits[24] = UNIT_DIMENSIONLESS;
-	g_lUnits[25] = NULL;
+	das_units aBuiltIn[] = {
+		UNIT_US2000, UNIT_MJ1958, UNIT_T2000, UNIT_T1970, UNIT_NS1970, UNIT_UTC,
+		UNIT_TT2000, UNIT_ET2000, UNIT_MILLISECONDS, UNIT_MICROSECONDS,
+		UNIT_NANOSECONDS, UNIT_SECONDS, UNIT_HOURS, UNIT_DAYS, UNIT_HERTZ,
+		UNIT_KILO_HERTZ, UNIT_MEGA_HERTZ, UNIT_E_SPECDENS, UNIT_B_SPECDENS,
+		UNIT_NT, UNIT_NUMBER_DENS, UNIT_DB, UNIT_KM, UNIT_EV, UNIT_DIMENSIONLESS
+	};
+
+	pthread_mutex_lock(&g_mtxUnits);
+	for(size_t u = 0; u < sizeof(aBuiltIn)/sizeof(das_units); ++u){
+		int iUnit = _Units_append(aBuiltIn[u]);
+		if((iUnit < 0)||(!_Units_addKey(aBuiltIn[u], iUnit))){
+			pthread_mutex_unlock(&g_mtxUnits);
+			return false;
+		}
+	}
+	pthread_mutex_unlock(&g_mtxUnits);
 		
 	return true;
 }
 
 int _Units_getUnique(const char* string)
 {
-	int i = 0;
-	for(i = 0; g_lUnits[i] != NULL && i < NUM_UNITS; i++)
-		if(strcmp(string, g_lUnits[i]) == 0) return i;
+	int i = _Units_find(string);
+	if(i >= 0) return i;
 	
 	/* Get the global units lock */
 	pthread_mutex_lock(&g_mtxUnits);
 	
 	/* Now check a second time, units could have been added while we
 	 * were waiting */
-	for(i = 0; g_lUnits[i] != NULL && i < NUM_UNITS; i++){
-		if(strcmp(string, g_lUnits[i]) == 0){ 
-			pthread_mutex_unlock(&g_mtxUnits);
-			return i;
-		}
-	}
-	
-	if(i < NUM_UNITS - 1){
-		/* Not free'ed for life of program and we don't care */
-		char* sHeap = (char*)calloc(strlen(string) + 1, sizeof(char));
-		strncpy(sHeap, string, strlen(string));
-		g_lUnits[i] = sHeap;
+	if((i = _Units_find(string)) >= 0){
 		pthread_mutex_unlock(&g_mtxUnits);
 		return i;
 	}
 	
+	/* Not free'ed for life of program and we don't care */
+	char* sHeap = (char*)calloc(strlen(string) + 1, sizeof(char));
+	if(sHeap == NULL){
+		pthread_mutex_unlock(&g_mtxUnits);
+		das_error(DASERR_UNITS, "Couldn't allocate unit registry memory");
+		return -1*DASERR_UNITS;
+	}
+	strncpy(sHeap, string, strlen(string));
+
+	if(((i = _Units_append(sHeap)) >= 0) && !_Units_addKey(sHeap, i))
+		i = -1*DASERR_UNITS;
+
+	pthread_mutex_unlock(&g_mtxUnits);
+	return i;
+}
+
+/* Remember that a string is another name for an existing unit */
+static void _Units_addAlias(const char* sAlias, int iUnit)
+{
+	pthread_mutex_lock(&g_mtxUnits);
+	if(_Units_find(sAlias) < 0){
+		size_t uLen = strlen(sAlias);
+		char* sHeap = (char*)calloc(uLen + 1, sizeof(char));
+		if(sHeap != NULL){
+			memcpy(sHeap, sAlias, uLen);
+			if(!_Units_addKey(sHeap, iUnit)) free(sHeap);
+		}
+	}
 	pthread_mutex_unlock(&g_mtxUnits);
-	das_error(DASERR_UNITS, "Out of space for user defined units, only %d different "
-	           "unit types supported in a single program", NUM_UNITS - 1);
-	return -1*DASERR_UNITS;
 }
 
 /* ********************************************************************* */
@@ -828,7 +974,7 @@ das_units Units_invert(das_units unit) {
 	qsort(aComp, nComp, sizeof(struct base_unit), _Units_positiveFirst);
 	
 	int iUnit = _Units_fromCompAry(aComp, nComp);
-	return (iUnit < 0) ? NULL : g_lUnits[iUnit];
+	return (iUnit < 0) ? NULL : _Units_at(iUnit);
 }
 
 void _Units_accumPowers(struct base_unit* pBase, const struct base_unit* pAdd)
@@ -926,7 +1072,7 @@ das_units Units_multiply(das_units ut1, das_units ut2)
 	qsort(comp3, len3, sizeof(struct base_unit), _Units_positiveFirst);
 
 	int iUnit = _Units_fromCompAry(comp3, len3);
-	return (iUnit < 0) ? NULL : g_lUnits[iUnit];
+	return (iUnit < 0) ? NULL : _Units_at(iUnit);
 }
 
 das_units Units_power(das_units unit, int power)
@@ -953,7 +1099,7 @@ das_units Units_power(das_units unit, int power)
 	qsort(comp, len, sizeof(struct base_unit), _Units_positiveFirst);
 	
 	int iUnit = _Units_fromCompAry(comp, len);
-	return (iUnit < 0) ? NULL : g_lUnits[iUnit];
+	return (iUnit < 0) ? NULL : _Units_at(iUnit);
 }
 
 das_units Units_root(das_units unit, int root)
@@ -982,7 +1128,7 @@ das_units Units_root(das_units unit, int root)
 	qsort(comp, len, sizeof(struct base_unit), _Units_positiveFirst);
 	
 	int iUnit = _Units_fromCompAry(comp, len);
-	return (iUnit < 0) ? NULL : g_lUnits[iUnit];
+	return (iUnit < 0) ? NULL : _Units_at(iUnit);
 }
 
 das_units Units_divide(das_units a, das_units b)
@@ -1381,7 +1527,7 @@ das_units Units_reduce(das_units orig, double* pFactor){
 	*pFactor = _Units_reduce(aComp, &nComp);
 	
 	int iUnit = _Units_fromCompAry(aComp, nComp);
-	return (iUnit < 0) ? NULL : g_lUnits[iUnit];
+	return (iUnit < 0) ? NULL : _Units_at(iUnit);
 }
 
 /* ************************************************************************** */
@@ -1400,7 +1546,7 @@ das_units Units_fromStr(const char* string)
 	strncpy(sBuf, string, _MAX_NUM_COMP*(_COMP_MAX_NAME+_COMP_MAX_EXP+3));
 	
 	/* Initialize our list if this is the first time */
-	if(g_lUnits[0] == NULL){
+	if(_UNIT_LOAD(g_uUnits) == 0){
 		das_error(DASERR_INIT, "Call das_init() before using Units functions");
 		return NULL;
 	}
@@ -1435,9 +1581,8 @@ das_units Units_fromStr(const char* string)
 	 * general unicode decomposition */
 	
 	/* See if this exact unit string was hit before */
-	int i = 0;
-	for(i = 0; g_lUnits[i] != NULL && i < NUM_UNITS; i++)
-		if(strcmp(sBuf, g_lUnits[i]) == 0) return g_lUnits[i];
+	int i = _Units_find(sBuf);
+	if(i >= 0) return _Units_at(i);
 		
 	/* Well, can't avoid general unit parsing now.  See if the reduced form of
 	 * any units are equivalent to the reduced form of these units */
@@ -1457,26 +1602,32 @@ das_units Units_fromStr(const char* string)
 	struct base_unit lOther[_MAX_NUM_COMP];
 	int nOther = 0;
 	double rOtherFactor = 0;
-	for(i = 0; g_lUnits[i] != NULL && i < NUM_UNITS; ++i){
+	das_units other;
+	int nUnits = (int)_UNIT_LOAD(g_uUnits);
+	for(i = 0; i < nUnits; ++i){
+		other = _Units_at(i);
 		
-		if(Units_isInterval(g_lUnits[i])) continue;
+		if(Units_isInterval(other)) continue;
 		
-		nOther = _Units_strToComponents(g_lUnits[i], lOther, _MAX_NUM_COMP);
+		nOther = _Units_strToComponents(other, lOther, _MAX_NUM_COMP);
 		
 		if(nOther != nReduced) continue;
 		
 		rOtherFactor = _Units_reduce(lOther, &nOther);
 		if(rOtherFactor != rReduceFactor) continue;
 		
-		if( _Units_reducedEqual(lReduced, lOther, nOther))
-			return g_lUnits[i];
+		if( _Units_reducedEqual(lReduced, lOther, nOther)){
+			/* Next time this spelling is a single lookup */
+			_Units_addAlias(sBuf, i);
+			return other;
+		}
 	}
 	
 	/* Nope, these are completely new, make new using string that preserves the
 	 * original order.  Ideally we would collapse units all the units we could
 	 * while preserving a scaling factor of 1.0 at this point. */
 	int iUnit = _Units_fromCompAry(lComp, nComp);
-	return (iUnit < 0) ? NULL : g_lUnits[iUnit];
+	return (iUnit < 0) ? NULL : _Units_at(iUnit);
 }
 
 
@@ -1600,31 +1751,52 @@ double _Units_convertFromUS2000( double value, das_units toUnits ) {
 }
 
 
-double Units_convertTo(das_units to, double rFrom, das_units from)
+/* Epoch scales that are a fixed linear transform of us2000:
+ *   us2000 = rA * value + rB
+ * TT2000 and ET2000 include leap seconds and are not linear. */
+static bool _Units_epochLinear(das_units units, double* pA, double* pB)
 {
-	/* Check for same units */
-	if((to == NULL) && (from == NULL)) 
-		return rFrom;
-	if((to != NULL) && (from != NULL) && (strcmp(to, from) == 0))
-		return rFrom;
+	if(units == UNIT_US2000){ *pA = 1.0;         *pB = 0.0;                   return true; }
+	if(units == UNIT_T2000) { *pA = 1.0e6;       *pB = 0.0;                   return true; }
+	if(units == UNIT_MJ1958){ *pA = 86400.0e6;   *pB = -15340.0 * 86400.0e6;  return true; }
+	if(units == UNIT_T1970) { *pA = 1.0e6;       *pB = -946684800.0e6;        return true; }
+	if(units == UNIT_NS1970){ *pA = 1.0e-3;      *pB = -9.466848e+14;         return true; }
+	return false;
+}
 
-	/* Not the same an NULL doesn't compare with anything */
-	if((to == NULL)||(from == NULL))
-		goto Units_convertTo_Error;
-	
-	double rUs2k = 0.0, rTo = 0.0;
-	if(Units_haveCalRep(to) && Units_haveCalRep(from)){
-		/* TT2000 & ET2000 have no time loss across leap seconds, don't 
-		   go out to a lossy time when converting between the two */
-		if((to == UNIT_ET2000)&&(from == UNIT_TT2000))
-			return Units_tt2k_to_et2k(rFrom);
-		if((to == UNIT_TT2000)&&(from == UNIT_ET2000))
-			return Units_et2k_to_tt2k(rFrom);
-		
-		rUs2k = _Units_convertToUS2000( rFrom, from );
-		rTo = _Units_convertFromUS2000( rUs2k, to );
+/* Epoch conversions that can't be reduced to a scale and offset */
+static double _Units_convertEpoch(das_units to, double rFrom, das_units from)
+{
+	/* TT2000 & ET2000 have no time loss across leap seconds, don't 
+	   go out to a lossy time when converting between the two */
+	if((to == UNIT_ET2000)&&(from == UNIT_TT2000))
+		return Units_tt2k_to_et2k(rFrom);
+	if((to == UNIT_TT2000)&&(from == UNIT_ET2000))
+		return Units_et2k_to_tt2k(rFrom);
 		
-		return rTo; /* D2 */
+	double rUs2k = _Units_convertToUS2000( rFrom, from );
+	return _Units_convertFromUS2000( rUs2k, to ); /* D2 */
+}
+
+/* Work out a conversion plan without the cache, returns a plan of kind
+ * DAS_UCONV_NONE without reporting an error if the units don't convert */
+static das_units_conv _Units_makeConv(das_units to, das_units from)
+{
+	das_units_conv conv = {to, from, DAS_UCONV_NONE, 0.0, 0.0};
+
+	if(Units_haveCalRep(to) && Units_haveCalRep(from)){
+		double rAFrom, rBFrom, rATo, rBTo;
+		if(_Units_epochLinear(from, &rAFrom, &rBFrom) && 
+			_Units_epochLinear(to, &rATo, &rBTo)
+		){
+			conv.nKind = DAS_UCONV_LINEAR;
+			conv.rScale = rAFrom / rATo;
+			conv.rOffset = (rBFrom - rBTo) / rATo;
+		}
+		else{
+			conv.nKind = DAS_UCONV_EPOCH;
+		}
+		return conv;
 	}
 	
 	struct base_unit aCompForm[_MAX_NUM_COMP];
@@ -1635,30 +1807,166 @@ double Units_convertTo(das_units to, double rFrom, das_units from)
 	memset(aCompTo, 0, sizeof(struct base_unit)*_MAX_NUM_COMP);
 	
 	if( (nCompFrom = _Units_strToComponents(from, aCompForm, _MAX_NUM_COMP))  < 0)
-		goto Units_convertTo_Error;
+		return conv;
 	if( (nCompTo = _Units_strToComponents(to, aCompTo, _MAX_NUM_COMP))  < 0)
-		goto Units_convertTo_Error;
+		return conv;
 	
 	double rFactorForm, rFactorTo;
 	
 	rFactorForm = _Units_reduce(aCompForm, &nCompFrom);
 	rFactorTo = _Units_reduce(aCompTo, &nCompTo);
 	
-	if(nCompFrom != nCompTo) goto Units_convertTo_Error;
+	if(nCompFrom != nCompTo) return conv;
 	
 	/* Since these are in a canonical order, if two components have different
 	   base units at any point, then they don't convert */
 	for(int i = 0; i < nCompFrom; i++)
 		if(strcasecmp(aCompForm[i].sName, aCompTo[i].sName) != 0) 
-			goto Units_convertTo_Error;
-	
-	rTo = rFrom * (rFactorForm / rFactorTo);
+			return conv;
 	
-	return rTo; /* ... D2 */
-	
-Units_convertTo_Error:
-	das_error(15, "Unit types %s and %s are not convertible.", to, from);	
-	return DAS_FILL_VALUE;
+	conv.nKind = DAS_UCONV_LINEAR;
+	conv.rScale = rFactorForm / rFactorTo;
+	conv.rOffset = 0.0;
+	return conv;
+}
+
+/* Process wide plan cache.  Unit strings are singletons, so the pair of
+ * pointers is the key.  Entries are never removed, once the table is full
+ * further plans are just computed on each call.
+ *
+ * Lookups take no lock, the same as for the units list above.  Writers hold
+ * g_mtxConv, fill in a new heap entry and then publish the pointer to it with
+ * a release store.  Entries are kept for the life of the program. */
+#define _CONV_CACHE_SZ 1024   /* power of 2 */
+
+static das_units_conv* g_aConvCache[_CONV_CACHE_SZ] = {NULL};
+static pthread_mutex_t g_mtxConv = PTHREAD_MUTEX_INITIALIZER;
+
+static bool _Units_isSingleton(das_units units)
+{
+	int i = _Units_find(units);
+	return (i >= 0) && (_Units_at(i) == units);
+}
+
+static das_units_conv _Units_getConv(das_units to, das_units from)
+{
+	das_units_conv conv = {to, from, DAS_UCONV_LINEAR, 1.0, 0.0};
+
+	/* Check for same units */
+	if((to == NULL) && (from == NULL))
+		return conv;
+	if((to == NULL)||(from == NULL)){
+		conv.nKind = DAS_UCONV_NONE;
+		return conv;
+	}
+	if((to == from)||(strcmp(to, from) == 0))
+		return conv;
+
+	size_t uHash = ((size_t)(uintptr_t)to * 31u) ^ (size_t)(uintptr_t)from;
+	uHash = (uHash ^ (uHash >> 9)) & (_CONV_CACHE_SZ - 1);
+	size_t u, i;
+	das_units_conv* pEnt;
+	bool bRoom = false;
+
+	for(u = 0; u < _CONV_CACHE_SZ; ++u){
+		i = (uHash + u) & (_CONV_CACHE_SZ - 1);
+		if((pEnt = _UNIT_LOAD(g_aConvCache[i])) == NULL){
+			bRoom = true;
+			break;
+		}
+		if((pEnt->to == to)&&(pEnt->from == from))
+			return *pEnt;
+	}
+
+	conv = _Units_makeConv(to, from);
+
+	/* Only cache library unit pointers, a caller's string buffer could be
+	   reused for different units */
+	if(!bRoom || !_Units_isSingleton(to) || !_Units_isSingleton(from))
+		return conv;
+
+	if((pEnt = (das_units_conv*)malloc(sizeof(das_units_conv))) == NULL)
+		return conv;
+	*pEnt = conv;
+
+	pthread_mutex_lock(&g_mtxConv);
+	for(u = 0; u < _CONV_CACHE_SZ; ++u){
+		i = (uHash + u) & (_CONV_CACHE_SZ - 1);
+		if(g_aConvCache[i] == NULL){
+			_UNIT_STORE(g_aConvCache[i], pEnt);
+			pEnt = NULL;
+			break;
+		}
+		if((g_aConvCache[i]->to == to)&&(g_aConvCache[i]->from == from))
+			break;  /* another thread beat us to it */
+	}
+	pthread_mutex_unlock(&g_mtxConv);
+
+	if(pEnt != NULL) free(pEnt);
+	return conv;
+}
+
+das_units_conv Units_getConverter(das_units to, das_units from)
+{
+	das_units_conv conv = _Units_getConv(to, from);
+	if(conv.nKind == DAS_UCONV_NONE)
+		das_error(DASERR_UNITS, "Unit types %s and %s are not convertible.", to, from);
+	return conv;
+}
+
+double Units_convertOne(const das_units_conv* pConv, double rVal)
+{
+	switch(pConv->nKind){
+	case DAS_UCONV_LINEAR: return rVal * pConv->rScale + pConv->rOffset;
+	case DAS_UCONV_EPOCH:  return _Units_convertEpoch(pConv->to, rVal, pConv->from);
+	default:               return DAS_FILL_VALUE;
+	}
+}
+
+DasErrCode Units_convertArray(
+	const das_units_conv* pConv, const double* pIn, double* pOut, size_t uVals
+){
+	size_t u;
+	const double rScale = pConv->rScale;
+	const double rOffset = pConv->rOffset;
+
+	switch(pConv->nKind){
+	case DAS_UCONV_LINEAR:
+		/* Plain loops, left for the compiler to vectorize */
+		if(rOffset == 0.0){
+			if(rScale == 1.0){
+				if(pOut != pIn) memcpy(pOut, pIn, uVals * sizeof(double));
+			}
+			else{
+				for(u = 0; u < uVals; ++u) pOut[u] = pIn[u] * rScale;
+			}
+		}
+		else{
+			for(u = 0; u < uVals; ++u) pOut[u] = pIn[u] * rScale + rOffset;
+		}
+		return DAS_OKAY;
+
+	case DAS_UCONV_EPOCH:
+		for(u = 0; u < uVals; ++u)
+			pOut[u] = _Units_convertEpoch(pConv->to, pIn[u], pConv->from);
+		return DAS_OKAY;
+
+	default:
+		return das_error(DASERR_UNITS, "Unit types %s and %s are not convertible.",
+			pConv->to, pConv->from
+		);
+	}
+}
+
+double Units_convertTo(das_units to, double rFrom, das_units from)
+{
+	das_units_conv conv = _Units_getConv(to, from);
+
+	if(conv.nKind == DAS_UCONV_NONE){
+		das_error(15, "Unit types %s and %s are not convertible.", to, from);	
+		return DAS_FILL_VALUE;
+	}
+	return Units_convertOne(&conv, rFrom);
 }
 
 
@@ -1949,6 +2257,218 @@ double Units_convertFromDt(das_units epoch_units, const das_time* pDt)
 	return _Units_convertFromUS2000(us2000, epoch_units);
 }
 
+/* ************************************************************************* */
+/* Cached time column parsing */
+
+#define _TP_BLANK(c) (((c)==' ')||((c)=='\t')||((c)=='\r')||((c)=='\n'))
+#define _TP_DIGIT(c) (((c) >= '0')&&((c) <= '9'))
+
+static bool _tp_digits(const char* p, int n, int* pVal)
+{
+	int nVal = 0;
+	for(int i = 0; i < n; ++i){
+		if(!_TP_DIGIT(p[i])) return false;
+		nVal = nVal*10 + (p[i] - '0');
+	}
+	*pVal = nVal;
+	return true;
+}
+
+static int _tp_layout(const char* p, int n)
+{
+	int nTmp;
+	if((n >= 10) && _tp_digits(p, 4, &nTmp) && (p[4] == '-') && 
+	   _tp_digits(p+5, 2, &nTmp) && (p[7] == '-') && _tp_digits(p+8, 2, &nTmp))
+		return DASTP_YMD;
+
+	if((n >= 8) && _tp_digits(p, 4, &nTmp) && (p[4] == '-') && 
+	   _tp_digits(p+5, 3, &nTmp) && ((n == 8)||(!_TP_DIGIT(p[8]))))
+		return DASTP_YDOY;
+
+	return DASTP_OTHER;
+}
+
+void das_tparser_init(das_tparser* pThis, das_units units)
+{
+	memset(pThis, 0, sizeof(das_tparser));
+	pThis->units = units;
+	pThis->nLayout = DASTP_UNKNOWN;
+}
+
+/* Load a new date prefix into the cache, false if it's not a valid date */
+static bool _das_tparser_setDate(das_tparser* pThis, const char* p)
+{
+	das_time dt = {0};
+	int nYear, nMonth = 1, nDay;
+
+	if(!_tp_digits(p, 4, &nYear)) return false;
+	if(pThis->nLayout == DASTP_YMD){
+		if((p[4] != '-')||(p[7] != '-')) return false;
+		if(!_tp_digits(p+5, 2, &nMonth) || !_tp_digits(p+8, 2, &nDay)) return false;
+		if((nMonth < 1)||(nMonth > 12)||(nDay < 1)) return false;
+	}
+	else{
+		if((p[4] != '-')||(!_tp_digits(p+5, 3, &nDay))) return false;
+		if((nDay < 1)||(nDay > 366)) return false;
+	}
+
+	dt.year = nYear; dt.month = nMonth; dt.mday = nDay;
+	dt_tnorm(&dt);
+
+	/* Reject dates that roll over, such as Feb. 30th */
+	if(dt.year != nYear) return false;
+	if((pThis->nLayout == DASTP_YMD)&&((dt.month != nMonth)||(dt.mday != nDay)))
+		return false;
+
+	/* Same Julian day arithmetic as Units_convertFromDt */
+	int jd = 367 * dt.year - 7 * (dt.year + (dt.month + 9) / 12) / 4 -
+	         3 * ((dt.year + (dt.month - 9) / 7) / 100 + 1) / 4 +
+	         275 * dt.month / 9 + dt.mday + 1721029;
+
+	pThis->rDayUs2k = ( jd - 2451545 ) * 86400000000.;
+	pThis->rDayMj1958 = ( jd - 2436205. );
+
+	/* Before 1972 UTC drifted against TAI, a day isn't a fixed number of SI
+	   seconds so only cache TT2000 for later dates */
+	pThis->bTT2k = (dt.year >= 1972);
+	if(pThis->bTT2k)
+		pThis->nDayTT2k = das_utc_to_tt2K(
+			(double)dt.year, (double)dt.month, (double)dt.mday, 0.0, 0.0, 0.0, 
+			0.0, 0.0, 0.0
+		);
+
+	memcpy(pThis->sDate, p, pThis->nDateLen);
+	pThis->bDate = true;
+	return true;
+}
+
+/* Parse the field up through the time of day.  Outputs the hour, minute and
+   the seconds field text so that callers can convert it the way they need */
+static bool _das_tparser_split(
+	das_tparser* pThis, const char* pField, int nLen, int* pHour, int* pMin,
+	const char** ppSec, int* pSecLen
+){
+	int i = 0;
+	while((i < nLen)&&_TP_BLANK(pField[i])) ++i;
+	while((nLen > i)&&(_TP_BLANK(pField[nLen-1])||(pField[nLen-1] == '\0'))) --nLen;
+
+	const char* p = pField + i;
+	int n = nLen - i;
+
+	if(pThis->nLayout == DASTP_UNKNOWN){
+		pThis->nLayout = _tp_layout(p, n);
+		pThis->nDateLen = (pThis->nLayout == DASTP_YMD) ? 10 : 8;
+	}
+	if(pThis->nLayout == DASTP_OTHER) return false;
+
+	if((n < pThis->nDateLen) || !pThis->bDate || 
+	   (memcmp(p, pThis->sDate, pThis->nDateLen) != 0)
+	){
+		if((n < pThis->nDateLen) || !_das_tparser_setDate(pThis, p)){
+			/* Maybe the layout changed mid-column, re-detect once */
+			int nLayout = _tp_layout(p, n);
+			if((nLayout == DASTP_OTHER)||(nLayout == pThis->nLayout)) return false;
+			pThis->nLayout = nLayout;
+			pThis->nDateLen = (nLayout == DASTP_YMD) ? 10 : 8;
+			pThis->bDate = false;
+			if(!_das_tparser_setDate(pThis, p)) return false;
+		}
+	}
+
+	p += pThis->nDateLen;
+	n -= pThis->nDateLen;
+
+	*pHour = 0; *pMin = 0; *ppSec = NULL; *pSecLen = 0;
+	if(n == 0) return true;  /* Just a date */
+
+	if(((*p != 'T')&&(*p != ' ')) || (n < 6)) return false;
+	if((p[3] != ':') || !_tp_digits(p+1, 2, pHour) || !_tp_digits(p+4, 2, pMin))
+		return false;
+	if((*pHour > 23)||(*pMin > 59)) return false;
+	p += 6; n -= 6;
+
+	if((n > 0)&&(p[n-1] == 'Z')) --n;
+	if(n == 0) return true;
+
+	if((*p != ':')||(n < 3)||(!_TP_DIGIT(p[1]))||(!_TP_DIGIT(p[2]))) return false;
+	++p; --n;
+
+	/* Seconds are ss or ss.fff..., nothing else may follow */
+	if((p[0] > '6')||((p[0] == '6')&&(p[1] != '0'))) return false;
+	if(n > 2){
+		if(p[2] != '.') return false;
+		for(int j = 3; j < n; ++j) if(!_TP_DIGIT(p[j])) return false;
+	}
+	*ppSec = p;
+	*pSecLen = n;
+	return true;
+}
+
+bool das_tparser_toDouble(
+	das_tparser* pThis, const char* pField, int nLen, double* pVal
+){
+	int nHour, nMin, nSecLen;
+	const char* pSec = NULL;
+
+	/* TT2000 and ET2000 need the exact integer path */
+	if((pThis->units == UNIT_TT2000)||(pThis->units == UNIT_ET2000)){
+		int64_t nTT2k;
+		if(!das_tparser_toTT2k(pThis, pField, nLen, &nTT2k)) return false;
+		if(pThis->units == UNIT_ET2000)
+			*pVal = Units_tt2k_to_et2k((double)nTT2k);
+		else
+			*pVal = (double)nTT2k;
+		return true;
+	}
+
+	if(!_das_tparser_split(pThis, pField, nLen, &nHour, &nMin, &pSec, &nSecLen))
+		return false;
+
+	double rSec = 0.0;
+	if((pSec != NULL)&&(das_txt2double(pSec, nSecLen, &rSec) != nSecLen))
+		return false;
+
+	/* Mirror the arithmetic in Units_convertFromDt so results match bit for bit */
+	double ssm = rSec + nHour*3600.0 + nMin*60.0;
+
+	if(pThis->units == UNIT_MJ1958){
+		*pVal = pThis->rDayMj1958 + ssm / 86400.;
+		return true;
+	}
+
+	double us2000 = pThis->rDayUs2k + ssm * 1000000;
+	if(pThis->units == UNIT_US2000)
+		*pVal = us2000;
+	else
+		*pVal = _Units_convertFromUS2000(us2000, pThis->units);
+	return true;
+}
+
+bool das_tparser_toTT2k(
+	das_tparser* pThis, const char* pField, int nLen, int64_t* pVal
+){
+	int nHour, nMin, nSecLen;
+	const char* pSec = NULL;
+
+	if(!_das_tparser_split(pThis, pField, nLen, &nHour, &nMin, &pSec, &nSecLen))
+		return false;
+	if(!pThis->bTT2k) return false;
+
+	int64_t nSec = nHour*3600 + nMin*60;
+	int64_t nNano = 0;
+	if(pSec != NULL){
+		nSec += (pSec[0] - '0')*10 + (pSec[1] - '0');
+		/* Fraction digits past nanoseconds are truncated, as in dt_to_tt2k */
+		int64_t nScale = 100000000;
+		for(int j = 3; (j < nSecLen)&&(nScale > 0); ++j){
+			nNano += (pSec[j] - '0') * nScale;
+			nScale /= 10;
+		}
+	}
+	*pVal = pThis->nDayTT2k + nSec*1000000000 + nNano;
+	return true;
+}
+
 bool Units_canMerge(das_units left, int op, das_units right){
 	if(das_op_isUnary(op)){
 		das_error(DASERR_UNITS, "Expected a binary operation,  '%s' is unary", 
@@ -347,6 +347,58 @@ DAS_API bool Units_canConvert(das_units fromUnits , das_units toUnits);
  */
 DAS_API double Units_convertTo( das_units toUnits, double rVal, das_units fromUnits );
 
+/** Conversion types for ::das_units_conv */
+#define DAS_UCONV_NONE   0  /**< Units are not convertible */
+#define DAS_UCONV_LINEAR 1  /**< to = from * rScale + rOffset */
+#define DAS_UCONV_EPOCH  2  /**< Leap second aware time conversion */
+
+/** A pre-computed conversion between two units
+ *
+ * Parsing and reducing unit strings is far more expensive than the conversion
+ * itself.  Get one of these from Units_getConverter() once, then apply it to
+ * as many values as needed with Units_convertOne() or Units_convertArray().
+ * Plain SI units and the linear epoch scales (us2000, t2000, mj1958, t1970,
+ * ns1970) reduce to a scale and offset.  Conversions involving TT2000 or
+ * ET2000 depend on the leap second table and are applied value by value.
+ */
+typedef struct das_units_conv {
+	das_units to;
+	das_units from;
+	int nKind;       /* One of the DAS_UCONV_ values */
+	double rScale;   /* Linear conversions only */
+	double rOffset;
+} das_units_conv;
+
+/** Get a conversion plan between two units
+ *
+ * Plans are cached for the life of the program, so repeat calls for the same
+ * pair of units are cheap.  This function is thread safe.
+ *
+ * @param toUnits The units of the output values
+ * @param fromUnits The units of the input values
+ *
+ * @returns A conversion object.  If the units are not convertible an error is
+ *          reported and the nKind member is DAS_UCONV_NONE.
+ */
+DAS_API das_units_conv Units_getConverter(das_units toUnits, das_units fromUnits);
+
+/** Convert a single value using a conversion plan */
+DAS_API double Units_convertOne(const das_units_conv* pConv, double rVal);
+
+/** Convert an array of values using a conversion plan
+ *
+ * @param pConv A conversion plan from Units_getConverter()
+ * @param pIn The input values
+ * @param pOut The output values, may be the same as pIn for in-place
+ *        conversion but must not otherwise overlap it
+ * @param uVals The number of values to convert
+ *
+ * @returns DAS_OKAY, or an error code if the plan is not a valid conversion
+ */
+DAS_API DasErrCode Units_convertArray(
+	const das_units_conv* pConv, const double* pIn, double* pOut, size_t uVals
+);
+
 
 /** Determine if the units in question can be converted to date-times 
  *
@@ -388,6 +440,77 @@ DAS_API DasErrCode Units_convertToDt(das_time* pDt, double value, das_units epoc
  */
 DAS_API double Units_convertFromDt(das_units epoch_units, const das_time* pDt);
 
+/** Cached parser for columns of ISO-8601 time strings
+ *
+ * Time columns in a stream almost always share one layout and, within a
+ * packet, one date.  This object detects the layout on the first value, then
+ * for each value only checks whether the date prefix changed.  The epoch
+ * offset of midnight (including the leap second count for TT2000) is
+ * recomputed only on a date change, the time of day is added directly.
+ *
+ * Recognized layouts are @c YYYY-MM-DD and @c YYYY-DDD followed by nothing,
+ * or by a 'T' or space and @c hh:mm, @c hh:mm:ss or @c hh:mm:ss.fff... with an
+ * optional trailing 'Z'.  Anything else makes the fast calls return false
+ * so that the caller can use dt_parsetime().
+ *
+ * Embed one per time column, no heap memory is used and no cleanup is needed.
+ */
+typedef struct das_time_parser {
+	das_units units;      /* Output units, NULL until initialized */
+	int nLayout;          /* One of the DASTP_ values */
+	int nDateLen;         /* Bytes in the date prefix */
+	bool bDate;           /* True if the cached date below is valid */
+	char sDate[12];       /* The cached date prefix */
+	bool bTT2k;           /* nDayTT2k valid, false before 1972 */
+	int64_t nDayTT2k;     /* TT2000 value at 00:00 of the cached date */
+	double rDayUs2k;      /* us2000 value at 00:00 of the cached date */
+	double rDayMj1958;    /* mj1958 value at 00:00 of the cached date */
+} das_tparser;
+
+#define DASTP_UNKNOWN 0
+#define DASTP_YMD     1
+#define DASTP_YDOY    2
+#define DASTP_OTHER   3
+
+/** Initialize or re-target a time column parser
+ *
+ * @param pThis The parser to initialize
+ * @param units The epoch units for output values
+ * @memberof das_tparser
+ */
+DAS_API void das_tparser_init(das_tparser* pThis, das_units units);
+
+/** Convert one fixed layout time string to a double in the parser's units
+ *
+ * Results are identical to dt_parsetime() followed by Units_convertFromDt()
+ * except for TT2000 and ET2000 output, where nanoseconds are taken directly
+ * from the fraction digits instead of through a binary floating point split.
+ *
+ * @param pThis The parser
+ * @param pField The start of the time text, need not be null terminated
+ * @param nLen The number of bytes in the field, surrounding blanks are ignored
+ * @param pVal Location to receive the converted value
+ *
+ * @returns true if the value was converted, false if the text doesn't match
+ *          a recognized layout, in which case nothing is written to pVal.
+ * @memberof das_tparser
+ */
+DAS_API bool das_tparser_toDouble(
+	das_tparser* pThis, const char* pField, int nLen, double* pVal
+);
+
+/** Convert one fixed layout time string directly to an integer TT2000 value
+ *
+ * Same as das_tparser_toDouble() but the parser units are ignored and the
+ * result is exact to the nanosecond.  Dates before 1972 are not handled by
+ * the fast path since UTC had no fixed offset from TAI then.
+ *
+ * @memberof das_tparser
+ */
+DAS_API bool das_tparser_toTT2k(
+	das_tparser* pThis, const char* pField, int nLen, int64_t* pVal
+);
+
 /** Get seconds since midnight for some value of an epoch time unit
  * @param rVal the value of the epoch time
  * @param epoch_units so type of epoch time unit.
@@ -32,6 +32,13 @@
 #include <stdio.h>
 #include <errno.h>
 #include <ctype.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#ifdef __unix
+#include <unistd.h>
+#endif
 
 /* POSIX directory traversal — Windows uses das2/win_dirent.h */
 #ifdef _WIN32
@@ -292,20 +299,66 @@ const DasUriSegDef* das_time_uridef(void)
  * ### Directory stack
  *
  * One _DasUriDepth entry exists per level of the template (pTplt->nLevels).
- * Depth D corresponds to scanning for level D: readdir is called on
- * pDepth[D].pDir and each entry is matched against pTplt->pLevels[D].pSegs.
+ * Depth D corresponds to scanning for level D: the entries of pDepth[D].pList
+ * are walked and each is matched against pTplt->pLevels[D].pSegs.
  * If level D is a directory level, matched entries cause opendir + push to
  * depth D+1.  If level D is the file level (bIsFile), matched entries are
  * yielded.
  *
- * When nCurDepth == N, the open DIR* handles are pDepth[0 .. N-1] and the
- * deepest one is being actively read.  nCurDepth == 0 means no DIRs are
- * open (initial state, before the first DasUriIter_next() call).
- *
- * $x and $v buffering fields will be added in step 6c.                        */
+ * Directories are read whole into a _DasUriList and then walked, so that no
+ * DIR* handles stay open between calls.  When nCurDepth == N, the listings
+ * in pDepth[0 .. N-1] are live and the deepest one is being walked.
+ * nCurDepth == 0 means nothing has been read yet.
+ *
+ * ### Parallel scanning and the listing cache
+ *
+ * If more than one scan thread is requested, reading a directory level's
+ * listing also queues reads of every sub-directory that matches and is in
+ * range.  Worker threads read those while the iterator walks earlier
+ * entries, so sibling directories on slow network filesystems are listed
+ * concurrently.  Output order is the same as a serial scan because the
+ * iterator still walks the listings in order, it just waits on a queued
+ * read instead of calling readdir itself.
+ *
+ * If a cache directory is set, each listing is saved there under a hash of
+ * the directory path along with the directory mtime.  Later scans reuse the
+ * saved listing when the mtime hasn't changed.  Directories modified in the
+ * last few seconds are never saved since a second change within the same
+ * mtime tick would go unnoticed.                                            */
+
+/* A directory listing, names are stored end to end in one buffer */
+typedef struct _das_uri_list_t {
+	char*  pBuf;
+	char** ppNames;
+	size_t uNames;
+} _DasUriList;
+
+/* One queued directory read */
+typedef struct _das_uri_job_t {
+	char         sPath[DURI_MAX_PATH];
+	_DasUriList* pList;        /* NULL if the directory couldn't be read    */
+	bool         bDone;
+	struct _das_uri_job_t* pNext;  /* work queue link                       */
+} _DasUriJob;
+
+/* Worker threads for directory reads, one pool per iterator */
+typedef struct _das_uri_pool_t {
+	pthread_mutex_t mtx;
+	pthread_cond_t  cndWork;   /* jobs queued, or time to quit              */
+	pthread_cond_t  cndDone;   /* a job finished                            */
+	_DasUriJob*     pHead;
+	_DasUriJob*     pTail;
+	bool            bQuit;
+	int             nThreads;
+	pthread_t*      pThreads;
+	const char*     sCache;    /* points into the owning scan state         */
+} _DasUriPool;
 
 typedef struct _das_uri_depth_t {
-	DIR* pDir;                  /* open handle; NULL until this depth is live */
+	_DasUriList* pList;         /* entries; NULL until this depth is live     */
+	size_t uNext;               /* next entry in pList to examine             */
+	_DasUriJob** ppJobs;        /* queued reads of sub-directories, aligned   */
+	                            /* with pList entries, NULL if not queued     */
 	char sPath[DURI_MAX_PATH];  /* full path of the directory opened here     */
 
 	/* File-level $x/$v buffering — only used when this depth is the file
@@ -328,8 +381,15 @@ typedef struct das_uri_scan_t {
 	bool          bFatal;    /* set at init if the template needs features    */
 	                         /* not yet implemented (e.g. $x/$v in 6b); next  */
 	                         /* returns NULL without opening any directory    */
+	int           nThreads;  /* directory read threads, 1 = serial            */
+	char          sCache[DURI_MAX_PATH];  /* listing cache dir, "" for none  */
+	_DasUriPool*  pPool;     /* started on the first next() if nThreads > 1   */
 } _DasUriScan;
 
+/* Defaults for new iterators, see das_uri_scanOpts() */
+static int  g_nUriThreads = 1;
+static char g_sUriCache[DURI_MAX_PATH] = {'\0'};
+
 
 /* ========================================================================= */
 /* ## Generic linked list sketch  (for future use, not part of public API)
@@ -1176,24 +1236,29 @@ DasErrCode init_DasUriIter(
 	}
 	pScan->nCurDepth = 0;
 	pScan->bFatal    = false;
+	pScan->nThreads  = g_nUriThreads;
+	snprintf(pScan->sCache, DURI_MAX_PATH, "%s", g_sUriCache);
 
 	pThis->pState = pScan;
 	return DAS_OKAY;
 }
 
+static void _stop_pool(_DasUriPool* pPool);
+static void _free_depth(_DasUriDepth* pDepth);
+
 void fini_DasUriIter(DasUriIter* pThis)
 {
 	if(pThis == NULL || pThis->pState == NULL) return;
 
 	_DasUriScan* pScan = (_DasUriScan*)pThis->pState;
 
-	/* Close any DIR handles still open from partial/interrupted iteration. */
-	for(int i = 0; i < pScan->nCurDepth; ++i){
-		if(pScan->pDepth[i].pDir != NULL){
-			closedir(pScan->pDepth[i].pDir);
-			pScan->pDepth[i].pDir = NULL;
-		}
-	}
+	/* Workers may still be filling queued reads from an interrupted
+	 * iteration, stop them before freeing the listings they write to. */
+	_stop_pool(pScan->pPool);
+	pScan->pPool = NULL;
+
+	for(int i = 0; i < pScan->nCurDepth; ++i)
+		_free_depth(pScan->pDepth + i);
 
 	free(pScan->pDepth);
 	free(pScan);
@@ -1216,6 +1281,26 @@ DasUriIter* new_DasUriIter(
 	return pThis;
 }
 
+void das_uri_scanOpts(int nThreads, const char* sCacheDir)
+{
+	g_nUriThreads = (nThreads < 1) ? 1 : nThreads;
+	snprintf(g_sUriCache, DURI_MAX_PATH, "%s", sCacheDir ? sCacheDir : "");
+}
+
+DasErrCode DasUriIter_scanOpts(DasUriIter* pThis, int nThreads, const char* sCacheDir)
+{
+	_DasUriScan* pScan = (_DasUriScan*)pThis->pState;
+	if(pScan == NULL) return DAS_OKAY;   /* literal templates don't scan */
+
+	if((pScan->nCurDepth > 0) || pThis->bDone)
+		return das_error(DASERR_URI,
+			"Scan options must be set before the first call to DasUriIter_next");
+
+	pScan->nThreads = (nThreads < 1) ? 1 : nThreads;
+	snprintf(pScan->sCache, DURI_MAX_PATH, "%s", sCacheDir ? sCacheDir : "");
+	return DAS_OKAY;
+}
+
 /* ========================================================================= */
 /* ## Iterator helpers (step 6b)                                              */
 
@@ -1672,18 +1757,365 @@ static int _ver_cmp(const char* sA, const char* sB, uint8_t uType)
 	return strcmp(sA, sB);
 }
 
-/* Open the directory for scan-depth iDepth into pScan->pDepth[iDepth].
- * pScan->pDepth[iDepth].sPath must already be populated with the full path.
- * ENOENT is not an error — caller handles the NULL return by popping. */
-static DIR* _open_dir(_DasUriScan* pScan, int iDepth)
+/* ========================================================================= */
+/* ## Directory listings and the listing cache                               */
+
+static void _free_list(_DasUriList* pList)
+{
+	if(pList == NULL) return;
+	free(pList->pBuf);
+	free(pList->ppNames);
+	free(pList);
+}
+
+/* Make a listing from uLen bytes of NUL separated names starting at pNames,
+ * pBuf is owned by the listing afterwards */
+static _DasUriList* _make_list(char* pBuf, const char* pNames, size_t uLen)
+{
+	_DasUriList* pList = (_DasUriList*)calloc(1, sizeof(_DasUriList));
+	if(pList == NULL){ free(pBuf); return NULL; }
+	pList->pBuf = pBuf;
+
+	size_t u, uNames = 0;
+	for(u = 0; u < uLen; ++u) if(pNames[u] == '\0') ++uNames;
+
+	pList->ppNames = (char**)malloc((uNames + 1) * sizeof(char*));
+	if(pList->ppNames == NULL){ _free_list(pList); return NULL; }
+
+	const char* pName = pNames;
+	for(u = 0; u < uNames; ++u){
+		pList->ppNames[u] = (char*)pName;
+		pName += strlen(pName) + 1;
+	}
+	pList->uNames = uNames;
+	return pList;
+}
+
+/* Cache file for a directory, named by a 64-bit FNV-1a hash of its path */
+static void _cache_file(
+	const char* sCache, const char* sDir, char* sOut, int nOut
+){
+	uint64_t uHash = 0xcbf29ce484222325ULL;
+	for(const char* p = sDir; *p; ++p){
+		uHash ^= (unsigned char)*p;
+		uHash *= 0x100000001b3ULL;
+	}
+	char sLeaf[32];
+	snprintf(sLeaf, sizeof(sLeaf), "%016llx.lst", (unsigned long long)uHash);
+	_join_path(sCache, sLeaf, sOut, nOut);
+}
+
+#define _URI_CACHE_MAGIC "das uri listing 1\n"
+
+/* Cache files are the magic line, the directory path, the directory mtime
+ * and then one name per line */
+static _DasUriList* _cache_load(const char* sFile, const char* sDir, long long nMtime)
 {
-	const char* sPath = pScan->pDepth[iDepth].sPath;
+	FILE* pIn = fopen(sFile, "rb");
+	if(pIn == NULL) return NULL;
+
+	char* pBuf = NULL;
+	long nLen = -1;
+	if(fseek(pIn, 0, SEEK_END) == 0) nLen = ftell(pIn);
+	if((nLen > 0) && (fseek(pIn, 0, SEEK_SET) == 0) &&
+	   ((pBuf = (char*)malloc(nLen + 1)) != NULL)){
+		if(fread(pBuf, 1, nLen, pIn) != (size_t)nLen){
+			free(pBuf);
+			pBuf = NULL;
+		}
+	}
+	fclose(pIn);
+	if(pBuf == NULL) return NULL;
+	pBuf[nLen] = '\0';
+
+	/* Check the header, anything unexpected is just a cache miss */
+	size_t uMagic = strlen(_URI_CACHE_MAGIC);
+	size_t uDir = strlen(sDir);
+	char* pRead = pBuf;
+	if(strncmp(pRead, _URI_CACHE_MAGIC, uMagic) != 0) goto MISS;
+	pRead += uMagic;
+	if((strncmp(pRead, sDir, uDir) != 0)||(pRead[uDir] != '\n')) goto MISS;
+	pRead += uDir + 1;
+
+	char* pEnd = NULL;
+	if((strtoll(pRead, &pEnd, 10) != nMtime)||(*pEnd != '\n')) goto MISS;
+	pRead = pEnd + 1;
+
+	/* Names are newline terminated, turn that into NUL termination */
+	size_t uNames = (size_t)(pBuf + nLen - pRead);
+	if((uNames > 0)&&(pRead[uNames - 1] != '\n')) goto MISS;
+	for(char* p = pRead; p < pBuf + nLen; ++p) if(*p == '\n') *p = '\0';
+
+	return _make_list(pBuf, pRead, uNames);
+
+MISS:
+	daslog_debug_v("Ignoring stale or damaged listing cache %s", sFile);
+	free(pBuf);
+	return NULL;
+}
+
+static pthread_mutex_t g_mtxUriTmp = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int g_uUriTmp = 0;
+
+/* Write atomically so that concurrent scans never see a partial listing,
+ * failures only cost a future cache miss */
+static void _cache_save(
+	const char* sFile, const char* sDir, long long nMtime, const _DasUriList* pList
+){
+	size_t u;
+	for(u = 0; u < pList->uNames; ++u)
+		if(strchr(pList->ppNames[u], '\n') != NULL) return;  /* unstorable */
+
+	if(das_mkdirsto(sFile) != DAS_OKAY) return;
+
+	pthread_mutex_lock(&g_mtxUriTmp);
+	unsigned int uSeq = g_uUriTmp++;
+	pthread_mutex_unlock(&g_mtxUriTmp);
+
+	long nPid = 0;
+#ifdef __unix
+	nPid = (long)getpid();
+#endif
+	char sTmp[DURI_MAX_PATH + 48];
+	snprintf(sTmp, sizeof(sTmp), "%s.%ld.%u.tmp", sFile, nPid, uSeq);
+
+	FILE* pOut = fopen(sTmp, "wb");
+	if(pOut == NULL) return;
+
+	bool bOkay = (fprintf(pOut, "%s%s\n%lld\n", _URI_CACHE_MAGIC, sDir, nMtime) > 0);
+	for(u = 0; bOkay && (u < pList->uNames); ++u)
+		bOkay = (fprintf(pOut, "%s\n", pList->ppNames[u]) > 0);
+	if(fclose(pOut) != 0) bOkay = false;
+
+#ifdef _WIN32
+	if(bOkay) remove(sFile);   /* rename won't replace files on windows */
+#endif
+	if(!bOkay || (rename(sTmp, sFile) != 0)){
+		daslog_debug_v("Couldn't save listing cache %s", sFile);
+		remove(sTmp);
+	}
+}
+
+/* Read one directory, from the cache if possible.  Safe to call from any
+ * thread.  Returns NULL if the directory couldn't be read, which is not an
+ * error, the caller just skips it. */
+static _DasUriList* _read_dir(const char* sPath, const char* sCache)
+{
+	struct stat info;
+	if(stat(sPath, &info) != 0){
+		daslog_debug_v("stat('%s') failed: %s", sPath, strerror(errno));
+		return NULL;
+	}
+	long long nMtime = (long long)info.st_mtime;
+
+	char sFile[DURI_MAX_PATH];
+	_DasUriList* pList = NULL;
+	if(sCache[0] != '\0'){
+		_cache_file(sCache, sPath, sFile, DURI_MAX_PATH);
+		if((pList = _cache_load(sFile, sPath, nMtime)) != NULL)
+			return pList;
+	}
+
 	DIR* pDir = opendir(sPath);
 	if(pDir == NULL){
 		daslog_debug_v("opendir('%s') failed: %s", sPath, strerror(errno));
+		return NULL;
 	}
-	pScan->pDepth[iDepth].pDir = pDir;
-	return pDir;
+
+	size_t uLen = 0, uCap = 4096;
+	char* pBuf = (char*)malloc(uCap);
+	struct dirent* pEnt = NULL;
+	while((pBuf != NULL) && ((pEnt = readdir(pDir)) != NULL)){
+		const char* sName = pEnt->d_name;
+		if(sName[0] == '.' && (sName[1] == '\0' ||
+		                      (sName[1] == '.' && sName[2] == '\0')))
+			continue;
+
+		size_t uName = strlen(sName) + 1;
+		if(uLen + uName > uCap){
+			while(uLen + uName > uCap) uCap *= 2;
+			char* pNew = (char*)realloc(pBuf, uCap);
+			if(pNew == NULL){ free(pBuf); pBuf = NULL; break; }
+			pBuf = pNew;
+		}
+		memcpy(pBuf + uLen, sName, uName);
+		uLen += uName;
+	}
+	closedir(pDir);
+	if(pBuf == NULL){
+		das_error(DASERR_URI, "out of memory listing %s", sPath);
+		return NULL;
+	}
+
+	if((pList = _make_list(pBuf, pBuf, uLen)) == NULL) return NULL;
+
+	if((sCache[0] != '\0') && ((long long)time(NULL) - nMtime > 2))
+		_cache_save(sFile, sPath, nMtime, pList);
+
+	return pList;
+}
+
+/* ========================================================================= */
+/* ## Directory read workers                                                 */
+
+static void* _pool_work(void* vpPool)
+{
+	_DasUriPool* pPool = (_DasUriPool*)vpPool;
+	_DasUriJob* pJob = NULL;
+
+	pthread_mutex_lock(&pPool->mtx);
+	while(true){
+		while(!pPool->bQuit && (pPool->pHead == NULL))
+			pthread_cond_wait(&pPool->cndWork, &pPool->mtx);
+		if(pPool->bQuit) break;
+
+		pJob = pPool->pHead;
+		pPool->pHead = pJob->pNext;
+		if(pPool->pHead == NULL) pPool->pTail = NULL;
+		pthread_mutex_unlock(&pPool->mtx);
+
+		_DasUriList* pList = _read_dir(pJob->sPath, pPool->sCache);
+
+		pthread_mutex_lock(&pPool->mtx);
+		pJob->pList = pList;
+		pJob->bDone = true;
+		pthread_cond_broadcast(&pPool->cndDone);
+	}
+	pthread_mutex_unlock(&pPool->mtx);
+	return NULL;
+}
+
+static _DasUriPool* _start_pool(int nThreads, const char* sCache)
+{
+	_DasUriPool* pPool = (_DasUriPool*)calloc(1, sizeof(_DasUriPool));
+	if(pPool == NULL) return NULL;
+	pPool->pThreads = (pthread_t*)calloc(nThreads, sizeof(pthread_t));
+	if(pPool->pThreads == NULL){ free(pPool); return NULL; }
+
+	pthread_mutex_init(&pPool->mtx, NULL);
+	pthread_cond_init(&pPool->cndWork, NULL);
+	pthread_cond_init(&pPool->cndDone, NULL);
+	pPool->sCache = sCache;
+
+	for(int i = 0; i < nThreads; ++i){
+		if(pthread_create(pPool->pThreads + i, NULL, _pool_work, pPool) != 0)
+			break;
+		++(pPool->nThreads);
+	}
+	if(pPool->nThreads == 0){
+		daslog_warn("Couldn't start directory scan threads, scanning serially");
+		_stop_pool(pPool);
+		return NULL;
+	}
+	return pPool;
+}
+
+static void _stop_pool(_DasUriPool* pPool)
+{
+	if(pPool == NULL) return;
+
+	pthread_mutex_lock(&pPool->mtx);
+	pPool->bQuit = true;
+	pthread_cond_broadcast(&pPool->cndWork);
+	pthread_mutex_unlock(&pPool->mtx);
+
+	for(int i = 0; i < pPool->nThreads; ++i)
+		pthread_join(pPool->pThreads[i], NULL);
+
+	/* Jobs still queued are owned by their depth and freed there */
+	pthread_cond_destroy(&pPool->cndDone);
+	pthread_cond_destroy(&pPool->cndWork);
+	pthread_mutex_destroy(&pPool->mtx);
+	free(pPool->pThreads);
+	free(pPool);
+}
+
+/* Wait for a queued read and take its listing */
+static _DasUriList* _pool_take(_DasUriPool* pPool, _DasUriJob* pJob)
+{
+	pthread_mutex_lock(&pPool->mtx);
+	while(!pJob->bDone)
+		pthread_cond_wait(&pPool->cndDone, &pPool->mtx);
+	_DasUriList* pList = pJob->pList;
+	pJob->pList = NULL;
+	pthread_mutex_unlock(&pPool->mtx);
+	return pList;
+}
+
+static void _free_depth(_DasUriDepth* pDepth)
+{
+	if(pDepth->ppJobs != NULL){
+		for(size_t u = 0; u < pDepth->pList->uNames; ++u){
+			if(pDepth->ppJobs[u] == NULL) continue;
+			_free_list(pDepth->ppJobs[u]->pList);
+			free(pDepth->ppJobs[u]);
+		}
+		free(pDepth->ppJobs);
+		pDepth->ppJobs = NULL;
+	}
+	_free_list(pDepth->pList);
+	pDepth->pList = NULL;
+	pDepth->uNext = 0;
+}
+
+/* Queue reads of the sub-directories of depth iDepth that the iterator will
+ * enter.  Uses the same filter as DasUriIter_next, so only directories that
+ * will actually be walked are read. */
+static void _queue_subdirs(
+	DasUriIter* pThis, _DasUriScan* pScan, int iDepth
+){
+	const DasUriTplt* pTplt = pThis->pTplt;
+	const DasUriLevel* pLvl = &pTplt->pLevels[iDepth];
+	_DasUriDepth* pDepth = pScan->pDepth + iDepth;
+	_DasUriPool* pPool = pScan->pPool;
+	_MatchOut match;
+
+	if(pLvl->bIsFile || (iDepth + 1 >= pTplt->nLevels) || (pDepth->pList->uNames == 0))
+		return;
+
+	pDepth->ppJobs = (_DasUriJob**)calloc(pDepth->pList->uNames, sizeof(_DasUriJob*));
+	if(pDepth->ppJobs == NULL) return;  /* serial reads still work */
+
+	int nQueued = 0;
+	pthread_mutex_lock(&pPool->mtx);
+	for(size_t u = 0; u < pDepth->pList->uNames; ++u){
+		const char* sName = pDepth->pList->ppNames[u];
+		if(!_match_entry(pLvl, sName, &match)) continue;
+		if(!_in_ranges(pTplt, pScan, iDepth, pLvl, match.aVals,
+		               pThis->nRanges, pThis->pRanges))
+			continue;
+
+		_DasUriJob* pJob = (_DasUriJob*)calloc(1, sizeof(_DasUriJob));
+		if(pJob == NULL) break;
+		_join_path(pDepth->sPath, sName, pJob->sPath, DURI_MAX_PATH);
+		if(pPool->pTail) pPool->pTail->pNext = pJob;
+		else pPool->pHead = pJob;
+		pPool->pTail = pJob;
+		pDepth->ppJobs[u] = pJob;
+		++nQueued;
+	}
+	if(nQueued > 0) pthread_cond_broadcast(&pPool->cndWork);
+	pthread_mutex_unlock(&pPool->mtx);
+}
+
+/* Read the directory for scan-depth iDepth into pScan->pDepth[iDepth].
+ * pScan->pDepth[iDepth].sPath must already be populated with the full path.
+ * pJob, if not NULL, is a queued read of the same directory.  A missing
+ * directory is not an error, the caller handles the NULL return by popping. */
+static _DasUriList* _open_dir(
+	DasUriIter* pThis, _DasUriScan* pScan, int iDepth, _DasUriJob* pJob
+){
+	_DasUriDepth* pDepth = pScan->pDepth + iDepth;
+	if(pJob != NULL)
+		pDepth->pList = _pool_take(pScan->pPool, pJob);
+	else
+		pDepth->pList = _read_dir(pDepth->sPath, pScan->sCache);
+	pDepth->uNext = 0;
+
+	if((pDepth->pList != NULL) && (pScan->pPool != NULL))
+		_queue_subdirs(pThis, pScan, iDepth);
+
+	return pDepth->pList;
 }
 
 const char* DasUriIter_next(DasUriIter* pThis)
@@ -1712,11 +2144,15 @@ const char* DasUriIter_next(DasUriIter* pThis)
 		return NULL;
 	}
 
-	/* First call: seed depth 0 with sBase and open it. */
+	/* First call: start the read threads, seed depth 0 with sBase and open it. */
 	if(pScan->nCurDepth == 0){
+		if((pScan->nThreads > 1) && (pScan->pPool == NULL))
+			pScan->pPool = _start_pool(pScan->nThreads, pScan->sCache);
+
 		snprintf(pScan->pDepth[0].sPath, DURI_MAX_PATH, "%s", pTplt->sBase);
 		pScan->nCurDepth = 1;
-		if(_open_dir(pScan, 0) == NULL){
+		if(_open_dir(pThis, pScan, 0, NULL) == NULL){
+			pScan->nCurDepth = 0;
 			pThis->bDone = true;
 			return NULL;
 		}
@@ -1727,35 +2163,27 @@ const char* DasUriIter_next(DasUriIter* pThis)
 	/* Walk the depth stack until we yield a file or run out. */
 	while(pScan->nCurDepth > 0){
 		int iDepth = pScan->nCurDepth - 1;
-		DIR* pDir  = pScan->pDepth[iDepth].pDir;
+		_DasUriDepth* pCur = &pScan->pDepth[iDepth];
 		const DasUriLevel* pLvl = &pTplt->pLevels[iDepth];
 
-		struct dirent* pEnt = readdir(pDir);
-		if(pEnt == NULL){
+		if(pCur->uNext >= pCur->pList->uNames){
 			/* End of directory — before popping, yield the buffered best
 			 * match for a file-level wildcard level (6c). */
-			if(pLvl->bIsFile && pLvl->bHasWild
-			   && pScan->pDepth[iDepth].bHaveBest)
-			{
-				_join_path(pScan->pDepth[iDepth].sPath,
-				           pScan->pDepth[iDepth].sBestName,
+			if(pLvl->bIsFile && pLvl->bHasWild && pCur->bHaveBest){
+				_join_path(pCur->sPath, pCur->sBestName,
 				           pThis->sCurrent, DURI_MAX_PATH);
-				pScan->pDepth[iDepth].bHaveBest = false;
-				closedir(pDir);
-				pScan->pDepth[iDepth].pDir = NULL;
+				pCur->bHaveBest = false;
+				_free_depth(pCur);
 				--pScan->nCurDepth;
 				return pThis->sCurrent;
 			}
-			closedir(pDir);
-			pScan->pDepth[iDepth].pDir = NULL;
+			_free_depth(pCur);
 			--pScan->nCurDepth;
 			continue;
 		}
 
-		const char* sName = pEnt->d_name;
-		if(sName[0] == '.' && (sName[1] == '\0' ||
-		                      (sName[1] == '.' && sName[2] == '\0')))
-			continue;
+		size_t uEnt = pCur->uNext++;
+		const char* sName = pCur->pList->ppNames[uEnt];
 
 		if(!_match_entry(pLvl, sName, &match))
 			continue;
@@ -1827,7 +2255,8 @@ const char* DasUriIter_next(DasUriIter* pThis)
 		pScan->nCurDepth = iDepth + 2;
 		/* Reset the pushed depth's buffer state for a fresh scan. */
 		pScan->pDepth[iDepth + 1].bHaveBest = false;
-		if(_open_dir(pScan, iDepth + 1) == NULL){
+		_DasUriJob* pJob = pCur->ppJobs ? pCur->ppJobs[uEnt] : NULL;
+		if(_open_dir(pThis, pScan, iDepth + 1, pJob) == NULL){
 			pScan->nCurDepth = iDepth + 1;
 			continue;
 		}
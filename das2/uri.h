@@ -662,6 +662,51 @@ DAS_API const char* DasUriIter_next(DasUriIter* pThis);
 DAS_API void del_DasUriIter(DasUriIter* pThis);
 
 
+/** Set directory scanning options for one iterator
+ *
+ * Archives with many directories on network filesystems spend most of their
+ * time in directory reads.  Two options help:
+ *
+ * With nThreads > 1, reading a directory queues reads of all its matching,
+ * in-range sub-directories to a pool of worker threads, so sibling
+ * directories are listed concurrently.  Paths are still returned in the same
+ * order as a serial scan.
+ *
+ * With a cache directory, each directory listing is saved along with the
+ * directory's modification time, and re-used by later scans until the
+ * directory changes.  This makes repeated scans of adjacent coordinate ranges
+ * much faster.  The cache directory is created if needed and may be shared
+ * by any number of processes.
+ *
+ * Must be called before the first call to DasUriIter_next().  Has no effect
+ * for literal templates.
+ *
+ * @param pThis      The iterator
+ * @param nThreads   Number of directory read threads, 1 or less to scan
+ *                   serially.
+ * @param sCacheDir  Directory for saved listings, or NULL to not use a cache.
+ * @return DAS_OKAY, or DASERR_URI if iteration has already started.
+ *
+ * @memberof DasUriIter
+ */
+DAS_API DasErrCode DasUriIter_scanOpts(
+	DasUriIter* pThis, int nThreads, const char* sCacheDir
+);
+
+/** Set the default directory scanning options for new iterators
+ *
+ * Applies to all iterators initialized afterwards, including the ones made
+ * by das_uri_list().  Not thread safe, call at program startup.  See
+ * DasUriIter_scanOpts() for details.
+ *
+ * @param nThreads   Number of directory read threads, 1 or less to scan
+ *                   serially, the default.
+ * @param sCacheDir  Directory for saved listings, or NULL to not use a
+ *                   cache, the default.
+ */
+DAS_API void das_uri_scanOpts(int nThreads, const char* sCacheDir);
+
+
 /* ************************************************************************* */
 /* Convenience functions */
 
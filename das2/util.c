@@ -146,6 +146,21 @@ void das_init(
 		daslog_setlevel(nLevel);
 	}
 
+	/* Save off the current account's home directory.  If a home directory
+	 * is not available return some system directory that is likely writable.
+	 * Done before module init since the DFT module looks for wisdom there */
+#ifdef _WIN32
+	if(getenv("USERPROFILE"))
+		strncpy(g_sHome, getenv("USERPROFILE"), HOME_DIR_SZ - 1);
+	else
+		strcpy(g_sHome, "C:\\");
+#else
+	if(getenv("HOME"))
+		strncpy(g_sHome, getenv("HOME"), HOME_DIR_SZ - 1);
+	else
+		strcpy(g_sHome, "/tmp");
+#endif
+
 	if( ! units_init(sProgName) ){
 		das_error(DASERR_INIT, "(%s) Failed units initialization", sProgName);
 		exit(DASERR_INIT);
@@ -169,20 +184,6 @@ void das_init(
 	
 	/* Default to fast index last printing */
 	das_varindex_prndir(true);
-
-	/* Save off the current account's home directory.  If a home directory
-	 * is not available return some system directory that is likely writable */
-#ifdef _WIN32
-	if(getenv("USERPROFILE"))
-		strncpy(g_sHome, getenv("USERPROFILE"), HOME_DIR_SZ - 1);
-	else
-		strcpy(g_sHome, "C:\\");
-#else
-	if(getenv("HOME"))
-		strncpy(g_sHome, getenv("HOME"), HOME_DIR_SZ - 1);
-	else
-		strcpy(g_sHome, "/tmp");
-#endif
 }
 
 void das_finish(){
@@ -924,6 +925,16 @@ double das_strtod_c(const char *nptr, char **endptr){
   return _strtod_l(nptr, endptr, c_locale);
 }
 
+float das_strtof_c(const char *nptr, char **endptr){
+
+  if(!g_bCLocalInit){
+    c_locale = _create_locale(LC_ALL,"C");
+    g_bCLocalInit = true;
+  }
+
+  return _strtof_l(nptr, endptr, c_locale);
+}
+
 #else  /* Posix */
 
 double das_strtod_c(const char *nptr, char **endptr){
@@ -950,6 +961,29 @@ double das_strtod_c(const char *nptr, char **endptr){
   return rVal;
 }
 
+float das_strtof_c(const char *nptr, char **endptr){
+  char buf[80];
+  
+  char* pPt = strchr(nptr, '.');
+
+  if(pPt == NULL || (size_t)(pPt - nptr) >= sizeof(buf))
+    return strtof(nptr, endptr);
+  
+  struct lconv* pLocale= localeconv();
+  *buf = '\0';
+  strncat(buf, nptr, sizeof(buf) - 1);
+  
+  buf[pPt - nptr] = *(pLocale->decimal_point);
+
+  char* pEnd;
+  float rVal = strtof(buf, &pEnd);
+
+  if(endptr)
+    *endptr = ((char*) nptr) + (pEnd - buf);
+  
+  return rVal;
+}
+
 #endif
 
 /* ************************************************************************* */
@@ -182,6 +182,8 @@ DasErrCode das_error_func_fixed(
  *  - @b 42 : iterator.c    - DASERR_ITER
  *  - @b 43 : spice.c       - DASERR_SPICE
  *  - @b 44 : uri.c         - DASERR_URI
+ *  - @b 45 : binacc.c      - DASERR_BINACC
+ *  - @b 46 : histo.c       - DASERR_HISTO
  * 
  * Application programs are recommended to use values 64 and above to avoid
  * colliding with future das2 error codes.
@@ -540,6 +542,9 @@ DAS_API int das_dirlist(
  */
 DAS_API double das_strtod_c(const char *nptr, char **endptr);
 
+/** A C locale string to float converter, the strtof version of das_strtod_c() */
+DAS_API float das_strtof_c(const char *nptr, char **endptr);
+
 /** Encode binary data as base64 (RFC 4648) characters in a new buffer.
  *
  * (Credit: stackoverflow user ryyst)
@@ -1436,6 +1436,255 @@ bool das_strn2baseint(const char* str, int nLen, int base, int* pRes)
 	return true;
 }
 
+/* ************************************************************************* */
+/* Fast bounded field parsing */
+
+#define _TXT_BLANK(c) (((c)==' ')||((c)=='\t')||((c)=='\r')||((c)=='\n')||\
+                       ((c)=='\v')||((c)=='\f'))
+
+#define _TXT_DIGIT(c) (((c) >= '0')&&((c) <= '9'))
+
+/* Every power of 10 up to 22 is exactly representable as a double */
+static const double g_rExact10[23] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int _das_txt_skipBlank(const char* pField, int nOff, int nLen)
+{
+	while((nOff < nLen)&&_TXT_BLANK(pField[nOff])) ++nOff;
+	return nOff;
+}
+
+/* Slow path, hand a null terminated copy to the C-locale strtod or strtof,
+   exactly one of pDbl or pFlt is set */
+static int _das_txt2real_slow(
+	const char* pField, int nBeg, int nLen, double* pDbl, float* pFlt
+){
+	char sBuf[128] = {'\0'};
+	int nCopy = nLen - nBeg;
+	if(nCopy > 127) nCopy = 127;
+
+	int i;
+	for(i = 0; (i < nCopy)&&(pField[nBeg + i] != '\0'); ++i)
+		sBuf[i] = pField[nBeg + i];
+	sBuf[i] = '\0';
+
+	char* pEnd = NULL;
+	if(pDbl != NULL){
+		double rVal = das_strtod_c(sBuf, &pEnd);
+		if(pEnd == sBuf) return 0;
+		*pDbl = rVal;
+	}
+	else{
+		float rVal = das_strtof_c(sBuf, &pEnd);
+		if(pEnd == sBuf) return 0;
+		*pFlt = rVal;
+	}
+	return _das_txt_skipBlank(pField, nBeg + (int)(pEnd - sBuf), nLen);
+}
+
+/* Break a field into sign, mantissa and decimal exponent.  Returns the
+   offset just past the number, or -1 if only the slow path can handle it */
+static int _das_txt_scan(
+	const char* pField, int nLen, int* pBeg, bool* pNeg, uint64_t* pMant,
+	int* pExp, bool* pTrunc
+){
+	int i = _das_txt_skipBlank(pField, 0, nLen);
+	*pBeg = i;
+
+	bool bNeg = false;
+	if((i < nLen)&&((pField[i] == '-')||(pField[i] == '+'))){
+		bNeg = (pField[i] == '-');
+		++i;
+	}
+
+	uint64_t uMant = 0;
+	int nSig = 0;         /* Significant digits in uMant */
+	int nExp = 0;         /* Decimal exponent to apply to uMant */
+	int nDigits = 0;      /* Any digits at all, including leading zeros */
+	bool bTrunc = false;  /* Dropped a non-zero digit */
+	int d;
+
+	while((i < nLen)&&_TXT_DIGIT(pField[i])){
+		d = pField[i] - '0';
+		if(nSig < 19){
+			uMant = uMant*10 + d;
+			if(uMant) ++nSig;
+		}
+		else{
+			++nExp;
+			if(d) bTrunc = true;
+		}
+		++nDigits; ++i;
+	}
+
+	if((i < nLen)&&(pField[i] == '.')){
+		++i;
+		while((i < nLen)&&_TXT_DIGIT(pField[i])){
+			d = pField[i] - '0';
+			if(nSig < 19){
+				uMant = uMant*10 + d;
+				if(uMant) ++nSig;
+				--nExp;
+			}
+			else if(d){
+				bTrunc = true;
+			}
+			++nDigits; ++i;
+		}
+	}
+
+	/* No digits, may be inf, nan or something else strtod understands */
+	if(nDigits == 0) return -1;
+
+	/* Exponent, only if at least one digit follows, same as strtod */
+	if((i < nLen)&&((pField[i] == 'e')||(pField[i] == 'E'))){
+		int j = i + 1;
+		bool bExpNeg = false;
+		if((j < nLen)&&((pField[j] == '-')||(pField[j] == '+'))){
+			bExpNeg = (pField[j] == '-');
+			++j;
+		}
+		if((j < nLen)&&_TXT_DIGIT(pField[j])){
+			int nExpVal = 0;
+			while((j < nLen)&&_TXT_DIGIT(pField[j])){
+				if(nExpVal < 100000) nExpVal = nExpVal*10 + (pField[j] - '0');
+				++j;
+			}
+			nExp += bExpNeg ? -nExpVal : nExpVal;
+			i = j;
+		}
+	}
+
+	/* Hex floats and other letter suffixes are strtod's problem */
+	if((i < nLen)&&(isalpha((unsigned char)pField[i]))) return -1;
+
+	*pNeg = bNeg; *pMant = uMant; *pExp = nExp; *pTrunc = bTrunc;
+	return i;
+}
+
+int das_txt2double(const char* pField, int nLen, double* pRes)
+{
+	int nBeg, nExp;
+	bool bNeg, bTrunc;
+	uint64_t uMant;
+
+	int i = _das_txt_scan(pField, nLen, &nBeg, &bNeg, &uMant, &nExp, &bTrunc);
+	if(i < 0)
+		return _das_txt2real_slow(pField, nBeg, nLen, pRes, NULL);
+
+	/* Clinger's fast path, both operands exact so the result is correctly
+	   rounded. */
+	double rVal;
+	if(uMant == 0){
+		rVal = 0.0;
+	}
+	else if(!bTrunc && (uMant <= (UINT64_C(1) << 53)) && (nExp >= -22) && (nExp <= 22)){
+		rVal = (double)uMant;
+		if(nExp < 0) rVal /= g_rExact10[-nExp];
+		else         rVal *= g_rExact10[nExp];
+	}
+	else{
+		return _das_txt2real_slow(pField, nBeg, nLen, pRes, NULL);
+	}
+
+	*pRes = bNeg ? -rVal : rVal;
+	return _das_txt_skipBlank(pField, i, nLen);
+}
+
+/* Every power of 10 up to 10 is exactly representable as a float */
+static const float g_fExact10[11] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+int das_txt2float(const char* pField, int nLen, float* pRes)
+{
+	int nBeg, nExp;
+	bool bNeg, bTrunc;
+	uint64_t uMant;
+
+	int i = _das_txt_scan(pField, nLen, &nBeg, &bNeg, &uMant, &nExp, &bTrunc);
+	if(i < 0)
+		return _das_txt2real_slow(pField, nBeg, nLen, NULL, pRes);
+
+	/* Same fast path at float precision.  Going through the double result
+	   instead would round twice.  Whole numbers up to 2^53 are exact as
+	   doubles, so narrowing those rounds only once. */
+	float rVal;
+	if(uMant == 0){
+		rVal = 0.0f;
+	}
+	else if(!bTrunc && (uMant <= (UINT64_C(1) << 24)) && (nExp >= -10) && (nExp <= 10)){
+		rVal = (float)uMant;
+		if(nExp < 0) rVal /= g_fExact10[-nExp];
+		else         rVal *= g_fExact10[nExp];
+	}
+	else if(!bTrunc && (uMant <= (UINT64_C(1) << 53)) && (nExp == 0)){
+		rVal = (float)(double)uMant;
+	}
+	else{
+		return _das_txt2real_slow(pField, nBeg, nLen, NULL, pRes);
+	}
+
+	*pRes = bNeg ? -rVal : rVal;
+	return _das_txt_skipBlank(pField, i, nLen);
+}
+
+/* Shared digit loop for the integer parsers, returns the end offset or 0 */
+static int _das_txt2mag(
+	const char* pField, int nLen, bool* pNeg, uint64_t uMax, uint64_t* pMag
+){
+	int i = _das_txt_skipBlank(pField, 0, nLen);
+
+	*pNeg = false;
+	if((i < nLen)&&((pField[i] == '-')||(pField[i] == '+'))){
+		*pNeg = (pField[i] == '-');
+		++i;
+	}
+	if((i >= nLen)||(!_TXT_DIGIT(pField[i]))) return 0;
+
+	uint64_t uMag = 0;
+	while((i < nLen)&&_TXT_DIGIT(pField[i])){
+		uint64_t d = (uint64_t)(pField[i] - '0');
+		if(uMag > (uMax - d)/10) return 0;   /* Would overflow */
+		uMag = uMag*10 + d;
+		++i;
+	}
+	*pMag = uMag;
+	return _das_txt_skipBlank(pField, i, nLen);
+}
+
+int das_txt2long(const char* pField, int nLen, int64_t* pRes)
+{
+	bool bNeg;
+	uint64_t uMag = 0;
+
+	/* Allow one more in magnitude for INT64_MIN, trimmed below if positive */
+	int n = _das_txt2mag(pField, nLen, &bNeg, (uint64_t)INT64_MAX + 1, &uMag);
+	if(n == 0) return 0;
+
+	if(bNeg){
+		*pRes = (uMag == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -((int64_t)uMag);
+	}
+	else{
+		if(uMag > (uint64_t)INT64_MAX) return 0;
+		*pRes = (int64_t)uMag;
+	}
+	return n;
+}
+
+int das_txt2ulong(const char* pField, int nLen, uint64_t* pRes)
+{
+	bool bNeg;
+	uint64_t uMag = 0;
+	int n = _das_txt2mag(pField, nLen, &bNeg, UINT64_MAX, &uMag);
+	if(n == 0) return 0;
+	if(bNeg && (uMag != 0)) return 0;
+	*pRes = uMag;
+	return n;
+}
+
 double* das_csv2doubles(const char* arrayString, int* p_nitems )
 {
     int i;
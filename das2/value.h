@@ -501,6 +501,62 @@ DAS_API bool das_str2baseint(const char* str, int base, int* pRes);
  */
 DAS_API bool das_strn2baseint(const char* str, int nLen, int base, int* pRes);
 
+/** Fast, locale independent conversion of a bounded text field to a double
+ *
+ * This is the text ingest workhorse used by the das2 @c ascii encodings and
+ * das3 text codecs.  Leading and trailing blanks are skipped.  The field need
+ * not be null terminated, parsing stops after nLen bytes, at a '\0', or at the
+ * first character that can't continue the number.
+ *
+ * Values with at most 19 significant digits whose mantissa fits in 53 bits
+ * and whose decimal exponent is within +/-22 are converted exactly with a
+ * single multiply or divide.  Anything else (long mantissas, large exponents,
+ * inf, nan, hex floats) goes through das_strtod_c() so results are always
+ * the correctly rounded value strtod(3) would give.
+ *
+ * @param pField The start of the text field
+ *
+ * @param nLen The maximum number of bytes to inspect
+ *
+ * @param pRes The location to store the resulting 8-byte float.
+ *
+ * @returns The number of bytes consumed including surrounding blanks, or 0
+ *        if the field doesn't begin with a number.  A return less than
+ *        nLen means the number was followed by other text.
+ */
+DAS_API int das_txt2double(const char* pField, int nLen, double* pRes);
+
+/** Fast conversion of a bounded text field to a 4-byte float
+ *
+ * Same field handling as das_txt2double(), but the value is rounded directly
+ * to float precision.  Parsing to a double and narrowing would round twice
+ * and can land one ulp off.  Mantissas up to 2^24 with a decimal exponent
+ * within +/-10 take the exact fast path, anything else goes through
+ * das_strtof_c().
+ *
+ * @returns The number of bytes consumed including surrounding blanks, or 0
+ *        if the field doesn't begin with a number.
+ */
+DAS_API int das_txt2float(const char* pField, int nLen, float* pRes);
+
+/** Fast conversion of a bounded text field to a signed 64-bit integer
+ *
+ * Same field handling as das_txt2double().  Only base 10 digits with an
+ * optional sign are accepted.
+ *
+ * @returns The number of bytes consumed including surrounding blanks, or 0
+ *        if the field doesn't begin with an integer or the value would
+ *        overflow an int64_t.
+ */
+DAS_API int das_txt2long(const char* pField, int nLen, int64_t* pRes);
+
+/** Fast conversion of a bounded text field to an unsigned 64-bit integer
+ *
+ * Same as das_txt2long() except negative values, other than -0, are rejected
+ * instead of wrapping.
+ */
+DAS_API int das_txt2ulong(const char* pField, int nLen, uint64_t* pRes);
+
 /* Don't think these are used anywhere
 typedef struct das_real_array{
 	double* values;
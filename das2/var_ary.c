@@ -39,6 +39,10 @@ void _DasVar_copyTo(const DasVar* pThis, DasVar* pOther);
 
 DasStream* _DasVar_getStream(const DasVar* pThis);
 void _DasVarVec_encodeFrame(const DasVar* pVar, DasBuf* pBuf);
+DasErrCode _DasVar_castVals(
+	das_val_type vtIn, const ubyte* pIn, const ubyte* pFillIn, das_val_type vtOut,
+	ubyte* pOut, size_t uVals
+);
 
 /* ************************************************************************* */
 /* Array mapping functions */
@@ -801,6 +805,132 @@ DasAry* _DasVarAry_slowSubset(
 	return pSlice;
 }
 
+/* Bulk reads for both DasVarAry and DasVarVecAry.  Dense arrays are walked
+ * a row at a time using the array strides, rows that are contiguous in
+ * memory are converted with a single call.  Ragged arrays are read one
+ * location at a time so that missing values can be filled. */
+DasErrCode DasVarAry_getBlock(
+	const DasVar* pBase, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest
+){
+	const DasVarAry* pThis = (const DasVarAry*)pBase;
+
+	das_val_type vtEl = pBase->vt;
+	size_t uComp = 1;
+	if(pThis->varsubtype == D2V_GEOVEC){
+		vtEl  = das_geovec_eltype(&(((const DasVarVecAry*)pThis)->tplt));
+		uComp = ((const DasVarVecAry*)pThis)->tplt.ncomp;
+	}
+	size_t uElSz  = das_vt_size(vtEl);
+	size_t uPtSz  = uElSz * uComp;                 /* bytes per location in */
+	size_t uOutPt = das_vt_size(vtOut) * uComp;    /* bytes per location out */
+
+	int nAryRank = DasAry_rank(pThis->pAry);
+	ptrdiff_t aAryShape[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+	ptrdiff_t aAryStride[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+	if(DasAry_stride(pThis->pAry, aAryShape, aAryStride) < 1)
+		return das_error(DASERR_VAR, "Couldn't get strides for array %s", 
+			DasAry_id(pThis->pAry)
+		);
+
+	bool bRagged = false;
+	for(int d = 0; d < nAryRank; ++d)
+		if(aAryStride[d] < 0) bRagged = true;
+
+	const ubyte* pFill = DasAry_getFill(pThis->pAry);
+
+	ptrdiff_t aLoc[DASIDX_MAX];
+	memcpy(aLoc, pMin, nRank * sizeof(ptrdiff_t));
+	ptrdiff_t aRead[DASIDX_MAX] = {0};   /* internal index stays at 0 */
+	int nLast = nRank - 1;
+	int d, iLoc;
+	DasErrCode nRet;
+
+	if(bRagged){
+		const ubyte* pVal;
+		while(aLoc[0] < pMax[0]){
+			for(d = 0; d < nRank; ++d){
+				if(pThis->idxmap[d] != DASIDX_UNUSED)
+					aRead[ pThis->idxmap[d] ] = aLoc[d];
+			}
+			if(DasAry_validAt(pThis->pAry, aRead)){
+				pVal = DasAry_getAt(pThis->pAry, vtEl, aRead);
+				nRet = _DasVar_castVals(vtEl, pVal, pFill, vtOut, pDest, uComp);
+			}
+			else{
+				for(size_t c = 0; c < uComp; ++c){
+					nRet = _DasVar_castVals(
+						vtEl, pFill, pFill, vtOut, pDest + c*(uOutPt/uComp), 1
+					);
+					if(nRet != DAS_OKAY) break;
+				}
+			}
+			if(nRet != DAS_OKAY) return nRet;
+			pDest += uOutPt;
+
+			for(d = nLast; d > -1; --d){
+				aLoc[d] += 1;
+				if((d > 0) && (aLoc[d] == pMax[d]))
+					aLoc[d] = pMin[d];
+				else
+					break;
+			}
+		}
+		return DAS_OKAY;
+	}
+
+	/* Dense: byte strides for each variable index, 0 for degenerate ones */
+	ptrdiff_t aVarStride[DASIDX_MAX] = {0};
+	for(d = 0; d < nRank; ++d){
+		iLoc = pThis->idxmap[d];
+		if(iLoc == DASIDX_UNUSED) continue;
+		aRead[iLoc] = pMin[d];
+		aVarStride[d] = aAryStride[iLoc] * uElSz;
+	}
+	const ubyte* pFirst = DasAry_getAt(pThis->pAry, vtEl, aRead);
+	if(pFirst == NULL)
+		return das_error(DASERR_VAR, "Block start is not valid in array %s",
+			DasAry_id(pThis->pAry)
+		);
+
+	size_t uRow = (size_t)(pMax[nLast] - pMin[nLast]);
+	bool bContig = (uRow == 1) || (aVarStride[nLast] == (ptrdiff_t)uPtSz);
+	const ubyte* pRow;
+
+	for(;;){
+		pRow = pFirst;
+		for(d = 0; d < nLast; ++d) pRow += (aLoc[d] - pMin[d]) * aVarStride[d];
+
+		if(bContig){
+			nRet = _DasVar_castVals(vtEl, pRow, pFill, vtOut, pDest, uRow * uComp);
+			if(nRet != DAS_OKAY) return nRet;
+		}
+		else if(aVarStride[nLast] == 0){  /* not a function of the last index */
+			nRet = _DasVar_castVals(vtEl, pRow, pFill, vtOut, pDest, uComp);
+			if(nRet != DAS_OKAY) return nRet;
+			for(size_t u = 1; u < uRow; ++u)
+				memcpy(pDest + u*uOutPt, pDest, uOutPt);
+		}
+		else{
+			for(size_t u = 0; u < uRow; ++u){
+				nRet = _DasVar_castVals(
+					vtEl, pRow + u*aVarStride[nLast], pFill, vtOut, pDest + u*uOutPt, uComp
+				);
+				if(nRet != DAS_OKAY) return nRet;
+			}
+		}
+		pDest += uRow * uOutPt;
+
+		/* Roll all but the last index */
+		for(d = nLast - 1; d > -1; --d){
+			if(++aLoc[d] < pMax[d]) break;
+			aLoc[d] = pMin[d];
+		}
+		if(d < 0) break;
+	}
+	return DAS_OKAY;
+}
+
 /* subset algorithm router */
 
 DasAry* DasVarAry_subset(
@@ -958,6 +1088,7 @@ DasErrCode init_DasVarAry(
 	pThis->base.lengthIn   = DasVarAry_lengthIn;
 	pThis->base.isFill     = DasVarAry_isFill;
 	pThis->base.subset     = DasVarAry_subset;
+	pThis->base.getBlock   = DasVarAry_getBlock;
 	pThis->base.nExtRank   = nExtRank;
 	pThis->base.nIntRank   = nIntRank;
 	pThis->base.degenerate = DasVarAry_degenerate;
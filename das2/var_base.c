@@ -18,6 +18,9 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
 
 #include "stream.h"
 
@@ -25,6 +28,7 @@
 #include "variable.h"
 
 #include "dimension.h"
+#include "vector.h"
 
 /* This would be alot easier to implement in D using sumtype... oh well */
 
@@ -172,6 +176,7 @@ void _DasVar_copyTo(const DasVar* pThis, DasVar* pOther)
 	pOther->isFill     = pThis->isFill;
 	pOther->isNumeric  = pThis->isNumeric;
 	pOther->subset     = pThis->subset;
+	pOther->getBlock   = pThis->getBlock;
 	pOther->incRef     = pThis->incRef;
 	pOther->copy       = pThis->copy;
 	pOther->decRef     = pThis->decRef;
@@ -248,6 +253,252 @@ DasAry* DasVar_subset(
 	return pThis->subset(pThis, nRank, pMin, pMax);
 }
 
+/* ************************************************************************* */
+/* Bulk value access */
+
+/* Convert uVals contiguous values between the simple numeric types.  Shared
+   by the getBlock implementations of each variable type.  The input fill
+   value becomes the output type's default fill value, even if the types
+   match.  Values that can't be
+   represented in an integer output, including NaNs, are set to fill as well
+   since casting them is undefined.  Real values that don't fit in a float
+   are handled the same way. */
+
+/* In-range tests, integer inputs are checked against the integer limits and
+   real inputs against the exclusive real limits, either way the value can be
+   truncated to the output type without overflow */
+#define _RNG_I(x, LO, HI, LOR, HIR) \
+	((x) >= 0 ? ((uint64_t)(x) <= (HI)) : ((int64_t)(x) >= (LO)))
+#define _RNG_R(x, LO, HI, LOR, HIR) (((x) > (LOR)) && ((x) < (HIR)))
+#define _FLT_I(x) true
+#define _FLT_R(x) (!(fabs((double)(x)) > FLT_MAX))
+
+#define _CAST_LOOP(TO, TI, OKAY) { \
+	const TI* pI = (const TI*)pIn; TO* pO = (TO*)pOut; \
+	const TI fillIn = *((const TI*)pFillIn); \
+	const TO fillOut = *((const TO*)das_vt_fill(vtOut)); \
+	for(size_t u = 0; u < uVals; ++u) \
+		pO[u] = ((pI[u] != fillIn) && (OKAY)) ? (TO)pI[u] : fillOut; \
+}
+
+#define _CAST_FROM(TI, RNG, FLT) \
+	switch(vtOut){ \
+	case vtUByte:  _CAST_LOOP( uint8_t, TI, RNG(pI[u], 0, UINT8_MAX, -1.0, 256.0)); \
+		return DAS_OKAY; \
+	case vtByte:   _CAST_LOOP(  int8_t, TI, RNG(pI[u], INT8_MIN, INT8_MAX, -129.0, 128.0)); \
+		return DAS_OKAY; \
+	case vtUShort: _CAST_LOOP(uint16_t, TI, RNG(pI[u], 0, UINT16_MAX, -1.0, 65536.0)); \
+		return DAS_OKAY; \
+	case vtShort:  _CAST_LOOP( int16_t, TI, RNG(pI[u], INT16_MIN, INT16_MAX, -32769.0, 32768.0)); \
+		return DAS_OKAY; \
+	case vtUInt:   _CAST_LOOP(uint32_t, TI, RNG(pI[u], 0, UINT32_MAX, -1.0, 4294967296.0)); \
+		return DAS_OKAY; \
+	case vtInt:    _CAST_LOOP( int32_t, TI, RNG(pI[u], INT32_MIN, INT32_MAX, -2147483649.0, 2147483648.0)); \
+		return DAS_OKAY; \
+	case vtULong:  _CAST_LOOP(uint64_t, TI, RNG(pI[u], 0, UINT64_MAX, -1.0, 18446744073709551616.0)); \
+		return DAS_OKAY; \
+	case vtLong:   _CAST_LOOP( int64_t, TI, RNG(pI[u], INT64_MIN, INT64_MAX, -9223372036854775808.0, 9223372036854775808.0)); \
+		return DAS_OKAY; \
+	case vtFloat:  _CAST_LOOP(   float, TI, FLT(pI[u])); return DAS_OKAY; \
+	case vtDouble: _CAST_LOOP(  double, TI, true); return DAS_OKAY; \
+	default: break; \
+	}
+
+/* Same type, only the fill value changes */
+#define _FILL_SWAP(T) { \
+	T* pO = (T*)pOut; \
+	const T fillIn = *((const T*)pFillIn); \
+	const T fillOut = *((const T*)das_vt_fill(vtOut)); \
+	for(size_t u = 0; u < uVals; ++u) \
+		if(pO[u] == fillIn) pO[u] = fillOut; \
+}
+
+DasErrCode _DasVar_castVals(
+	das_val_type vtIn, const ubyte* pIn, const ubyte* pFillIn, das_val_type vtOut,
+	ubyte* pOut, size_t uVals
+){
+	if(vtIn == vtOut){
+		memmove(pOut, pIn, uVals * das_vt_size(vtIn));
+		if((pFillIn == NULL)||
+		   (memcmp(pFillIn, das_vt_fill(vtIn), das_vt_size(vtIn)) == 0))
+			return DAS_OKAY;
+
+		switch(vtIn){
+		case vtUByte:  _FILL_SWAP( uint8_t); break;
+		case vtByte:   _FILL_SWAP(  int8_t); break;
+		case vtUShort: _FILL_SWAP(uint16_t); break;
+		case vtShort:  _FILL_SWAP( int16_t); break;
+		case vtUInt:   _FILL_SWAP(uint32_t); break;
+		case vtInt:    _FILL_SWAP( int32_t); break;
+		case vtULong:  _FILL_SWAP(uint64_t); break;
+		case vtLong:   _FILL_SWAP( int64_t); break;
+		case vtFloat:  _FILL_SWAP(   float); break;
+		case vtDouble: _FILL_SWAP(  double); break;
+		default: break;  /* Times, text and such are copied as is */
+		}
+		return DAS_OKAY;
+	}
+	if(pFillIn == NULL)
+		pFillIn = (const ubyte*)das_vt_fill(vtIn);
+
+	switch(vtIn){
+	case vtUByte:  _CAST_FROM( uint8_t, _RNG_I, _FLT_I); break;
+	case vtByte:   _CAST_FROM(  int8_t, _RNG_I, _FLT_I); break;
+	case vtUShort: _CAST_FROM(uint16_t, _RNG_I, _FLT_I); break;
+	case vtShort:  _CAST_FROM( int16_t, _RNG_I, _FLT_I); break;
+	case vtUInt:   _CAST_FROM(uint32_t, _RNG_I, _FLT_I); break;
+	case vtInt:    _CAST_FROM( int32_t, _RNG_I, _FLT_I); break;
+	case vtULong:  _CAST_FROM(uint64_t, _RNG_I, _FLT_I); break;
+	case vtLong:   _CAST_FROM( int64_t, _RNG_I, _FLT_I); break;
+	case vtFloat:  _CAST_FROM(   float, _RNG_R, _FLT_R); break;
+	case vtDouble: _CAST_FROM(  double, _RNG_R, _FLT_R); break;
+	default: break;
+	}
+	return das_error(DASERR_VAR, "Can't convert %s values to %s in bulk",
+		das_vt_toStr(vtIn), das_vt_toStr(vtOut)
+	);
+}
+
+#undef _CAST_FROM
+#undef _CAST_LOOP
+#undef _FLT_R
+#undef _FLT_I
+#undef _RNG_R
+#undef _RNG_I
+
+/* Number of values in a block request, including vector components, or 0
+   if the request is invalid */
+static size_t _DasVar_blockVals(
+	const DasVar* pThis, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax
+){
+	size_t aShape[DASIDX_MAX] = DASIDX_INIT_BEGIN;
+	if(das_rng2shape(nRank, pMin, pMax, aShape) < 0)
+		return 0;
+
+	/* Catch reads past the end of known dimensions, ragged and degenerate 
+	   dimensions are left for the implementations to handle */
+	ptrdiff_t aVarShape[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+	if(pThis->vartype != D2V_CONST){
+		pThis->shape(pThis, aVarShape);
+		for(int d = 0; d < nRank; ++d){
+			if((aVarShape[d] >= 0)&&(pMax[d] > aVarShape[d])){
+				das_error(DASERR_VAR, "Block range %td to %td is outside index %d "
+					"of length %td", pMin[d], pMax[d], d, aVarShape[d]
+				);
+				return 0;
+			}
+		}
+	}
+
+	size_t uVals = 1;
+	for(int d = 0; d < nRank; ++d) uVals *= (size_t)(pMax[d] - pMin[d]);
+
+	if(pThis->vt == vtGeoVec){
+		ptrdiff_t aIntr[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+		if((pThis->intrShape(pThis, aIntr) != 1)||(aIntr[0] < 1)){
+			das_error(DASERR_VAR, "Can't determine the number of vector components");
+			return 0;
+		}
+		uVals *= (size_t)aIntr[0];
+	}
+	return uVals;
+}
+
+/* Slow fallback for variables without a getBlock function: run get() over
+   every location and convert each datum.  Locations get() can't read, such
+   as those past the end of a ragged index, are filled. */
+static DasErrCode _DasVar_getBlockGeneric(
+	const DasVar* pThis, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest
+){
+	ptrdiff_t aLoc[DASIDX_MAX] = DASIDX_INIT_BEGIN;
+	memcpy(aLoc, pMin, nRank * sizeof(ptrdiff_t));
+
+	size_t uOutSz = das_vt_size(vtOut);
+	const ubyte* pFillOut = (const ubyte*)das_vt_fill(vtOut);
+	size_t uComp = 1;
+	if(pThis->vt == vtGeoVec){
+		ptrdiff_t aIntr[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+		pThis->intrShape(pThis, aIntr);
+		uComp = (size_t)aIntr[0];
+	}
+
+	das_datum dm;
+	DasErrCode nRet = DAS_OKAY;
+	size_t c;
+	int d;
+
+	while(aLoc[0] < pMax[0]){
+		if(!pThis->get(pThis, aLoc, &dm)){
+			for(c = 0; c < uComp; ++c, pDest += uOutSz)
+				memcpy(pDest, pFillOut, uOutSz);
+		}
+		else if(dm.vt == vtGeoVec){
+			das_geovec* pVec = (das_geovec*)&dm;
+			nRet = _DasVar_castVals(
+				das_geovec_eltype(pVec), das_geovec_comp(pVec, 0), NULL, vtOut, pDest,
+				pVec->ncomp
+			);
+			pDest += uOutSz * pVec->ncomp;
+		}
+		else{
+			nRet = _DasVar_castVals(dm.vt, (const ubyte*)&dm, NULL, vtOut, pDest, 1);
+			pDest += uOutSz;
+		}
+		if(nRet != DAS_OKAY) return nRet;
+
+		for(d = nRank - 1; d > -1; --d){
+			aLoc[d] += 1;
+			if((d > 0) && (aLoc[d] == pMax[d]))
+				aLoc[d] = pMin[d];
+			else
+				break;
+		}
+	}
+	return DAS_OKAY;
+}
+
+ptrdiff_t DasVar_getBlock(
+	const DasVar* pThis, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest, size_t uDestLen
+){
+	if((vtOut < vtUByte)||(vtOut > vtDouble))
+		return -1 * das_error(DASERR_VAR, "Block output must be a simple numeric "
+			"type, not %s", das_vt_toStr(vtOut)
+		);
+
+	/* Constants are degenerate in every index, so any rank will do */
+	if((nRank < 1)||(nRank > pThis->nExtRank)||
+	   ((pThis->vartype != D2V_CONST)&&(nRank != pThis->nExtRank)))
+		return -1 * das_error(DASERR_VAR, "External variable is rank %d, but block "
+			"specification is rank %d", pThis->nExtRank, nRank
+		);
+
+	if(((pThis->vt < vtUByte)||(pThis->vt > vtDouble))&&(pThis->vt != vtGeoVec))
+		return -1 * das_error(DASERR_VAR, "Block access is only available for "
+			"numeric variables, not %s", das_vt_toStr(pThis->vt)
+		);
+
+	size_t uVals = _DasVar_blockVals(pThis, nRank, pMin, pMax);
+	if(uVals == 0)
+		return -1 * DASERR_VAR;
+
+	if(uVals > uDestLen)
+		return -1 * das_error(DASERR_VAR, "Block has %zu values but the output "
+			"buffer only holds %zu", uVals, uDestLen
+		);
+
+	DasErrCode nRet;
+	if(pThis->getBlock != NULL)
+		nRet = pThis->getBlock(pThis, nRank, pMin, pMax, vtOut, pDest);
+	else
+		nRet = _DasVar_getBlockGeneric(pThis, nRank, pMin, pMax, vtOut, pDest);
+
+	if(nRet != DAS_OKAY)
+		return -1 * nRet;
+	return (ptrdiff_t)uVals;
+}
+
 bool DasVar_isNumeric(const DasVar* pThis)
 {
 	return pThis->isNumeric(pThis);
@@ -33,9 +33,38 @@ char* _DasVar_prnUnits(const DasVar* pThis, char* sBuf, int nLen);
 char* _DasVar_prnRange(const DasVar* pThis, char* sBuf, int nLen);
 char* _DasVar_prnType(const DasVar* pThis, char* pWrite, int nLen);
 int _DasVar_noIntrShape(const DasVar* pBase, ptrdiff_t* pShape);
+DasErrCode _DasVar_castVals(
+	das_val_type vtIn, const ubyte* pIn, const ubyte* pFillIn, das_val_type vtOut,
+	ubyte* pOut, size_t uVals
+);
 
 
 
+/* ************************************************************************* */
+/* Compiled expressions */
+
+/* A binary expression tree is flattened once, when it's built, into a postfix
+ * instruction list.  Load instructions read a block of leaf values and push
+ * it, operator instructions pop two blocks and push the result.  Unit scaling
+ * is resolved at compile time and carried on the operator.  Evaluation runs
+ * the whole list over a slab of values at a time so the per-element cost is
+ * a single tight loop per operator instead of a datum round trip per node. */
+
+#define _BIN_LOAD 0
+
+typedef struct bin_instr{
+	int nOp;             /* _BIN_LOAD or one of the D2BOP_ values */
+	const DasVar* pLeaf; /* For loads, the variable to read */
+	double rScale;       /* For operators, factor for the right hand block */
+} bin_instr;
+
+typedef struct bin_prog{
+	das_val_type vtCalc; /* vtFloat or vtDouble, all blocks use this type */
+	int nDepth;          /* Maximum stack depth while evaluating */
+	int nInstr;
+	bin_instr aInstr[];
+} bin_prog;
+
 /* ************************************************************************* */
 /* Binary functions on other Variables */
 
@@ -51,8 +80,17 @@ typedef struct das_var_binary{
 	double  rRightScale; /* Scaling factor for right hand values */
 
 	das_val_type et;     /* Pre calculated element type, avoid sub-calls*/
+
+	bin_prog* pProg;     /* Compiled form for block reads, NULL if the tree
+	                      * has non-numeric parts */
 } DasVarBinary;
 
+bin_prog* _DasVarBinary_compile(const DasVarBinary* pThis);
+DasErrCode DasVarBinary_getBlock(
+	const DasVar* pBase, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest
+);
+
 /* Shared base-class copy helper (var_base.c); no public prototype, so declare it
    locally the same way the other copy_DasVar* implementations do. */
 void _DasVar_copyTo(const DasVar* pThis, DasVar* pOther);
@@ -75,6 +113,10 @@ DasVar* copy_DasVarBinary(const DasVar* pBase)
 	pRet->pLeft  = pThis->pLeft->copy(pThis->pLeft);
 	pRet->pRight = pThis->pRight->copy(pThis->pRight);
 
+	/* The program points at the operands, so it can't be shared */
+	pRet->pProg = _DasVarBinary_compile(pRet);
+	pRet->base.getBlock = (pRet->pProg != NULL) ? pThis->base.getBlock : NULL;
+
 	return (DasVar*)pRet;
 }
 
@@ -394,7 +436,7 @@ bool DasVarBinary_get(const DasVar* pBase, ptrdiff_t* pIdx, das_datum* pDatum)
 		case D2BOP_SUB: *((double*)pDatum) -= *((double*)&dmRight); break;
 		case D2BOP_MUL: *((double*)pDatum) *= *((double*)&dmRight); break;
 		case D2BOP_DIV: *((double*)pDatum) /= *((double*)&dmRight); break;
-		case D2BOP_POW: *((double*)pDatum) = pow(*((double*)&dmRight), *((double*)pDatum)); break;
+		case D2BOP_POW: *((double*)pDatum) = pow(*((double*)pDatum), *((double*)&dmRight)); break;
 		default:
 			das_error(DASERR_NOTIMP, "Binary operation not yet implemented ");
 		}
@@ -475,14 +517,24 @@ DasAry* DasVarBinary_subset(
 	
 	if(pAry == NULL) return NULL;
 	
+	size_t uTotCount;
+	ubyte* pWrite = DasAry_getBuf(pAry, pBase->vt, DIM0, &uTotCount);
+
+	/* Compiled trees fill the whole array in one go */
+	if(pThis->pProg != NULL){
+		if(DasVarBinary_getBlock(pBase, nRank, pMin, pMax, pBase->vt, pWrite) != DAS_OKAY){
+			dec_DasAry(pAry);
+			return NULL;
+		}
+		return pAry;
+	}
+
 	/* Going to take the slow boat from China on this one.  Just repeatedly
 	 * invoke the get function */
 	
 	ptrdiff_t pIdx[DASIDX_MAX] = DASIDX_INIT_UNUSED;
 	memcpy(pIdx, pMin,  pBase->nExtRank * sizeof(ptrdiff_t));
 	
-	size_t uTotCount;
-	ubyte* pWrite = DasAry_getBuf(pAry, pBase->vt, DIM0, &uTotCount);
 	das_datum dm;
 #ifndef NDEBUG
 	size_t vSzChk = DasAry_valSize(pAry);
@@ -521,6 +573,175 @@ DasAry* DasVarBinary_subset(
 	return pAry;
 }
 
+/* Count the instructions needed for a sub-tree, or return -1 if any part of
+ * it can't be evaluated as plain numbers */
+static int _bin_count(const DasVar* pVar, bool* pDouble)
+{
+	if(pVar->vartype != D2V_BINARY_OP){
+		if((pVar->vt < vtUByte)||(pVar->vt > vtDouble)) return -1;
+		if(pVar->vt != vtFloat) *pDouble = true;
+		return 1;
+	}
+
+	const DasVarBinary* pNode = (const DasVarBinary*)pVar;
+	if((pVar->vt != vtFloat)&&(pVar->vt != vtDouble)) return -1;
+	if((pVar->vt == vtDouble)||(pNode->rRightScale != 1.0)) *pDouble = true;
+
+	int nLeft = _bin_count(pNode->pLeft, pDouble);
+	if(nLeft < 0) return -1;
+	int nRight = _bin_count(pNode->pRight, pDouble);
+	if(nRight < 0) return -1;
+	return nLeft + nRight + 1;
+}
+
+/* Emit postfix instructions for a sub-tree, returns the stack depth needed */
+static int _bin_emit(const DasVar* pVar, bin_prog* pProg)
+{
+	bin_instr* pIn;
+	if(pVar->vartype != D2V_BINARY_OP){
+		pIn = pProg->aInstr + pProg->nInstr++;
+		pIn->nOp = _BIN_LOAD;
+		pIn->pLeaf = pVar;
+		pIn->rScale = 1.0;
+		return 1;
+	}
+
+	const DasVarBinary* pNode = (const DasVarBinary*)pVar;
+	int nLeft = _bin_emit(pNode->pLeft, pProg);
+	int nRight = _bin_emit(pNode->pRight, pProg) + 1; /* left is still pushed */
+
+	pIn = pProg->aInstr + pProg->nInstr++;
+	pIn->nOp = pNode->nOp;
+	pIn->pLeaf = NULL;
+	pIn->rScale = pNode->rRightScale;
+	return (nLeft > nRight) ? nLeft : nRight;
+}
+
+bin_prog* _DasVarBinary_compile(const DasVarBinary* pThis)
+{
+	bool bDouble = false;
+	int nInstr = _bin_count((const DasVar*)pThis, &bDouble);
+	if(nInstr < 0) return NULL;
+
+	bin_prog* pProg = (bin_prog*)calloc(
+		1, sizeof(bin_prog) + nInstr * sizeof(bin_instr)
+	);
+	if(pProg == NULL) return NULL;
+
+	pProg->vtCalc = bDouble ? vtDouble : vtFloat;
+	pProg->nDepth = _bin_emit((const DasVar*)pThis, pProg);
+	assert(pProg->nInstr == nInstr);
+	return pProg;
+}
+
+/* Bulk reads.  The compiled program is run a slab of the first index at a
+ * time.  Each leaf is read straight into its stack block in the calculation
+ * type and each operator is a plain loop over the slab. */
+#define _BIN_SLAB 4096
+
+#define _BIN_LOOP(T, POW) \
+	if(rScale != 1.0){ \
+		for(u = 0; u < uN; ++u) ((T*)pR)[u] = (T)(((T*)pR)[u] * rScale); \
+	} \
+	switch(pIn->nOp){ \
+	case D2BOP_ADD: for(u = 0; u < uN; ++u) ((T*)pOut)[u] = ((T*)pL)[u] + ((T*)pR)[u]; break; \
+	case D2BOP_SUB: for(u = 0; u < uN; ++u) ((T*)pOut)[u] = ((T*)pL)[u] - ((T*)pR)[u]; break; \
+	case D2BOP_MUL: for(u = 0; u < uN; ++u) ((T*)pOut)[u] = ((T*)pL)[u] * ((T*)pR)[u]; break; \
+	case D2BOP_DIV: for(u = 0; u < uN; ++u) ((T*)pOut)[u] = ((T*)pL)[u] / ((T*)pR)[u]; break; \
+	case D2BOP_POW: for(u = 0; u < uN; ++u) ((T*)pOut)[u] = POW(((T*)pL)[u], ((T*)pR)[u]); break; \
+	default: nRet = das_error(DASERR_NOTIMP, "Binary operation not yet implemented "); break; \
+	}
+
+DasErrCode DasVarBinary_getBlock(
+	const DasVar* pBase, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest
+){
+	const DasVarBinary* pThis = (const DasVarBinary*)pBase;
+	const bin_prog* pProg = pThis->pProg;
+	if(pProg == NULL)
+		return das_error(DASERR_VAR, "Block reads of %s binary operations are not "
+			"supported", das_vt_toStr(pBase->vt)
+		);
+
+	das_val_type vtCalc = pProg->vtCalc;
+	size_t uCalcSz = das_vt_size(vtCalc);
+
+	size_t uInner = 1;
+	for(int d = 1; d < nRank; ++d) uInner *= (size_t)(pMax[d] - pMin[d]);
+	ptrdiff_t nSlab = (ptrdiff_t)(_BIN_SLAB / uInner);
+	if(nSlab < 1) nSlab = 1;
+	if(nSlab > pMax[0] - pMin[0]) nSlab = pMax[0] - pMin[0];
+
+	/* One block per stack level */
+	size_t uMax = (size_t)nSlab * uInner;
+	ubyte* pStack = (ubyte*)malloc(pProg->nDepth * uMax * uCalcSz);
+	if(pStack == NULL)
+		return das_error(DASERR_VAR, "Couldn't allocate %zu bytes",
+			pProg->nDepth * uMax * uCalcSz
+		);
+
+	ptrdiff_t aMin[DASIDX_MAX];
+	ptrdiff_t aMax[DASIDX_MAX];
+	memcpy(aMin, pMin, nRank * sizeof(ptrdiff_t));
+	memcpy(aMax, pMax, nRank * sizeof(ptrdiff_t));
+
+	bool bDirect = (vtOut == vtCalc);
+	size_t uOutSz = das_vt_size(vtOut);
+	DasErrCode nRet = DAS_OKAY;
+	const bin_instr* pIn;
+	ubyte* pL; ubyte* pR; ubyte* pOut;
+	double rScale;
+	size_t u, uN;
+	int i, nTop;
+
+	for(ptrdiff_t i0 = pMin[0]; i0 < pMax[0]; i0 += nSlab){
+		aMin[0] = i0;
+		aMax[0] = (i0 + nSlab < pMax[0]) ? i0 + nSlab : pMax[0];
+		uN = (size_t)(aMax[0] - i0) * uInner;
+
+		nTop = 0;
+		for(i = 0; i < pProg->nInstr; ++i){
+			pIn = pProg->aInstr + i;
+
+			if(pIn->nOp == _BIN_LOAD){
+				pL = pStack + nTop * uMax * uCalcSz;
+				if(DasVar_getBlock(pIn->pLeaf, nRank, aMin, aMax, vtCalc, pL, uN) < 0){
+					nRet = DASERR_VAR;
+					break;
+				}
+				++nTop;
+				continue;
+			}
+
+			/* The root operator can write straight to the output */
+			pL = pStack + (nTop - 2) * uMax * uCalcSz;
+			pR = pL + uMax * uCalcSz;
+			pOut = (bDirect && (i == pProg->nInstr - 1)) ? pDest : pL;
+			rScale = pIn->rScale;
+			if(vtCalc == vtDouble){
+				_BIN_LOOP(double, pow);
+			}
+			else{
+				_BIN_LOOP(float, powf);
+			}
+			if(nRet != DAS_OKAY) break;
+			--nTop;
+		}
+		if(nRet != DAS_OKAY) break;
+
+		if(!bDirect){
+			if((nRet = _DasVar_castVals(vtCalc, pStack, NULL, vtOut, pDest, uN)) != DAS_OKAY)
+				break;
+		}
+		pDest += uN * uOutSz;
+	}
+
+	free(pStack);
+	return nRet;
+}
+
+#undef _BIN_LOOP
+
 /* Fill propogates, if either item is fill, the result is fill */
 bool DasVarBinary_isFill(const DasVar* pBase, const ubyte* pCheck, das_val_type vt)
 {
@@ -538,6 +759,7 @@ int dec_DasVarBinary(DasVar* pBase){
 	DasVarBinary* pThis = (DasVarBinary*)pBase;
 	pThis->pLeft->decRef(pThis->pLeft);
 	pThis->pRight->decRef(pThis->pRight);
+	free(pThis->pProg);
 	DasDesc_freeProps((DasDesc*)pBase);
 	free(pThis);
 	return 0;
@@ -602,6 +824,7 @@ DasVar* new_DasVarBinary_tok(
 	pThis->base.isFill     = DasVarBinary_isFill;
 	pThis->base.isNumeric  = DasVarBinary_isNumeric;
 	pThis->base.subset     = DasVarBinary_subset;
+	pThis->base.getBlock   = DasVarBinary_getBlock;
 	
 	pThis->base.incRef     = inc_DasVar;
 	pThis->base.decRef     = dec_DasVarBinary;
@@ -689,6 +912,11 @@ DasVar* new_DasVarBinary_tok(
 	
 	pRight->incRef(pRight);
 	pLeft->incRef(pLeft);
+
+	/* Flatten the tree for block reads, anything that doesn't compile uses
+	   the generic per-element path */
+	pThis->pProg = _DasVarBinary_compile(pThis);
+	if(pThis->pProg == NULL) pThis->base.getBlock = NULL;
 	
 	return &(pThis->base);
 }
@@ -28,6 +28,10 @@
 char* _DasVar_prnUnits(const DasVar* pThis, char* sBuf, int nLen);
 char* _DasVar_prnType(const DasVar* pThis, char* pWrite, int nLen);
 int _DasVar_noIntrShape(const DasVar* pBase, ptrdiff_t* pShape);
+DasErrCode _DasVar_castVals(
+	das_val_type vtIn, const ubyte* pIn, const ubyte* pFillIn, das_val_type vtOut,
+	ubyte* pOut, size_t uVals
+);
 
 /* ************************************************************************* */
 /* Constants */
@@ -198,6 +202,31 @@ DasAry* DasConstant_subset(
 	return pAry;
 }
 
+/* Convert the value once, then fill the block by doubling copies */
+DasErrCode DasConstant_getBlock(
+	const DasVar* pBase, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest
+){
+	const DasConstant* pThis = (const DasConstant*)pBase;
+
+	DasErrCode nRet = _DasVar_castVals(
+		pThis->datum.vt, (const ubyte*)&(pThis->datum), NULL, vtOut, pDest, 1
+	);
+	if(nRet != DAS_OKAY) return nRet;
+
+	size_t uLocs = 1;
+	for(int d = 0; d < nRank; ++d) uLocs *= (size_t)(pMax[d] - pMin[d]);
+
+	size_t uTotal = uLocs * das_vt_size(vtOut);
+	size_t uDone  = das_vt_size(vtOut);
+	while(uDone < uTotal){
+		size_t uCopy = (uDone < (uTotal - uDone)) ? uDone : (uTotal - uDone);
+		memcpy(pDest + uDone, pDest, uCopy);
+		uDone += uCopy;
+	}
+	return DAS_OKAY;
+}
+
 bool DasConstant_degenerate(const DasVar* pBase, int iIdx)
 {
 	return true;
@@ -239,6 +268,7 @@ DasVar* new_DasConstant(const char* sId, const das_datum* pDm)
 	pThis->base.isFill     = DasConstant_isFill;
 	pThis->base.isNumeric  = DasConstant_isNumeric;
 	pThis->base.subset     = DasConstant_subset;
+	pThis->base.getBlock   = DasConstant_getBlock;
 	pThis->base.incRef     = inc_DasVar;
 	pThis->base.decRef     = dec_DasConstant;
 	pThis->base.copy       = copy_DasConstant;
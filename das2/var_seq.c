@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include <assert.h>
+#include <math.h>
 
 #include "dataset.h"
 #include "vector.h"   /* das_geovec + accessors for vtGeoVec sequences */
@@ -32,6 +33,10 @@ char* _DasVar_prnType(const DasVar* pThis, char* pWrite, int nLen);
 int _DasVar_noIntrShape(const DasVar* pBase, ptrdiff_t* pShape);
 DasStream* _DasVar_getStream(const DasVar* pThis);
 void _DasVarVec_encodeFrame(const DasVar* pVar, DasBuf* pBuf);
+DasErrCode _DasVar_castVals(
+	das_val_type vtIn, const ubyte* pIn, const ubyte* pFillIn, das_val_type vtOut,
+	ubyte* pOut, size_t uVals
+);
 
 
 /* ************************************************************************* */
@@ -470,6 +475,99 @@ DasAry* DasVarSeq_subset(
 	return pAry;
 }
 
+/* Bulk reads.  Values are generated a row (last index) at a time into a
+ * small scratch buffer and converted from there.  Floating point rows that
+ * depend on the last index are filled directly from the row's starting value,
+ * using the same arithmetic as das_value_accum() so they match 
+ * DasVarSeq_get() exactly.  Everything else runs _DasVarSeq_calc() per
+ * location, which still avoids the datum and dispatch overhead of get(). */
+#define _SEQ_CHUNK 256
+
+DasErrCode DasVarSeq_getBlock(
+	const DasVar* pBase, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest
+){
+	const DasVarSeq* pThis = (const DasVarSeq*)pBase;
+
+	das_val_type vtEl = pBase->vt;
+	size_t uComp = 1;
+	if(vtEl == vtGeoVec){
+		vtEl  = das_geovec_eltype((const das_geovec*)pThis->B);
+		uComp = das_geovec_numComp((const das_geovec*)pThis->B);
+	}
+	size_t uPtSz  = das_vt_size(vtEl) * uComp;
+	size_t uOutPt = das_vt_size(vtOut) * uComp;
+
+	/* Slope on the last index, if the sequence depends on it */
+	int nLast = nRank - 1;
+	int kLast = -1;
+	for(int k = 0; k < pThis->nDeps; ++k)
+		if(pThis->aDep[k] == nLast) kLast = k;
+
+	bool bLinear = (kLast == pThis->nDeps - 1) && 
+	               ((vtEl == vtDouble)||(vtEl == vtFloat)) && (uComp == 1);
+
+	uint64_t aScratch[_SEQ_CHUNK * 3];    /* room for 3-component vectors */
+	ubyte* pScratch = (ubyte*)aScratch;
+	ubyte value[DATUM_BUF_SZ];
+
+	ptrdiff_t aLoc[DASIDX_MAX];
+	memcpy(aLoc, pMin, nRank * sizeof(ptrdiff_t));
+	ptrdiff_t nBeg, nEnd, n;
+	DasErrCode nRet;
+	int d;
+
+	for(;;){
+		/* Start of the row, for linear rows this excludes the last term */
+		if(bLinear){
+			aLoc[nLast] = 0;
+			if(!_DasVarSeq_calc(pThis, aLoc, value)) return DASERR_VAR;
+		}
+
+		for(nBeg = pMin[nLast]; nBeg < pMax[nLast]; nBeg = nEnd){
+			nEnd = nBeg + _SEQ_CHUNK;
+			if(nEnd > pMax[nLast]) nEnd = pMax[nLast];
+
+			if(bLinear && (vtEl == vtDouble)){
+				double rM = *((const double*)pThis->M[kLast]);
+				double rB = *((const double*)value);
+				double* pOut = (double*)pScratch;
+				for(n = nBeg; n < nEnd; ++n) pOut[n - nBeg] = rM * (double)n + rB;
+				if(!isfinite(pOut[0]) || !isfinite(pOut[nEnd - nBeg - 1]))
+					return das_error(DASERR_VAR, "Overflow evaluating sequence %s", pThis->sId);
+			}
+			else if(bLinear){
+				float rM = *((const float*)pThis->M[kLast]);
+				float rB = *((const float*)value);
+				float* pOut = (float*)pScratch;
+				for(n = nBeg; n < nEnd; ++n) pOut[n - nBeg] = rM * (float)n + rB;
+				if(!isfinite(pOut[0]) || !isfinite(pOut[nEnd - nBeg - 1]))
+					return das_error(DASERR_VAR, "Overflow evaluating sequence %s", pThis->sId);
+			}
+			else{
+				for(n = nBeg; n < nEnd; ++n){
+					aLoc[nLast] = n;
+					if(!_DasVarSeq_calc(pThis, aLoc, value)) return DASERR_VAR;
+					/* geovec components are packed at the front of the struct */
+					memcpy(pScratch + (n - nBeg)*uPtSz, value, uPtSz);
+				}
+			}
+
+			nRet = _DasVar_castVals(vtEl, pScratch, NULL, vtOut, pDest, (nEnd - nBeg)*uComp);
+			if(nRet != DAS_OKAY) return nRet;
+			pDest += (nEnd - nBeg) * uOutPt;
+		}
+
+		/* Roll all but the last index */
+		for(d = nLast - 1; d > -1; --d){
+			if(++aLoc[d] < pMax[d]) break;
+			aLoc[d] = pMin[d];
+		}
+		if(d < 0) break;
+	}
+	return DAS_OKAY;
+}
+
 bool DasVarSeq_degenerate(const DasVar* pBase, int iIndex)
 {
 	DasVarSeq* pThis = (DasVarSeq*)pBase;
@@ -528,6 +626,7 @@ DasVar* new_DasVarSeq(
 	pThis->base.lengthIn   = DasVarSeq_lengthIn;
 	pThis->base.isFill     = DasVarSeq_isFill;
 	pThis->base.subset     = DasVarSeq_subset;
+	pThis->base.getBlock   = DasVarSeq_getBlock;
 	pThis->base.degenerate = DasVarSeq_degenerate;
 	pThis->base.elemType   = DasVarSeq_elemType;
 
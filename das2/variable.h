@@ -335,6 +335,13 @@ typedef struct das_variable{
 		const struct das_variable* pThis, int nRank, const ptrdiff_t* pMin,
 		const ptrdiff_t* pMax
 	);
+
+	/* Write values for a range of indices into a contiguous buffer, may be 
+	 * NULL in which case DasVar_getBlock() falls back to calling get() */
+	DasErrCode (*getBlock)(
+		const struct das_variable* pThis, int nRank, const ptrdiff_t* pMin,
+		const ptrdiff_t* pMax, das_val_type vtOut, ubyte* pDest
+	);
 	
 	/** Increment the reference count for this variable and return the new count */
 	int (*incRef)(struct das_variable* pThis);
@@ -1077,6 +1084,51 @@ DAS_API DasAry* DasVar_subset(
 	const DasVar* pThis, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax
 );
 
+/** Copy a block of values from a variable into a contiguous typed buffer
+ *
+ * This is the bulk version of DasVar_get().  The value at every location in
+ * the range is written to pDest in row-major order (last index varies
+ * fastest), converted to vtOut.  Each variable type
+ * fills the block using strided copies or whole-row arithmetic instead of
+ * a function call and datum per value, so exporters that need all of a
+ * variable's values should prefer this function to iterating with
+ * DasVar_get().
+ *
+ * Geometric vector variables write all of their components for each
+ * location, so the output holds ncomp values per location.  Input fill
+ * values are written as the default fill value for vtOut, see das_vt_fill(),
+ * even if vtOut is the variable's own type, as are locations past the end of
+ * a ragged index.  Values that are out of
+ * range for an integer vtOut, or for vtFloat, and NaNs converted to integers
+ * are also written as fill, so narrowing conversions never overflow.
+ *
+ * @param pThis the variable in question.
+ *
+ * @param nRank The length of the range arrays, which should be the same as
+ *             the rank of the dataset.  This argument is set when using the
+ *             range macros (i.e. RNG_1, RNG_2, ...)
+ *
+ * @param pMin The inclusive lower bound for each index.
+ *
+ * @param pMax The exclusive upper bound for each index.
+ *
+ * @param vtOut The output value type, one of vtUByte through vtDouble.
+ *
+ * @param pDest The output buffer, aligned for vtOut
+ *
+ * @param uDestLen The number of vtOut values pDest can hold
+ *
+ * @returns The number of values written, or a negative error code if the
+ *          range is invalid, pDest is too small or the variable doesn't
+ *          hold numbers.
+ *
+ * @memberof DasVar
+ */
+DAS_API ptrdiff_t DasVar_getBlock(
+	const DasVar* pThis, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax,
+	das_val_type vtOut, ubyte* pDest, size_t uDestLen
+);
+
 /** A small utility helper, make a component lable for a variable 
  * 
  * This function follows a heuristic to try and produce reasonable component
@@ -0,0 +1,532 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(DAS_NO_SIMD)
+#define _DAS_XFORM_SIMD
+#include <emmintrin.h>
+#endif
+
+#include "util.h"
+#include "vector.h"
+#include "xform.h"
+
+/* ************************************************************************* */
+/* Quaternions, (w, x, y, z) order */
+
+void das_quat_fromMat(const double m[3][3], double q[4])
+{
+	/* Shepperd's method, divide by the largest of the four candidates */
+	double rTrace = m[0][0] + m[1][1] + m[2][2];
+	double s;
+
+	if(rTrace > 0.0){
+		s = 2.0 * sqrt(rTrace + 1.0);
+		q[0] = 0.25 * s;
+		q[1] = (m[2][1] - m[1][2]) / s;
+		q[2] = (m[0][2] - m[2][0]) / s;
+		q[3] = (m[1][0] - m[0][1]) / s;
+	}
+	else if((m[0][0] > m[1][1])&&(m[0][0] > m[2][2])){
+		s = 2.0 * sqrt(1.0 + m[0][0] - m[1][1] - m[2][2]);
+		q[0] = (m[2][1] - m[1][2]) / s;
+		q[1] = 0.25 * s;
+		q[2] = (m[0][1] + m[1][0]) / s;
+		q[3] = (m[0][2] + m[2][0]) / s;
+	}
+	else if(m[1][1] > m[2][2]){
+		s = 2.0 * sqrt(1.0 + m[1][1] - m[0][0] - m[2][2]);
+		q[0] = (m[0][2] - m[2][0]) / s;
+		q[1] = (m[0][1] + m[1][0]) / s;
+		q[2] = 0.25 * s;
+		q[3] = (m[1][2] + m[2][1]) / s;
+	}
+	else{
+		s = 2.0 * sqrt(1.0 + m[2][2] - m[0][0] - m[1][1]);
+		q[0] = (m[1][0] - m[0][1]) / s;
+		q[1] = (m[0][2] + m[2][0]) / s;
+		q[2] = (m[1][2] + m[2][1]) / s;
+		q[3] = 0.25 * s;
+	}
+}
+
+void das_quat_toMat(const double q[4], double m[3][3])
+{
+	double rNorm2 = q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3];
+	double s = (rNorm2 > 0.0) ? 2.0 / rNorm2 : 0.0;
+
+	double w = q[0], x = q[1], y = q[2], z = q[3];
+
+	m[0][0] = 1.0 - s*(y*y + z*z);
+	m[0][1] = s*(x*y - z*w);
+	m[0][2] = s*(x*z + y*w);
+
+	m[1][0] = s*(x*y + z*w);
+	m[1][1] = 1.0 - s*(x*x + z*z);
+	m[1][2] = s*(y*z - x*w);
+
+	m[2][0] = s*(x*z - y*w);
+	m[2][1] = s*(y*z + x*w);
+	m[2][2] = 1.0 - s*(x*x + y*y);
+}
+
+void das_quat_slerp(
+	const double aQ0[4], const double aQ1[4], double rFrac, double aOut[4]
+){
+	int i;
+	double aQ1s[4];
+	double rDot = aQ0[0]*aQ1[0] + aQ0[1]*aQ1[1] + aQ0[2]*aQ1[2] + aQ0[3]*aQ1[3];
+
+	/* q and -q are the same rotation, take the short way around */
+	if(rDot < 0.0){
+		rDot = -rDot;
+		for(i = 0; i < 4; ++i) aQ1s[i] = -aQ1[i];
+	}
+	else{
+		for(i = 0; i < 4; ++i) aQ1s[i] = aQ1[i];
+	}
+
+	double r0, r1;
+	if(rDot > 1.0 - 1e-9){
+		/* Within about 1e-4 rad, sin(theta) is too small to divide by, but
+		   the linear blend is good to better than 1e-13 rad here */
+		r0 = 1.0 - rFrac;
+		r1 = rFrac;
+	}
+	else{
+		double rTheta = acos(rDot);
+		double rSin = sin(rTheta);
+		r0 = sin((1.0 - rFrac)*rTheta) / rSin;
+		r1 = sin(rFrac*rTheta) / rSin;
+	}
+
+	double rNorm = 0.0;
+	for(i = 0; i < 4; ++i){
+		aOut[i] = r0*aQ0[i] + r1*aQ1s[i];
+		rNorm += aOut[i]*aOut[i];
+	}
+	rNorm = sqrt(rNorm);
+	for(i = 0; i < 4; ++i) aOut[i] /= rNorm;
+}
+
+double das_quat_angle(const double aQ0[4], const double aQ1[4])
+{
+	/* 4*atan2(|q0 - q1|, |q0 + q1|) keeps full precision near zero where
+	   2*acos(q0.q1) does not */
+	int i;
+	double rDot = 0.0, rDiff = 0.0, rSum = 0.0;
+	for(i = 0; i < 4; ++i) rDot += aQ0[i]*aQ1[i];
+	double s = (rDot < 0.0) ? -1.0 : 1.0;
+
+	for(i = 0; i < 4; ++i){
+		rDiff += (aQ0[i] - s*aQ1[i])*(aQ0[i] - s*aQ1[i]);
+		rSum  += (aQ0[i] + s*aQ1[i])*(aQ0[i] + s*aQ1[i]);
+	}
+	return 4.0 * atan2(sqrt(rDiff), sqrt(rSum));
+}
+
+/* ************************************************************************* */
+/* Hermite states */
+
+void das_hermite3(
+	const double aS0[6], const double aS1[6], double rDt, double rFrac,
+	double aOut[6]
+){
+	int i;
+	if(rDt == 0.0){
+		memcpy(aOut, aS0, 6*sizeof(double));
+		return;
+	}
+
+	double s = rFrac, s2 = rFrac*rFrac, s3 = rFrac*rFrac*rFrac;
+
+	double h00 = 2*s3 - 3*s2 + 1,  d00 = 6*s2 - 6*s;
+	double h10 = s3 - 2*s2 + s,    d10 = 3*s2 - 4*s + 1;
+	double h01 = -2*s3 + 3*s2,     d01 = -6*s2 + 6*s;
+	double h11 = s3 - s2,          d11 = 3*s2 - 2*s;
+
+	for(i = 0; i < 3; ++i){
+		aOut[i] = h00*aS0[i] + h10*rDt*aS0[i+3] + h01*aS1[i] + h11*rDt*aS1[i+3];
+		aOut[i+3] = (d00*aS0[i] + d01*aS1[i])/rDt + d10*aS0[i+3] + d11*aS1[i+3];
+	}
+}
+
+/* ************************************************************************* */
+/* Adaptive sampling */
+
+#define _SAMP_ROT   9
+#define _SAMP_STATE 6
+
+/* Deep enough for a bisection over any size_t range */
+#define _SAMP_STACK 130
+
+typedef struct sampler {
+	size_t uStride;          /* _SAMP_ROT or _SAMP_STATE */
+	const double* pTimes;
+	double rTol;
+	das_rot_fn fnRot;
+	das_state_fn fnState;
+	void* pUser;
+	double* pVals;
+	bool* pValid;
+	size_t uCalls;
+} sampler_t;
+
+/* Evaluate record i exactly, or copy record iPrev if it's at the same time */
+static void _samp_eval(sampler_t* pSamp, size_t i, size_t iPrev, bool bHavePrev)
+{
+	double* pVal = pSamp->pVals + i*pSamp->uStride;
+
+	if(bHavePrev && (pSamp->pTimes[i] == pSamp->pTimes[iPrev])){
+		memcpy(pVal, pSamp->pVals + iPrev*pSamp->uStride, pSamp->uStride*sizeof(double));
+		pSamp->pValid[i] = pSamp->pValid[iPrev];
+		return;
+	}
+
+	++(pSamp->uCalls);
+	if(pSamp->uStride == _SAMP_ROT)
+		pSamp->pValid[i] = pSamp->fnRot(pSamp->pUser, pSamp->pTimes[i], (double (*)[3])pVal);
+	else
+		pSamp->pValid[i] = pSamp->fnState(pSamp->pUser, pSamp->pTimes[i], pVal);
+}
+
+/* Interpolate at time rTime between exact records iA and iB */
+static void _samp_interp(
+	sampler_t* pSamp, size_t iA, size_t iB, double rTime, double* pOut
+){
+	const double* pA = pSamp->pVals + iA*pSamp->uStride;
+	const double* pB = pSamp->pVals + iB*pSamp->uStride;
+	double rDt = pSamp->pTimes[iB] - pSamp->pTimes[iA];
+	double rFrac = (rDt > 0.0) ? (rTime - pSamp->pTimes[iA]) / rDt : 0.0;
+
+	if(pSamp->uStride == _SAMP_ROT){
+		double aQa[4], aQb[4], aQ[4];
+		das_quat_fromMat((const double (*)[3])pA, aQa);
+		das_quat_fromMat((const double (*)[3])pB, aQb);
+		das_quat_slerp(aQa, aQb, rFrac, aQ);
+		das_quat_toMat(aQ, (double (*)[3])pOut);
+	}
+	else{
+		das_hermite3(pA, pB, rDt, rFrac, pOut);
+	}
+}
+
+static double _samp_err(sampler_t* pSamp, const double* pApprox, const double* pExact)
+{
+	if(pSamp->uStride == _SAMP_ROT){
+		double aQ0[4], aQ1[4];
+		das_quat_fromMat((const double (*)[3])pApprox, aQ0);
+		das_quat_fromMat((const double (*)[3])pExact, aQ1);
+		return das_quat_angle(aQ0, aQ1);
+	}
+	return sqrt(
+		(pApprox[0] - pExact[0])*(pApprox[0] - pExact[0]) +
+		(pApprox[1] - pExact[1])*(pApprox[1] - pExact[1]) +
+		(pApprox[2] - pExact[2])*(pApprox[2] - pExact[2])
+	);
+}
+
+/* Fill the records strictly between exact records iA and iB */
+static void _samp_fill(sampler_t* pSamp, size_t iA, size_t iB)
+{
+	size_t i;
+	double rDt = pSamp->pTimes[iB] - pSamp->pTimes[iA];
+	double rFrac;
+
+	if(pSamp->uStride == _SAMP_ROT){
+		double aQa[4], aQb[4], aQ[4];
+		das_quat_fromMat((const double (*)[3])(pSamp->pVals + iA*_SAMP_ROT), aQa);
+		das_quat_fromMat((const double (*)[3])(pSamp->pVals + iB*_SAMP_ROT), aQb);
+		for(i = iA + 1; i < iB; ++i){
+			rFrac = (rDt > 0.0) ? (pSamp->pTimes[i] - pSamp->pTimes[iA]) / rDt : 0.0;
+			das_quat_slerp(aQa, aQb, rFrac, aQ);
+			das_quat_toMat(aQ, (double (*)[3])(pSamp->pVals + i*_SAMP_ROT));
+			pSamp->pValid[i] = true;
+		}
+	}
+	else{
+		for(i = iA + 1; i < iB; ++i){
+			_samp_interp(pSamp, iA, iB, pSamp->pTimes[i], pSamp->pVals + i*_SAMP_STATE);
+			pSamp->pValid[i] = true;
+		}
+	}
+}
+
+/* Bisect the span between exact records iBeg and iEnd */
+static void _samp_span(sampler_t* pSamp, size_t iBeg, size_t iEnd)
+{
+	size_t aStack[_SAMP_STACK][2];
+	int nTop = 0;
+	double aApprox[9];
+
+	aStack[0][0] = iBeg;
+	aStack[0][1] = iEnd;
+	nTop = 1;
+
+	while(nTop > 0){
+		--nTop;
+		size_t iA = aStack[nTop][0];
+		size_t iB = aStack[nTop][1];
+		if(iB - iA < 2) continue;
+
+		size_t iM = iA + (iB - iA)/2;
+		_samp_eval(pSamp, iM, iA, true);
+
+		if(pSamp->pValid[iA] && pSamp->pValid[iM] && pSamp->pValid[iB]){
+			_samp_interp(pSamp, iA, iB, pSamp->pTimes[iM], aApprox);
+			if(_samp_err(pSamp, aApprox, pSamp->pVals + iM*pSamp->uStride) <= pSamp->rTol){
+				_samp_fill(pSamp, iA, iM);
+				_samp_fill(pSamp, iM, iB);
+				continue;
+			}
+		}
+
+		/* Push the later half first so that records are finished in order */
+		assert(nTop + 2 <= _SAMP_STACK);
+		aStack[nTop][0] = iM;  aStack[nTop][1] = iB;  ++nTop;
+		aStack[nTop][0] = iA;  aStack[nTop][1] = iM;  ++nTop;
+	}
+}
+
+static size_t _samp_run(sampler_t* pSamp, size_t uLen, double rMaxStep)
+{
+	size_t i;
+	const double* pTimes = pSamp->pTimes;
+	bool bSorted = true;
+
+	if(uLen == 0) return 0;
+
+	for(i = 1; i < uLen; ++i){
+		if(!(pTimes[i] >= pTimes[i-1])){ bSorted = false; break; }
+	}
+
+	if(!bSorted || (uLen < 3) || !(pSamp->rTol > 0.0)){
+		for(i = 0; i < uLen; ++i) _samp_eval(pSamp, i, i - 1, (i > 0));
+		return pSamp->uCalls;
+	}
+
+	/* Exact nodes at most rMaxStep apart, then bisect between them */
+	size_t iNode = 0;
+	_samp_eval(pSamp, 0, 0, false);
+	while(iNode < uLen - 1){
+		size_t iNext = uLen - 1;
+		if(rMaxStep > 0.0){
+			iNext = iNode + 1;
+			while((iNext < uLen - 1)&&(pTimes[iNext + 1] - pTimes[iNode] <= rMaxStep))
+				++iNext;
+		}
+		_samp_eval(pSamp, iNext, iNode, true);
+		_samp_span(pSamp, iNode, iNext);
+		iNode = iNext;
+	}
+	return pSamp->uCalls;
+}
+
+size_t das_xform_sampleRot(
+	const double* pTimes, size_t uLen, double rTol, double rMaxStep,
+	das_rot_fn fn, void* pUser, double* pMats, bool* pValid
+){
+	sampler_t samp = {_SAMP_ROT, pTimes, rTol, fn, NULL, pUser, pMats, pValid, 0};
+	return _samp_run(&samp, uLen, rMaxStep);
+}
+
+size_t das_xform_sampleState(
+	const double* pTimes, size_t uLen, double rTol, double rMaxStep,
+	das_state_fn fn, void* pUser, double* pStates, bool* pValid
+){
+	sampler_t samp = {_SAMP_STATE, pTimes, rTol, NULL, fn, pUser, pStates, pValid, 0};
+	return _samp_run(&samp, uLen, rMaxStep);
+}
+
+/* ************************************************************************* */
+/* Block coordinate conversions and rotations */
+
+#define _DEG2RAD 0.017453292519943295
+#define _RAD2DEG 57.295779513082323
+#define _TWO_PI  6.283185307179586
+
+DasErrCode das_xform_toCart(ubyte uSys, double* pVecs, size_t uLen)
+{
+	size_t u;
+	double r, a, b;
+	double* v = pVecs;
+
+	switch(uSys){
+	case DAS_VSYS_CART:
+		return DAS_OKAY;
+
+	case DAS_VSYS_CYL:      /* ρ,φ,z */
+		for(u = 0; u < uLen; ++u, v += 3){
+			r = v[0];  a = v[1] * _DEG2RAD;
+			v[0] = r * cos(a);
+			v[1] = r * sin(a);
+		}
+		return DAS_OKAY;
+
+	case DAS_VSYS_SPH:      /* r,θ,φ */
+		for(u = 0; u < uLen; ++u, v += 3){
+			r = v[0];  a = v[1] * _DEG2RAD;  b = v[2] * _DEG2RAD;
+			v[0] = r * sin(a) * cos(b);
+			v[1] = r * sin(a) * sin(b);
+			v[2] = r * cos(a);
+		}
+		return DAS_OKAY;
+
+	case DAS_VSYS_CENTRIC:  /* r,φ,θ */
+		for(u = 0; u < uLen; ++u, v += 3){
+			r = v[0];  a = v[1] * _DEG2RAD;  b = v[2] * _DEG2RAD;
+			v[0] = r * cos(b) * cos(a);
+			v[1] = r * cos(b) * sin(a);
+			v[2] = r * sin(b);
+		}
+		return DAS_OKAY;
+	}
+
+	return das_error(DASERR_VEC, "Can't convert from %s coordinates to cartesian",
+		das_compsys_str(uSys)
+	);
+}
+
+DasErrCode das_xform_fromCart(ubyte uSys, double* pVecs, size_t uLen)
+{
+	size_t u;
+	double x, y, z, rXY;
+	double* v = pVecs;
+
+	switch(uSys){
+	case DAS_VSYS_CART:
+		return DAS_OKAY;
+
+	case DAS_VSYS_CYL:      /* ρ,φ,z with φ in [0, 360) */
+		for(u = 0; u < uLen; ++u, v += 3){
+			x = v[0];  y = v[1];
+			v[0] = hypot(x, y);
+			v[1] = ((x == 0.0)&&(y == 0.0)) ? 0.0 : atan2(y, x);
+			if(v[1] < 0.0) v[1] += _TWO_PI;
+			v[1] *= _RAD2DEG;
+		}
+		return DAS_OKAY;
+
+	case DAS_VSYS_SPH:      /* r,θ,φ with φ in (-180, 180] */
+		for(u = 0; u < uLen; ++u, v += 3){
+			x = v[0];  y = v[1];  z = v[2];
+			rXY = hypot(x, y);
+			v[0] = hypot(rXY, z);
+			v[1] = ((rXY == 0.0)&&(z == 0.0)) ? 0.0 : atan2(rXY, z) * _RAD2DEG;
+			v[2] = ((x == 0.0)&&(y == 0.0)) ? 0.0 : atan2(y, x) * _RAD2DEG;
+		}
+		return DAS_OKAY;
+
+	case DAS_VSYS_CENTRIC:  /* r,φ,θ with φ in (-180, 180] */
+		for(u = 0; u < uLen; ++u, v += 3){
+			x = v[0];  y = v[1];  z = v[2];
+			rXY = hypot(x, y);
+			v[0] = hypot(rXY, z);
+			v[1] = ((x == 0.0)&&(y == 0.0)) ? 0.0 : atan2(y, x) * _RAD2DEG;
+			v[2] = ((rXY == 0.0)&&(z == 0.0)) ? 0.0 : atan2(z, rXY) * _RAD2DEG;
+		}
+		return DAS_OKAY;
+	}
+
+	return das_error(DASERR_VEC, "Can't convert from cartesian to %s coordinates",
+		das_compsys_str(uSys)
+	);
+}
+
+#ifdef _DAS_XFORM_SIMD
+
+/* Rotates vectors two at a time, the low lane holds the first vector and the
+   high lane the second.  Returns the number of vectors handled */
+static size_t _xform_rotate_sse2(
+	const double* pMats, size_t uMatStep, const double* pIn, size_t uLen,
+	double* pOut
+){
+	size_t u = 0;
+	int r;
+	__m128d x, y, z, o;
+	const double* pA;
+	const double* pB;
+
+	if(uMatStep == 0){
+		__m128d m[9];
+		for(r = 0; r < 9; ++r) m[r] = _mm_set1_pd(pMats[r]);
+
+		for(; u + 2 <= uLen; u += 2, pIn += 6, pOut += 6){
+			x = _mm_set_pd(pIn[3], pIn[0]);
+			y = _mm_set_pd(pIn[4], pIn[1]);
+			z = _mm_set_pd(pIn[5], pIn[2]);
+			for(r = 0; r < 3; ++r){
+				o = _mm_add_pd(
+					_mm_add_pd(_mm_mul_pd(m[3*r], x), _mm_mul_pd(m[3*r + 1], y)),
+					_mm_mul_pd(m[3*r + 2], z)
+				);
+				_mm_storel_pd(pOut + r, o);
+				_mm_storeh_pd(pOut + 3 + r, o);
+			}
+		}
+		return u;
+	}
+
+	for(; u + 2 <= uLen; u += 2, pIn += 6, pOut += 6){
+		x = _mm_set_pd(pIn[3], pIn[0]);
+		y = _mm_set_pd(pIn[4], pIn[1]);
+		z = _mm_set_pd(pIn[5], pIn[2]);
+		pA = pMats + u*uMatStep;
+		pB = pA + uMatStep;
+		for(r = 0; r < 3; ++r){
+			o = _mm_add_pd(
+				_mm_add_pd(
+					_mm_mul_pd(_mm_set_pd(pB[3*r], pA[3*r]), x),
+					_mm_mul_pd(_mm_set_pd(pB[3*r + 1], pA[3*r + 1]), y)
+				),
+				_mm_mul_pd(_mm_set_pd(pB[3*r + 2], pA[3*r + 2]), z)
+			);
+			_mm_storel_pd(pOut + r, o);
+			_mm_storeh_pd(pOut + 3 + r, o);
+		}
+	}
+	return u;
+}
+
+#endif /* _DAS_XFORM_SIMD */
+
+void das_xform_rotate(
+	const double* pMats, size_t uMatStep, const double* pIn, size_t uLen,
+	double* pOut
+){
+	size_t u = 0;
+	double x, y, z;
+	const double* m;
+
+#ifdef _DAS_XFORM_SIMD
+	u = _xform_rotate_sse2(pMats, uMatStep, pIn, uLen, pOut);
+#endif
+
+	for(; u < uLen; ++u){
+		m = pMats + u*uMatStep;
+		x = pIn[3*u];  y = pIn[3*u + 1];  z = pIn[3*u + 2];
+		pOut[3*u]     = m[0]*x + m[1]*y + m[2]*z;
+		pOut[3*u + 1] = m[3]*x + m[4]*y + m[5]*z;
+		pOut[3*u + 2] = m[6]*x + m[7]*y + m[8]*z;
+	}
+}
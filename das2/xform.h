@@ -0,0 +1,200 @@
+/* Copyright (C) 2025 Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * Das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * Das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file xform.h Rotations, interpolation and coordinate conversions for
+ * frame transforms
+ */
+
+#ifndef _das_xform_h_
+#define _das_xform_h_
+
+#include <das2/defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup DM
+ * @{
+ */
+
+/** Convert a rotation matrix to a unit quaternion
+ *
+ * @param mRot A proper rotation matrix, row major
+ * @param aQuat The output quaternion in (w, x, y, z) order, w is the scalar
+ *        part.  The sign is arbitrary, q and -q are the same rotation.
+ */
+DAS_API void das_quat_fromMat(const double mRot[3][3], double aQuat[4]);
+
+/** Convert a quaternion to a rotation matrix
+ *
+ * @param aQuat A quaternion in (w, x, y, z) order, need not be normalized
+ * @param mRot The output rotation matrix, row major
+ */
+DAS_API void das_quat_toMat(const double aQuat[4], double mRot[3][3]);
+
+/** Spherical linear interpolation between two rotations
+ *
+ * Always takes the shorter of the two paths between the rotations.
+ *
+ * @param aQ0 The unit quaternion at fraction 0
+ * @param aQ1 The unit quaternion at fraction 1
+ * @param rFrac The fraction of the way from aQ0 to aQ1
+ * @param aOut The interpolated unit quaternion, may not alias the inputs
+ */
+DAS_API void das_quat_slerp(
+	const double aQ0[4], const double aQ1[4], double rFrac, double aOut[4]
+);
+
+/** Get the angle of the rotation that takes one rotation to another
+ *
+ * @returns The angle in radians, from 0 to pi.  Accurate for small angles.
+ */
+DAS_API double das_quat_angle(const double aQ0[4], const double aQ1[4]);
+
+/** Cubic Hermite interpolation of a position and velocity state
+ *
+ * @param aS0 The state at fraction 0, (x, y, z, vx, vy, vz)
+ * @param aS1 The state at fraction 1
+ * @param rDt The time between the two states in the units of the velocity
+ *        denominator.
+ * @param rFrac The fraction of the way from aS0 to aS1
+ * @param aOut The interpolated state, the velocity is the derivative of the
+ *        interpolating polynomial.
+ */
+DAS_API void das_hermite3(
+	const double aS0[6], const double aS1[6], double rDt, double rFrac,
+	double aOut[6]
+);
+
+/** Function that provides exact rotation matrices, for example a wrapper
+ * around SPICE pxform_c.  Returns false if no rotation is available at the
+ * given time. */
+typedef bool (*das_rot_fn)(void* pUser, double rTime, double mRot[3][3]);
+
+/** Function that provides exact position and velocity states, for example a
+ * wrapper around SPICE spkez_c.  Returns false if no state is available at
+ * the given time. */
+typedef bool (*das_state_fn)(void* pUser, double rTime, double aState[6]);
+
+/** Get rotation matrices at many times with a bounded number of exact calls
+ *
+ * If the times are sorted, the exact function is evaluated at nodes no more
+ * than rMaxStep apart, and each span between nodes is bisected until the
+ * midpoint rotation agrees with the SLERP of the end points to within
+ * rTol.  Records between accepted nodes are interpolated.  Since only the
+ * midpoint is checked, rMaxStep should be well under any period in the
+ * motion, such as a spin period, or the check can alias.
+ *
+ * A failed exact call forces the spans around it to be bisected down to
+ * single records, so records next to coverage gaps are always evaluated
+ * exactly.  Gaps that fall between two accepted nodes are not seen.
+ *
+ * If rTol is not positive, fewer than three times are given, or the times
+ * are not sorted, every time is evaluated exactly.  Repeated times are only
+ * evaluated once.
+ *
+ * @param pTimes The times to sample, in whatever units fn expects
+ * @param uLen The number of times
+ * @param rTol The maximum rotation angle error, in radians
+ * @param rMaxStep The maximum time between exact nodes, or 0 for no limit
+ * @param fn The exact rotation function
+ * @param pUser Passed through to fn
+ * @param pMats Output, 9*uLen doubles, one row major matrix per time
+ * @param pValid Output, uLen flags, false if a time had no rotation
+ *
+ * @returns The number of calls made to fn
+ */
+DAS_API size_t das_xform_sampleRot(
+	const double* pTimes, size_t uLen, double rTol, double rMaxStep,
+	das_rot_fn fn, void* pUser, double* pMats, bool* pValid
+);
+
+/** Get position and velocity states at many times with a bounded number of
+ * exact calls
+ *
+ * Same as das_xform_sampleRot() except that spans are interpolated with
+ * das_hermite3() and the error is the distance between the interpolated and
+ * exact midpoint positions.
+ *
+ * @param pTimes The times to sample, in the velocity denominator units
+ * @param uLen The number of times
+ * @param rTol The maximum position error
+ * @param rMaxStep The maximum time between exact nodes, or 0 for no limit
+ * @param fn The exact state function
+ * @param pUser Passed through to fn
+ * @param pStates Output, 6*uLen doubles, one state per time
+ * @param pValid Output, uLen flags, false if a time had no state
+ *
+ * @returns The number of calls made to fn
+ */
+DAS_API size_t das_xform_sampleState(
+	const double* pTimes, size_t uLen, double rTol, double rMaxStep,
+	das_state_fn fn, void* pUser, double* pStates, bool* pValid
+);
+
+/** Convert a block of vectors to cartesian coordinates in place
+ *
+ * Matches the SPICE functions cylrec_c(), sphrec_c() and latrec_c() to within
+ * rounding, but without a function call per vector.
+ *
+ * @param uSys The input coordinate system, one of DAS_VSYS_CART,
+ *        DAS_VSYS_CYL (ρ,φ,z), DAS_VSYS_SPH (r,θ,φ, θ is colatitude) or
+ *        DAS_VSYS_CENTRIC (r,φ,θ, θ is latitude).  Angles are in degrees.
+ *        Ellipsoidal systems are not supported since they need the body
+ *        radii.
+ * @param pVecs The vectors, 3*uLen values, (x,y,z) on output
+ * @param uLen The number of vectors
+ *
+ * @returns DAS_OKAY, or an error code if the system isn't supported
+ */
+DAS_API DasErrCode das_xform_toCart(ubyte uSys, double* pVecs, size_t uLen);
+
+/** Convert a block of cartesian vectors to another coordinate system in place
+ *
+ * The inverse of das_xform_toCart().  Matches the SPICE functions reccyl_c(),
+ * recsph_c() and reclat_c() to within rounding, including the angle ranges.
+ * Angles are output in degrees.
+ *
+ * @returns DAS_OKAY, or an error code if the system isn't supported
+ */
+DAS_API DasErrCode das_xform_fromCart(ubyte uSys, double* pVecs, size_t uLen);
+
+/** Rotate a block of vectors
+ *
+ * Each output vector is a row major 3x3 matrix times the input vector.  On
+ * x86_64 two vectors are rotated at a time with SSE2.
+ *
+ * @param pMats The rotation matrices, 9 values each
+ * @param uMatStep 9 to use one matrix per vector, or 0 to apply the first
+ *        matrix to all vectors
+ * @param pIn The input vectors, 3*uLen values
+ * @param uLen The number of vectors
+ * @param pOut The output vectors, 3*uLen values, may be the same as pIn
+ */
+DAS_API void das_xform_rotate(
+	const double* pMats, size_t uMatStep, const double* pIn, size_t uLen,
+	double* pOut
+);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _das_xform_h_ */
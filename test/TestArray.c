@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
 #include <string.h>
 
 #include <das2/core.h>
@@ -536,6 +537,128 @@ int main(int argc, char** argv)
 	
 	dec_DasAry(pBytes);
 	
+	/* Grow a waveform array well past a few re-allocations, switching to 
+	 * memory mapped storage part way through, then take the memory */
+	DasAry* pWave = new_DasAry(
+		"waveform", vtInt, 0, (const ubyte*)NULL, RANK_2(0, 1024), UNIT_DIMENSIONLESS
+	);
+	int aRec[1024];
+	for(int i = 0; i < 2000; ++i){
+		if(i == 500) DasAry_setUsage(pWave, D2ARY_LARGE_MEM);
+		for(int j = 0; j < 1024; ++j) aRec[j] = i*1024 + j;
+		DasAry_append(pWave, (const ubyte*)aRec, 1024);
+	}
+	if((DasAry_lengthIn(pWave, DIM0) != 2000)||
+	   (DasAry_getIntAt(pWave, IDX1(3, 7)) != 3*1024 + 7)||
+	   (DasAry_getIntAt(pWave, IDX1(1999, 1023)) != 2000*1024 - 1)){
+		printf("ERROR: Test 24 (large array growth) failed\n");
+		return 124;
+	}
+	size_t uWaveLen = 0, uWaveOff = 0;
+	int* pWaveMem = (int*)DasAry_disownElements(pWave, &uWaveLen, &uWaveOff);
+	if((pWaveMem == NULL)||(uWaveLen != 2000*1024)||(pWaveMem[uWaveOff + 1500*1024] != 1500*1024)){
+		printf("ERROR: Test 25 (disown large array memory) failed\n");
+		return 125;
+	}
+	free(pWaveMem);
+	dec_DasAry(pWave);
+	
+	/* Test 26: Swapped binary values round trip through a codec.  Counts that
+	   aren't a multiple of any vector width exercise the kernel tails. */
+	const int nSwp = 1037;
+	ubyte aBE[1037*4];
+	for(int i = 0; i < nSwp; ++i){
+		int16_t nVal = (int16_t)(i*61 - 32000);
+		aBE[2*i] = (ubyte)(((uint16_t)nVal) >> 8);  aBE[2*i+1] = (ubyte)(nVal & 0xFF);
+	}
+	double rSwpFill = -1e31;
+	DasAry* pSwp = new_DasAry("swapped", vtDouble, 0, (const ubyte*)&rSwpFill, RANK_1(0), UNIT_DIMENSIONLESS);
+	DasCodec codec;
+	int nRead = 0;
+	if((DasCodec_init(DASENC_READ, &codec, pSwp, "real", "BEint", 2, 0, NULL, NULL) != DAS_OKAY)||
+	   (DasCodec_decode(&codec, aBE, nSwp*2, nSwp, &nRead) < 0)||(nRead != nSwp)){
+		printf("ERROR: Test 26 (swap and widen BE int16 to double) failed\n");
+		return 126;
+	}
+	for(int i = 0; i < nSwp; ++i){
+		if(DasAry_getDoubleAt(pSwp, IDX0(i)) != (double)(int16_t)(i*61 - 32000)){
+			printf("ERROR: Test 26 (swap and widen BE int16 to double) failed at %d\n", i);
+			return 126;
+		}
+	}
+	DasCodec_deInit(&codec);
+
+	/* Narrow them to BE floats, including the fill value */
+	double rFillVal = rSwpFill;  /* should map to the float fill value */
+	DasAry_putAt(pSwp, IDX0(7), (const ubyte*)&rFillVal, 1);
+	DasBuf* pOut = new_DasBuf(nSwp*4);
+	if((DasCodec_init(DASENC_WRITE, &codec, pSwp, "real", "BEreal", 4, 0, NULL, NULL) != DAS_OKAY)||
+	   (DasCodec_encode(&codec, pOut, 0, NULL, nSwp, 0) != nSwp)||
+	   (DasBuf_written(pOut) != (size_t)(nSwp*4))){
+		printf("ERROR: Test 27 (narrow and swap double to BE float) failed\n");
+		return 127;
+	}
+	const ubyte* pF = (const ubyte*)pOut->sBuf;
+	for(int i = 0; i < nSwp; ++i){
+		ubyte aLE[4] = {pF[4*i+3], pF[4*i+2], pF[4*i+1], pF[4*i]};
+		float fVal; memcpy(&fVal, aLE, 4);
+		float fExpect = (i == 7) ? *((const float*)das_vt_fill(vtFloat)) : (float)(int16_t)(i*61 - 32000);
+		if(fVal != fExpect){
+			printf("ERROR: Test 27 (narrow and swap double to BE float) failed at %d\n", i);
+			return 127;
+		}
+	}
+	DasCodec_deInit(&codec);
+	del_DasBuf(pOut);
+
+	/* Test 28: Growing an array after disowning it's elements must not write
+	   into the memory that was handed over */
+	int nKeepFill = -1;
+	DasAry* pKeep = new_DasAry(
+		"kept", vtInt, 0, (const ubyte*)&nKeepFill, RANK_1(0), UNIT_DIMENSIONLESS
+	);
+	for(int i = 0; i < 100; ++i) DasAry_append(pKeep, (const ubyte*)&i, 1);
+	size_t uKeepLen = 0, uKeepOff = 0;
+	int* pKeepMem = (int*)DasAry_disownElements(pKeep, &uKeepLen, &uKeepOff);
+	if((pKeepMem == NULL)||(uKeepLen != 100)||DasAry_ownsElements(pKeep)){
+		printf("ERROR: Test 28 (grow after disown) failed to disown\n");
+		return 128;
+	}
+	int* pKeepCopy = (int*)malloc(uKeepLen * sizeof(int));
+	memcpy(pKeepCopy, pKeepMem + uKeepOff, uKeepLen * sizeof(int));
+
+	for(int i = 100; i < 1000; ++i) DasAry_append(pKeep, (const ubyte*)&i, 1);
+	DasAry_clear(pKeep);
+	for(int i = 0; i < 1000; ++i){
+		int nVal = -i;
+		DasAry_append(pKeep, (const ubyte*)&nVal, 1);
+	}
+	if((memcmp(pKeepCopy, pKeepMem + uKeepOff, uKeepLen * sizeof(int)) != 0)||
+	   (DasAry_size(pKeep) != 1000)||(DasAry_getIntAt(pKeep, IDX0(999)) != -999)||
+	   (!DasAry_ownsElements(pKeep))){
+		printf("ERROR: Test 28 (grow after disown) failed\n");
+		return 128;
+	}
+	free(pKeepCopy);
+	free(pKeepMem);
+	dec_DasAry(pKeep);  /* Frees the new storage, valgrind should show no leak */
+
+	/* Test 29: Text floats are rounded once.  The value is a hair above the
+	   midpoint between 1 and the next float, going through double first lands
+	   exactly on the midpoint and then rounds down to 1 */
+	const char* sHalf = " 1.00000005960464477539062500001";
+	float rHalfFill = -1e31f;
+	DasAry* pHalf = new_DasAry("half", vtFloat, 0, (const ubyte*)&rHalfFill, RANK_1(0), UNIT_DIMENSIONLESS);
+	if((DasCodec_init(DASENC_READ, &codec, pHalf, "real", "utf8", (int)strlen(sHalf), 0, NULL, NULL) != DAS_OKAY)||
+	   (DasCodec_decode(&codec, (const ubyte*)sHalf, (int)strlen(sHalf), 1, &nRead) < 0)||
+	   (DasAry_size(pHalf) != 1)||
+	   (*((const float*)DasAry_getAt(pHalf, vtFloat, IDX0(0))) != 1.0f + FLT_EPSILON)){
+		printf("ERROR: Test 29 (single rounding of text floats) failed\n");
+		return 129;
+	}
+	DasCodec_deInit(&codec);
+	dec_DasAry(pHalf);
+
 	/* Clean up the arrays, check that all memory is free'ed using valgrind */
 	dec_DasAry(pTmp);  /* do this first to test that sub arrays don't free 
 							  * memory owned by parent arrays */
@@ -0,0 +1,239 @@
+/** @file TestBinAcc.c Unit tests for the fill aware bin accumulators
+ *
+ * The accumulators have a vector path on x86_64 and a scalar path for
+ * leftovers and other machines, so every check here compares against a
+ * plain loop over lengths that exercise both. */
+
+/* Author: Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file contains test and example code that intends to explain an
+ * interface.
+ *
+ * As United States courts have ruled that interfaces cannot be copyrighted,
+ * the code in this individual source file, TestBinAcc.c, is placed into the
+ * public domain and may be displayed, incorporated or otherwise re-used without
+ * restriction.  It is offered to the public without any without any warranty
+ * including even the implied warranty of merchantability or fitness for a
+ * particular purpose.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <das2/core.h>
+
+#define NRECS 23
+
+/* The reference fill test, same as PlaneDesc_isFill() */
+static bool isFill(double rFill, double x)
+{
+	return (rFill == 0.0 && x == 0.0) || (fabs((rFill - x)/rFill) < 0.00001);
+}
+
+/* Deterministic test data with fill sprinkled in, including values that are
+   only near the fill value */
+static void mkRec(double* pVals, size_t uVals, double rFill, unsigned int nSeed)
+{
+	srand(nSeed);
+	for(size_t u = 0; u < uVals; ++u){
+		switch(rand() % 7){
+		case 0:  pVals[u] = rFill; break;
+		case 1:  pVals[u] = rFill * (1.0 + 1e-7); break;
+		default: pVals[u] = ((double)rand() / RAND_MAX) * 200.0 - 150.0; break;
+		}
+	}
+}
+
+static bool same(double a, double b)
+{
+	return (a == b) || (fabs(a - b) <= 1e-9 + 1e-12*(fabs(a) + fabs(b)));
+}
+
+/* Add NRECS records to each bin of an accumulator and check all statistics */
+static int checkItems(int nTest, size_t uBins, size_t uItems, double rFill)
+{
+	DasBinAcc* pAcc = new_DasBinAcc(uBins, uItems, rFill, DAS_BINACC_MIN|DAS_BINACC_MAX);
+	if(pAcc == NULL)
+		return das_error(nTest, "Test %d: couldn't make accumulator", nTest);
+
+	double* pVals = (double*)malloc(uItems * sizeof(double));
+	double* pSum  = (double*)calloc(uBins*uItems, sizeof(double));
+	double* pCnt  = (double*)calloc(uBins*uItems, sizeof(double));
+	double* pMin  = (double*)malloc(uBins*uItems * sizeof(double));
+	double* pMax  = (double*)malloc(uBins*uItems * sizeof(double));
+	for(size_t u = 0; u < uBins*uItems; ++u){ pMin[u] = HUGE_VAL; pMax[u] = -HUGE_VAL; }
+
+	for(int r = 0; r < NRECS; ++r){
+		for(size_t b = 0; b < uBins; ++b){
+			mkRec(pVals, uItems, rFill, r*131 + b);
+			if(DasBinAcc_add(pAcc, b, pVals, uItems) != DAS_OKAY)
+				return das_error(nTest, "Test %d: add failed", nTest);
+			for(size_t u = 0; u < uItems; ++u){
+				if(isFill(rFill, pVals[u])) continue;
+				size_t i = b*uItems + u;
+				pSum[i] += pVals[u];
+				pCnt[i] += 1;
+				if(pVals[u] < pMin[i]) pMin[i] = pVals[u];
+				if(pVals[u] > pMax[i]) pMax[i] = pVals[u];
+			}
+		}
+	}
+
+	for(size_t b = 0; b < uBins; ++b){
+		const double* pMean = DasBinAcc_get(pAcc, b, DAS_BINACC_MEAN);
+		for(size_t u = 0; u < uItems; ++u){
+			size_t i = b*uItems + u;
+			double rExpect = (pCnt[i] == 0) ? rFill : pSum[i]/pCnt[i];
+			if(!same(pMean[u], rExpect))
+				return das_error(nTest, "Test %d: bin %zu item %zu mean %.17g, "
+					"expected %.17g", nTest, b, u, pMean[u], rExpect);
+		}
+		const double* pGot = DasBinAcc_get(pAcc, b, DAS_BINACC_COUNT);
+		for(size_t u = 0; u < uItems; ++u)
+			if(pGot[u] != pCnt[b*uItems + u])
+				return das_error(nTest, "Test %d: bin %zu item %zu count %g, "
+					"expected %g", nTest, b, u, pGot[u], pCnt[b*uItems + u]);
+		pGot = DasBinAcc_get(pAcc, b, DAS_BINACC_MIN);
+		for(size_t u = 0; u < uItems; ++u){
+			size_t i = b*uItems + u;
+			if(pGot[u] != ((pCnt[i] == 0) ? rFill : pMin[i]))
+				return das_error(nTest, "Test %d: bin %zu item %zu min %g, "
+					"expected %g", nTest, b, u, pGot[u], pMin[i]);
+		}
+		pGot = DasBinAcc_get(pAcc, b, DAS_BINACC_MAX);
+		for(size_t u = 0; u < uItems; ++u){
+			size_t i = b*uItems + u;
+			if(pGot[u] != ((pCnt[i] == 0) ? rFill : pMax[i]))
+				return das_error(nTest, "Test %d: bin %zu item %zu max %g, "
+					"expected %g", nTest, b, u, pGot[u], pMax[i]);
+		}
+	}
+
+	/* Clearing one bin leaves the others alone */
+	DasBinAcc_clearBin(pAcc, 0);
+	const double* pGot = DasBinAcc_get(pAcc, 0, DAS_BINACC_MEAN);
+	for(size_t u = 0; u < uItems; ++u)
+		if(pGot[u] != rFill)
+			return das_error(nTest, "Test %d: cleared bin isn't empty", nTest);
+	if(uBins > 1){
+		pGot = DasBinAcc_get(pAcc, 1, DAS_BINACC_COUNT);
+		for(size_t u = 0; u < uItems; ++u)
+			if(pGot[u] != pCnt[uItems + u])
+				return das_error(nTest, "Test %d: clearing bin 0 changed bin 1", nTest);
+	}
+
+	free(pVals); free(pSum); free(pCnt); free(pMin); free(pMax);
+	del_DasBinAcc(pAcc);
+	daslog_info_v("Test %d success. %zu bins of %zu items, fill %g",
+		nTest, uBins, uItems, rFill);
+	return 0;
+}
+
+/* Collapse records of various lengths into a single item */
+static int checkCollapse(int nTest, size_t uVals, double rFill)
+{
+	DasBinAcc* pAcc = new_DasBinAcc(1, 1, rFill, DAS_BINACC_MIN|DAS_BINACC_MAX);
+	double* pVals = (double*)malloc(uVals * sizeof(double));
+	double rSum = 0, rCnt = 0, rMin = HUGE_VAL, rMax = -HUGE_VAL;
+
+	for(int r = 0; r < NRECS; ++r){
+		mkRec(pVals, uVals, rFill, r + 7);
+		DasBinAcc_add(pAcc, 0, pVals, uVals);
+		for(size_t u = 0; u < uVals; ++u){
+			if(isFill(rFill, pVals[u])) continue;
+			rSum += pVals[u];  rCnt += 1;
+			if(pVals[u] < rMin) rMin = pVals[u];
+			if(pVals[u] > rMax) rMax = pVals[u];
+		}
+	}
+
+	if(DasBinAcc_get(pAcc, 0, DAS_BINACC_COUNT)[0] != rCnt)
+		return das_error(nTest, "Test %d: collapsed count mismatch", nTest);
+	if(!same(DasBinAcc_get(pAcc, 0, DAS_BINACC_SUM)[0], rSum))
+		return das_error(nTest, "Test %d: collapsed sum mismatch", nTest);
+	if(DasBinAcc_get(pAcc, 0, DAS_BINACC_MIN)[0] != rMin)
+		return das_error(nTest, "Test %d: collapsed min mismatch", nTest);
+	if(DasBinAcc_get(pAcc, 0, DAS_BINACC_MAX)[0] != rMax)
+		return das_error(nTest, "Test %d: collapsed max mismatch", nTest);
+
+	free(pVals);
+	del_DasBinAcc(pAcc);
+	daslog_info_v("Test %d success. Collapsed %d records of %zu values", nTest,
+		NRECS, uVals);
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	int nTest = 0;
+	int nRet = 0;
+
+	/* Odd and even widths, so both the paired and leftover paths run */
+	if((nRet = checkItems(++nTest, 1, 1, -1e31)) != 0) return nRet;
+	if((nRet = checkItems(++nTest, 3, 7, -1e31)) != 0) return nRet;
+	if((nRet = checkItems(++nTest, 2, 160, 0.0)) != 0) return nRet;
+	if((nRet = checkItems(++nTest, 4, 81, 1e-9)) != 0) return nRet;
+
+	if((nRet = checkCollapse(++nTest, 1, -1e31)) != 0) return nRet;
+	if((nRet = checkCollapse(++nTest, 255, -1e31)) != 0) return nRet;
+	if((nRet = checkCollapse(++nTest, 1024, 0.0)) != 0) return nRet;
+
+	/* An all-negative bin must report a negative peak, and an empty bin the
+	   fill value */
+	++nTest;
+	DasBinAcc* pAcc = new_DasBinAcc(2, 3, -1e31, DAS_BINACC_MAX);
+	double aNeg[3] = {-5.0, -1e31, -2.5};
+	DasBinAcc_add(pAcc, 0, aNeg, 3);
+	const double* pPeak = DasBinAcc_get(pAcc, 0, DAS_BINACC_MAX);
+	if((pPeak[0] != -5.0)||(pPeak[1] != -1e31)||(pPeak[2] != -2.5))
+		return das_error(nTest, "Test %d: wrong peaks for negative data", nTest);
+	pPeak = DasBinAcc_get(pAcc, 1, DAS_BINACC_MAX);
+	if(pPeak[0] != -1e31)
+		return das_error(nTest, "Test %d: empty bin isn't fill", nTest);
+	del_DasBinAcc(pAcc);
+	daslog_info_v("Test %d success. Negative peaks and empty bins", nTest);
+
+	/* Quantiles skip fill, fold collapsed records into one sketch and are
+	   exact while a bin holds fewer values than the sketch size */
+	++nTest;
+	pAcc = new_DasBinAcc(2, 2, -1e31, DAS_BINACC_QUANT);
+	double aRec[2];
+	for(int i = 0; i < 9; ++i){
+		aRec[0] = (double)((i * 5) % 9);  /* 0 to 8, shuffled */
+		aRec[1] = (i % 3 == 0) ? -1e31 : 100.0 + i;
+		DasBinAcc_add(pAcc, 0, aRec, 2);
+	}
+	const double* pQuant = DasBinAcc_getQuantile(pAcc, 0, 0.5);
+	if((pQuant[0] != 4.0)||(pQuant[1] != 104.0))
+		return das_error(nTest, "Test %d: medians are %g and %g, expected 4 and "
+			"104", nTest, pQuant[0], pQuant[1]);
+	pQuant = DasBinAcc_getQuantile(pAcc, 1, 0.5);
+	if((pQuant[0] != -1e31)||(pQuant[1] != -1e31))
+		return das_error(nTest, "Test %d: empty bin isn't fill", nTest);
+	DasBinAcc_clearBin(pAcc, 0);
+	if(DasBinAcc_getQuantile(pAcc, 0, 0.5)[0] != -1e31)
+		return das_error(nTest, "Test %d: cleared bin isn't empty", nTest);
+	del_DasBinAcc(pAcc);
+
+	pAcc = new_DasBinAcc(1, 1, 0.0, DAS_BINACC_QUANT);
+	if(DasBinAcc_setSketchCap(pAcc, 64) != DAS_OKAY)
+		return das_error(nTest, "Test %d: couldn't resize sketches", nTest);
+	double aWide[101];
+	for(int i = 0; i < 101; ++i) aWide[i] = (double)((i * 37) % 101);  /* 0 is fill */
+	DasBinAcc_add(pAcc, 0, aWide, 101);
+	pQuant = DasBinAcc_getQuantile(pAcc, 0, 0.0);
+	if(pQuant[0] != 1.0)
+		return das_error(nTest, "Test %d: collapsed minimum is %g", nTest, pQuant[0]);
+	pQuant = DasBinAcc_getQuantile(pAcc, 0, 1.0);
+	if(pQuant[0] != 100.0)
+		return das_error(nTest, "Test %d: collapsed maximum is %g", nTest, pQuant[0]);
+	del_DasBinAcc(pAcc);
+	daslog_info_v("Test %d success. Quantiles of items and collapsed records", nTest);
+
+	daslog_info("All bin accumulator tests passed.");
+	return 0;
+}
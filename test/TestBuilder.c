@@ -150,6 +150,71 @@ bool test_secure_url(const char* sInitialUrl, int nTest)
 	return true;
 }
 
+/* Merged das3 streams can carry hundreds of datasets, make sure the
+   descriptor table grows and that ID lookups work both ways */
+bool test_many_ids(int nTest)
+{
+	const int nDs = 700;
+	DasStream* pSd = new_DasStream();
+	DasDs* lDs[700] = {NULL};
+	char sId[32] = {'\0'};
+
+	for(int i = 0; i < nDs; ++i){
+		snprintf(sId, 31, "ds_%d", i);
+		lDs[i] = new_DasDs(sId, "many", 1);
+		int nPktId = (i * 37) % 60000 + 1;  /* sparse, non-sequential */
+		if(DasStream_addDesc(pSd, (DasDesc*)lDs[i], nPktId) != DAS_OKAY){
+			printf("ERROR: Test %d failed, couldn't add dataset at ID %d\n", nTest, nPktId);
+			return false;
+		}
+	}
+	if(DasStream_getNPktDesc(pSd) != (size_t)nDs){
+		printf("ERROR: Test %d failed, expected %d descriptors\n", nTest, nDs);
+		return false;
+	}
+
+	/* Remove every third one to exercise the reverse index deletes */
+	int nRemoved = 0;
+	for(int i = 0; i < nDs; i += 3){
+		int nPktId = (i * 37) % 60000 + 1;
+		if(DasStream_freeDatDesc(pSd, nPktId) != DAS_OKAY) return false;
+		lDs[i] = NULL;
+		++nRemoved;
+	}
+	const int nKept = nDs - nRemoved;   /* 700 - 234 = 466 */
+	if((nKept != 466)||(DasStream_getNPktDesc(pSd) != (size_t)nKept)){
+		printf("ERROR: Test %d failed, expected %d descriptors after removal, "
+		       "found %zu\n", nTest, nKept, DasStream_getNPktDesc(pSd));
+		return false;
+	}
+
+	for(int i = 0; i < nDs; ++i){
+		int nPktId = (i * 37) % 60000 + 1;
+		DasDesc* pDesc = DasStream_getDesc(pSd, nPktId);
+		if(pDesc != (DasDesc*)lDs[i]){
+			printf("ERROR: Test %d failed, wrong descriptor at ID %d\n", nTest, nPktId);
+			return false;
+		}
+		if((lDs[i] != NULL)&&(DasStream_getPktId(pSd, pDesc) != nPktId)){
+			printf("ERROR: Test %d failed, reverse lookup for ID %d gave %d\n",
+			       nTest, nPktId, DasStream_getPktId(pSd, pDesc));
+			return false;
+		}
+	}
+
+	int nPrev = 0, nSeen = 0;
+	while(DasStream_nextDesc(pSd, &nPrev) != NULL) ++nSeen;
+	if(nSeen != nKept){
+		printf("ERROR: Test %d failed, iterated %d descriptors, expected %d\n",
+		       nTest, nSeen, nKept);
+		return false;
+	}
+
+	del_DasStream(pSd);
+	printf("INFO: Test %d, %d descriptor IDs round tripped\n", nTest, nDs);
+	return true;
+}
+
 int main(int argc, char** argv)
 {
 	/* Exit on errors, log info messages and above */
@@ -171,6 +236,9 @@ int main(int argc, char** argv)
 		return nErr;
 	}
 	
+	/* Pure in-memory check, doesn't depend on any sample files */
+	if(!test_many_ids(12)) return 12;
+
 	if(!test_file("test/x_multi_y.d2s",                2)) return 13;
 	if(!test_file("test/cassini_rpws_sample.d2t",      3)) return 13;
 	if(!test_file("test/juno_waves_sample.d2t",        4)) return 13;
@@ -11,7 +11,10 @@
  *
  * Before the var_ary.c / var_seq.c lengthIn fixes a non-mapping variable
  * reported a bogus length here and the MIN-merge dragged the answer off; this
- * test would have gone red on both fixtures. */
+ * test would have gone red on both fixtures.
+ *
+ * A third test loads a descriptor with enough properties to trigger the
+ * property name index and checks that it tracks sets, removals and clears. */
 
 /* Author: Chris Piker <chris-piker@uiowa.edu>
  *
@@ -28,6 +31,9 @@
 
 #define _POSIX_C_SOURCE 200112L
 
+#include <string.h>
+#include <stdio.h>
+
 #include <das2/core.h>
 
 const char* g_sProg = "TestDataset";
@@ -150,6 +156,58 @@ int main(int argc, char** argv)
 		nTest, aRows[0], aRows[1], aRows[2]);
 	del_DasStream(pSd); pSd = NULL;
 
+	/* ------------------------------------------------------------------ */
+	/* Test 3: property lookups on a descriptor big enough to be indexed.
+	   Sets, overrides and removals after the first lookup must all be seen,
+	   and clearing must not leave stale index entries behind. */
+	++nTest; ++nErr;
+	DasDesc desc;
+	memset(&desc, 0, sizeof(DasDesc));
+	DasDesc_init(&desc, DATASET);
+	char sName[32];
+	const int nProps = 400;
+	for(int i = 0; i < nProps; ++i){
+		snprintf(sName, 31, "prop%03d", i);
+		DasDesc_setInt(&desc, sName, i);
+		if(DasDesc_getInt(&desc, sName) != i)   /* interleave lookups and sets */
+			return das_error(nErr, "Test %d: %s not found after set", nTest, sName);
+	}
+	for(int i = 0; i < nProps; i += 3){
+		snprintf(sName, 31, "prop%03d", i);
+		DasDesc_setStr(&desc, sName, "overridden value that won't fit in place");
+	}
+	for(int i = 0; i < nProps; i += 5){
+		snprintf(sName, 31, "prop%03d", i);
+		if(!DasDesc_remove(&desc, sName))
+			return das_error(nErr, "Test %d: couldn't remove %s", nTest, sName);
+	}
+	for(int i = 0; i < nProps; ++i){
+		snprintf(sName, 31, "prop%03d", i);
+		const DasProp* pProp = DasDesc_getLocal(&desc, sName);
+		if(i % 5 == 0){
+			if(pProp != NULL)
+				return das_error(nErr, "Test %d: removed %s still present", nTest, sName);
+		}
+		else if(i % 3 == 0){
+			if((pProp == NULL)||(strncmp(DasProp_value(pProp), "overridden", 10) != 0))
+				return das_error(nErr, "Test %d: override of %s lost", nTest, sName);
+		}
+		else if(DasDesc_getInt(&desc, sName) != i)
+			return das_error(nErr, "Test %d: wrong value for %s", nTest, sName);
+	}
+	if(DasDesc_hasLocal(&desc, "prop"))
+		return das_error(nErr, "Test %d: found a property that was never set", nTest);
+
+	DasDesc_clearProps(&desc);
+	if(DasDesc_hasLocal(&desc, "prop001") || (DasDesc_length(&desc) != 0))
+		return das_error(nErr, "Test %d: properties survived a clear", nTest);
+	DasDesc_setInt(&desc, "prop001", 7);
+	if(DasDesc_getInt(&desc, "prop001") != 7)
+		return das_error(nErr, "Test %d: set after clear failed", nTest);
+	DasDesc_freeProps(&desc);
+	daslog_info_v("Test %d success. %d indexed properties set, overridden and removed.",
+		nTest, nProps);
+
 	daslog_info("All dataset shape/length tests passed.");
 	return 0;
 }
@@ -0,0 +1,207 @@
+/** @file TestDft.c Unit tests for real input transforms and parallel PSDs
+ *
+ * Real-only input goes down a half length r2c path, so results are checked
+ * against the same signal run through the complex path with a zero
+ * imaginary part.  Batched and pooled PSDs are checked against Das2Psd. */
+
+/* Author: Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file contains test and example code that intends to explain an
+ * interface.
+ *
+ * As United States courts have ruled that interfaces cannot be copyrighted,
+ * the code in this individual source file, TestDft.c, is placed into the
+ * public domain and may be displayed, incorporated or otherwise re-used without
+ * restriction.  It is offered to the public without any without any warranty
+ * including even the implied warranty of merchantability or fitness for a
+ * particular purpose.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#include <das2/core.h>
+
+#define DFT_LEN  64
+#define NSAMPS   4000
+#define NTHREADS 4
+
+static bool same(double a, double b)
+{
+	return fabs(a - b) <= 1e-9 * (1.0 + fabs(a) + fabs(b));
+}
+
+static void mkSignal(double* pVals, size_t uVals)
+{
+	srand(42);
+	for(size_t u = 0; u < uVals; ++u)
+		pVals[u] = 3.0*sin(0.3*u) + cos(0.05*u) + ((double)rand()/RAND_MAX) - 0.2;
+}
+
+/* Threads running PSDs on a shared plan at the same time */
+struct thread_data {
+	DftPlan* pPlan;
+	const double* pInput;
+	size_t uSegs;
+	double* pOutput;
+};
+
+static void* doPsds(void* vpThreadData)
+{
+	struct thread_data* pTd = (struct thread_data*)vpThreadData;
+	Das2Psd* pPsd = new_Psd(pTd->pPlan, true, "hann");
+	size_t uLen = 0;
+	for(size_t s = 0; s < pTd->uSegs; ++s){
+		Psd_calculate(pPsd, pTd->pInput + s*DFT_LEN, NULL);
+		const double* pOut = Psd_get(pPsd, &uLen);
+		for(size_t u = 0; u < uLen; ++u) pTd->pOutput[s*uLen + u] = pOut[u];
+	}
+	del_Das2Psd(pPsd);
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	int nTest = 0;
+	size_t u, s, uLen = 0, uLen2 = 0;
+	const size_t uPsdLen = DFT_LEN/2 + 1;
+
+	double* pSig = (double*)malloc(NSAMPS * sizeof(double));
+	double* pZero = (double*)calloc(NSAMPS, sizeof(double));
+	mkSignal(pSig, NSAMPS);
+
+	DftPlan* pPlan = new_DftPlan(DFT_LEN, true);
+
+	/* Test 1: Real and imaginary components from the r2c path */
+	++nTest;
+	Das2Dft* pReal = new_Dft(pPlan, "hann");
+	Das2Dft* pCmp = new_Dft(pPlan, "hann");
+	Dft_calculate(pReal, pSig, NULL);
+	Dft_calculate(pCmp, pSig, pZero);
+	for(int c = 0; c < 2; ++c){
+		const double* pA = c ? Dft_getImg(pReal, &uLen) : Dft_getReal(pReal, &uLen);
+		const double* pB = c ? Dft_getImg(pCmp, &uLen2) : Dft_getReal(pCmp, &uLen2);
+		if((uLen != DFT_LEN)||(uLen2 != DFT_LEN))
+			return das_error(nTest, "Test %d: component lengths %zu and %zu",
+				nTest, uLen, uLen2);
+		for(u = 0; u < DFT_LEN; ++u)
+			if(!same(pA[u], pB[u]))
+				return das_error(nTest, "Test %d: component %d index %zu is %.17g, "
+					"expected %.17g", nTest, c, u, pA[u], pB[u]);
+	}
+	daslog_info_v("Test %d success. Real input DFT components", nTest);
+
+	/* Test 2: Magnitudes from the r2c path */
+	++nTest;
+	const double* pMag = Dft_getMagnitude(pReal, &uLen);
+	Dft_calculate(pCmp, pSig, NULL);  /* second object still matches */
+	const double* pMag2 = Dft_getMagnitude(pCmp, &uLen2);
+	if((uLen != uPsdLen)||(uLen2 != uPsdLen))
+		return das_error(nTest, "Test %d: magnitude length %zu", nTest, uLen);
+	for(u = 0; u < uPsdLen; ++u)
+		if(!same(pMag[u], pMag2[u]) || (pMag[u] <= 0.0))
+			return das_error(nTest, "Test %d: magnitude %zu mismatch", nTest, u);
+	del_Dft(pReal);
+	del_Dft(pCmp);
+	daslog_info_v("Test %d success. Real input DFT magnitudes", nTest);
+
+	/* Test 3: PSDs of real input, r2c vs complex with zero imaginary */
+	++nTest;
+	Das2Psd* pPsd = new_Psd(pPlan, true, "hann");
+	double* pExpect = (double*)malloc(NSAMPS * uPsdLen * sizeof(double));
+	size_t uSegs = 0;
+	for(s = 0; (s+1)*DFT_LEN <= NSAMPS; ++s, ++uSegs){
+		Psd_calculate(pPsd, pSig + s*DFT_LEN, pZero);
+		const double* pCmpPsd = Psd_get(pPsd, &uLen);
+		double rLowHalf = 0.0;
+		for(u = 1; u < DFT_LEN/2; ++u) rLowHalf += pCmpPsd[u];
+
+		Psd_calculate(pPsd, pSig + s*DFT_LEN, NULL);
+		const double* pRealPsd = Psd_get(pPsd, &uLen);
+		if(uLen != uPsdLen)
+			return das_error(nTest, "Test %d: PSD length %zu", nTest, uLen);
+
+		/* Complex PSDs keep the positive and negative frequencies apart */
+		double rRealHalf = 0.0;
+		for(u = 1; u < DFT_LEN/2; ++u) rRealHalf += pRealPsd[u];
+		if(!same(rRealHalf, 2.0*rLowHalf))
+			return das_error(nTest, "Test %d: segment %zu power %.17g, expected "
+				"%.17g", nTest, s, rRealHalf, 2.0*rLowHalf);
+		for(u = 0; u < uPsdLen; ++u) pExpect[s*uPsdLen + u] = pRealPsd[u];
+	}
+	daslog_info_v("Test %d success. %zu real input PSDs", nTest, uSegs);
+
+	/* Test 4: Many threads on one plan */
+	++nTest;
+	struct thread_data aTd[NTHREADS];
+	pthread_t aThreads[NTHREADS];
+	double* pGot = (double*)calloc(NSAMPS * uPsdLen, sizeof(double));
+	size_t uPer = uSegs / NTHREADS;
+	for(int i = 0; i < NTHREADS; ++i){
+		aTd[i].pPlan = pPlan;
+		aTd[i].pInput = pSig + i*uPer*DFT_LEN;
+		aTd[i].uSegs = uPer;
+		aTd[i].pOutput = pGot + i*uPer*uPsdLen;
+		pthread_create(aThreads + i, NULL, doPsds, aTd + i);
+	}
+	for(int i = 0; i < NTHREADS; ++i) pthread_join(aThreads[i], NULL);
+	for(u = 0; u < NTHREADS*uPer*uPsdLen; ++u)
+		if(!same(pGot[u], pExpect[u]))
+			return das_error(nTest, "Test %d: threaded PSD value %zu mismatch",
+				nTest, u);
+	daslog_info_v("Test %d success. %d threads sharing a plan", nTest, NTHREADS);
+
+	/* Test 5: Batched and pooled PSDs over a sliding window */
+	++nTest;
+	DasPsdBatch* pBatch = new_DasPsdBatch(DFT_LEN, true, "hann");
+	DasPsdPool* pPool = new_DasPsdPool(NTHREADS);
+	size_t uShift = DFT_LEN/4;
+	int nSegs = DasPsdBatch_slide(pBatch, pSig, NSAMPS, uShift);
+	if(nSegs != (NSAMPS - DFT_LEN)/uShift + 1)
+		return das_error(nTest, "Test %d: slide made %d segments", nTest, nSegs);
+	for(s = 0; s < (size_t)nSegs; ++s){
+		Psd_calculate(pPsd, pSig + s*uShift, NULL);
+		const double* pA = Psd_get(pPsd, &uLen);
+		const double* pB = DasPsdBatch_get(pBatch, s, &uLen2);
+		for(u = 0; u < uPsdLen; ++u)
+			if(!same(pA[u], pB[u]))
+				return das_error(nTest, "Test %d: batch segment %zu mismatch", nTest, s);
+		pGot[s] = pB[3];
+	}
+
+	DasPsdBatch* pPooled = new_DasPsdBatch(DFT_LEN, true, "hann");
+	for(int nRep = 0; nRep < 3; ++nRep){
+		if(DasPsdPool_slide(pPool, pPooled, pSig, NSAMPS, uShift) != nSegs)
+			return das_error(nTest, "Test %d: pool segment count mismatch", nTest);
+		for(s = 0; s < (size_t)nSegs; ++s)
+			if(DasPsdBatch_get(pPooled, s, &uLen)[3] != pGot[s])
+				return das_error(nTest, "Test %d: pool segment %zu mismatch", nTest, s);
+	}
+
+	const double* aSegs[3] = {pSig + 100, pSig + 7, pSig + 2000};
+	if(DasPsdPool_calc(pPool, pPooled, aSegs, 3) != 3)
+		return das_error(nTest, "Test %d: pool calc failed", nTest);
+	Psd_calculate(pPsd, pSig + 2000, NULL);
+	if(!same(DasPsdBatch_get(pPooled, 2, &uLen)[5], Psd_get(pPsd, &uLen2)[5]))
+		return das_error(nTest, "Test %d: pool calc mismatch", nTest);
+	if(DasPsdBatch_get(pPooled, 3, &uLen) != NULL)
+		return das_error(nTest, "Test %d: stale pool result returned", nTest);
+
+	del_DasPsdBatch(pPooled);
+	del_DasPsdBatch(pBatch);
+	daslog_info_v("Test %d success. %d batched PSDs on %d threads", nTest, nSegs,
+		DasPsdPool_threads(pPool));
+	del_DasPsdPool(pPool);
+
+	del_Das2Psd(pPsd);
+	del_DftPlan(pPlan);
+	free(pSig); free(pZero); free(pExpect); free(pGot);
+
+	daslog_info("All DFT tests passed.");
+	return 0;
+}
@@ -0,0 +1,153 @@
+/** @file TestFmt.c Unit tests for the printf-free value writers
+ *
+ * Every fast path result is compared against snprintf with the same format,
+ * and shortest round trip output is compared against a search over printf
+ * precisions. */
+
+/* Author: Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file contains test and example code that intends to explain an
+ * interface.
+ *
+ * As United States courts have ruled that interfaces cannot be copyrighted,
+ * the code in this individual source file, TestFmt.c, is placed into the
+ * public domain and may be displayed, incorporated or otherwise re-used without
+ * restriction.  It is offered to the public without any without any warranty
+ * including even the implied warranty of merchantability or fitness for a
+ * particular purpose.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <das2/core.h>
+
+#define NVALS 50000
+
+/* Values spread over 90 decades with some short decimals, ties and floats */
+static double mkVal(void)
+{
+	double rVal = ((double)rand() / RAND_MAX) * pow(10.0, rand() % 90 - 45);
+	switch(rand() % 8){
+	case 0: rVal = floor(rVal * 1000.0) / 1000.0; break;
+	case 1: rVal = (rand() % 2000) / 8.0; break;
+	case 2: rVal = (float)rVal; break;
+	}
+	return (rand() % 2) ? -rVal : rVal;
+}
+
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	int nTest = 0;
+	char sFast[128];
+	char sSlow[128];
+	das_fmt fmt;
+
+	/* Test 1: Real formats */
+	++nTest;
+	const char* aReal[] = {
+		"%9.2e", "% 14.7e", "%13.6e", "%.3e", "%+12.4E", "%-12.3e", "%012.3e",
+		"%.0e", "%.15e", "%.17e", "%10.3f", "%06.3f", "%02.0f", "%012.9f",
+		"%-8.2f", "%+.1f", NULL
+	};
+	double aSpecial[] = {
+		0.0, -0.0, 0.5, 1.5, 2.5, 0.125, 0.375, 9.995, 9.9999999, 99.5, 1e22,
+		1e23, 5e-324, 1.7e308, INFINITY, -INFINITY, NAN, 0.05, 0.15, 2.675
+	};
+	srand(3);
+	for(int f = 0; aReal[f] != NULL; ++f){
+		das_fmt_init(&fmt, aReal[f]);
+		if(fmt.nKind == DASFMT_PRINTF)
+			return das_error(nTest, "Test %d: format %s not recognized", nTest, aReal[f]);
+
+		bool bFix = (aReal[f][strlen(aReal[f]) - 1] == 'f');
+		for(int i = 0; i < NVALS + (int)(sizeof(aSpecial)/sizeof(double)); ++i){
+			double rVal = (i < NVALS) ? mkVal() : aSpecial[i - NVALS];
+			if(bFix && (i < NVALS)) rVal = fmod(rVal, 1e6);
+
+			int nFast = das_fmt_real(&fmt, sFast, sizeof(sFast), rVal);
+			int nSlow = snprintf(sSlow, sizeof(sSlow), aReal[f], rVal);
+			if((nFast != nSlow)||(strcmp(sFast, sSlow) != 0))
+				return das_error(nTest, "Test %d: %s of %.17g gave '%s', expected '%s'",
+					nTest, aReal[f], rVal, sFast, sSlow);
+		}
+	}
+
+	/* Other conversions are passed through */
+	das_fmt_init(&fmt, "%.5g");
+	das_fmt_real(&fmt, sFast, sizeof(sFast), 0.1);
+	if((fmt.nKind != DASFMT_PRINTF)||(strcmp(sFast, "0.1") != 0))
+		return das_error(nTest, "Test %d: %%g conversion mishandled", nTest);
+
+	/* Truncation follows snprintf */
+	das_fmt_init(&fmt, "%.3e");
+	if((das_fmt_real(&fmt, sFast, 5, 1.0) != 9)||(strcmp(sFast, "1.00") != 0))
+		return das_error(nTest, "Test %d: truncation mishandled", nTest);
+	daslog_info_v("Test %d success. Real values match snprintf", nTest);
+
+	/* Test 2: Time formats */
+	++nTest;
+	const char* aTime[] = {
+		"%04d-%02d-%02dT%02d:%02d:%06.3f", "%04d-%02d-%02dT%02d:%02d:%02.0f ",
+		"%04d-%02d-%02dT%02d:%02d:%012.9f", "%04d-%02d-%02dT%02d", "%04d  ",
+		"%04d-%03dT%02d", NULL
+	};
+	for(int f = 0; aTime[f] != NULL; ++f){
+		das_fmt_init(&fmt, aTime[f]);
+		for(int i = 0; i < NVALS; ++i){
+			das_time dt = {0};
+			dt.year = 2020 + i / 100000;  dt.month = 1 + (i / 20000) % 12;
+			dt.mday = 1 + (i / 3000) % 28;  dt.hour = (i / 500) % 24;
+			dt.minute = (i / 10) % 60;  dt.second = fmod(i * 0.0123457, 60.0);
+			if(i % 997 == 0) dt.second = 59.99996;
+			if(i == 5) dt.year = -5;
+
+			int nFast = das_fmt_time(&fmt, sFast, sizeof(sFast), &dt);
+			int nSlow = snprintf(sSlow, sizeof(sSlow), aTime[f], dt.year, dt.month,
+				dt.mday, dt.hour, dt.minute, dt.second);
+			if((nFast != nSlow)||(strcmp(sFast, sSlow) != 0))
+				return das_error(nTest, "Test %d: %s gave '%s', expected '%s'",
+					nTest, aTime[f], sFast, sSlow);
+		}
+	}
+	daslog_info_v("Test %d success. Time stamps match snprintf", nTest);
+
+	/* Test 3: Shortest round trip */
+	++nTest;
+	int nLonger = 0;
+	for(int i = 0; i < NVALS; ++i){
+		bool bFloat = (i % 3 == 0);
+		double rVal = (i % 5 == 0) ? ldexp(1.0, rand() % 200 - 100) : mkVal();
+		if(bFloat) rVal = (float)rVal;
+
+		das_fmt_shortest(sFast, sizeof(sFast), rVal, bFloat);
+		double rBack = bFloat ? strtof(sFast, NULL) : strtod(sFast, NULL);
+		if(rBack != rVal)
+			return das_error(nTest, "Test %d: '%s' doesn't read back as %.17g",
+				nTest, sFast, rVal);
+
+		int nPrec;
+		for(nPrec = 0; nPrec < 16; ++nPrec){
+			snprintf(sSlow, sizeof(sSlow), "%.*e", nPrec, rVal);
+			rBack = bFloat ? strtof(sSlow, NULL) : strtod(sSlow, NULL);
+			if(rBack == rVal) break;
+		}
+		snprintf(sSlow, sizeof(sSlow), "%.*e", nPrec, rVal);
+		if(strcmp(sFast, sSlow) != 0) ++nLonger;
+	}
+	das_fmt_shortest(sFast, sizeof(sFast), 0.1, false);
+	if(strcmp(sFast, "1e-01") != 0)
+		return das_error(nTest, "Test %d: 0.1 written as '%s'", nTest, sFast);
+	if(nLonger > NVALS / 1000)
+		return das_error(nTest, "Test %d: %d values weren't shortest", nTest, nLonger);
+	daslog_info_v("Test %d success. Shortest output round trips, %d of %d "
+		"values one digit long", nTest, nLonger, NVALS);
+
+	daslog_info("All value formatting tests passed.");
+	return 0;
+}
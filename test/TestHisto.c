@@ -0,0 +1,195 @@
+/** @file TestHisto.c Unit tests for histograms and quantile sketches
+ *
+ * Exact histograms find bins by hashing, so counts and bin order are
+ * compared against a plain sort of the same values.  Sketch estimates are
+ * checked against exact ranks with a tolerance. */
+
+/* Author: Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file contains test and example code that intends to explain an
+ * interface.
+ *
+ * As United States courts have ruled that interfaces cannot be copyrighted,
+ * the code in this individual source file, TestHisto.c, is placed into the
+ * public domain and may be displayed, incorporated or otherwise re-used without
+ * restriction.  It is offered to the public without any without any warranty
+ * including even the implied warranty of merchantability or fitness for a
+ * particular purpose.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <das2/core.h>
+
+#define NITEMS  3
+#define NVALS   20000
+#define NSKETCH 200000
+
+static int cmpDbl(const void* vp1, const void* vp2)
+{
+	double r1 = *((const double*)vp1);
+	double r2 = *((const double*)vp2);
+	return (r1 < r2) ? -1 : ((r1 > r2) ? 1 : 0);
+}
+
+/* Quantized values so that there are many repeats, like raw sensor data */
+static double mkVal(void)
+{
+	return floor(((double)rand() / RAND_MAX) * 4000.0 - 1000.0) * 0.25;
+}
+
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	int nTest = 0;
+	size_t u, b, i;
+	double rVal;
+
+	/* Test 1: Exact counts and order */
+	++nTest;
+	double* pVals = (double*)malloc(NITEMS * NVALS * sizeof(double));
+	DasHisto* pHisto = new_DasHisto(DAS_HISTO_EXACT, NITEMS, 0, 0, 0);
+	srand(17);
+	for(u = 0; u < NITEMS*NVALS; ++u){
+		pVals[u] = mkVal();
+		if(DasHisto_add(pHisto, u % NITEMS, pVals[u]) != DAS_OKAY)
+			return das_error(nTest, "Test %d: add failed", nTest);
+	}
+	DasHisto_add(pHisto, 0, NAN);  /* ignored */
+
+	size_t uBins = DasHisto_finish(pHisto);
+	double rPrev = -HUGE_VAL;
+	double aTotal[NITEMS] = {0};
+	for(b = 0; b < uBins; ++b){
+		double* pCounts = DasHisto_bin(pHisto, b, &rVal);
+		if(rVal <= rPrev)
+			return das_error(nTest, "Test %d: bin %zu value %g is out of order",
+				nTest, b, rVal);
+		rPrev = rVal;
+
+		/* Naive count of this value for each item */
+		for(i = 0; i < NITEMS; ++i){
+			double rCount = 0;
+			for(u = i; u < NITEMS*NVALS; u += NITEMS)
+				if(pVals[u] == rVal) rCount += 1;
+			if(pCounts[i] != rCount)
+				return das_error(nTest, "Test %d: value %g item %zu count %g, "
+					"expected %g", nTest, rVal, i, pCounts[i], rCount);
+			aTotal[i] += rCount;
+		}
+	}
+	for(i = 0; i < NITEMS; ++i)
+		if(aTotal[i] != NVALS)
+			return das_error(nTest, "Test %d: item %zu total %g", nTest, i, aTotal[i]);
+	if(DasHisto_bin(pHisto, uBins, &rVal) != NULL)
+		return das_error(nTest, "Test %d: bin past the end returned", nTest);
+	daslog_info_v("Test %d success. %zu distinct values in exact mode", nTest, uBins);
+
+	/* Test 2: Adding after finishing keeps the counts */
+	++nTest;
+	DasHisto_add(pHisto, 1, 1e6);
+	DasHisto_add(pHisto, 1, -1e6);
+	DasHisto_add(pHisto, 2, -0.0);
+	if(DasHisto_finish(pHisto) != uBins + 2)
+		return das_error(nTest, "Test %d: expected %zu bins", nTest, uBins + 2);
+	if((DasHisto_bin(pHisto, 0, &rVal)[1] != 1)||(rVal != -1e6))
+		return das_error(nTest, "Test %d: new low value misplaced", nTest);
+	if((DasHisto_bin(pHisto, uBins + 1, &rVal)[1] != 1)||(rVal != 1e6))
+		return das_error(nTest, "Test %d: new high value misplaced", nTest);
+	del_DasHisto(pHisto);
+	daslog_info_v("Test %d success. Values added after sorting", nTest);
+
+	/* Test 3: Linear bins */
+	++nTest;
+	pHisto = new_DasHisto(DAS_HISTO_LINEAR, 1, -10.0, 10.0, 4);
+	double aLin[] = {-10.0, -5.01, -5.0, 0.0, 4.99, 7.5, 10.0, 10.01, -11.0};
+	double aLinExpect[] = {2, 1, 2, 2};
+	for(u = 0; u < sizeof(aLin)/sizeof(double); ++u) DasHisto_add(pHisto, 0, aLin[u]);
+	if((DasHisto_finish(pHisto) != 4)||(pHisto->uDropped != 2))
+		return das_error(nTest, "Test %d: wrong bins or dropped count", nTest);
+	for(b = 0; b < 4; ++b){
+		double rCount = DasHisto_bin(pHisto, b, &rVal)[0];
+		if((rCount != aLinExpect[b])||(rVal != -7.5 + 5.0*b))
+			return das_error(nTest, "Test %d: bin %zu at %g has %g, expected %g",
+				nTest, b, rVal, rCount, aLinExpect[b]);
+	}
+	del_DasHisto(pHisto);
+	daslog_info_v("Test %d success. Linear bins", nTest);
+
+	/* Test 4: Log bins */
+	++nTest;
+	pHisto = new_DasHisto(DAS_HISTO_LOG, 1, 1.0, 1000.0, 3);
+	double aLog[] = {1.0, 9.0, 10.0, 99.0, 150.0, 999.0, 0.0, -5.0, 2000.0};
+	double aLogExpect[] = {2, 2, 2};
+	for(u = 0; u < sizeof(aLog)/sizeof(double); ++u) DasHisto_add(pHisto, 0, aLog[u]);
+	if(pHisto->uDropped != 3)
+		return das_error(nTest, "Test %d: dropped %zu", nTest, pHisto->uDropped);
+	for(b = 0; b < 3; ++b){
+		double rCount = DasHisto_bin(pHisto, b, &rVal)[0];
+		if((rCount != aLogExpect[b])||(fabs(rVal - pow(10.0, b + 0.5)) > 1e-9*rVal))
+			return das_error(nTest, "Test %d: bin %zu at %g has %g", nTest, b,
+				rVal, rCount);
+	}
+	del_DasHisto(pHisto);
+	daslog_info_v("Test %d success. Log bins", nTest);
+
+	/* Test 5: Small sketches are exact */
+	++nTest;
+	DasQuantile* pSketch = new_DasQuantile(0);
+	if(!isnan(DasQuantile_rank(pSketch, 0.0, true)))
+		return das_error(nTest, "Test %d: empty sketch rank isn't NaN", nTest);
+	for(u = 0; u < 100; ++u) DasQuantile_add(pSketch, (double)(u % 10));
+	if((DasQuantile_rank(pSketch, 4.0, true) != 0.5)||
+	   (DasQuantile_rank(pSketch, 4.0, false) != 0.4)||
+	   (DasQuantile_value(pSketch, 0.0) != 0.0)||
+	   (DasQuantile_value(pSketch, 1.0) != 9.0)||
+	   (DasQuantile_value(pSketch, 0.5) != 4.0))
+		return das_error(nTest, "Test %d: small sketch isn't exact", nTest);
+	daslog_info_v("Test %d success. Exact small sketch", nTest);
+
+	/* Test 6: Large sketch rank error */
+	++nTest;
+	DasQuantile_clear(pSketch);
+	double* pBig = (double*)malloc(NSKETCH * sizeof(double));
+	srand(5);
+	for(u = 0; u < NSKETCH; ++u){
+		/* skewed distribution */
+		pBig[u] = pow((double)rand() / RAND_MAX, 3.0) * 100.0;
+		DasQuantile_add(pSketch, pBig[u]);
+	}
+	if(DasQuantile_count(pSketch) != NSKETCH)
+		return das_error(nTest, "Test %d: count mismatch", nTest);
+	qsort(pBig, NSKETCH, sizeof(double), cmpDbl);
+
+	double rMaxErr = 0.0;
+	for(i = 1; i < 100; ++i){
+		size_t uIdx = (i * NSKETCH) / 100;
+		double rExact = (double)(uIdx + 1) / NSKETCH;
+		double rErr = fabs(DasQuantile_rank(pSketch, pBig[uIdx], true) - rExact);
+		if(rErr > rMaxErr) rMaxErr = rErr;
+
+		/* And the inverse, the value's exact rank should be near the target */
+		rVal = DasQuantile_value(pSketch, i / 100.0);
+		double* pAt = pBig;
+		while((pAt < pBig + NSKETCH) && (*pAt <= rVal)) ++pAt;
+		rErr = fabs((double)(pAt - pBig)/NSKETCH - i/100.0);
+		if(rErr > rMaxErr) rMaxErr = rErr;
+	}
+	if(rMaxErr > 0.01)
+		return das_error(nTest, "Test %d: maximum rank error %.4f", nTest, rMaxErr);
+	if((DasQuantile_value(pSketch, 0.0) != pBig[0])||
+	   (DasQuantile_value(pSketch, 1.0) != pBig[NSKETCH-1]))
+		return das_error(nTest, "Test %d: min/max aren't exact", nTest);
+	del_DasQuantile(pSketch);
+	daslog_info_v("Test %d success. Sketch of %d values, maximum rank error %.4f",
+		nTest, NSKETCH, rMaxErr);
+
+	free(pVals);
+	free(pBig);
+	daslog_info("All histogram tests passed.");
+	return 0;
+}
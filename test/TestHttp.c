@@ -0,0 +1,317 @@
+/** @file TestHttp.c Unit tests for HTTP/1.1 keep-alive and message framing
+ *
+ * A small HTTP server runs on the loopback interface in a background thread
+ * and counts the connections it accepts.  Bodies are checked byte for byte
+ * and connection counts show when the client re-used a parked connection. */
+
+/* Author: Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file contains test and example code that intends to explain an
+ * interface.
+ *
+ * As United States courts have ruled that interfaces cannot be copyrighted,
+ * the code in this individual source file, TestHttp.c, is placed into the
+ * public domain and may be displayed, incorporated or otherwise re-used without
+ * restriction.  It is offered to the public without any without any warranty
+ * including even the implied warranty of merchantability or fitness for a
+ * particular purpose.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <das2/core.h>
+
+#define BODY_SZ 40000
+
+static char g_sBody[BODY_SZ + 1];
+static int g_nPort = 0;
+static int g_nAccepts = 0;
+static pthread_mutex_t g_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static int nAccepts(void)
+{
+	pthread_mutex_lock(&g_mtx);
+	int n = g_nAccepts;
+	pthread_mutex_unlock(&g_mtx);
+	return n;
+}
+
+static void sendAll(int nFd, const char* pBuf, size_t uLen)
+{
+	ssize_t nSent;
+	while(uLen > 0){
+		if((nSent = send(nFd, pBuf, uLen, 0)) <= 0) return;
+		pBuf += nSent;
+		uLen -= nSent;
+	}
+}
+
+static void sendStr(int nFd, const char* sStr){ sendAll(nFd, sStr, strlen(sStr)); }
+
+/* Serve requests on one connection until the client hangs up.  Paths:
+ *   /len    body with a Content-Length header
+ *   /chunk  body in three chunks, with an extension and a trailer
+ *   /redir  302 to /chunk, with a small body of it's own
+ *   /close  body ended by closing the connection
+ *   /bye    like /len, but then close as if an idle timeout expired
+ *   /empty  204 with no framing headers, the connection stays open
+ *   others  404 with an empty body, the connection stays open
+ * HTTP/1.0 requests always get a body ended by closing the connection.
+ * Requests without a Host header naming the port get a 400, as a virtual
+ * host would route them somewhere else */
+static void* serveConn(void* vpFd)
+{
+	int nFd = (int)(intptr_t)vpFd;
+	char sReq[4096];
+	char sPath[256];
+	char sHdr[256];
+	size_t uLen;
+	ssize_t nRead;
+
+	while(true){
+		uLen = 0;
+		sReq[0] = '\0';
+		while(strstr(sReq, "\r\n\r\n") == NULL){
+			nRead = recv(nFd, sReq + uLen, sizeof(sReq) - 1 - uLen, 0);
+			if(nRead <= 0) goto DONE;
+			uLen += nRead;
+			sReq[uLen] = '\0';
+		}
+		if(sscanf(sReq, "GET %255[^? ]", sPath) != 1) goto DONE;
+
+		snprintf(sHdr, 255, "\r\nHost: 127.0.0.1:%d\r\n", g_nPort);
+		if(strstr(sReq, sHdr) == NULL){
+			sendStr(nFd, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n");
+			continue;
+		}
+
+		if(strstr(sReq, " HTTP/1.0\r\n") != NULL){
+			sendStr(nFd, "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\n\r\n");
+			sendAll(nFd, g_sBody, BODY_SZ);
+			goto DONE;
+		}
+
+		if((strcmp(sPath, "/len") == 0)||(strcmp(sPath, "/bye") == 0)){
+			snprintf(sHdr, 255, "HTTP/1.1 200 OK\r\ncontent-length: %d\r\n\r\n", BODY_SZ);
+			sendStr(nFd, sHdr);
+			sendAll(nFd, g_sBody, BODY_SZ);
+			if(strcmp(sPath, "/bye") == 0) goto DONE;
+		}
+		else if(strcmp(sPath, "/chunk") == 0){
+			sendStr(nFd, "HTTP/1.1 200 OK\r\nTransfer-Encoding: Chunked\r\n\r\n");
+			sendStr(nFd, "7;name=value\r\n");
+			sendAll(nFd, g_sBody, 7);
+			snprintf(sHdr, 255, "\r\n%X\r\n", 20000);
+			sendStr(nFd, sHdr);
+			sendAll(nFd, g_sBody + 7, 20000);
+			snprintf(sHdr, 255, "\r\n%x\r\n", BODY_SZ - 20007);
+			sendStr(nFd, sHdr);
+			sendAll(nFd, g_sBody + 20007, BODY_SZ - 20007);
+			sendStr(nFd, "\r\n0\r\nX-Checksum: none\r\n\r\n");
+		}
+		else if(strcmp(sPath, "/redir") == 0){
+			snprintf(sHdr, 255, "HTTP/1.1 302 Found\r\nLocation: "
+				"http://127.0.0.1:%d/chunk\r\nContent-Length: 5\r\n\r\nmoved", g_nPort);
+			sendStr(nFd, sHdr);
+		}
+		else if(strcmp(sPath, "/empty") == 0){
+			sendStr(nFd, "HTTP/1.1 204 No Content\r\n\r\n");
+		}
+		else if(strcmp(sPath, "/close") == 0){
+			sendStr(nFd, "HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n");
+			sendAll(nFd, g_sBody, BODY_SZ);
+			goto DONE;
+		}
+		else{
+			sendStr(nFd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+		}
+	}
+
+DONE:
+	close(nFd);
+	return NULL;
+}
+
+static void* serve(void* vpFd)
+{
+	int nSrv = (int)(intptr_t)vpFd;
+	int nFd;
+	pthread_t thread;
+	while((nFd = accept(nSrv, NULL, NULL)) >= 0){
+		pthread_mutex_lock(&g_mtx);
+		++g_nAccepts;
+		pthread_mutex_unlock(&g_mtx);
+		pthread_create(&thread, NULL, serveConn, (void*)(intptr_t)nFd);
+		pthread_detach(thread);
+	}
+	return NULL;
+}
+
+/* Read a URL and check the body, returns false if it didn't match */
+static bool readOkay(const char* sPath, DasHttpResp* pRes)
+{
+	char sUrl[128];
+	snprintf(sUrl, 127, "http://127.0.0.1:%d%s", g_nPort, sPath);
+	DasAry* pAry = das_http_readUrl(sUrl, NULL, NULL, pRes, -1, DASHTTP_TO_MIN);
+	if(pAry == NULL) return false;
+
+	size_t uLen = 0;
+	const ubyte* pBytes = DasAry_getBytesIn(pAry, DIM0, &uLen);
+	bool bOkay = (uLen == BODY_SZ) && (memcmp(pBytes, g_sBody, BODY_SZ) == 0);
+	dec_DasAry(pAry);
+	DasHttpResp_freeFields(pRes);
+	return bOkay;
+}
+
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	signal(SIGPIPE, SIG_IGN);
+
+	int nTest = 0;
+	DasHttpResp res;
+	char sUrl[128];
+
+	srand(9);
+	for(int i = 0; i < BODY_SZ; ++i) g_sBody[i] = 'a' + (rand() % 26);
+
+	/* Start the server on an open loopback port */
+	int nSrv = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	socklen_t uAddrLen = sizeof(addr);
+	if((bind(nSrv, (struct sockaddr*)&addr, sizeof(addr)) != 0)||
+	   (listen(nSrv, 8) != 0)||
+	   (getsockname(nSrv, (struct sockaddr*)&addr, &uAddrLen) != 0))
+		return das_error(1, "Couldn't start a loopback server");
+	g_nPort = ntohs(addr.sin_port);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, serve, (void*)(intptr_t)nSrv);
+	pthread_detach(thread);
+
+	/* Test 1: Content-Length body, lower case header name */
+	++nTest;
+	if(!readOkay("/len", &res))
+		return das_error(nTest, "Test %d: Content-Length body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 1)
+		return das_error(nTest, "Test %d: %d connections", nTest, nAccepts());
+	daslog_info_v("Test %d success. Content-Length body read", nTest);
+
+	/* Test 2: Chunked body on the same connection */
+	++nTest;
+	if(!readOkay("/chunk", &res))
+		return das_error(nTest, "Test %d: chunked body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 1)
+		return das_error(nTest, "Test %d: connection not re-used, %d connections",
+			nTest, nAccepts());
+	daslog_info_v("Test %d success. Chunked body read on a re-used connection", nTest);
+
+	/* Test 3: Redirect body is skipped and the connection re-used */
+	++nTest;
+	if(!readOkay("/redir", &res))
+		return das_error(nTest, "Test %d: redirected body mismatch, %s", nTest, res.sError);
+	if((nAccepts() != 1)||(strcmp(res.url.sPath, "/chunk") != 0))
+		return das_error(nTest, "Test %d: %d connections, final path %s",
+			nTest, nAccepts(), res.url.sPath);
+	daslog_info_v("Test %d success. Redirect followed on the same connection", nTest);
+
+	/* Test 4: Stream fetches pick up the parked connection, but the body
+	 *         still ends when the socket closes */
+	++nTest;
+	snprintf(sUrl, 127, "http://127.0.0.1:%d/len", g_nPort);
+	if(!das_http_getBody(sUrl, NULL, NULL, &res, DASHTTP_TO_MIN))
+		return das_error(nTest, "Test %d: %s", nTest, res.sError);
+	char* pBody = (char*)calloc(BODY_SZ + 1024, 1);
+	size_t uLen = 0;
+	ssize_t nRead;
+	while((nRead = recv(res.nSockFd, pBody + uLen, BODY_SZ + 1024 - uLen, 0)) > 0)
+		uLen += nRead;
+	close(res.nSockFd);
+	DasHttpResp_freeFields(&res);
+	if((uLen != BODY_SZ)||(memcmp(pBody, g_sBody, BODY_SZ) != 0))
+		return das_error(nTest, "Test %d: raw body mismatch, %zu bytes", nTest, uLen);
+	if(nAccepts() != 1)
+		return das_error(nTest, "Test %d: %d connections", nTest, nAccepts());
+	free(pBody);
+	daslog_info_v("Test %d success. Stream fetch used the parked connection", nTest);
+
+	/* Test 5: Connection: close bodies read to EOF and aren't parked */
+	++nTest;
+	if(!readOkay("/close", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	if(!readOkay("/len", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 3)
+		return das_error(nTest, "Test %d: %d connections, expected 3", nTest, nAccepts());
+	daslog_info_v("Test %d success. Closed connections not re-used", nTest);
+
+	/* Test 6: A parked connection the server dropped is noticed */
+	++nTest;
+	if(!readOkay("/bye", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	struct timespec wait = {0, 100000000};
+	nanosleep(&wait, NULL);
+	if(!readOkay("/len", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 4)
+		return das_error(nTest, "Test %d: %d connections, expected 4", nTest, nAccepts());
+	daslog_info_v("Test %d success. Dropped connection replaced", nTest);
+
+	/* Test 7: A 204 has no body even without framing headers, so the read
+	 *         doesn't wait for EOF and the connection is kept */
+	++nTest;
+	snprintf(sUrl, 127, "http://127.0.0.1:%d/empty", g_nPort);
+	DasAry* pAry = das_http_readUrl(sUrl, NULL, NULL, &res, -1, DASHTTP_TO_MIN);
+	if((pAry != NULL)||(res.nCode != 204))
+		return das_error(nTest, "Test %d: expected a 204 error, got status %d",
+			nTest, res.nCode);
+	DasHttpResp_freeFields(&res);
+	if(!readOkay("/len", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 4)
+		return das_error(nTest, "Test %d: %d connections, expected 4", nTest, nAccepts());
+	daslog_info_v("Test %d success. Empty response didn't end the connection", nTest);
+
+	/* Test 8: A framed error response is skipped and the connection kept */
+	++nTest;
+	snprintf(sUrl, 127, "http://127.0.0.1:%d/missing", g_nPort);
+	pAry = das_http_readUrl(sUrl, NULL, NULL, &res, -1, DASHTTP_TO_MIN);
+	if((pAry != NULL)||(res.nCode != 404))
+		return das_error(nTest, "Test %d: expected a 404 error, got status %d",
+			nTest, res.nCode);
+	DasHttpResp_freeFields(&res);
+	if(!readOkay("/len", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 4)
+		return das_error(nTest, "Test %d: %d connections, expected 4", nTest, nAccepts());
+	daslog_info_v("Test %d success. Not found response didn't end the connection", nTest);
+
+	/* Test 9: No pool, one connection per request */
+	++nTest;
+	if(das_http_setPoolSize(0) != DASHTTP_POOL_DEF)
+		return das_error(nTest, "Test %d: unexpected default pool size", nTest);
+	if(!readOkay("/len", &res) || !readOkay("/len", &res))
+		return das_error(nTest, "Test %d: body mismatch, %s", nTest, res.sError);
+	if(nAccepts() != 6)
+		return das_error(nTest, "Test %d: %d connections, expected 6", nTest, nAccepts());
+	daslog_info_v("Test %d success. HTTP/1.0 mode without a pool", nTest);
+
+	daslog_info("All HTTP tests passed.");
+	return 0;
+}
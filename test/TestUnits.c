@@ -375,6 +375,136 @@ int main(int argc, char** argv) {
 		}
 	}
 
+	/* Test 38: Cached time column parser agrees with the general path */
+	{
+		const char* aTimes[] = {
+			"2017-01-02T12:34:56.789", "2017-01-02T12:34:56.790", "2017-01-03T00:00:00",
+			"  2016-12-31T23:59:60.5 ", "2017-002T01:02:03.000123Z", "1997-05-07 15:00",
+			"2000-02-29T08:00:00.25", "1969-07-20T20:17:40", "2017-01-02", NULL
+		};
+		das_units aUnits[] = {UNIT_US2000, UNIT_T2000, UNIT_MJ1958, UNIT_T1970, 
+		                      UNIT_NS1970, NULL};
+		das_tparser tp;
+		for(int u = 0; aUnits[u] != NULL; ++u){
+			das_tparser_init(&tp, aUnits[u]);
+			for(int i = 0; aTimes[i] != NULL; ++i){
+				/* Leap second strings are only meaningful for TT2000 */
+				if(strstr(aTimes[i], ":60") != NULL) continue;
+				double rFast, rSlow;
+				dt_null(&dt);
+				if(!dt_parsetime(aTimes[i], &dt)){
+					printf("ERROR: Test 38 Failed, can't parse %s\n", aTimes[i]);
+					return 15;
+				}
+				rSlow = Units_convertFromDt(aUnits[u], &dt);
+				if(!das_tparser_toDouble(&tp, aTimes[i], strlen(aTimes[i]), &rFast)||
+				   (rFast != rSlow)){
+					printf("ERROR: Test 38 Failed, %s in %s gave %.17g expected %.17g\n",
+					       aTimes[i], Units_toStr(aUnits[u]), rFast, rSlow);
+					return 15;
+				}
+			}
+		}
+
+		/* TT2000 is exact to the nanosecond, including over a leap second */
+		int64_t nTT2k;
+		das_tparser_init(&tp, UNIT_TT2000);
+		if(!das_tparser_toTT2k(&tp, "2016-12-31T23:59:59", 19, &nTT2k)){
+			printf("ERROR: Test 38 Failed, TT2000 fast path not taken\n");
+			return 15;
+		}
+		int64_t nBefore = nTT2k;
+		das_tparser_toTT2k(&tp, "2016-12-31T23:59:60.5", 21, &nTT2k);
+		if(nTT2k - nBefore != 1500000000LL){
+			printf("ERROR: Test 38 Failed, leap second offset %lld\n", 
+			       (long long)(nTT2k - nBefore));
+			return 15;
+		}
+		das_tparser_toTT2k(&tp, "2017-01-01T00:00:00.000000001", 29, &nTT2k);
+		if(nTT2k - nBefore != 2000000001LL){
+			printf("ERROR: Test 38 Failed, midnight after leap second %lld\n", 
+			       (long long)(nTT2k - nBefore));
+			return 15;
+		}
+		dt_null(&dt);
+		dt_parsetime("2017-01-01T00:00:00", &dt);
+		if(dt_to_tt2k(&dt) != nTT2k - 1){
+			printf("ERROR: Test 38 Failed, TT2000 disagrees with dt_to_tt2k\n");
+			return 15;
+		}
+		if(das_tparser_toTT2k(&tp, "1969-07-20T20:17:40", 19, &nTT2k)){
+			printf("ERROR: Test 38 Failed, pre-1972 TT2000 should use the general path\n");
+			return 15;
+		}
+		if(das_tparser_toTT2k(&tp, "2017-02-30T00:00:00", 19, &nTT2k)){
+			printf("ERROR: Test 38 Failed, accepted February 30th\n");
+			return 15;
+		}
+	}
+
+	/* Test 39: Cached conversion plans */
+	{
+		das_units_conv conv = Units_getConverter(
+			Units_fromStr("V**2 cm**-2 Hz**-1"), Units_fromStr(UNIT_E_SPECDENS)
+		);
+		if((conv.nKind != DAS_UCONV_LINEAR)||(fabs(conv.rScale - 1.0e-4) > 1.0e-18)){
+			printf("ERROR: Test 39 Failed, spectral density scale %.17g\n", conv.rScale);
+			return 15;
+		}
+
+		double aIn[37], aOut[37];
+		for(int i = 0; i < 37; ++i) aIn[i] = 1.0e8 + i * 1.0e6;
+		conv = Units_getConverter(UNIT_T1970, UNIT_US2000);
+		Units_convertArray(&conv, aIn, aOut, 37);
+		for(int i = 0; i < 37; ++i){
+			if(fabs(aOut[i] - Units_convertTo(UNIT_T1970, aIn[i], UNIT_US2000)) > 1.0e-6){
+				printf("ERROR: Test 39 Failed, us2000 to t1970 gave %.17g\n", aOut[i]);
+				return 15;
+			}
+		}
+
+		/* Leap second scales are evaluated value by value */
+		conv = Units_getConverter(UNIT_TT2000, UNIT_US2000);
+		if(conv.nKind != DAS_UCONV_EPOCH){
+			printf("ERROR: Test 39 Failed, TT2000 should not be a linear conversion\n");
+			return 15;
+		}
+		Units_convertArray(&conv, aIn, aOut, 37);
+		if(aOut[36] != Units_convertTo(UNIT_TT2000, aIn[36], UNIT_US2000)){
+			printf("ERROR: Test 39 Failed, us2000 to TT2000 gave %.17g\n", aOut[36]);
+			return 15;
+		}
+	}
+
+	/* Test 40: The unit registry has no fixed capacity */
+	{
+		char sName[32];
+		das_units aMany[300];
+		for(int i = 0; i < 300; ++i){
+			snprintf(sName, 32, "gizmo%c%c", 'a' + i/26, 'a' + i%26);
+			if((aMany[i] = Units_fromStr(sName)) == NULL){
+				printf("ERROR: Test 40 Failed, couldn't define unit %s\n", sName);
+				return 15;
+			}
+		}
+		for(int i = 0; i < 300; ++i){
+			snprintf(sName, 32, "gizmo%c%c", 'a' + i/26, 'a' + i%26);
+			if((Units_fromStr(sName) != aMany[i])||(strcmp(aMany[i], sName) != 0)){
+				printf("ERROR: Test 40 Failed, %s is not a singleton\n", sName);
+				return 15;
+			}
+		}
+
+		/* Equivalent spellings resolve to the first definition, every time */
+		for(int i = 0; i < 2; ++i){
+			if(Units_fromStr("Hz**-1 V**2 m**-2") != UNIT_E_SPECDENS){
+				printf("ERROR: Test 40 Failed, respelled spectral density units "
+				       "gave %s\n", Units_fromStr("Hz**-1 V**2 m**-2"));
+				return 15;
+			}
+		}
+	}
+
 	printf("INFO: All unit manipulation tests passed\n\n");
 	return 0;
 }
@@ -19,8 +19,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <dirent.h>
+#include <utime.h>
 
 #include <das2/core.h>
 
@@ -1347,6 +1350,129 @@ int test_multiyr_time(const char* sBase)
 }
 
 
+/* ========================================================================= */
+/* Test 13 — Parallel scanning and listing cache
+ *
+ * The same query is run serially, with four scan threads, and twice with a
+ * listing cache (once to fill it, once to read from it).  All four runs must
+ * return the same paths in the same order.
+ *
+ * Fixture (template: $Y/$j/$Y$j.dat): every 15th day of year, starting at
+ * day 1, for 2023 through 2025.  Directory times are set an hour in the past, fresh
+ * directories are never cached since they may still be changing.
+ *
+ * Query "2023-001" → "2025-365" → 72 files expected.
+ */
+
+#define SCAN_EXPECT 72
+
+/* Run the query, concatenate the paths into sOut.  Returns the count or -1 */
+static int _scan_paths(
+	const char* sTplt, int nThreads, const char* sCache, char* sOut, size_t uOut
+){
+	DasUriTplt* pTplt = new_DasUriTplt();
+	if(pTplt == NULL) return -1;
+	das_range rng;
+	DasUriIter iter;
+	if((DasUriTplt_register(pTplt, das_time_uridef()) != DAS_OKAY)||
+	   (DasUriTplt_pattern(pTplt, sTplt) != DAS_OKAY)||
+	   (das_range_fromUtc(&rng, "2023-001", "2025-365") != DAS_OKAY)||
+	   (init_DasUriIter(&iter, pTplt, 1, &rng) != DAS_OKAY)
+	){
+		del_DasUriTplt(pTplt); return -1;
+	}
+	int nFound = -1;
+	if(DasUriIter_scanOpts(&iter, nThreads, sCache) == DAS_OKAY){
+		nFound = 0;
+		sOut[0] = '\0';
+		size_t uLen = 0;
+		const char* sPath;
+		while((sPath = DasUriIter_next(&iter)) != NULL){
+			uLen += snprintf(sOut + uLen, uOut - uLen, "%s\n", sPath);
+			if(uLen >= uOut){ nFound = -1; break; }
+			++nFound;
+		}
+		/* Options are fixed once scanning starts */
+		if(DasUriIter_scanOpts(&iter, 1, NULL) == DAS_OKAY) nFound = -1;
+	}
+	fini_DasUriIter(&iter);
+	del_DasUriTplt(pTplt);
+	return nFound;
+}
+
+int test_scan_opts(const char* sBase)
+{
+	printf("INFO: test_scan_opts: threaded scans and listing cache\n");
+
+	char sSub[DURI_MAX_PATH];
+	char sPath[DURI_MAX_PATH];
+	struct utimbuf tOld;
+	tOld.actime = tOld.modtime = time(NULL) - 3600;
+
+	for(int nYear = 2023; nYear <= 2025; ++nYear){
+		for(int nDoy = 1; nDoy < 360; nDoy += 15){
+			snprintf(sSub, sizeof(sSub), "scan/%d/%03d/%d%03d.dat",
+				nYear, nDoy, nYear, nDoy);
+			if(mkfile(sBase, sSub) != 0){ printf("FAIL\n"); return 1; }
+			snprintf(sPath, sizeof(sPath), "%s/scan/%d/%03d", sBase, nYear, nDoy);
+			utime(sPath, &tOld);
+		}
+		snprintf(sPath, sizeof(sPath), "%s/scan/%d", sBase, nYear);
+		utime(sPath, &tOld);
+	}
+	snprintf(sPath, sizeof(sPath), "%s/scan", sBase);
+	utime(sPath, &tOld);
+
+	char sTplt[DURI_MAX_PATH];
+	char sCache[DURI_MAX_PATH];
+	snprintf(sTplt, sizeof(sTplt), "%s/scan/$Y/$j/$Y$j.dat", sBase);
+	snprintf(sCache, sizeof(sCache), "%s/scan_cache", sBase);
+
+	static char aOut[4][SCAN_EXPECT * DURI_MAX_PATH];
+	const char* aLabel[4] = {"serial", "4 threads", "cache fill", "cache read"};
+	int nFail = 0;
+
+	for(int i = 0; i < 4; ++i){
+		int nFound = _scan_paths(
+			sTplt, (i == 1) ? 4 : ((i == 3) ? 2 : 1), (i < 2) ? NULL : sCache,
+			aOut[i], sizeof(aOut[i])
+		);
+		if(nFound != SCAN_EXPECT){
+			printf("FAIL: scan %s: found %d, expected %d\n", aLabel[i], nFound,
+				SCAN_EXPECT);
+			++nFail;
+		}
+		else if((i > 0) && (strcmp(aOut[i], aOut[0]) != 0)){
+			printf("FAIL: scan %s: paths differ from the serial scan\n", aLabel[i]);
+			++nFail;
+		}
+		else{
+			printf("PASS: scan %s: found %d\n", aLabel[i], nFound);
+		}
+	}
+
+	/* Make sure the cache was actually used */
+	int nCached = 0;
+	DIR* pDir = opendir(sCache);
+	if(pDir != NULL){
+		struct dirent* pEnt;
+		while((pEnt = readdir(pDir)) != NULL)
+			if(strstr(pEnt->d_name, ".lst") != NULL) ++nCached;
+		closedir(pDir);
+	}
+	if(nCached == 0){
+		printf("FAIL: scan cache: no listings saved in %s\n", sCache);
+		++nFail;
+	}
+	else{
+		printf("PASS: scan cache: %d listings saved\n", nCached);
+	}
+
+	if(nFail == 0) printf("INFO: test_scan_opts: PASS\n");
+	return nFail;
+}
+
+
 /* ========================================================================= */
 
 int main(int argc, char** argv)
@@ -1372,6 +1498,7 @@ int main(int argc, char** argv)
 	nFail += test_duplicate_wild(sBase);
 	nFail += test_roundup_utc(sBase);
 	nFail += test_multiyr_time(sBase);
+	nFail += test_scan_opts(sBase);
 
 	if(nFail == 0)
 		printf("INFO: All TestUri tests passed\n");
@@ -72,6 +72,16 @@ DasErrCode onData(StreamDesc* pSd, int iPktId, DasDs* pDs, void* pUser)
 	return DAS_OKAY;
 }
 
+/* Second, quiet pass over each file through a memory mapped reader, which
+   hands data packets to the decoders in place.  Must see the same packets. */
+static int64_t g_nPkts = 0;
+
+DasErrCode onCountData(StreamDesc* pSd, int iPktId, DasDs* pDs, void* pUser)
+{
+	++g_nPkts;
+	return DAS_OKAY;
+}
+
 DasErrCode onClose(StreamDesc* pSd, void* pUser)
 {
 	for(int i = 0; i < MAX_PKT_IDS; ++i){
@@ -155,6 +165,11 @@ int main(int argc, char** argv)
 		handler.closeHandler = onClose;
 		DasIO_addProcessor(pIn, &handler);
 
+		StreamHandler counter;
+		memset(&counter, 0, sizeof(StreamHandler));
+		counter.dsDataHandler = onCountData;
+		DasIO_addProcessor(pIn, &counter);
+
 		if(DasIO_readAll(pIn) != 0){
 			printf("ERROR: Couldn't parse %s\n", argv[i]);
 			return 64;
@@ -162,6 +177,41 @@ int main(int argc, char** argv)
 
 		del_DasIO(pIn); /* Should free all memory, check with valgrind*/
 
+		int64_t nPkts = g_nPkts;
+		g_nPkts = 0;
+		pIn = new_DasIO_mmap("TestV3Read", argv[i], "r");
+		DasIO_model(pIn, STREAM_MODEL_MIXED);
+		DasIO_addProcessor(pIn, &counter);
+		if(DasIO_readAll(pIn) != 0){
+			printf("ERROR: Couldn't parse %s via mmap\n", argv[i]);
+			return 64;
+		}
+		del_DasIO(pIn);
+		if(g_nPkts != nPkts){
+			printf("ERROR: mmap read of %s saw %ld data packets, expected %ld\n",
+			       argv[i], (long)g_nPkts, (long)nPkts);
+			return 64;
+		}
+		g_nPkts = 0;
+
+		/* Third pass with packet framing on a reader thread */
+		pFile = fopen(argv[i], "r");
+		pIn = new_DasIO_cfile("TestV3Read", pFile, "r");
+		DasIO_model(pIn, STREAM_MODEL_MIXED);
+		DasIO_pipeline(pIn, 4);
+		DasIO_addProcessor(pIn, &counter);
+		if(DasIO_readAll(pIn) != 0){
+			printf("ERROR: Couldn't parse %s via pipelined reads\n", argv[i]);
+			return 64;
+		}
+		del_DasIO(pIn);
+		if(g_nPkts != nPkts){
+			printf("ERROR: pipelined read of %s saw %ld data packets, expected %ld\n",
+			       argv[i], (long)g_nPkts, (long)nPkts);
+			return 64;
+		}
+		g_nPkts = 0;
+
 		printf("INFO: %s parsed without errors\n", argv[i]);
 	}
 
@@ -178,6 +178,88 @@ static void test_accum_rejects(void)
 	if(r==DAS_OKAY) FAIL("null step not rejected");
 }
 
+/* ************************************************************************* */
+/* das_txt2double & friends: bounded field parsing must match strtod exactly */
+
+static void test_txt_parse(void)
+{
+	const char* aCases[] = {
+		"0", "-0", "1", "-1", "3.14159", "  42.5  ", "1e10", "1.5E-7", "-2.5e+3",
+		".5", "5.", "0.1", "0.2", "0.3", "123456789012345678", "9007199254740993",
+		"1.7976931348623157e308", "4.9e-324", "2.2250738585072014e-308",
+		"1e23", "8.98846567431158e307", "0.000000000000000000000000001234",
+		"12345678901234567890123", "1.00000000000000011102230246251565404",
+		"inf", "-nan", "1e", "7e+", NULL
+	};
+	double rGot, rExp;
+	char* pEnd;
+	for(int i = 0; aCases[i] != NULL; ++i){
+		const char* sCase = aCases[i];
+		int nLen = (int)strlen(sCase);
+		int n = das_txt2double(sCase, nLen, &rGot);
+		rExp = strtod(sCase, &pEnd);
+		if(n == 0){ FAIL("'%s' not parsed", sCase); continue; }
+		if(isnan(rExp)){
+			if(!isnan(rGot)) FAIL("'%s' expected nan", sCase);
+			continue;
+		}
+		if(memcmp(&rGot, &rExp, sizeof(double)) != 0)
+			FAIL("'%s' -> %.17g, expected %.17g", sCase, rGot, rExp);
+	}
+
+	/* Random round trips through the shortest and longest useful forms */
+	srand(12345);
+	char sBuf[64];
+	for(int i = 0; i < 20000; ++i){
+		double rVal = ((double)rand() / RAND_MAX - 0.5) * pow(10.0, (rand() % 60) - 30);
+		snprintf(sBuf, 63, (i & 1) ? "%.17g" : "%.6e", rVal);
+		rExp = strtod(sBuf, NULL);
+		if(das_txt2double(sBuf, (int)strlen(sBuf), &rGot) != (int)strlen(sBuf))
+			FAIL("'%s' not fully consumed", sBuf);
+		else if(rGot != rExp)
+			FAIL("'%s' -> %.17g, expected %.17g", sBuf, rGot, rExp);
+	}
+
+	/* Floats must round once, straight from the text */
+	float fGot, fExp;
+	const char* aFltCases[] = {
+		"0.1", "-3.4028235e38", "1.17549435e-38", "16777217", "9007199254740993",
+		"1.00000005960464477539", "3.14159265358979", "1e-45", "  7.5e3  ", NULL
+	};
+	for(int i = 0; aFltCases[i] != NULL; ++i){
+		const char* sCase = aFltCases[i];
+		fExp = strtof(sCase, NULL);
+		if(das_txt2float(sCase, (int)strlen(sCase), &fGot) != (int)strlen(sCase))
+			FAIL("'%s' not fully consumed as float", sCase);
+		else if(fGot != fExp)
+			FAIL("'%s' -> %.9g, expected %.9g", sCase, fGot, fExp);
+	}
+	for(int i = 0; i < 20000; ++i){
+		double rVal = ((double)rand() / RAND_MAX - 0.5) * pow(10.0, (rand() % 40) - 20);
+		snprintf(sBuf, 63, (i & 1) ? "%.9g" : "%.6e", rVal);
+		fExp = strtof(sBuf, NULL);
+		if(das_txt2float(sBuf, (int)strlen(sBuf), &fGot) != (int)strlen(sBuf))
+			FAIL("'%s' not fully consumed as float", sBuf);
+		else if(fGot != fExp)
+			FAIL("'%s' -> %.9g, expected %.9g", sBuf, fGot, fExp);
+	}
+
+	/* Fields are bounded, not null terminated */
+	if((das_txt2double("12.5|99", 4, &rGot) != 4)||(rGot != 12.5))
+		FAIL("bounded field 12.5|99");
+	if(das_txt2double("   ", 3, &rGot) != 0) FAIL("blank field parsed");
+	if(das_txt2double("1.5x", 4, &rGot) != 3) FAIL("trailing text consumed");
+
+	int64_t nVal; uint64_t uVal;
+	if((das_txt2long(" -9223372036854775808 ", 22, &nVal) != 22)||(nVal != INT64_MIN))
+		FAIL("INT64_MIN");
+	if(das_txt2long("9223372036854775808", 19, &nVal) != 0) FAIL("int64 overflow");
+	if((das_txt2ulong("18446744073709551615", 20, &uVal) != 20)||(uVal != UINT64_MAX))
+		FAIL("UINT64_MAX");
+	if(das_txt2ulong("-1", 2, &uVal) != 0) FAIL("unsigned -1 accepted");
+	if(das_txt2long("1.5", 3, &nVal) != 1) FAIL("integer stops at radix");
+}
+
 /* ************************************************************************* */
 int main(int argc, char** argv)
 {
@@ -191,6 +273,7 @@ int main(int argc, char** argv)
 	test_accum_values();
 	test_accum_guards();
 	test_accum_rejects();
+	test_txt_parse();
 
 	if(g_fails > 0){
 		printf("ERROR: TestValue had %d failure(s)\n", g_fails);
@@ -5951,6 +5951,48 @@ void print_times(const DasAry* aSlice, FILE* pOut, int nPerRow, int nFracSec)
 	fputs("\n", pOut);
 }
 
+/* Compare a DasVar_getBlock() read against element-by-element DasVar_get()
+   calls over the same range.  Returns the number of mismatched values, or -1
+   if the block read itself failed.  Only scalar variables are handled here. */
+static int cmpBlock(
+	const char* sName, const DasVar* pVar, int nRank, const ptrdiff_t* pMin, const ptrdiff_t* pMax
+){
+	size_t uVals = 1;
+	for(int d = 0; d < nRank; ++d) uVals *= (size_t)(pMax[d] - pMin[d]);
+
+	double* pBlk = (double*)calloc(uVals, sizeof(double));
+	ptrdiff_t nGot = DasVar_getBlock(
+		pVar, nRank, pMin, pMax, vtDouble, (ubyte*)pBlk, uVals
+	);
+	if(nGot != (ptrdiff_t)uVals){
+		free(pBlk);
+		return -1;
+	}
+
+	int nBad = 0;
+	das_datum dm;
+	ptrdiff_t loc[DASIDX_MAX] = DASIDX_INIT_BEGIN;
+	for(int d = 0; d < nRank; ++d) loc[d] = pMin[d];
+
+	for(size_t u = 0; u < uVals; ++u){
+		DasVar_get(pVar, loc, &dm);
+		double rWant = das_datum_toDbl(&dm);
+		double rTol = fabs(rWant) * 1.0e-12;
+		if(fabs(pBlk[u] - rWant) > rTol){
+			if(nBad < 4)
+				fprintf(stderr, "   %s: block value %.17g != get value %.17g\n",
+					sName, pBlk[u], rWant);
+			++nBad;
+		}
+		for(int d = nRank - 1; d > -1; --d){   /* Inc Index */
+			if(++loc[d] < pMax[d]) break;
+			loc[d] = pMin[d];
+		}
+	}
+	free(pBlk);
+	return nBad;
+}
+
 /* Decode a DasVar index value (a lengthIn or a shape entry) into something
    readable.  A negative value is a flag, not a count: RAGGED/FUNC/UNUSED.  Uses
    a rotating set of static buffers so several calls can appear in one printf. */
@@ -6561,6 +6603,203 @@ int main(int argc, char** argv)
 	}
 	fprintf(stderr, "Test 16 success. Vector sequence composes per-component geovecs.\n");
 
+	/* Test 17: Bulk reads match single value reads for every variable type */
+	fprintf(stderr, "\nTest 17: Bulk typed block reads\n");
+	{
+		struct {
+			const char* sName; const DasVar* pVar; ptrdiff_t aMin[3]; ptrdiff_t aMax[3];
+		} aBlk[] = {
+			{"echo",    vEcho,   {0, 0, 0},  {3, 160, 80}}, /* dense rows   */
+			{"echo",    vEcho,   {1, 10, 79},{3, 20, 80}},  /* one column   */
+			{"freq",    vFreq,   {0, 0, 0},  {3, 160, 80}}, /* degenerate   */
+			{"range",   vRange,  {0, 0, 0},  {3, 160, 80}}, /* sequence     */
+			{"delay",   vDelay,  {2, 5, 3},  {3, 9, 77}},   /* offset range */
+			{"app_alt", vAppAlt, {0, 0, 0},  {3, 160, 80}}  /* unit scaling */
+		};
+		for(size_t i = 0; i < sizeof(aBlk)/sizeof(aBlk[0]); ++i){
+			int nBad = cmpBlock(aBlk[i].sName, aBlk[i].pVar, 3, aBlk[i].aMin, aBlk[i].aMax);
+			if(nBad != 0){
+				fprintf(stderr, "Test 17 FAILED: block %zu of %s (%d bad)\n",
+					i, aBlk[i].sName, nBad);
+				return 17;
+			}
+		}
+
+		/* Vectors expand to their components in storage order */
+		int32_t aComp[12] = {0};
+		ptrdiff_t aVMin[1] = {1};
+		ptrdiff_t aVMax[1] = {4};
+		if(DasVar_getBlock(
+			vL1Vecs, 1, aVMin, aVMax, vtInt, (ubyte*)aComp, 12
+		) != 9){
+			fprintf(stderr, "Test 17 FAILED: vector block size\n");
+			return 17;
+		}
+		for(int i = 0; i < 9; ++i){
+			if(aComp[i] != level1Vecs[1 + i/3][i%3]){
+				fprintf(stderr, "Test 17 FAILED: vector component %d = %d\n", i, aComp[i]);
+				return 17;
+			}
+		}
+
+		/* Typed output narrower than the storage type */
+		float aSmall[80];
+		ptrdiff_t aSMin[3] = {2, 7, 0};
+		ptrdiff_t aSMax[3] = {3, 8, 80};
+		if(DasVar_getBlock(vRange, 3, aSMin, aSMax, vtFloat, (ubyte*)aSmall, 80) != 80){
+			fprintf(stderr, "Test 17 FAILED: float range block\n");
+			return 17;
+		}
+		if(fabsf(aSmall[79] - (float)(rMin + 79*rDelta)) > 1.0e-3f){
+			fprintf(stderr, "Test 17 FAILED: range[79] = %g\n", aSmall[79]);
+			return 17;
+		}
+	}
+	fprintf(stderr, "Test 17 success. Block reads agree with single value reads.\n");
+
+	/* Test 18: Compiled reference + offset expressions */
+	fprintf(stderr, "\nTest 18: Compiled reference + offset expressions\n");
+	{
+		double aRefVals[4] = {7.0e14, 7.0e14 + 1.0e6, 7.0e14 + 2.5e6, 7.0e14 + 4.0e6};
+		DasAry* aRef = new_DasAry("ref", vtDouble, 0, NULL, RANK_1(0), Units_fromStr("us2000"));
+		DasAry_append(aRef, (const ubyte*)aRefVals, 4);
+
+		float aOffVals[4*512];
+		for(int i = 0; i < 4*512; ++i) aOffVals[i] = (i % 512) * 0.25f;
+		DasAry* aOff = new_DasAry("offset", vtFloat, 0, NULL, RANK_2(0,512), Units_fromStr("ms"));
+		DasAry_append(aOff, (const ubyte*)aOffVals, 4*512);
+
+		DasVar* vRef = new_DasVarArray(aRef, SCALAR_2(0, DEGEN));
+		DasVar* vOff = new_DasVarArray(aOff, SCALAR_2(0, 1));
+		DasVar* vAbs = new_DasVarBinary("time", vRef, "+", vOff);
+		DasVar* vRel = new_DasVarBinary("rel_time", vAbs, "-", vRef);
+		fprintf(stderr, "   %s\n", DasVar_toStr(vRel, sBuf, 511));
+
+		ptrdiff_t aMin[2] = {0, 0};
+		ptrdiff_t aMax[2] = {4, 512};
+		if((cmpBlock("time", vAbs, 2, aMin, aMax) != 0)||
+		   (cmpBlock("rel_time", vRel, 2, aMin, aMax) != 0)){
+			fprintf(stderr, "Test 18 FAILED: compiled block differs from get()\n");
+			return 18;
+		}
+
+		/* Subsets of compiled trees are filled by the block evaluator */
+		DasAry* pSub = DasVar_subset(vRel, 2, aMin, aMax);
+		if(pSub == NULL){
+			fprintf(stderr, "Test 18 FAILED: relative time subset\n");
+			return 18;
+		}
+		size_t uSub = 0;
+		const double* pRel = (const double*)DasAry_getIn(pSub, vtDouble, DIM0, &uSub);
+		if((uSub != 4*512)||(pRel[511] != 511*0.25e3)||(pRel[512] != 0.0)){
+			fprintf(stderr, "Test 18 FAILED: relative time subset\n");
+			return 18;
+		}
+		dec_DasAry(pSub);
+
+		dec_DasVar(vRel);
+		dec_DasVar(vAbs);
+		dec_DasVar(vOff);
+		dec_DasVar(vRef);
+		dec_DasAry(aOff);
+		dec_DasAry(aRef);
+	}
+	fprintf(stderr, "Test 18 success. Compiled expressions match per-element evaluation.\n");
+
+	/* Test 19: Narrowing block reads map fill and out of range values */
+	fprintf(stderr, "\nTest 19: Narrowing block reads\n");
+	{
+		double aVals[7] = {DAS_FILL_VALUE, 42.7, -5.0, 300.0, 1.0e20, NAN, -2.0e9};
+		DasAry* aNarrow = new_DasAry("narrow", vtDouble, 0, NULL, RANK_1(0), UNIT_DIMENSIONLESS);
+		DasAry_append(aNarrow, (const ubyte*)aVals, 7);
+		DasVar* vNarrow = new_DasVarArray(aNarrow, SCALAR_1(0));
+
+		ptrdiff_t aMin[1] = {0};
+		ptrdiff_t aMax[1] = {7};
+		uint8_t aUByte[7];
+		int32_t aInt[7];
+		float aFloat[7];
+		const uint8_t uFill = *((const uint8_t*)das_vt_fill(vtUByte));
+		const int32_t nFill = *((const int32_t*)das_vt_fill(vtInt));
+		uint8_t aUByteWant[7] = {uFill, 42, uFill, uFill, uFill, uFill, uFill};
+		int32_t aIntWant[7] = {nFill, 42, -5, 300, nFill, nFill, -2000000000};
+
+		if((DasVar_getBlock(vNarrow, 1, aMin, aMax, vtUByte, aUByte, 7) != 7)||
+		   (DasVar_getBlock(vNarrow, 1, aMin, aMax, vtInt, (ubyte*)aInt, 7) != 7)||
+		   (DasVar_getBlock(vNarrow, 1, aMin, aMax, vtFloat, (ubyte*)aFloat, 7) != 7)){
+			fprintf(stderr, "Test 19 FAILED: narrowing block reads\n");
+			return 19;
+		}
+		for(int i = 0; i < 7; ++i){
+			if((aUByte[i] != aUByteWant[i])||(aInt[i] != aIntWant[i])){
+				fprintf(stderr, "Test 19 FAILED: value %d read as %u and %d\n", 
+					i, aUByte[i], aInt[i]);
+				return 19;
+			}
+		}
+		if((aFloat[0] != *((const float*)das_vt_fill(vtFloat)))||(aFloat[2] != -5.0f)||
+		   (!isnan(aFloat[5]))){
+			fprintf(stderr, "Test 19 FAILED: float values %g, %g, %g\n", 
+				aFloat[0], aFloat[2], aFloat[5]);
+			return 19;
+		}
+
+		/* Integer fill widens to the real fill value */
+		int16_t aShort[3] = {7, -32767, 32000};
+		DasAry* aWide = new_DasAry("wide", vtShort, 0, NULL, RANK_1(0), UNIT_DIMENSIONLESS);
+		DasAry_append(aWide, (const ubyte*)aShort, 3);
+		DasVar* vWide = new_DasVarArray(aWide, SCALAR_1(0));
+		double aDbl[3];
+		int8_t aByte[3];
+		aMax[0] = 3;
+		if((DasVar_getBlock(vWide, 1, aMin, aMax, vtDouble, (ubyte*)aDbl, 3) != 3)||
+		   (DasVar_getBlock(vWide, 1, aMin, aMax, vtByte, (ubyte*)aByte, 3) != 3)){
+			fprintf(stderr, "Test 19 FAILED: widening block reads\n");
+			return 19;
+		}
+		if((aDbl[0] != 7.0)||(aDbl[1] != DAS_FILL_VALUE)||(aDbl[2] != 32000.0)||
+		   (aByte[0] != 7)||(aByte[1] != -128)||(aByte[2] != -128)){
+			fprintf(stderr, "Test 19 FAILED: widening values %g %g %g, %d %d %d\n",
+				aDbl[0], aDbl[1], aDbl[2], aByte[0], aByte[1], aByte[2]);
+			return 19;
+		}
+		dec_DasVar(vWide);
+		dec_DasVar(vNarrow);
+	}
+	fprintf(stderr, "Test 19 success. Narrowing conversions fill instead of overflowing.\n");
+
+	/* Test 20: Same type block reads map a custom fill too */
+	fprintf(stderr, "\nTest 20: Same type block reads with custom fill\n");
+	{
+		int16_t nCustom = -999;
+		int16_t aShort[4] = {5, -999, -32767, 12};
+		DasAry* aSame = new_DasAry(
+			"same", vtShort, 0, (const ubyte*)&nCustom, RANK_1(0), UNIT_DIMENSIONLESS
+		);
+		DasAry_append(aSame, (const ubyte*)aShort, 4);
+		DasVar* vSame = new_DasVarArray(aSame, SCALAR_1(0));
+
+		ptrdiff_t aMin[1] = {0};
+		ptrdiff_t aMax[1] = {4};
+		int16_t aOut[4];
+		double aDbl[4];
+		const int16_t nFill = *((const int16_t*)das_vt_fill(vtShort));
+		if((DasVar_getBlock(vSame, 1, aMin, aMax, vtShort, (ubyte*)aOut, 4) != 4)||
+		   (DasVar_getBlock(vSame, 1, aMin, aMax, vtDouble, (ubyte*)aDbl, 4) != 4)){
+			fprintf(stderr, "Test 20 FAILED: block reads\n");
+			return 20;
+		}
+		/* The default fill isn't fill in this array, so it passes through */
+		if((aOut[0] != 5)||(aOut[1] != nFill)||(aOut[2] != -32767)||(aOut[3] != 12)||
+		   (aDbl[1] != DAS_FILL_VALUE)||(aDbl[2] != -32767.0)){
+			fprintf(stderr, "Test 20 FAILED: values %d %d %d %d, %g %g\n",
+				aOut[0], aOut[1], aOut[2], aOut[3], aDbl[1], aDbl[2]);
+			return 20;
+		}
+		dec_DasVar(vSame);
+	}
+	fprintf(stderr, "Test 20 success. Custom fill becomes the default fill for any output type.\n");
+
 	fprintf(stderr, "\nGood! All errors found and no false positives.\n");
 
 	/* Tear down every top-level handle so leak_test reports zeros.  Vars and
@@ -0,0 +1,372 @@
+/** @file TestXform.c Unit tests for rotation and state interpolation
+ *
+ * The adaptive samplers are run on synthetic rotations and orbits with known
+ * exact values, and every output record is checked against the exact value
+ * for the requested tolerance. */
+
+/* Author: Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file contains test and example code that intends to explain an
+ * interface.
+ *
+ * As United States courts have ruled that interfaces cannot be copyrighted,
+ * the code in this individual source file, TestXform.c, is placed into the
+ * public domain and may be displayed, incorporated or otherwise re-used without
+ * restriction.  It is offered to the public without any without any warranty
+ * including even the implied warranty of merchantability or fitness for a
+ * particular purpose.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <das2/core.h>
+
+#define PI      3.14159265358979323846
+#define ARCSEC  (PI / (180.0 * 3600.0))
+
+/* 200 seconds of 128 S/s data */
+#define NROT    25600
+#define RATE    128.0
+
+/* 6 hours around perijove at 1 S/s */
+#define NORB    21600
+
+static void rotZ(double rAng, double m[3][3])
+{
+	memset(m, 0, 9*sizeof(double));
+	m[0][0] = cos(rAng);  m[0][1] = -sin(rAng);
+	m[1][0] = sin(rAng);  m[1][1] = cos(rAng);
+	m[2][2] = 1.0;
+}
+
+static void rotX(double rAng, double m[3][3])
+{
+	memset(m, 0, 9*sizeof(double));
+	m[0][0] = 1.0;
+	m[1][1] = cos(rAng);  m[1][2] = -sin(rAng);
+	m[2][1] = sin(rAng);  m[2][2] = cos(rAng);
+}
+
+static void mxm(double a[3][3], double b[3][3], double out[3][3])
+{
+	int i, j, k;
+	for(i = 0; i < 3; ++i)
+		for(j = 0; j < 3; ++j){
+			out[i][j] = 0.0;
+			for(k = 0; k < 3; ++k) out[i][j] += a[i][k]*b[k][j];
+		}
+}
+
+static double matAngle(double a[3][3], double b[3][3])
+{
+	double aQa[4], aQb[4];
+	das_quat_fromMat((const double (*)[3])a, aQa);
+	das_quat_fromMat((const double (*)[3])b, aQb);
+	return das_quat_angle(aQa, aQb);
+}
+
+/* A spinning spacecraft with a slow nutation, 20 s spin, 600 s nutation */
+typedef struct spinner {
+	double rGapBeg;
+	double rGapEnd;
+} spinner_t;
+
+static bool spinRot(void* pUser, double rTime, double mRot[3][3])
+{
+	spinner_t* pSpin = (spinner_t*)pUser;
+	if((rTime >= pSpin->rGapBeg)&&(rTime < pSpin->rGapEnd))
+		return false;
+
+	double mSpin[3][3], mTilt[3][3], mNut[3][3], mTmp[3][3];
+	rotZ(2.0*PI*rTime/20.0, mSpin);
+	rotX(0.05 + 0.01*sin(2.0*PI*rTime/600.0), mTilt);
+	rotZ(2.0*PI*rTime/600.0, mNut);
+	mxm(mTilt, mSpin, mTmp);
+	mxm(mNut, mTmp, mRot);
+	return true;
+}
+
+/* An inclined elliptical orbit about Jupiter, time 0 is perijove */
+static bool keplerState(void* pUser, double rTime, double aState[6])
+{
+	const double rMu = 126686534.0;    /* km^3/s^2 */
+	const double rA = 1.0e6;           /* km */
+	const double rEcc = 0.8;
+	const double rInc = 0.3;
+
+	double rN = sqrt(rMu / (rA*rA*rA));
+	double rM = rN * rTime;
+	double rE = rM;
+	for(int i = 0; i < 50; ++i){
+		double rStep = (rE - rEcc*sin(rE) - rM) / (1.0 - rEcc*cos(rE));
+		rE -= rStep;
+		if(fabs(rStep) < 1e-15) break;
+	}
+	double rB = rA * sqrt(1.0 - rEcc*rEcc);
+	double rDen = 1.0 - rEcc*cos(rE);
+	double x = rA*(cos(rE) - rEcc);
+	double y = rB*sin(rE);
+	double vx = -rA*rN*sin(rE)/rDen;
+	double vy = rB*rN*cos(rE)/rDen;
+
+	aState[0] = x;  aState[1] = y*cos(rInc);  aState[2] = y*sin(rInc);
+	aState[3] = vx; aState[4] = vy*cos(rInc); aState[5] = vy*sin(rInc);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	int nTest = 0;
+	size_t u, uCalls;
+	int i, j;
+	double rErr, rMaxErr;
+	double mExact[3][3];
+	double aExact[6];
+
+	/* Test 1: Quaternion round trips, including half turns */
+	++nTest;
+	double aAxes[][4] = {
+		{0.3, 1, 2, 3}, {PI, 1, 0, 0}, {PI, 0, 1, 0}, {PI, 0, 0, 1},
+		{PI, 1, 1, 0}, {3.0, -1, 0.5, 0.2}, {1e-9, 0, 0, 1}, {0, 1, 0, 0}
+	};
+	for(u = 0; u < sizeof(aAxes)/sizeof(aAxes[0]); ++u){
+		double rNorm = sqrt(aAxes[u][1]*aAxes[u][1] + aAxes[u][2]*aAxes[u][2] +
+		                    aAxes[u][3]*aAxes[u][3]);
+		double aQ[4] = {cos(aAxes[u][0]/2), 0, 0, 0};
+		for(i = 1; i < 4; ++i) aQ[i] = sin(aAxes[u][0]/2) * aAxes[u][i] / rNorm;
+
+		double mRot[3][3], aQ2[4];
+		das_quat_toMat(aQ, mRot);
+		das_quat_fromMat((const double (*)[3])mRot, aQ2);
+		if(das_quat_angle(aQ, aQ2) > 1e-12)
+			return das_error(nTest, "Test %d: round trip %zu off by %g rad", nTest,
+				u, das_quat_angle(aQ, aQ2));
+
+		/* And the angle from identity is the rotation angle */
+		double aIdent[4] = {1, 0, 0, 0};
+		if(fabs(das_quat_angle(aIdent, aQ) - aAxes[u][0]) > 1e-12)
+			return das_error(nTest, "Test %d: angle %zu is %g, expected %g", nTest,
+				u, das_quat_angle(aIdent, aQ), aAxes[u][0]);
+	}
+	daslog_info_v("Test %d success. Quaternion conversions", nTest);
+
+	/* Test 2: SLERP of a fixed axis rotation is exact */
+	++nTest;
+	double aQ0[4] = {cos(0.1), 0, 0, sin(0.1)};
+	double aQ1[4] = {-cos(0.9), 0, 0, -sin(0.9)};  /* negated on purpose */
+	double aQ[4];
+	das_quat_slerp(aQ0, aQ1, 0.25, aQ);
+	double aExpect[4] = {cos(0.3), 0, 0, sin(0.3)};
+	if(das_quat_angle(aQ, aExpect) > 1e-12)
+		return das_error(nTest, "Test %d: SLERP is off by %g rad", nTest,
+			das_quat_angle(aQ, aExpect));
+
+	/* Small spans must use the true arc too, a linear blend of these is off
+	   by about 7e-8 rad away from the midpoint */
+	double aQ2[4] = {cos(0.3), 0, 0, sin(0.3)};
+	double aQ3[4] = {cos(0.3 + 0.0131), 0, 0, sin(0.3 + 0.0131)};
+	for(i = 1; i < 4; i += 2){
+		das_quat_slerp(aQ2, aQ3, 0.25*i, aQ);
+		aExpect[0] = cos(0.3 + 0.0131*0.25*i);
+		aExpect[3] = sin(0.3 + 0.0131*0.25*i);
+		if(das_quat_angle(aQ, aExpect) > 1e-12)
+			return das_error(nTest, "Test %d: SLERP at %g over a small span is off "
+				"by %g rad", nTest, 0.25*i, das_quat_angle(aQ, aExpect));
+	}
+	daslog_info_v("Test %d success. Spherical linear interpolation", nTest);
+
+	/* Test 3: Hermite interpolation of a cubic is exact */
+	++nTest;
+	double aS0[6] = {1, 2, 3, 0.5, -1, 2};
+	double aS1[6], aSm[6];
+	for(i = 0; i < 3; ++i){   /* p(t) = p0 + v0 t + t^3, over 2 seconds */
+		aS1[i] = aS0[i] + aS0[i+3]*2.0 + 8.0;
+		aS1[i+3] = aS0[i+3] + 12.0;
+	}
+	das_hermite3(aS0, aS1, 2.0, 0.75, aSm);
+	for(i = 0; i < 3; ++i){
+		if((fabs(aSm[i] - (aS0[i] + aS0[i+3]*1.5 + 3.375)) > 1e-12)||
+		   (fabs(aSm[i+3] - (aS0[i+3] + 6.75)) > 1e-12))
+			return das_error(nTest, "Test %d: component %d is off", nTest, i);
+	}
+	daslog_info_v("Test %d success. Hermite interpolation", nTest);
+
+	/* Test 4: Adaptive rotation sampling of a nutating spinner */
+	++nTest;
+	double* pTimes = (double*)malloc(NROT * sizeof(double));
+	double* pMats = (double*)malloc(9 * NROT * sizeof(double));
+	double* pStates = (double*)malloc(6 * NORB * sizeof(double));
+	bool* pValid = (bool*)malloc(NROT * sizeof(bool));
+	for(u = 0; u < NROT; ++u) pTimes[u] = 1000.0 + u / RATE;
+
+	spinner_t spin = {-1.0, -1.0};
+	uCalls = das_xform_sampleRot(
+		pTimes, NROT, ARCSEC, 5.0, spinRot, &spin, pMats, pValid
+	);
+	rMaxErr = 0.0;
+	for(u = 0; u < NROT; ++u){
+		spinRot(&spin, pTimes[u], mExact);
+		if(!pValid[u])
+			return das_error(nTest, "Test %d: record %zu not valid", nTest, u);
+		rErr = matAngle((double (*)[3])(pMats + 9*u), mExact);
+		if(rErr > rMaxErr) rMaxErr = rErr;
+	}
+	if(rMaxErr > ARCSEC)
+		return das_error(nTest, "Test %d: maximum error %.3f arcsec", nTest,
+			rMaxErr / ARCSEC);
+	if(uCalls > NROT / 10)
+		return das_error(nTest, "Test %d: %zu exact calls for %d records", nTest,
+			uCalls, NROT);
+	daslog_info_v("Test %d success. %zu exact calls for %d rotations, maximum "
+		"error %.3f arcsec", nTest, uCalls, NROT, rMaxErr / ARCSEC);
+
+	/* Test 5: Coverage gaps are found and their edges are exact */
+	++nTest;
+	spin.rGapBeg = 1050.0;
+	spin.rGapEnd = 1053.0;
+	uCalls = das_xform_sampleRot(
+		pTimes, NROT, ARCSEC, 1.0, spinRot, &spin, pMats, pValid
+	);
+	for(u = 0; u < NROT; ++u){
+		bool bInGap = (pTimes[u] >= spin.rGapBeg)&&(pTimes[u] < spin.rGapEnd);
+		if(pValid[u] == bInGap)
+			return das_error(nTest, "Test %d: record %zu at %.4f, valid is %d", nTest,
+				u, pTimes[u], (int)pValid[u]);
+		if(pValid[u]){
+			spinRot(&spin, pTimes[u], mExact);
+			if(matAngle((double (*)[3])(pMats + 9*u), mExact) > ARCSEC)
+				return das_error(nTest, "Test %d: record %zu out of tolerance", nTest, u);
+		}
+	}
+	daslog_info_v("Test %d success. %zu exact calls with a 3 second gap", nTest, uCalls);
+
+	/* Test 6: No tolerance means every distinct time is exact */
+	++nTest;
+	for(u = 0; u < 100; ++u) pTimes[u] = 1049.0 + (u/2) * 0.1;  /* pairs */
+	uCalls = das_xform_sampleRot(pTimes, 100, 0.0, 0.0, spinRot, &spin, pMats, pValid);
+	if(uCalls != 50)
+		return das_error(nTest, "Test %d: %zu exact calls, expected 50", nTest, uCalls);
+	for(u = 0; u < 100; ++u){
+		bool bInGap = (pTimes[u] >= spin.rGapBeg)&&(pTimes[u] < spin.rGapEnd);
+		if(pValid[u] == bInGap)
+			return das_error(nTest, "Test %d: record %zu valid is %d", nTest, u,
+				(int)pValid[u]);
+		if(pValid[u]){
+			spinRot(&spin, pTimes[u], mExact);
+			for(i = 0; i < 3; ++i)
+				for(j = 0; j < 3; ++j)
+					if(pMats[9*u + 3*i + j] != mExact[i][j])
+						return das_error(nTest, "Test %d: record %zu differs", nTest, u);
+		}
+	}
+
+	/* Unsorted times are also all exact */
+	pTimes[10] = 1000.0;
+	uCalls = das_xform_sampleRot(pTimes, 100, ARCSEC, 0.0, spinRot, &spin, pMats, pValid);
+	if(uCalls != 51)
+		return das_error(nTest, "Test %d: %zu exact calls for unsorted times", nTest, uCalls);
+	daslog_info_v("Test %d success. Exact mode", nTest);
+
+	/* Test 7: Adaptive state sampling through perijove */
+	++nTest;
+	for(u = 0; u < NORB; ++u) pTimes[u] = -(NORB/2) + (double)u;
+	uCalls = das_xform_sampleState(
+		pTimes, NORB, 0.01, 600.0, keplerState, NULL, pStates, pValid
+	);
+	rMaxErr = 0.0;
+	for(u = 0; u < NORB; ++u){
+		keplerState(NULL, pTimes[u], aExact);
+		if(!pValid[u])
+			return das_error(nTest, "Test %d: record %zu not valid", nTest, u);
+		rErr = 0.0;
+		for(i = 0; i < 3; ++i)
+			rErr += (pStates[6*u + i] - aExact[i])*(pStates[6*u + i] - aExact[i]);
+		rErr = sqrt(rErr);
+		if(rErr > rMaxErr) rMaxErr = rErr;
+	}
+	if(rMaxErr > 0.01)
+		return das_error(nTest, "Test %d: maximum error %.4f km", nTest, rMaxErr);
+	if(uCalls > NORB / 10)
+		return das_error(nTest, "Test %d: %zu exact calls for %d records", nTest,
+			uCalls, NORB);
+	daslog_info_v("Test %d success. %zu exact calls for %d states, maximum "
+		"error %.5f km", nTest, uCalls, NORB, rMaxErr);
+
+	/* Test 8: Block rotations, shared and per-vector, odd lengths, in place */
+	++nTest;
+	double* pVecs = (double*)malloc(3 * 101 * sizeof(double));
+	double* pRot = (double*)malloc(3 * 101 * sizeof(double));
+	for(u = 0; u < 101; ++u){
+		spin.rGapBeg = spin.rGapEnd = -1.0;
+		spinRot(&spin, 10.0 + u*0.37, (double (*)[3])(pMats + 9*u));
+		for(i = 0; i < 3; ++i) pVecs[3*u + i] = sin(u*1.3 + i) * 40.0;
+	}
+	for(int nShared = 0; nShared < 2; ++nShared){
+		size_t uStep = nShared ? 0 : 9;
+		das_xform_rotate(pMats, uStep, pVecs, 101, pRot);
+		for(u = 0; u < 101; ++u){
+			const double* m = pMats + u*uStep;
+			for(i = 0; i < 3; ++i){
+				double rExp = m[3*i]*pVecs[3*u] + m[3*i+1]*pVecs[3*u+1] + m[3*i+2]*pVecs[3*u+2];
+				if(fabs(pRot[3*u + i] - rExp) > 1e-12)
+					return das_error(nTest, "Test %d: vector %zu component %d is %g, "
+						"expected %g", nTest, u, i, pRot[3*u + i], rExp);
+			}
+		}
+	}
+	memcpy(pStates, pVecs, 3 * 101 * sizeof(double));
+	das_xform_rotate(pMats, 9, pStates, 101, pStates);
+	das_xform_rotate(pMats, 9, pVecs, 101, pRot);
+	if(memcmp(pStates, pRot, 3 * 101 * sizeof(double)) != 0)
+		return das_error(nTest, "Test %d: in-place rotation differs", nTest);
+	daslog_info_v("Test %d success. Block rotations", nTest);
+
+	/* Test 9: Block coordinate conversions */
+	++nTest;
+	double aCyl[] = {2.0, 270.0, -1.0};   /* ρ,φ,z, φ in [0,360) */
+	double aSph[] = {2.0, 90.0, -90.0};   /* r,θ,φ, θ from the pole */
+	double aLat[] = {2.0, -90.0, 0.0};    /* r,φ,θ, θ from the equator */
+	double aCar[] = {0.0, -2.0, 0.0};
+	double aTmp[3];
+	double* aSys[] = {aCyl, aSph, aLat};
+	ubyte aSysId[] = {DAS_VSYS_CYL, DAS_VSYS_SPH, DAS_VSYS_CENTRIC};
+	for(j = 0; j < 3; ++j){
+		memcpy(aTmp, aSys[j], 3*sizeof(double));
+		das_xform_toCart(aSysId[j], aTmp, 1);
+		if(j == 0) aCar[2] = -1.0; else aCar[2] = 0.0;
+		for(i = 0; i < 3; ++i)
+			if(fabs(aTmp[i] - aCar[i]) > 1e-12)
+				return das_error(nTest, "Test %d: %s to cartesian, component %d is %g",
+					nTest, das_compsys_str(aSysId[j]), i, aTmp[i]);
+		das_xform_fromCart(aSysId[j], aTmp, 1);
+		for(i = 0; i < 3; ++i)
+			if(fabs(aTmp[i] - aSys[j][i]) > 1e-12)
+				return das_error(nTest, "Test %d: %s from cartesian, component %d is %g",
+					nTest, das_compsys_str(aSysId[j]), i, aTmp[i]);
+	}
+	memcpy(pStates, pVecs, 3 * 101 * sizeof(double));
+	for(j = 0; j < 3; ++j){
+		das_xform_fromCart(aSysId[j], pStates, 101);
+		das_xform_toCart(aSysId[j], pStates, 101);
+		for(u = 0; u < 3*101; ++u)
+			if(fabs(pStates[u] - pVecs[u]) > 1e-12)
+				return das_error(nTest, "Test %d: %s round trip is off", nTest,
+					das_compsys_str(aSysId[j]));
+	}
+	daslog_info_v("Test %d success. Block coordinate conversions", nTest);
+
+	free(pVecs);
+	free(pRot);
+	free(pTimes);
+	free(pMats);
+	free(pStates);
+	free(pValid);
+	daslog_info("All transform interpolation tests passed.");
+	return 0;
+}
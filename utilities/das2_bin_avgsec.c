@@ -63,17 +63,9 @@ size_t g_uMinIndex[100][MAXPLANES] = {{0}};
 /* Keep track of the Std. Dev. plane for each origin plane */
 size_t g_uStdDevIndex[100][MAXPLANES] = {{0}};
 
-/* Sum accumulation array, one for each plane of each packet type, fill values
- * aren't added to the count */
-double* g_ldSum[100][MAXPLANES] = {{NULL}};
-
-/* Counting array, one for each plane of each packet type, fill values aren't
-   added to the count. */
-double* g_ldCount[100][MAXPLANES] = {{NULL}};
-
-/* Min max arrays, one for each variable of each physical dimension */
-double* g_ldMin[100][MAXPLANES] = {{NULL}};
-double* g_ldMax[100][MAXPLANES] = {{NULL}};
+/* Sum, count and optionally min/max accumulators, one for each plane of each
+ * packet type, fill values aren't added to the count */
+DasBinAcc* g_lpBins[100][MAXPLANES] = {{NULL}};
 
 /* Accumulation arrays, if needed */
 DasAry* g_lpAccum[100][MAXPLANES] = {{NULL}};
@@ -218,9 +210,8 @@ DasErrCode sendData(int nPktId)
 	
 	double dTmp    = 0.0;
 	double average = 0.0;
-	double minVal = 0.0;
-	double maxVal = 0.0;
 	double sdVal = 0.0;
+	DasBinAcc* pBins = NULL;
 	DasAry* pAcc = NULL;
 	const double* pAccVals = NULL;
 	size_t uAccAllVals = 0;
@@ -244,94 +235,78 @@ DasErrCode sendData(int nPktId)
 			continue;
 		}
 
+		pBins = g_lpBins[nPktId][u];
+		PlaneDesc_setValues(pPlane, DasBinAcc_get(pBins, 0, DAS_BINACC_MEAN));
+
+		if(bRangeOut){
+			pMin = PktDesc_getPlane(pPdOut, g_uMinIndex[nPktId][u]);
+			PlaneDesc_setValues(pMin, DasBinAcc_get(pBins, 0, DAS_BINACC_MIN));
+			pMax = PktDesc_getPlane(pPdOut, g_uMaxIndex[nPktId][u]);
+			PlaneDesc_setValues(pMax, DasBinAcc_get(pBins, 0, DAS_BINACC_MAX));
+		}
+
 		size_t uItems = PlaneDesc_getNItems(pPlane);
-		for(size_t v = 0; v < uItems; v++){
+		for(size_t v = 0; bStdDevOut && (v < uItems); v++){
 				
-			if(g_ldCount[nPktId][u][v] == 0.0){
-				average = PlaneDesc_getFill(pPlane);
-				minVal = average;
-				maxVal = average;
-				sdVal  = average;
+			if(pBins->pCount[v] == 0.0){
+				sdVal = PlaneDesc_getFill(pPlane);
 			}
 			else{
-				average = g_ldSum[nPktId][u][v] / g_ldCount[nPktId][u][v];
-
-				if(bRangeOut){
-					minVal = g_ldMin[nPktId][u][v];
-					maxVal = g_ldMax[nPktId][u][v];
+				average = PlaneDesc_getValue(pPlane, v);
+				/* Run through all accumulated values for this "frequency" and get SD 
+				 * -or-
+				 * run through all accumulated values for all "offsets" and get SD */
+				pAcc = g_lpAccum[nPktId][u];
+				size_t uSzEa = 0;
+				pAccVals = (double*)DasAry_getAllVals(pAcc, &uSzEa, &uAccAllVals);
+				uAccPkts = DasAry_lengthIn(pAcc, DIM0);
+				uAccOffsets = DasAry_lengthIn(pAcc, DIM1_AT(0));
+
+				if(uAccPkts*uAccOffsets != uAccAllVals){
+					return das_error(P_ERR, "Expected %zu*%zu = %zu accumlated values, have %zu",
+						uAccPkts, uAccOffsets, uAccPkts*uAccOffsets, uAccAllVals
+					);
 				}
 
-				if(bStdDevOut){
-					/* Run through all accumulated values for this "frequency" and get SD 
-					 * -or-
-					 * run through all accumulated values for all "offsets" and get SD */
-					pAcc = g_lpAccum[nPktId][u];
-					size_t uSzEa = 0;
-					pAccVals = (double*)DasAry_getAllVals(pAcc, &uSzEa, &uAccAllVals);
-					uAccPkts = DasAry_lengthIn(pAcc, DIM0);
-					uAccOffsets = DasAry_lengthIn(pAcc, DIM1_AT(0));
-
-					if(uAccPkts*uAccOffsets != uAccAllVals){
-						return das_error(P_ERR, "Expected %zu*%zu = %zu accumlated values, have %zu",
-							uAccPkts, uAccOffsets, uAccPkts*uAccOffsets, uAccAllVals
-						);
-					}
-
-					sdVal = 0;
-					if(uAccAllVals > 1){  /* SD of 1 value is == 0 */
-
-						/* If these data are rank 2 but output is only rank 1, iteration
-						   is not "per frequency" but over all offsets */
-						if((uAccOffsets > 1) && (uItems == 1)){
-
-							size_t uNonFill = 0;
-							for(size_t uPkt = 0; uPkt < uAccPkts; ++uPkt){
-								for(size_t uOff = 0; uOff < uAccOffsets; ++uOff){
-									dTmp = pAccVals[uAccOffsets*uPkt + uOff]; /* I know I can stride, it's das2*/
-									if(! PlaneDesc_isFill(pPlane, dTmp)){
-										dTmp = (dTmp - average);
-										sdVal += dTmp*dTmp;
-										++uNonFill;
-									}
+				sdVal = 0;
+				if(uAccAllVals > 1){  /* SD of 1 value is == 0 */
+
+					/* If these data are rank 2 but output is only rank 1, iteration
+					   is not "per frequency" but over all offsets */
+					if((uAccOffsets > 1) && (uItems == 1)){
+
+						size_t uNonFill = 0;
+						for(size_t uPkt = 0; uPkt < uAccPkts; ++uPkt){
+							for(size_t uOff = 0; uOff < uAccOffsets; ++uOff){
+								dTmp = pAccVals[uAccOffsets*uPkt + uOff]; /* I know I can stride, it's das2*/
+								if(! PlaneDesc_isFill(pPlane, dTmp)){
+									dTmp = (dTmp - average);
+									sdVal += dTmp*dTmp;
+									++uNonFill;
 								}
 							}
-							if(uNonFill > 1)
-								sdVal /= (uNonFill - 1);		
 						}
-						else{
-							for(size_t uPkt = 0; uPkt < uAccPkts; ++uPkt){
-								dTmp = (pAccVals[uAccOffsets*uPkt + v] - average);
-								sdVal += dTmp*dTmp;
-							}
-							sdVal /= (uAccPkts - 1);		
+						if(uNonFill > 1)
+							sdVal /= (uNonFill - 1);		
+					}
+					else{
+						for(size_t uPkt = 0; uPkt < uAccPkts; ++uPkt){
+							dTmp = (pAccVals[uAccOffsets*uPkt + v] - average);
+							sdVal += dTmp*dTmp;
 						}
-
-						sdVal = sqrt(sdVal);
+						sdVal /= (uAccPkts - 1);		
 					}
+
+					sdVal = sqrt(sdVal);
 				}
 			}
 			
-			PlaneDesc_setValue(pPlane, v, average);
-				
-			if(bRangeOut){
-				pMin = PktDesc_getPlane(pPdOut, g_uMinIndex[nPktId][u]);
-				PlaneDesc_setValue(pMin, v, minVal);
-				pMax = PktDesc_getPlane(pPdOut, g_uMaxIndex[nPktId][u]);
-				PlaneDesc_setValue(pMax, v, maxVal);
-						
-				g_ldMin[nPktId][u][v]   = 0.0;
-				g_ldMax[nPktId][u][v]   = 0.0;
-			}
-
-			if(bStdDevOut){
-				pStdDev = PktDesc_getPlane(pPdOut, g_uStdDevIndex[nPktId][u]);
-				PlaneDesc_setValue(pStdDev, v, sdVal);
-			}
-		
-			g_ldSum[nPktId][u][v]   = 0.0;
-			g_ldCount[nPktId][u][v] = 0.0;
+			pStdDev = PktDesc_getPlane(pPdOut, g_uStdDevIndex[nPktId][u]);
+			PlaneDesc_setValue(pStdDev, v, sdVal);
 		}
 
+		DasBinAcc_clear(pBins);
+
 		if(g_lpAccum[nPktId][u] != NULL)
 			DasAry_clear(g_lpAccum[nPktId][u]);
 	}
@@ -459,25 +434,19 @@ DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* v)
 			g_uStdDevIndex[nPktId][u] = PktDesc_addPlane(pPdOut, pStdDevPlane);
 		}
 		
-		if(g_ldSum[nPktId][u] != NULL) free(g_ldSum[nPktId][u]);
-		if(g_ldCount[nPktId][u] != NULL) free(g_ldCount[nPktId][u]);
-		
-		if(g_bRangeOut){
-			if(g_ldMin[nPktId][u] != NULL) free(g_ldMin[nPktId][u]);
-			if(g_ldMax[nPktId][u] != NULL) free(g_ldMax[nPktId][u]);
-		}
+		del_DasBinAcc(g_lpBins[nPktId][u]);
+
 		if(g_bStdDevOut){
 			if(g_lpAccum[nPktId][u] != NULL)
 				dec_DasAry(g_lpAccum[nPktId][u]);
 		}
 		
-		g_ldSum[nPktId][u] = (double*)calloc(uItems, sizeof(double));
-		g_ldCount[nPktId][u] = (double*)calloc(uItems, sizeof(double));
-		
-		if(g_bRangeOut){
-			g_ldMin[nPktId][u] = (double*)calloc(uItems, sizeof(double));
-			g_ldMax[nPktId][u] = (double*)calloc(uItems, sizeof(double));
-		}
+		g_lpBins[nPktId][u] = new_DasBinAcc(
+			1, uItems, PlaneDesc_getFill(pPlOut),
+			g_bRangeOut ? (DAS_BINACC_MIN | DAS_BINACC_MAX) : 0
+		);
+		if(g_lpBins[nPktId][u] == NULL)
+			return P_ERR;
 		if(g_bStdDevOut){
 			double dFill = PlaneDesc_getFill(pPlOut);
 			g_lpAccum[nPktId][u] = new_DasAry(
@@ -497,7 +466,6 @@ DasErrCode onPktData(PktDesc* pPdIn, void* ud)
 {
 	int nRet = 0;
 	int nPktId = PktDesc_getId(pPdIn);
-	bool bRange = g_bRangeOut; /* Avoid L1 cache miss in tight loop */
 	
 	/* Check to see if this is the first time this packet type has
 	   been seen  (Note: output packet ID's mirror the input) */
@@ -539,33 +507,12 @@ DasErrCode onPktData(PktDesc* pPdIn, void* ud)
 		pInPlane = PktDesc_getPlane(pPdIn, u);
 		pVals = PlaneDesc_getValues(pInPlane);
 		size_t nVals = PlaneDesc_getNItems(pInPlane);
-		size_t vOut = 0;
-		for(size_t v = 0; v < nVals; v++){
-			
-			if(PlaneDesc_isFill(pInPlane, pVals[v]))
-				continue;
 
-			vOut = COLLAPSE(pInPlane) ? 0 : v;
-			
-			// the sum / count calculation would fail for TT2000 long integers.
-			// but this calculation is ignored for X planes.
-			g_ldSum[nPktId][u][vOut] += pVals[v];
-			g_ldCount[nPktId][u][vOut] += 1;
-			if(bRange){
-					
-				if(g_ldCount[nPktId][u][vOut] == 1){
-					g_ldMin[nPktId][u][vOut] = pVals[v];
-					g_ldMax[nPktId][u][vOut] = pVals[v];
-				}
-				else{
-					if(pVals[v] < g_ldMin[nPktId][u][vOut])
-						g_ldMin[nPktId][u][vOut] = pVals[v];
-					
-					if(pVals[v] > g_ldMax[nPktId][u][vOut])
-						g_ldMax[nPktId][u][vOut] = pVals[v];
-				}
-			}
-		}
+		/* Collapsed planes have a single item accumulator, so all values are
+		   summed into it.  The sum / count calculation would fail for TT2000
+		   long integers, but this calculation is ignored for X planes. */
+		nRet = DasBinAcc_add(g_lpBins[nPktId][u], 0, pVals, nVals);
+		if(nRet != 0) return nRet;
 
 		/* They want to accumlate data for some reason, so do it. */
 		if(g_lpAccum[nPktId][u] != NULL){
@@ -53,16 +53,9 @@ size_t g_uOrigPlanes[100] = {0};
 /* Keep track of the peak plane for each original plane */
 size_t g_uPeakIndex[100][MAXPLANES] = {{0}};
 
-/* Sum accumulation array, one for each plane of each packet type, fill values
- * aren't added to the count */
-double* g_lrSum[100][MAXPLANES] = {{NULL}};
-
-/* Counting array, one for each plane of each packet type, fill values aren't
-   added to the count. */
-double* g_lrCount[100][MAXPLANES] = {{NULL}};
-
-/* Peaks array, one for each plane of each packet type */
-double* g_lrPeaks[100][MAXPLANES] = {{NULL}};
+/* Sum, count and peak accumulators, one for each plane of each packet type,
+ * fill values aren't added to the count */
+DasBinAcc* g_lpBins[100][MAXPLANES] = {{NULL}};
 
 /* ************************************************************************* */
 /* Comments and exceptions */
@@ -151,42 +144,31 @@ DasErrCode sendData(int nPktId)
 	PktDesc* pPdOut = StreamDesc_getPktDesc(g_pSdOut, nPktId);
 	
 	double value = 0.0;
-	double peakVal = 0.0;
 	PlaneDesc* pPlane = NULL;
 	PlaneDesc* pPeaks = NULL;
+	DasBinAcc* pBins = NULL;
 	
 	for(size_t p = 0; p < g_uOrigPlanes[nPktId]; p++){
 		pPlane = PktDesc_getPlane(pPdOut, p);
 		
-		for(size_t u = 0; u < PlaneDesc_getNItems(pPlane); u++){
-			if(pPlane->planeType == X){
-				value = g_rBinSzMicroSec*(((double)g_lnBin[nPktId]) + 0.5) + g_rStartMicroSec;
-			}
-			else{
-				if(g_lrCount[nPktId][p][u] == 0.0){
-					value = PlaneDesc_getFill(pPlane);
-					peakVal = value;
-				}
-				else{
-					value = g_lrSum[nPktId][p][u] / g_lrCount[nPktId][p][u];
-					peakVal = g_lrPeaks[nPktId][p][u];
-				}
-			}
-			PlaneDesc_setValue(pPlane, u, value);
-			
-			if(pPlane->planeType != X){
-				pPeaks = PktDesc_getPlane(pPdOut, g_uPeakIndex[nPktId][p]);
-				PlaneDesc_setValue(pPeaks, u, peakVal);
-			}
-			
-			g_lrSum[nPktId][p][u] = 0.0;
-			g_lrCount[nPktId][p][u] = 0.0;
-			g_lrPeaks[nPktId][p][u] = 0.0;
+		if(pPlane->planeType == X){
+			value = g_rBinSzMicroSec*(((double)g_lnBin[nPktId]) + 0.5) + g_rStartMicroSec;
+			for(size_t u = 0; u < PlaneDesc_getNItems(pPlane); u++)
+				PlaneDesc_setValue(pPlane, u, value);
+			continue;
 		}
-		
-		g_lbHasBinNo[nPktId] = false;
-		g_lnBin[nPktId] = 0;
+
+		pBins = g_lpBins[nPktId][p];
+		PlaneDesc_setValues(pPlane, DasBinAcc_get(pBins, 0, DAS_BINACC_MEAN));
+
+		pPeaks = PktDesc_getPlane(pPdOut, g_uPeakIndex[nPktId][p]);
+		PlaneDesc_setValues(pPeaks, DasBinAcc_get(pBins, 0, DAS_BINACC_MAX));
+
+		DasBinAcc_clear(pBins);
 	}
+
+	g_lbHasBinNo[nPktId] = false;
+	g_lnBin[nPktId] = 0;
 	
 	return DasIO_writePktData(g_pIoOut, pPdOut);
 }
@@ -259,13 +241,12 @@ DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* v)
 			 */
 		}
 		
-		if(g_lrSum[nPktId][u] != NULL) free(g_lrSum[nPktId][u]);
-		if(g_lrCount[nPktId][u] != NULL) free(g_lrCount[nPktId][u]);
-		if(g_lrPeaks[nPktId][u] != NULL) free(g_lrPeaks[nPktId][u]);
-		
-		g_lrSum[nPktId][u] = (double*)calloc(uItems, sizeof(double));
-		g_lrCount[nPktId][u] = (double*)calloc(uItems, sizeof(double));
-		g_lrPeaks[nPktId][u] = (double*)calloc(uItems, sizeof(double));
+		del_DasBinAcc(g_lpBins[nPktId][u]);
+		g_lpBins[nPktId][u] = new_DasBinAcc(
+			1, uItems, PlaneDesc_getFill(pPlOut), DAS_BINACC_MAX
+		);
+		if(g_lpBins[nPktId][u] == NULL)
+			return P_ERR;
 	}	
 
 	return DasIO_writePktDesc(g_pIoOut, pPdOut);
@@ -318,14 +299,10 @@ DasErrCode onPktData(PktDesc* pPdIn, void* ud)
 		
 		pInPlane = PktDesc_getPlane(pPdIn, u);
 		pVals = PlaneDesc_getValues(pInPlane);
-		for(size_t v = 0; v < PlaneDesc_getNItems(pInPlane); v++){
-			if(!PlaneDesc_isFill(pInPlane, pVals[v])){
-				g_lrSum[nPktId][u][v] += pVals[v];
-				g_lrCount[nPktId][u][v] += 1;
-				if(pVals[v] > g_lrPeaks[nPktId][u][v])
-					g_lrPeaks[nPktId][u][v] = pVals[v];
-			}
-		}
+		nRet = DasBinAcc_add(
+			g_lpBins[nPktId][u], 0, pVals, PlaneDesc_getNItems(pInPlane)
+		);
+		if(nRet != 0) return nRet;
 	}
 	return nRet;
 }
@@ -0,0 +1,547 @@
+/* Copyright (C) 2025  Chris Piker  <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* das2_bin_quantile: Time reduce das2 streams to medians or other quantiles */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <das2/core.h>
+
+#define P_ERR 100
+
+#define MAX_QUANT 16
+
+/* ************************************************************************* */
+/* Record Keeping */
+
+bool g_bProgress = true;         /* Forward or drop stream annotations */
+DasIO* g_pIoOut = NULL;          /* The output writer */
+StreamDesc* g_pSdOut = NULL;     /* The output stream descriptor */
+
+/* The us2000 time of the first packet received, or the -b time */
+double g_rStartMicroSec = 0.0;
+bool g_bHasStartTime = false;
+
+double g_rBinSzMicroSec = 0.0;   /* Output bin size in micro-seconds */
+bool   g_lbHasBinNo[100] = {false};
+long   g_lnBin[100] = {0};       /* The current X-axis 'bin number' by pkt id */
+
+/* Keep track of where the original data planes stop */
+size_t g_uOrigPlanes[100] = {0};
+
+/* Requested quantiles, the first goes in the original plane */
+double g_aQuant[MAX_QUANT] = {0.5};
+int g_nQuant = 1;
+
+/* Values held per sketch level, 0 for the library default */
+size_t g_uSketchCap = 0;
+
+/* Index of the first extra quantile plane for each original plane, the
+ * rest follow in order */
+size_t g_uQuantIndex[100][MAXPLANES] = {{0}};
+
+/* Quantile accumulators, one for each plane of each packet type, fill values
+ * aren't added */
+DasBinAcc* g_lpBins[100][MAXPLANES] = {{NULL}};
+
+/* ************************************************************************* */
+/* Maybe copy out Exceptions and Comments */
+
+DasErrCode onException(OobExcept* pExcept, void* vpOut)
+{
+	return DasIO_writeException(g_pIoOut, pExcept);
+}
+
+DasErrCode onComment(OobComment* pCmt, void* vpOut)
+{
+	if(! g_bProgress && (
+		(strcmp(pCmt->sType, "taskProgress") == 0) || (strcmp(pCmt->sType, "taskSize") == 0)
+	))
+		return DAS_OKAY;
+
+	return DasIO_writeComment(g_pIoOut, pCmt);
+}
+
+/*****************************************************************************/
+/* Stream Header Processing */
+
+DasErrCode onStreamHdr(StreamDesc* pSdIn, void* v)
+{
+	g_pSdOut = StreamDesc_copy(pSdIn);
+	double rBinSzSec = g_rBinSzMicroSec*1e-6;
+	double rCacheRes = rBinSzSec;
+	char sResInfo[64] = {'\0'};
+	const char* sWhat = ((g_nQuant == 1)&&(g_aQuant[0] == 0.5)) ? "Medians" : "Quantiles";
+
+	/* Update the output xTagWidth if it's less than the resolution */
+	if( DasDesc_has((DasDesc*)g_pSdOut, "xTagWidth" ) ) {
+		double rInWidth = DasDesc_getDatum((DasDesc*)g_pSdOut, "xTagWidth", UNIT_SECONDS);
+		if(rInWidth < rBinSzSec)
+			DasDesc_setDatum((DasDesc*)g_pSdOut, "xTagWidth", rBinSzSec, UNIT_SECONDS);
+		else
+			rCacheRes = rInWidth;
+	}
+	else{
+		DasDesc_setDatum((DasDesc*)g_pSdOut, "xTagWidth", rBinSzSec, UNIT_SECONDS);
+	}
+
+	DasDesc_setDatum((DasDesc*)g_pSdOut, "xCacheResolution", rCacheRes, UNIT_SECONDS);
+
+	if(rCacheRes < 1.0)
+		snprintf(sResInfo, 63, " (%.0f ms %s)", rCacheRes*1000, sWhat);
+	else if(rCacheRes < 60.0)
+		snprintf(sResInfo, 63, " (%.1f s %s)", rCacheRes, sWhat);
+	else if(rCacheRes < 3600.0)
+		snprintf(sResInfo, 63, " (%.1f minute %s)", rCacheRes/60.0, sWhat);
+	else if(rCacheRes < 86400.0)
+		snprintf(sResInfo, 63, " (%.1f hour %s)", rCacheRes/3600.0, sWhat);
+	else
+		snprintf(sResInfo, 63, " (%.3g day %s)", rCacheRes/86400, sWhat);
+
+	DasDesc_setStr((DasDesc*)g_pSdOut, "xCacheResInfo", sResInfo);
+
+	if(DasDesc_has((DasDesc*)g_pSdOut, "Data_type"))
+		DasDesc_setStr((DasDesc*)g_pSdOut, "Data_type", "K0>Key Parameter");
+
+	return DasIO_writeStreamDesc(g_pIoOut, g_pSdOut);
+}
+
+/* ************************************************************************* */
+/* Waveform <yscan> planes that fit in a single bin are collapsed to a single
+   point, same as das2_bin_avgsec */
+
+bool shouldCollapse(PlaneDesc* pPlane){
+
+	if(PlaneDesc_getType(pPlane) != YScan)
+		return false;
+
+	const char* sRend = DasDesc_getStr((DasDesc*)pPlane, "renderer");
+	if(sRend == NULL) return false;
+	if(strcmp("waveform", sRend) != 0) return false;
+
+	das_units units = PlaneDesc_getYTagUnits(pPlane);
+	if(! Units_canConvert(units, UNIT_SECONDS)) return false;
+
+	size_t uItems = PlaneDesc_getNItems(pPlane);
+	double dMin = 0.0, dMax = 0.0;
+	const double* pTags = PlaneDesc_getOrMakeYTags(pPlane);
+	for(size_t u = 0; u < uItems; ++u){
+		if((u == 0)||(dMin > pTags[u])) dMin = pTags[u];
+		if((u == 0)||(dMax < pTags[u])) dMax = pTags[u];
+	}
+
+	double dRange = Units_convertTo(UNIT_MICROSECONDS, dMax - dMin, units);
+	return (dRange <= g_rBinSzMicroSec);
+}
+
+/*****************************************************************************/
+/* Data Output */
+
+DasErrCode sendData(int nPktId)
+{
+	/* Don't flush a packet that hasn't seen any data */
+	if( ! g_lbHasBinNo[nPktId] )
+		return 0;
+
+	PktDesc* pPdOut = StreamDesc_getPktDesc(g_pSdOut, nPktId);
+	PlaneDesc* pPlane = NULL;
+	PlaneDesc* pQuant = NULL;
+	DasBinAcc* pBins = NULL;
+	double rVal;
+
+	for(size_t u = 0; u < g_uOrigPlanes[nPktId]; u++){
+
+		pPlane = PktDesc_getPlane(pPdOut, u);
+
+		if(pPlane->planeType == X){
+			rVal = g_rBinSzMicroSec*(((double)g_lnBin[nPktId]) + 0.5) +
+			       g_rStartMicroSec;
+			PlaneDesc_setValue(pPlane, 0, rVal);
+			continue;
+		}
+
+		pBins = g_lpBins[nPktId][u];
+		for(int q = 0; q < g_nQuant; ++q){
+			pQuant = (q == 0) ? pPlane :
+				PktDesc_getPlane(pPdOut, g_uQuantIndex[nPktId][u] + q - 1);
+			PlaneDesc_setValues(pQuant, DasBinAcc_getQuantile(pBins, 0, g_aQuant[q]));
+		}
+
+		DasBinAcc_clear(pBins);
+	}
+
+	g_lbHasBinNo[nPktId] = false;
+	g_lnBin[nPktId] = 0;
+
+	return DasIO_writePktData(g_pIoOut, pPdOut);
+}
+
+/*****************************************************************************/
+/* Packet Header Processing */
+
+DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* v)
+{
+	int nPktId = PktDesc_getId(pPdIn);
+
+	/* If this output packet ID already exists, kick out any data associated
+	   with it and delete it */
+	if(StreamDesc_isValidId(g_pSdOut, nPktId)){
+		sendData(nPktId);
+		StreamDesc_freeDesc(g_pSdOut, nPktId);
+	}
+
+	/* Each data plane takes one output plane per quantile */
+	size_t uInPlanes = PktDesc_getNPlanes(pPdIn);
+	size_t uDataPlanes = uInPlanes - PktDesc_getNPlanesOfType(pPdIn, X);
+	size_t uOutPlanes = uInPlanes + (g_nQuant - 1)*uDataPlanes;
+	if(uOutPlanes > MAXPLANES)
+		return das_error(P_ERR, "Packet type %02d has %zu data planes, %d "
+			"quantiles of each would need %zu output planes but only %d are "
+			"supported", nPktId, uDataPlanes, g_nQuant, uOutPlanes, MAXPLANES
+		);
+
+	PktDesc* pPdOut = StreamDesc_clonePktDescById(g_pSdOut, pSdIn, nPktId);
+
+	g_lbHasBinNo[nPktId] = false;
+	g_uOrigPlanes[nPktId] = uInPlanes;
+
+	PlaneDesc* pPlIn  = NULL;
+	PlaneDesc* pPlOut = NULL;
+	PlaneDesc* pPlNew = NULL;
+	PlaneDesc* pQuant = NULL;
+	char sNewVar[128] = {'\0'};
+
+	for(size_t u = 0; u < g_uOrigPlanes[nPktId]; u++){
+
+		pPlOut = PktDesc_getPlane(pPdOut, u);
+		pPlIn  = PktDesc_getPlane(pPdIn,  u);
+
+		if(pPlOut->planeType == X){
+			pPlOut->units = UNIT_US2000;
+			continue;
+		}
+
+		if(shouldCollapse(pPlOut)){
+			pPlNew = new_PlaneDesc(
+				Y, PlaneDesc_getName(pPlOut),
+				DasEnc_copy( PlaneDesc_getValEncoder(pPlOut) ),
+				PlaneDesc_getUnits(pPlOut)
+			);
+			PlaneDesc_setFill(pPlNew, PlaneDesc_getFill(pPlOut));
+			DasDesc_copyIn((DasDesc*)pPlNew, (DasDesc*)pPlOut);
+
+			PktDesc_replaceAt(pPdOut, u, pPlNew);
+			del_PlaneDesc(pPlOut);
+			pPlOut = pPlNew;
+		}
+
+		/* The original plane holds the first quantile */
+		DasDesc_setStr((DasDesc*)pPlOut, "source", PlaneDesc_getName(pPlIn));
+		DasDesc_setStr((DasDesc*)pPlOut, "operation", "BIN_QUANTILE");
+		DasDesc_setDouble((DasDesc*)pPlOut, "quantile", g_aQuant[0]);
+
+		for(int q = 1; q < g_nQuant; ++q){
+			pQuant = PlaneDesc_copy(pPlOut);
+			snprintf(sNewVar, 127, "%s.p%g", PlaneDesc_getName(pPlIn), g_aQuant[q]*100);
+			PlaneDesc_setName(pQuant, sNewVar);
+			DasDesc_setDouble((DasDesc*)pQuant, "quantile", g_aQuant[q]);
+			size_t uIdx = PktDesc_addPlane(pPdOut, pQuant);
+			if(q == 1) g_uQuantIndex[nPktId][u] = uIdx;
+		}
+
+		del_DasBinAcc(g_lpBins[nPktId][u]);
+		g_lpBins[nPktId][u] = new_DasBinAcc(
+			1, PlaneDesc_getNItems(pPlOut), PlaneDesc_getFill(pPlOut), DAS_BINACC_QUANT
+		);
+		if(g_lpBins[nPktId][u] == NULL)
+			return P_ERR;
+		if((g_uSketchCap > 0) && (DasBinAcc_setSketchCap(g_lpBins[nPktId][u], g_uSketchCap) != 0))
+			return P_ERR;
+	}
+
+	return DasIO_writePktDesc(g_pIoOut, pPdOut);
+}
+
+/*****************************************************************************/
+/* Packet Data Processing */
+
+DasErrCode onPktData(PktDesc* pPdIn, void* ud)
+{
+	int nRet = 0;
+	int nPktId = PktDesc_getId(pPdIn);
+
+	PlaneDesc* pX = PktDesc_getXPlane(pPdIn);
+	double rCurTime = PlaneDesc_getValue(pX, 0);
+	rCurTime = Units_convertTo(UNIT_US2000, rCurTime, PlaneDesc_getUnits(pX));
+
+	if(! g_bHasStartTime){
+		g_rStartMicroSec = rCurTime;
+		g_bHasStartTime = true;
+	}
+
+	long nCurBin = (rCurTime - g_rStartMicroSec)/g_rBinSzMicroSec;
+	if(g_lbHasBinNo[nPktId]){
+		if(nCurBin != g_lnBin[nPktId])
+			if( (nRet = sendData(nPktId)) != 0) return nRet;
+	}
+
+	g_lnBin[nPktId] = nCurBin;
+	g_lbHasBinNo[nPktId] = true;
+
+	PktDesc* pPdOut = StreamDesc_getPktDesc(g_pSdOut, nPktId);
+	PlaneDesc* pInPlane = NULL;
+	int nXPlanes = 0;
+	for(size_t u = 0; u < PktDesc_getNPlanes(pPdIn); u++){
+		if(PktDesc_getPlane(pPdOut, u)->planeType == X){
+			nXPlanes += 1;
+			if(nXPlanes > 1)
+				return das_error(P_ERR, "das2_bin_quantile reducer can't handle "
+						            "packets with more than one X plane.");
+			continue;
+		}
+
+		/* Collapsed planes have one item, the accumulator folds all values
+		   into it */
+		pInPlane = PktDesc_getPlane(pPdIn, u);
+		nRet = DasBinAcc_add(
+			g_lpBins[nPktId][u], 0, PlaneDesc_getValues(pInPlane),
+			PlaneDesc_getNItems(pInPlane)
+		);
+		if(nRet != DAS_OKAY) return nRet;
+	}
+	return nRet;
+}
+
+/* ************************************************************************* */
+/* Stream Close Handling */
+
+DasErrCode onClose(StreamDesc* pSdIn, void* ud){
+
+	DasErrCode nRet = 0;
+	for(int nPktId = 1; nPktId < 100; nPktId++){
+		if(StreamDesc_isValidId(g_pSdOut, nPktId)){
+			if( (nRet = sendData(nPktId) ) != 0) return nRet;
+		}
+	}
+	return 0;
+}
+
+/*****************************************************************************/
+void prnHelp()
+{
+	fprintf(stderr,
+"SYNOPSIS\n"
+"   das2_bin_quantile - Reduces the size of Das2 streams to medians or other\n"
+"   quantiles over time.\n"
+"\n"
+"USAGE\n"
+"   das2_bin_quantile [-p] [-q LIST] [-k SIZE] [-b BEGIN] BIN_SECONDS\n"
+"\n"
+"DESCRIPTION\n"
+"   das2_bin_quantile is a classic Unix filter, reading das2 streams on\n"
+"   standard input and producing a time-reduced das2 stream on standard\n"
+"   output.  It is used the same way as das2_bin_avgsec, but instead of the\n"
+"   average of the <y> and <yscan> values in each time bin, it outputs the\n"
+"   median, or any other requested quantiles.  Only values with the same\n"
+"   packet ID and plane name are combined, and within <yscan> planes only\n"
+"   Z-values with the same Y coordinate are combined.  Median filtered\n"
+"   spectrograms are much less sensitive to interference spikes than\n"
+"   averaged ones.\n"
+"\n"
+"   Quantiles are estimated with fixed size streaming sketches, so memory\n"
+"   use does not depend on the number of values in a bin.  Bins with fewer\n"
+"   values than the sketch size, 256 by default, get exact results.  Larger\n"
+"   bins typically have rank errors well under 1%%.\n"
+"\n"
+"   It is assumed that <x> plane values are time points, see das2_bin_avgsec\n"
+"   for allowed time units.  As with das2_bin_avgsec, waveform <yscan> planes\n"
+"   that span less than BIN_SECONDS are collapsed to a single <y> plane.\n"
+"\n"
+"OPTIONS\n"
+"   -h        Generate this message.\n"
+"\n"
+"   -b BEGIN  Instead of starting the 0th bin at the first time value \n"
+"             received, specify a starting bin.  This useful when creating\n"
+"             pre-generated caches of binned data as it keeps the bin \n"
+"             boundaries predictable.\n"
+"\n"
+"   -q LIST   A comma separated list of quantiles from 0 to 1 to output.\n"
+"             The first replaces the values of each input plane, the others\n"
+"             are output in new planes named PLANE.pN where N is the\n"
+"             percentile.  Defaults to 0.5, the median.  For example:\n"
+"\n"
+"                -q 0.5,0.1,0.9\n"
+"\n"
+"             outputs the median, 10th and 90th percentiles.  Up to %d\n"
+"             quantiles may be given, but output packets are limited to\n"
+"             %d planes, so packets with many data planes allow fewer.\n"
+"\n"
+"   -k SIZE   Values held per sketch level.  Larger sketches are more\n"
+"             accurate but use more memory.  Defaults to 256.\n"
+"\n"
+"   -p        Drop stream progress messages.  This is useful when caching\n"
+"             reduced resolution streams.\n"
+"\n"
+"DAS2 PROPERTIES\n"
+"   das2_bin_quantile sets the following <stream> properties on output:\n"
+"\n"
+"      xCacheResolution - Set to a Datum that represents the binning period\n"
+"\n"
+"      xCacheResInfo - Set to human readable string representing the binning\n"
+"         period.\n"
+"\n"
+"   Each output data plane gets the properties:\n"
+"\n"
+"      operation - Set to BIN_QUANTILE\n"
+"\n"
+"      quantile - The quantile, from 0 to 1, of the values in the plane.\n"
+"\n"
+"AUTHORS\n"
+"   chris-piker@uiowa.edu\n"
+"\n"
+"SEE ALSO\n"
+"   das2_bin_avgsec, das2_bin_peakavgsec, das2_histo, das2_ascii\n"
+"\n"
+"   The das 2 ICD @ http://das2.org for an introduction to the das 2 system.\n"
+"\n", MAX_QUANT, MAXPLANES);
+}
+
+/* ************************************************************************* */
+/* Parse the quantile list */
+
+bool getQuantiles(const char* sList)
+{
+	const char* pRead = sList;
+	char* pEnd = NULL;
+	g_nQuant = 0;
+	while(*pRead != '\0'){
+		if(g_nQuant >= MAX_QUANT){
+			das_error(P_ERR, "Too many quantiles, limit is %d", MAX_QUANT);
+			return false;
+		}
+		double rQuant = strtod(pRead, &pEnd);
+		if((pEnd == pRead)||(rQuant < 0.0)||(rQuant > 1.0)||
+		   ((*pEnd != ',')&&(*pEnd != '\0'))){
+			das_error(P_ERR, "Invalid quantile list '%s'", sList);
+			return false;
+		}
+		g_aQuant[g_nQuant++] = rQuant;
+		pRead = (*pEnd == ',') ? pEnd + 1 : pEnd;
+	}
+	if(g_nQuant == 0){
+		das_error(P_ERR, "Empty quantile list");
+		return false;
+	}
+	return true;
+}
+
+/* ************************************************************************** */
+
+int main(int argc, char *argv[])
+{
+	int iBinSzArg = 1;
+	double rBinSize = 0.0;
+	int nRet = 0;
+
+	/* Exit on errors, log info messages and above */
+	das_init(argv[0], DASERR_DIS_EXIT, 0, DASLOG_INFO, NULL);
+
+	if(argc < 2){
+		fprintf(stderr, "Usage das2_bin_quantile BIN_SIZE_SECS\n\nIssue -h"
+              " to output the help page.\n");
+		return 4;
+	}
+
+	if(strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0){
+		prnHelp();
+		return 0;
+	}
+
+	das_time dt = {0};
+	for(int i = 1; i < argc; i++){
+		if(strcmp(argv[i], "-b") == 0){
+			if(i+1 == argc)
+				return das_error(P_ERR, "Begin bin position missing after -b");
+			iBinSzArg += 2;
+			if(! dt_parsetime(argv[i+1], &dt))
+				return das_error(P_ERR, "Couldn't convert %s to a date-time",
+						            argv[i+1]);
+			g_rStartMicroSec = Units_convertFromDt(UNIT_US2000, &dt);
+			g_bHasStartTime = true;
+			++i;
+			continue;
+		}
+		if(strcmp(argv[i], "-q") == 0){
+			if(i+1 == argc)
+				return das_error(P_ERR, "Quantile list missing after -q");
+			iBinSzArg += 2;
+			if(!getQuantiles(argv[++i])) return P_ERR;
+			continue;
+		}
+		if(strcmp(argv[i], "-k") == 0){
+			if(i+1 == argc)
+				return das_error(P_ERR, "Sketch size missing after -k");
+			iBinSzArg += 2;
+			if((sscanf(argv[++i], "%zu", &g_uSketchCap) != 1)||(g_uSketchCap < 2))
+				return das_error(P_ERR, "Invalid sketch size '%s'", argv[i]);
+			continue;
+		}
+		if(strcmp(argv[i], "-p") == 0){
+			g_bProgress = false;
+			iBinSzArg += 1;
+			continue;
+		}
+	}
+
+	if(argc != 1 + iBinSzArg){
+		fprintf(stderr, "Usage: das2_bin_quantile [-p] [-q LIST] [-k SIZE] "
+		        "[-b begin] BIN_SECONDS \nIssue the command %s -h for more "
+		        "info.\n\n", argv[0]);
+		return P_ERR;
+	}
+
+	sscanf(argv[iBinSzArg], "%lf", &rBinSize);
+	if(rBinSize <= 0.0){
+		fprintf(stderr, "Output bin size must be bigger than 0 seconds!");
+		return P_ERR;
+	}
+	g_rBinSzMicroSec = rBinSize * 1.0e6;
+
+	g_pIoOut = new_DasIO_cfile("das2_bin_quantile", stdout, "w");
+
+	StreamHandler* pSh = new_StreamHandler(NULL);
+	pSh->streamDescHandler = onStreamHdr;
+	pSh->pktDescHandler = onPktHdr;
+	pSh->pktDataHandler = onPktData;
+	pSh->closeHandler = onClose;
+	pSh->commentHandler = onComment;
+	pSh->exceptionHandler = onException;
+
+	DasIO* pIn = new_DasIO_cfile("Standard Input", stdin, "r");
+	DasIO_addProcessor(pIn, pSh);
+
+	nRet = DasIO_readAll(pIn);
+	del_DasIO(pIn);
+	free(pSh);
+	pIn = NULL;
+	return nRet;
+}
@@ -669,7 +669,7 @@ have_file_list:
 		}
 		
 		fprintf(stderr, "   Reading: %s\n", pFileList[u]);
-		if( (pIn = new_DasIO_file("das2_cache_rdr", pFileList[u], "r")) == NULL)
+		if( (pIn = new_DasIO_mmap("das2_cache_rdr", pFileList[u], "r")) == NULL)
 				continue;
 		
 		DasIO_addProcessor(pIn, pSh);	
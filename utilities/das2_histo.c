@@ -34,102 +34,53 @@
 
 int g_nFrac = RAW_COUNTS;
 
+/* Binning, exact values by default */
+int g_nMode = DAS_HISTO_EXACT;
+double g_rMin = 0.0;
+double g_rMax = 0.0;
+size_t g_uBins = 0;
+
+/* If non-zero, estimate cumulative fractions at this many quantiles */
+size_t g_uQuant = 0;
 
 /* ************************************************************************* */
 
-/* Storage arrays:
- * We need one output array per output packet type.  Note that there may be
+/* Storage:
+ * We need one set of counts per output packet type.  Note that there may be
  * more output packet types then input packet types since the peaks may need
- * to be separated from the averages.  One of these is attached to each input
- * plane descriptor via the user data pointer 
+ * to be separated from the averages.  One of these is attached to the X plane
+ * of each output packet via the user data pointer.  Either the histogram or
+ * the per-item sketches are used, not both.
  */
+typedef struct histo_acc {
+	DasHisto* pHisto;
+	DasQuantile** ppSketch;
+	size_t uItems;
+} histo_acc_t;
 
-/* Most sensors have 12-bit outputs or less.  In some cases these states can be
- * shifted by gain or range settings giving up to about 5-bits more states.
- * Unless averaging has happened you can have more output states than input
- * states, so arrays that start at 2**17 will usually not result in an
- * additional allocation. */ 
-#define LIN_ARY_MIN_SZ 0x20000 
-
-typedef struct linear_array {
-	double* data;    /* The data values */
-	ptrdiff_t used;     /* The number of locations used in the array */
-	ptrdiff_t size;     /* The total number of locations in the array */
-	double max_val;  /* The maximum value */
-} lin_ary_s;
-
-/* Get existing index, or insertion point for new data values into the array.
- * This algorithm is cleaner if we used recursion, but tail-call optimization
- * is often not done in debug code and I don't want to trigger a stack overflow.
- * 
- */
-ptrdiff_t find_val(const lin_ary_s* pLinAry, double dVal, bool* pExists)
-{
-	if(pLinAry->used == 0) return 0;
-	
-	double* aData = pLinAry->data;
-	
-	ptrdiff_t iHi = pLinAry->used -1;
-	ptrdiff_t iLo = 0;
-	ptrdiff_t iMid = -1;
-
-	while (iLo <= iHi) { 
-		iMid = iLo + (iHi - iLo)/2; 
-  
-		if(aData[iMid] == dVal){                   /* Found, return location */
-			*pExists = true;
-			return iMid;
-		}
-  
-		if (aData[iMid] < dVal) iLo = iMid + 1;  /* Val maybe in right half */
-		else iHi = iMid - 1;                    /* Val maybe in left half  */
-  } 
-  
-	/* value not present, return insert location */
-	*pExists = false;
-	iMid = (iHi + iLo) / 2;
-	if(aData[iMid] > dVal) return iMid;
-	else return iMid + 1;
-}
-
-/** Grow the array such that index i is a valid position but don't mark
- *  that position as used */
-void grow_for_idx(lin_ary_s* pAry, ptrdiff_t idx)
+histo_acc_t* new_histo_acc(size_t uItems)
 {
-	if(idx < pAry->size) return;
-	
-	size_t uNewSz = pAry->size;
-	if(uNewSz < LIN_ARY_MIN_SZ) uNewSz = LIN_ARY_MIN_SZ;
-	double* pTmp = (double*)calloc(uNewSz, sizeof(double));
-	memcpy(pTmp, pAry->data, pAry->size*sizeof(double));
-	free(pAry->data);
-	pAry->data = pTmp;
-	pAry->size = uNewSz;
+	histo_acc_t* pAcc = (histo_acc_t*)calloc(1, sizeof(histo_acc_t));
+	pAcc->uItems = uItems;
+	if(g_uQuant > 0){
+		pAcc->ppSketch = (DasQuantile**)calloc(uItems, sizeof(DasQuantile*));
+		for(size_t u = 0; u < uItems; ++u) pAcc->ppSketch[u] = new_DasQuantile(0);
+	}
+	else{
+		pAcc->pHisto = new_DasHisto(g_nMode, uItems, g_rMin, g_rMax, g_uBins);
+	}
+	return pAcc;
 }
 
-/** Shift down items, growing the array if needed */
-bool right_shift(lin_ary_s* pAry, ptrdiff_t idx, size_t space)
+void del_histo_acc(histo_acc_t* pAcc)
 {
-	if(idx < 0 || space <= 0){ 
-		das_error(DASERR_ASSERT, "logic error");
-		return false;
+	if(pAcc == NULL) return;
+	del_DasHisto(pAcc->pHisto);
+	if(pAcc->ppSketch){
+		for(size_t u = 0; u < pAcc->uItems; ++u) del_DasQuantile(pAcc->ppSketch[u]);
+		free(pAcc->ppSketch);
 	}
-	if(idx >= pAry->size) grow_for_idx(pAry, idx + space);
-	
-	/* Careful, this is a double pointer so incrementing it by one moves it
-	 * 8 bytes to the right */
-	void* pDest = pAry->data + idx + space;
-	void* pSrc = pAry->data + idx;
-	
-	/* The amount of data to move is the used - idx */
-	
-	/* but here we have to specify number of bytes, not number of doubles */
-	memmove(pDest, pSrc, (pAry->used - idx) * sizeof(double));
-	
-	/* Fill in the left over bytes with zeros since all the arrays start
-	 * with that value */
-	memset(pSrc, 0x0, space*sizeof(double));
-	return true;
+	free(pAcc);
 }
 
 /*****************************************************************************/
@@ -181,7 +132,6 @@ DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* vpOut)
 	
 	
 	/* Construct one output packet header for each input PLANE */
-	lin_ary_s* pVals = NULL;
 	PlaneDesc* pPlaneIn = NULL;
 	PlaneDesc* pXOut = NULL;
 	PlaneDesc* pPlOut = NULL;
@@ -201,13 +151,6 @@ DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* vpOut)
 		pEnc = new_DasEncoding(DAS2DT_HOST_REAL, 8, NULL);
 		pXOut = new_PlaneDesc(X, NULL, pEnc, PlaneDesc_getUnits(pPlaneIn));
 		
-		/* Have it hold the output data value (X-axis) for us */
-		pVals = (lin_ary_s*)calloc(1, sizeof(lin_ary_s));
-		pVals->size = LIN_ARY_MIN_SZ;
-		pVals->data = (double*)calloc(pVals->size, sizeof(double));
-		
-		pXOut->pUser = pVals;
-		
 		/* Now make a counts plane, needs to be the same shape as the input, but
 		 * units are now dimensionless counts.  Assume we can encode this as
 		 * floats unless we're outputting raw counts and the value in any bin
@@ -240,14 +183,11 @@ DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* vpOut)
 		snprintf(sName, 63, "%s_hist", PlaneDesc_getName(pPlaneIn));
 		PlaneDesc_setName(pPlOut, sName);
 		
-		size_t uItems = PlaneDesc_getNItems(pPlaneIn);
-		
-		/* Have it hold the output counts (data-axis) for us */
-		pVals = (lin_ary_s*)calloc(1, sizeof(lin_ary_s));
-		pVals->size = LIN_ARY_MIN_SZ * uItems;
-		pVals->data = (double*)calloc(pVals->size, sizeof(double));
-		
-		pPlOut->pUser = pVals;
+		/* Have the X plane hold the output values and counts for us */
+		pXOut->pUser = new_histo_acc(PlaneDesc_getNItems(pPlaneIn));
+		if(((histo_acc_t*)pXOut->pUser)->pHisto == NULL && g_uQuant == 0)
+			return das_error(P_ERR, "Couldn't create histogram for plane %s", 
+			                 PlaneDesc_getName(pPlaneIn));
 		
 		/* make a new packet to hold the output, save it with the input plane so
 		 * we can find it */
@@ -263,7 +203,7 @@ DasErrCode onPktHdr(StreamDesc* pSdIn, PktDesc* pPdIn, void* vpOut)
 }
 
 /* ************************************************************************* */
-/* Binary search and store */
+/* Count values */
 
 DasErrCode onPktData(PktDesc* pPdIn, void* vpOut)
 {
@@ -271,60 +211,42 @@ DasErrCode onPktData(PktDesc* pPdIn, void* vpOut)
 	PktDesc* pPktOut = NULL;
 	PlaneDesc* pXOut = NULL;
 	PlaneDesc* pPlOut = NULL;
-	lin_ary_s* pValAry = NULL;
-	lin_ary_s* pCountAry = NULL;
+	histo_acc_t* pAcc = NULL;
 	
 	size_t u, uItems, uPlanes = PktDesc_getNPlanes(pPdIn);
 	int j;
 	double rFill = DAS_FILL_VALUE;
 	double rVal = 0.0;
+	DasErrCode nRet = DAS_OKAY;
 	for(int i=0; i < uPlanes; ++i){
 		pPlaneIn = PktDesc_getPlane(pPdIn, i);
 		if(PlaneDesc_getType(pPlaneIn) == X) continue;
 		
 		pPktOut = (PktDesc*) pPlaneIn->pUser;
 		pXOut = PktDesc_getPlaneByType(pPktOut, X, 0);
-		pValAry = (lin_ary_s*)pXOut->pUser;
+		pAcc = (histo_acc_t*)pXOut->pUser;
 		
 		j = 0;
 		do{ 
 			pPlOut = PktDesc_getPlane(pPktOut, j++);
 		} while(PlaneDesc_getType(pPlOut) == X);
-		pCountAry = (lin_ary_s*) pPlOut->pUser;
 		
 		rFill = PlaneDesc_getFill(pPlOut);
 		
-		/* For each value in the input plane, see if we have it in the output */
+		/* Bins are found by hash lookup or direct calculation, so adding a
+		 * value costs the same no matter how many distinct values came before */
 		uItems = PlaneDesc_getNItems(pPlaneIn);
 		for(u = 0; u < uItems; ++u){
 			rVal = PlaneDesc_getValue(pPlaneIn, u);
 			if(rVal == rFill) continue;
 			
-			bool bHaveIt = false;
-			int iX = find_val(pValAry, rVal, &bHaveIt);
-		
-			/* Make sure my output arrays are big enough*/
-			if(iX >= pValAry->size) grow_for_idx(pValAry, iX);
-			int iDat = iX * uItems + u;
-			if(iDat >= pCountAry->size) grow_for_idx(pCountAry, iDat);
-			
-			/* Shift items to make room for new data value and counts.  We have to
-			 * shift  */
-			if(!bHaveIt){
-				if(iX < pValAry->used){
-					
-					right_shift(pValAry, iX, 1);
-					right_shift(pCountAry, iX*uItems, uItems);
-				}
-				pValAry->used += 1;
-				pCountAry->used += uItems;
+			if(pAcc->ppSketch){
+				DasQuantile_add(pAcc->ppSketch[u], rVal);
+			}
+			else{
+				if((nRet = DasHisto_add(pAcc->pHisto, u, rVal)) != DAS_OKAY)
+					return nRet;
 			}
-			
-			pValAry->data[iX] = rVal;
-			pCountAry->data[iDat] += 1;
-			
-			if(pCountAry->data[iDat] > pCountAry->max_val) 
-				pCountAry->max_val = pCountAry->data[iDat];
 		}
 	}
 	return DAS_OKAY;
@@ -348,22 +270,88 @@ DasErrCode onComment(OobComment* pCmt, void* vpOut)
 /* ************************************************************************* */
 /* Writing out packet data */
 
+static int cmpDbl(const void* vp1, const void* vp2)
+{
+	double r1 = *((const double*)vp1);
+	double r2 = *((const double*)vp2);
+	return (r1 < r2) ? -1 : ((r1 > r2) ? 1 : 0);
+}
+
+/* Estimated cumulative fractions from the sketches.  The output values are
+ * the union of each item's quantiles, so every item is well sampled. */
+DasErrCode writeSketches(
+	DasIO* pOut, PktDesc* pPktOut, PlaneDesc* pXOut, PlaneDesc* pPlOut, 
+	histo_acc_t* pAcc
+){
+	DasErrCode nRet = DAS_OKAY;
+	if( (nRet = DasIO_writePktDesc(pOut, pPktOut)) != DAS_OKAY) return nRet;
+
+	size_t uItems = pAcc->uItems;
+	double* pVals = (double*)malloc((g_uQuant + 1)*uItems*sizeof(double));
+	double* pFracs = (double*)malloc(uItems*sizeof(double));
+	size_t i, j, uVals = 0;
+	double rVal;
+	
+	for(j = 0; j < uItems; ++j){
+		if(DasQuantile_count(pAcc->ppSketch[j]) == 0) continue;
+		for(i = 0; i <= g_uQuant; ++i)
+			pVals[uVals++] = DasQuantile_value(pAcc->ppSketch[j], ((double)i)/g_uQuant);
+	}
+	qsort(pVals, uVals, sizeof(double), cmpDbl);
+	
+	for(i = 0; i < uVals; ++i){
+		if((i > 0)&&(pVals[i] == pVals[i-1])) continue;
+		rVal = pVals[i];
+		
+		for(j = 0; j < uItems; ++j){
+			if(DasQuantile_count(pAcc->ppSketch[j]) == 0)
+				pFracs[j] = 0.0;
+			else if(g_nFrac == FRAC_BELOW)
+				pFracs[j] = DasQuantile_rank(pAcc->ppSketch[j], rVal, true);
+			else
+				pFracs[j] = 1.0 - DasQuantile_rank(pAcc->ppSketch[j], rVal, false);
+		}
+		PlaneDesc_setValue(pXOut, 0, rVal);
+		PlaneDesc_setValues(pPlOut, pFracs);
+		if( (nRet = DasIO_writePktData(pOut, pPktOut)) != DAS_OKAY) break;
+	}
+	free(pVals);
+	free(pFracs);
+	return nRet;
+}
+
 DasErrCode writeHisto(DasIO* pOut, PktDesc* pPktOut)
 {	
 	DasErrCode nRet = DAS_OKAY;
 	PlaneDesc* pXOut = PktDesc_getXPlane(pPktOut);
-	lin_ary_s* pValAry = (lin_ary_s*) pXOut->pUser;
+	histo_acc_t* pAcc = (histo_acc_t*) pXOut->pUser;
 	PlaneDesc* pPlOut = NULL;
 	
 	int iPlane = 0;
 	do{ 
 		pPlOut = PktDesc_getPlane(pPktOut, iPlane++);
 	} while(PlaneDesc_getType(pPlOut) == X);
-	lin_ary_s* pCountAry = (lin_ary_s*) pPlOut->pUser;
+	
+	if(pAcc->ppSketch){
+		nRet = writeSketches(pOut, pPktOut, pXOut, pPlOut, pAcc);
+		del_histo_acc(pAcc);
+		pXOut->pUser = NULL;
+		return nRet;
+	}
+	
+	DasHisto* pHisto = pAcc->pHisto;
+	ptrdiff_t nUsed = DasHisto_finish(pHisto);
+	if(pHisto->uDropped > 0)
+		daslog_info_v("%zu values of %s were outside the histogram edges",
+		              pHisto->uDropped, PlaneDesc_getName(pPlOut));
+	
+	/* Bins are stored row major, one row of counts per value */
+	double* pVals = pHisto->pVals;
+	double* pCounts = pHisto->pCounts;
 	
 	/* Check to see if we need to change the output encoding for the data 
 	 * values.  Floats can only handle integers at most 16,777,217 (2^24) + 1 */
-	if((pCountAry->max_val >= 16777217) && (g_nFrac == RAW_COUNTS) ){
+	if((pHisto->rMaxCount >= 16777217) && (g_nFrac == RAW_COUNTS) ){
 		DasEncoding* pEnc = new_DasEncoding(DAS2DT_HOST_REAL, 8, NULL);
 		PlaneDesc_setValEncoder(pPlOut, pEnc);
 	}
@@ -373,47 +361,50 @@ DasErrCode writeHisto(DasIO* pOut, PktDesc* pPktOut)
 	ptrdiff_t iTotal = 0, i = 0, j = 0;
 	
 	/* Converting to cumulative fraction */
-	if((g_nFrac == FRAC_BELOW)&&(pValAry->used > 0)){
-		for(i = 1; i < pValAry->used; ++i){
+	if((g_nFrac == FRAC_BELOW)&&(nUsed > 0)){
+		for(i = 1; i < nUsed; ++i){
 			for(j = 0; j < nItems; ++j){
-				pCountAry->data[i*nItems + j] += pCountAry->data[(i-1)*nItems + j];
+				pCounts[i*nItems + j] += pCounts[(i-1)*nItems + j];
 			}
 		}
 	
-		iTotal = nItems * (pValAry->used - 1);
-		for(i = 0; i < pValAry->used; ++i){
+		iTotal = nItems * (nUsed - 1);
+		for(i = 0; i < nUsed; ++i){
 			for(j = 0; j < nItems; ++j) {
 				
-				if(pCountAry->data[iTotal + j] > 0.0)
-					pCountAry->data[i*nItems + j] /= pCountAry->data[iTotal + j];
+				if(pCounts[iTotal + j] > 0.0)
+					pCounts[i*nItems + j] /= pCounts[iTotal + j];
 			}
 		}
 	}
 	
 	/* Converting to reverse cumulative fraction */
-	if((g_nFrac == FRAC_ABOVE)&&(pValAry->used > 0)){
-		for(i = pValAry->used - 2; i >= 0; --i){
+	if((g_nFrac == FRAC_ABOVE)&&(nUsed > 0)){
+		for(i = nUsed - 2; i >= 0; --i){
 			for(j = 0; j < nItems; ++j){
-				pCountAry->data[i*nItems + j] += pCountAry->data[(i+1)*nItems + j];
+				pCounts[i*nItems + j] += pCounts[(i+1)*nItems + j];
 			}
 		}
 	
 		/* Hit 0th block last since it's the divisor */
-		for(i = pValAry->used - 1; i >= 0; --i){
+		for(i = nUsed - 1; i >= 0; --i){
 			for(j = 0; j < nItems; ++j) {
 				/* careful, wierd datasets could have all fill values, which
 				   would be indicated by 0th block being empty */
-				if(pCountAry->data[0 + j] > 0.0)
-					pCountAry->data[i*nItems + j] /= pCountAry->data[0 + j];
+				if(pCounts[0 + j] > 0.0)
+					pCounts[i*nItems + j] /= pCounts[0 + j];
 			}
 		}		
 	}
 	
-	for(i = 0; i < pValAry->used; ++i){
-		PlaneDesc_setValue(pXOut, 0, pValAry->data[i]);
-		PlaneDesc_setValues(pPlOut, pCountAry->data + i*nItems);
+	for(i = 0; i < nUsed; ++i){
+		PlaneDesc_setValue(pXOut, 0, pVals[i]);
+		PlaneDesc_setValues(pPlOut, pCounts + i*nItems);
 		if( (nRet = DasIO_writePktData(pOut, pPktOut)) != DAS_OKAY) return nRet;
 	}
+	
+	del_histo_acc(pAcc);
+	pXOut->pUser = NULL;
 	return DAS_OKAY;
 }
 
@@ -455,13 +446,13 @@ DasErrCode emitAndFreePkts(StreamDesc* pSdIn, DasDesc* pDescIn, void* vpOut)
 
 DasErrCode onClose(StreamDesc* pSdIn, void* vpOut)
 {
-	PktDesc* pPktIn = NULL;
+	DasDesc* pDesc = NULL;
 	DasErrCode nRet = DAS_OKAY;
-	for(int i = 1; i < MAX_PKTIDS; ++i){
-		pPktIn = StreamDesc_getPktDesc(pSdIn, i);
-		if(pPktIn == NULL) continue;
+	int nPktId = 0;
+	while((pDesc = DasStream_nextDesc(pSdIn, &nPktId)) != NULL){
+		if(pDesc->type != PACKET) continue;
 		
-		if( (nRet = emitAndFreePkts(pSdIn, (DasDesc*)pPktIn, vpOut)) != DAS_OKAY) return nRet;
+		if( (nRet = emitAndFreePkts(pSdIn, pDesc, vpOut)) != DAS_OKAY) return nRet;
 	}
 	return DAS_OKAY;
 }
@@ -500,6 +491,24 @@ void prnHelp(FILE* pFile)
 "         value.  By default the total count of points at a given data value\n"
 "         are output.\n"
 "\n"
+"   -l MIN,MAX,N, --linear=MIN,MAX,N\n"
+"         Count values in N equal width bins from MIN to MAX instead of\n"
+"         counting each distinct value.  Output values are bin centers.\n"
+"         Values outside the edges are dropped.  Use this for data that\n"
+"         has been averaged or otherwise has few repeated values.\n"
+"\n"
+"   -g MIN,MAX,N, --log=MIN,MAX,N\n"
+"         Same as --linear but the bins are of equal width in log10 space,\n"
+"         and output values are geometric bin centers.  MIN must be\n"
+"         greater than zero.\n"
+"\n"
+"   -q N, --quantiles=N\n"
+"         Only valid with -b or -a.  Estimate the cumulative fractions with\n"
+"         fixed size streaming sketches instead of keeping a count for every\n"
+"         value.  Output values are the N-quantiles of each item, so memory\n"
+"         use stays small for any input.  Fractions are typically within 1%%\n"
+"         of the exact result.\n"
+"\n"
 "   -h,--help\n"
 "         Print this help text\n"
 "\n"
@@ -519,6 +528,31 @@ void prnHelp(FILE* pFile)
 /* ************************************************************************* */
 /* Main */
 
+/* Parse MIN,MAX,N from either the next argument or after the '=' */
+bool getEdges(int argc, char** argv, int* pArg, int nMode)
+{
+	const char* sArg = NULL;
+	if(argv[*pArg][1] != '-'){
+		if(*pArg >= argc - 1){
+			das_error(P_ERR, "Missing bin edges after %s", argv[*pArg]);
+			return false;
+		}
+		*pArg += 1;
+		sArg = argv[*pArg];
+	}
+	else{
+		sArg = strchr(argv[*pArg], '=') + 1;
+	}
+	
+	if((sscanf(sArg, "%lf,%lf,%zu", &g_rMin, &g_rMax, &g_uBins) != 3)||
+	   (g_uBins < 1)||(g_rMax <= g_rMin)||((nMode == DAS_HISTO_LOG)&&(g_rMin <= 0.0))){
+		das_error(P_ERR, "Invalid bin edges '%s', use -h for help.", sArg);
+		return false;
+	}
+	g_nMode = nMode;
+	return true;
+}
+
 int main(int argc, char* argv[]) 
 {
 	int nRet = 0;
@@ -548,11 +582,33 @@ int main(int argc, char* argv[])
 			continue;
 		}
 		
+		if(strcmp(argv[i], "-l") == 0 || strncmp(argv[i], "--linear=", 9) == 0){
+			if(!getEdges(argc, argv, &i, DAS_HISTO_LINEAR)) return P_ERR;
+			continue;
+		}
+		
+		if(strcmp(argv[i], "-g") == 0 || strncmp(argv[i], "--log=", 6) == 0){
+			if(!getEdges(argc, argv, &i, DAS_HISTO_LOG)) return P_ERR;
+			continue;
+		}
+		
+		if(strcmp(argv[i], "-q") == 0 || strncmp(argv[i], "--quantiles=", 12) == 0){
+			const char* sArg = (argv[i][1] == 'q') ? argv[i+1] : argv[i] + 12;
+			if(argv[i][1] == 'q') ++i;
+			if((sArg == NULL)||(sscanf(sArg, "%zu", &g_uQuant) != 1)||(g_uQuant < 1))
+				return das_error(P_ERR, "Invalid quantile count, use -h for help.");
+			continue;
+		}
+		
 		return das_error(P_ERR, "Unrecognized command line option, '%s'.  Use -h "
 				           "for help.", argv[i]);
 		
 	}
 	
+	if((g_uQuant > 0)&&(g_nFrac == RAW_COUNTS))
+		return das_error(P_ERR, "-q only applies to cumulative fractions, use "
+		                 "-b or -a as well.");
+	
 	/* Create an un-compressed output I/O object */
 	DasIO* pOut = new_DasIO_cfile("das2_histo", stdout, "w");
 	
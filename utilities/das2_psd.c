@@ -66,6 +66,9 @@ See the help text in prnHelp() for mor info. -cwp
 
 #define P_ERR 105
 
+/* Input packets read ahead of the handlers when multi-threaded */
+#define PSD_READ_AHEAD 8
+
 #ifndef DasIO_throw
 #define DasIO_srverr(pIo, pSd, sMsg) \
   DasIO_throwException(pIo, pSd, DAS_EX_SERVER_ERR, sMsg); exit(P_ERR);
@@ -75,8 +78,9 @@ See the help text in prnHelp() for mor info. -cwp
 /* Globals */
 
 StreamDesc* g_pSdOut = NULL;
-DftPlan* g_pDftPlan = NULL;        /* The PSD plan */
-Das2Psd* g_pPsdCalc = NULL;        /* The PSD calculator */
+DasPsdBatch* g_pPsdBatch = NULL;   /* PSDs for x transforms, one per yscan */
+DasPsdPool* g_pPool = NULL;        /* Threads for calculating PSD batches */
+int g_nThreads = 1;
 
 #define TRANSFORM_UNK   0x00
 #define TRANSFORM_IN_X  0x01
@@ -138,6 +142,7 @@ typedef struct aux_info {
 	double rYOutScale;
 	double rZOutScale;
 	Accum* pAccum;
+	DasPsdBatch* pBatch;  /* Per-packet PSDs for y transforms */
 }AuxInfo;
 
 AuxInfo* new_AuxInfo(int nDftLen)
@@ -151,6 +156,7 @@ AuxInfo* new_AuxInfo(int nDftLen)
 	pThis->rYOutScale = 1.0;
 	pThis->rZOutScale = 1.0;
 	pThis->pAccum = NULL;
+	pThis->pBatch = NULL;
 	return pThis;
 }
 
@@ -158,6 +164,7 @@ void del_AuxInfo(void* vpThis)
 {
 	AuxInfo* pThis = (AuxInfo*)vpThis;
 	del_Accum(pThis->pAccum);
+	del_DasPsdBatch(pThis->pBatch);
 	free(vpThis);
 }
 
@@ -950,9 +957,9 @@ DasErrCode onXTransformPktData(PktDesc* pPdIn, PktDesc* pPdOut, DasIO* pIoOut)
 		return DAS_OKAY;  
 
 	/* Step 3: Make power spectral density */
-	if(g_pPsdCalc == NULL){
-		g_pDftPlan = new_DftPlan(g_uDftLen, true);
-		g_pPsdCalc = new_Psd(g_pDftPlan, g_bShiftDC, "hann");
+	if(g_pPsdBatch == NULL){
+		if((g_pPsdBatch = new_DasPsdBatch(g_uDftLen, g_bShiftDC, "hann")) == NULL)
+			return P_ERR;
 	}
 
 	/* If this packet's header has not been transmitted, finalize and transmit
@@ -969,11 +976,34 @@ DasErrCode onXTransformPktData(PktDesc* pPdIn, PktDesc* pPdOut, DasIO* pIoOut)
 	}
 	
 	int i, j;
-	bool bFill = false;
 	const double* pPSD = NULL;
 	size_t uPsdLen = 0;
 	double tau;
 	size_t uShift = g_uDftLen / g_uSlideDenom;
+
+	/* Transform all yscans that have no fill in a single batch.  If any
+	   input value is fill, the whole spectrum is fill */
+	const double* aSegs[MAXPLANES];
+	int aSegIdx[MAXPLANES];
+	int nSegs = 0;
+	for(iPlane = 0; iPlane < nPlanes; ++iPlane){
+		aSegIdx[iPlane] = -1;
+		pPlaneOut = PktDesc_getPlane(pPdOut, iPlane);
+		if(PlaneDesc_getType(pPlaneOut) != YScan) continue;
+		
+		pAux = (AuxInfo*)pPlaneOut->pUser;
+		if((pAux->iMinDftOut == -1)||(pAux->iMaxDftOut == -1)) continue;
+		
+		pAccum = pAux->pAccum;
+		for(i = 0; i < pAccum->iNext; ++i)
+			if PlaneDesc_isFill(pPlaneOut, pAccum->pData[i]) break;
+		if(i < pAccum->iNext) continue;
+		
+		aSegIdx[iPlane] = nSegs;
+		aSegs[nSegs++] = pAccum->pData;
+	}
+	if((nSegs > 0)&&(DasPsdPool_calc(g_pPool, g_pPsdBatch, aSegs, nSegs) < 0))
+		return P_ERR;
 	
 	for(iPlane = 0; iPlane < nPlanes; ++iPlane){
 		pPlaneIn  = PktDesc_getPlane(pPdIn,  iPlane);
@@ -1001,20 +1031,12 @@ DasErrCode onXTransformPktData(PktDesc* pPdIn, PktDesc* pPdOut, DasIO* pIoOut)
 				break;
 			}
 			
-			for(i = 0; i < pAccum->iNext; ++i){               /* Fill check */
-				if PlaneDesc_isFill(pPlaneOut, pAccum->pData[i]){  
-					bFill = true; break;
-				}
-	 		}
-			
-			if(bFill){
-				/* If any input value is fill, the whole spectrum is fill */
+			if(aSegIdx[iPlane] < 0){
 				for(j = 0, i = pAux->iMinDftOut; i < pAux->iMaxDftOut; ++i, ++j)
 					PlaneDesc_setValue(pPlaneOut, j, pPlaneOut->rFill);
 			}
 			else{
-				Psd_calculate(g_pPsdCalc, pAccum->pData, NULL);
-				pPSD = Psd_get(g_pPsdCalc, &uPsdLen);
+				pPSD = DasPsdBatch_get(g_pPsdBatch, aSegIdx[iPlane], &uPsdLen);
 				
 				for(j = 0, i = pAux->iMinDftOut; i < pAux->iMaxDftOut; ++i, ++j)
 					PlaneDesc_setValue(pPlaneOut, j, rZscale*pPSD[i]);
@@ -1122,11 +1144,32 @@ DasErrCode onYTransformPktData(PktDesc* pPdIn, PktDesc* pPdOut, DasIO* pIoOut)
 	AuxInfo* pAux = NULL;
 	bool bSkip = false;
 	double rFill = NAN;
+	size_t uShift = g_uDftLen/g_uSlideDenom;
+
+	/* Transform every full length segment of each yscan in one batch per
+	   plane, segments with fill are skipped below */
+	for(uPlane = 0; uPlane < PktDesc_getNPlanes(pPdIn); ++uPlane){
+		pPlaneIn = PktDesc_getPlane(pPdIn, uPlane);
+		if(PlaneDesc_getType(pPlaneIn) != YScan) continue;
+		if( (pPlaneOut = (PlaneDesc*)(pPlaneIn->pUser)) == NULL) continue;
+		if(PlaneDesc_getType(pPlaneOut) != YScan) continue;
+
+		pAux = (AuxInfo*)pPlaneOut->pUser;
+		if(pAux->pBatch == NULL){
+			pAux->pBatch = new_DasPsdBatch(g_uDftLen, g_bShiftDC, "hann");
+			if(pAux->pBatch == NULL) return P_ERR;
+		}
+		pInData = PlaneDesc_getValues(pPlaneIn);
+		if(DasPsdPool_slide(
+			g_pPool, pAux->pBatch, pInData, PlaneDesc_getNItems(pPlaneIn), uShift
+		) < 0)
+			return P_ERR;
+	}
 
 	while(uReadPt < uMaxItems){
 
 		if( ! _anyYscanInputInRng(pPdIn, uReadPt, g_uDftLen)){
-			uReadPt += g_uDftLen/g_uSlideDenom;
+			uReadPt += uShift;
 			continue;  /* No useful output in range */
 		}
 
@@ -1162,14 +1205,7 @@ DasErrCode onYTransformPktData(PktDesc* pPdIn, PktDesc* pPdOut, DasIO* pIoOut)
 						PlaneDesc_setValue(pPlaneOut, u, rVal);
 				}
 				else{
-					if(g_pPsdCalc == NULL){
-						g_pDftPlan = new_DftPlan(g_uDftLen, true);
-						g_pPsdCalc = new_Psd(g_pDftPlan, g_bShiftDC, "hann");
-					 }
-
-					pInData = PlaneDesc_getValues(pPlaneIn);
-					Psd_calculate(g_pPsdCalc, pInData+uReadPt, NULL);
-					pOutData = Psd_get(g_pPsdCalc, &uPsdLen);
+					pOutData = DasPsdBatch_get(pAux->pBatch, uReadPt/uShift, &uPsdLen);
 
 					uItems = PlaneDesc_getNItems(pPlaneOut);
 					if((pAux->iMaxDftOut - pAux->iMinDftOut) != uItems){
@@ -1220,7 +1256,7 @@ DasErrCode onYTransformPktData(PktDesc* pPdIn, PktDesc* pPdOut, DasIO* pIoOut)
 			if((nRet=DasIO_writePktData(pIoOut, pPdOut)) != DAS_OKAY) return nRet;
 		}
 		g_nPktsOut += 1;
-		uReadPt += g_uDftLen/g_uSlideDenom;
+		uReadPt += uShift;
 	}
 	return DAS_OKAY;
 }
@@ -1373,6 +1409,12 @@ void prnHelp()
 "                 Note: A space is required between unit value and the unit\n"
 "                 string, so this argument will need quotes.\n"
 "\n"
+"   -t N,--threads=N\n"
+"                 Spread PSD calculations over N threads, or one thread per\n"
+"                 CPU if N is 0.  Only <yscan> packets that hold many DFT\n"
+"                 lengths worth of points benefit.  If N is not 1 input is\n"
+"                 also read ahead on a separate thread.  Defaults to 1.\n"
+"\n"
 "   -n,--no-skip  Do not skip over input packet *types* that cannot be\n"
 "                 transformed, instead exit the program with an error message.\n"
 "                 Individual data packets that cannot be transformed are always\n"
@@ -1520,6 +1562,27 @@ bool parseArgs(
 				continue;		
 			}
 
+			if((strcmp(argv[i], "-t") == 0)||(strncmp(argv[i], "--threads=", 10) == 0)){
+				if(strcmp(argv[i], "-t") == 0){
+					if(i >= (argc - 1)){
+						das_send_queryerr(2, "Missing argument for -t");
+						return false;
+					}
+					++i;
+					sArg = argv[i];
+				}
+				else{
+					sArg = argv[i] + 10;
+				}
+				if((sscanf(sArg, "%zu", &uTmp) != 1)||(uTmp > 1024)){
+					das_send_queryerr(2,"Couldn't convert '%s' to a thread count "
+					                  "from 0 to 1024", sArg);
+					return false;
+				}
+				g_nThreads = (int)uTmp;
+				continue;
+			}
+
 			if((strcmp(argv[i], "-n") == 0)||(strcmp(argv[i], "--no-skip") == 0)){
 				g_bSkip = false;
 				continue;
@@ -1586,8 +1649,8 @@ int main(int argc, char** argv) {
 	if(!parseArgs(argc, argv, &g_uDftLen, &g_uSlideDenom, &g_cadence, &g_jitter))
 		return 13;
 
-	/* We know our output size, generate an FFT plan */
-
+	/* Start the PSD threads, if any.  Plans are made on first use */
+	g_pPool = new_DasPsdPool(g_nThreads);
 
 	/* Make output writer and a stream handler structure */
 	DasIO* pIoOut = new_DasIO_cfile("das2_psd", stdout, "w");
@@ -1606,6 +1669,10 @@ int main(int argc, char** argv) {
 	DasIO* pIn = new_DasIO_cfile("Standard Input", stdin, "r");
 	DasIO_addProcessor(pIn, pSh);
 
+	/* Overlap reading with the transforms when running multi-threaded */
+	if(g_nThreads != 1)
+		DasIO_pipeline(pIn, PSD_READ_AHEAD);
+
 	int nRet = DasIO_readAll(pIn);
 
 	/* Uncomment to make valgrind happy */
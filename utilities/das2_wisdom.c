@@ -0,0 +1,154 @@
+/* Copyright (C) 2025  Chris Piker <chris-piker@uiowa.edu>
+ *
+ * This file is part of das2C, the Core Das2 C Library.
+ *
+ * das2C is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * das2C is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 2.1 along with das2C; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* das2_wisdom: Measure FFTW plans for DFT lengths and save them for later */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <das2/core.h>
+
+/* ************************************************************************* */
+void prnHelp()
+{
+	fprintf(stderr,
+"SYNOPSIS\n"
+"   das2_wisdom - Measure and save fast DFT plans for particular lengths\n"
+"\n"
+"USAGE\n"
+"   das2_wisdom [options] LENGTH [LENGTH ...]\n"
+"\n"
+"DESCRIPTION\n"
+"   Programs such as das2_psd use the FFTW library to calculate Fourier\n"
+"   transforms.  FFTW picks among many ways of computing a transform of a\n"
+"   given length by timing them, and records the winners as \"wisdom\".\n"
+"   For lengths with large prime factors, which are common for instrument\n"
+"   waveforms, a thorough search can find plans that are much faster than\n"
+"   the ones found during normal program startup.\n"
+"\n"
+"   das2_wisdom plans every transform that libdas2 uses for each LENGTH and\n"
+"   saves the results.  By default they are added to the per-account wisdom\n"
+"   file which all das2 programs load at startup:\n"
+"\n"
+"      $HOME/.daswisdom\n"
+"\n"
+"   Set the environment variable DAS_FFTW_WISDOM to use a different file.\n"
+"   Wisdom already in the file, or in the system wisdom file, is kept.\n"
+"\n"
+"OPTIONS\n"
+"   -h,--help     Display this text and exit.\n"
+"\n"
+"   -p,--patient  Use the FFTW patient planner.  This can take minutes per\n"
+"                 length but usually finds faster plans.\n"
+"\n"
+"   -x,--exhaustive\n"
+"                 Use the FFTW exhaustive planner.  Very slow.\n"
+"\n"
+"   -o FILE,--output=FILE\n"
+"                 Write wisdom to FILE instead of the per-account file.  To\n"
+"                 update the system wide wisdom for all accounts use the\n"
+"                 system file, typically /etc/fftw/wisdom.\n"
+"\n"
+"EXAMPLE\n"
+"   Learn patient plans for the Cassini RPWS waveform lengths:\n"
+"\n"
+"      das2_wisdom -p 512 2048 10240\n"
+"\n"
+"AUTHOR\n"
+"   chris-piker@uiowa.edu\n"
+"\n"
+"SEE ALSO\n"
+"   * das2_psd\n"
+"\n"
+"   * fftw-wisdom(1)\n"
+"\n");
+}
+
+/* ************************************************************************* */
+int main(int argc, char** argv)
+{
+	das_init(argv[0], DASERR_DIS_RET, 0, DASLOG_INFO, NULL);
+
+	int nEffort = DAS_DFT_MEASURE;
+	const char* sOut = NULL;
+	size_t aLens[256] = {0};
+	size_t uLens = 0;
+	size_t uTmp = 0;
+
+	for(int i = 1; i < argc; ++i){
+		if(argv[i][0] == '-'){
+			if((strcmp(argv[i], "-h") == 0)||(strcmp(argv[i], "--help") == 0)){
+				prnHelp();
+				return 0;
+			}
+			if((strcmp(argv[i], "-p") == 0)||(strcmp(argv[i], "--patient") == 0)){
+				nEffort = DAS_DFT_PATIENT;
+				continue;
+			}
+			if((strcmp(argv[i], "-x") == 0)||(strcmp(argv[i], "--exhaustive") == 0)){
+				nEffort = DAS_DFT_EXHAUSTIVE;
+				continue;
+			}
+			if(strcmp(argv[i], "-o") == 0){
+				if(i >= argc - 1){
+					fprintf(stderr, "ERROR: Missing argument for -o\n");
+					return 13;
+				}
+				sOut = argv[++i];
+				continue;
+			}
+			if(strncmp(argv[i], "--output=", 9) == 0){
+				sOut = argv[i] + 9;
+				continue;
+			}
+			fprintf(stderr, "ERROR: Unknown command line parameter '%s'\n", argv[i]);
+			return 13;
+		}
+
+		if((sscanf(argv[i], "%zu", &uTmp) != 1)||(uTmp < 2)){
+			fprintf(stderr, "ERROR: Couldn't convert '%s' to a DFT length\n", argv[i]);
+			return 13;
+		}
+		if(uLens >= sizeof(aLens)/sizeof(size_t)){
+			fprintf(stderr, "ERROR: Too many DFT lengths, limit is %zu\n",
+			        sizeof(aLens)/sizeof(size_t));
+			return 13;
+		}
+		aLens[uLens++] = uTmp;
+	}
+
+	if(uLens == 0){
+		fprintf(stderr, "ERROR: No DFT lengths given, use -h for help\n");
+		return 13;
+	}
+
+	DasErrCode nRet;
+	for(size_t u = 0; u < uLens; ++u){
+		clock_t nBeg = clock();
+		if((nRet = dft_learn(aLens[u], nEffort)) != DAS_OKAY) return nRet;
+		daslog_info_v("Planned length %zu in %.1f seconds", aLens[u],
+		              ((double)(clock() - nBeg)) / CLOCKS_PER_SEC);
+	}
+
+	if((nRet = dft_saveWisdom(sOut)) != DAS_OKAY) return nRet;
+	daslog_info_v("Wisdom saved to %s", sOut ? sOut : dft_userWisdom());
+	return 0;
+}
@@ -2639,12 +2639,15 @@ const ubyte* _valueToTT2k(
 
 	/* Just handle doubles for now, that's the most common time type */
 	const double* pDblSrc = NULL;
+	das_units_conv conv;
 	switch(vt){
 	case vtDouble:
 		/* TODO: Check endianness here! */
 		pDblSrc = (const double*)pData;
+		conv = Units_getConverter(UNIT_US2000, units);
+		if(conv.nKind == DAS_UCONV_NONE) return NULL;
 		for(size_t u = 0; u < uTimes; ++u){
-			g_pTimeValBuf[u] = das_us2K_to_tt2K(Units_convertTo(UNIT_US2000, pDblSrc[u], units));
+			g_pTimeValBuf[u] = das_us2K_to_tt2K(Units_convertOne(&conv, pDblSrc[u]));
 		}
 		return (const ubyte*)g_pTimeValBuf;
 
@@ -39,8 +39,10 @@
 int g_nTimeWidth = 24;    /* default to 'time24' */
 const char* g_sTimeFmt = NULL;
 
-int g_nGenRes = 7;        /* Default to 7 sig digits */
+int g_nGenRes = 7;        /* Default to 7 sig digits, 0 for shortest exact */
 int g_nSecRes = 3;        /* default to milliseconds */
+das_fmt g_fmtReal;        /* Cached writers for the two settings above */
+das_fmt g_fmtTime;
 int g_n8ByteWidth = 17;   /* default to 'ascii17' for 8-byte floats */
 int g_n4ByteWidth = 14;   /* default to 'ascii14' for 4-byte floats */
 char g_sSep[12] = {';', '\0'};
@@ -139,7 +141,8 @@ void prnHelp()
 "              other ASCII 7-bit character.\n"
 "\n"
 "   -r DIGITS  Set the number of significant digits for general output.  The\n"
-"              minimum resolution is 2 significant digits.\n"
+"              minimum resolution is 2 significant digits.  Use 0 to write\n"
+"              each value with the fewest digits that read back exactly.\n"
 "\n"
 "   -s SUBSEC  Set the sub-second resolution.  Output N digits of sub-second\n"
 "              resolution.  The minimum value is 0, thus time values are always\n"
@@ -293,6 +296,15 @@ void _prnVarHdrs(DasDs* pDs, int nOutput, enum dim_type dmt)
 
 }
 
+/* Write a float or double at the general resolution */
+static size_t _csv_realStr(das_val_type vt, const ubyte* pVal, char* sBuf, size_t uLen)
+{
+	double rVal = (vt == vtFloat) ? *((const float*)pVal) : *((const double*)pVal);
+	if(g_nGenRes == 0)
+		return das_fmt_shortest(sBuf, uLen, rVal, (vt == vtFloat));
+	return das_fmt_real(&g_fmtReal, sBuf, uLen, rVal);
+}
+
 /* Format a datum value-only, rendering a calendar-unit count as UTC.  das3_csv shows
    times as UTC by default; the library value formatter stays faithful to storage, so
    the epoch->das_time conversion is done here. */
@@ -310,6 +322,37 @@ static const char* _csv_datumStr(
 		dmT.units = UNIT_UTC;
 		pDm = &dmT;
 	}
+
+	/* Values at the output resolution skip printf */
+	if(nFracDigits == g_nGenRes){
+		if((pDm->vt == vtFloat)||(pDm->vt == vtDouble)){
+			_csv_realStr(pDm->vt, (const ubyte*)pDm, sBuf, uLen);
+			return sBuf;
+		}
+		const das_geovec* pVec = (const das_geovec*)pDm;
+		if((pDm->vt == vtGeoVec)&&((pVec->et == vtFloat)||(pVec->et == vtDouble))){
+			size_t uSep = strlen(sSep);
+			size_t uUsed = 0;
+			for(int i = 0; (i < pVec->ncomp)&&(uUsed + uSep + 1 < uLen); ++i){
+				if(i > 0){
+					memcpy(sBuf + uUsed, sSep, uSep);
+					uUsed += uSep;
+				}
+				uUsed += _csv_realStr(
+					pVec->et, ((const ubyte*)pVec) + pVec->esize * i, sBuf + uUsed, 
+					uLen - uUsed
+				);
+				if(uUsed >= uLen) uUsed = uLen - 1;
+			}
+			sBuf[uUsed] = '\0';
+			return sBuf;
+		}
+	}
+	if((pDm->vt == vtTime)&&(nFracDigits == g_nSecRes)&&(g_nSecRes > 0)){
+		das_fmt_time(&g_fmtTime, sBuf, uLen, (const das_time*)pDm);
+		return sBuf;
+	}
+
 	return das_datum_toStrValOnlySep(pDm, sBuf, uLen, nFracDigits, sSep);
 }
 
@@ -573,10 +616,11 @@ int main( int argc, char *argv[]) {
 				return das_error(PERR, "Resolution parameter missing after -r\n");
 			
 			g_nGenRes = atoi(argv[i]);
-			if(g_nGenRes < 2 || g_nGenRes > 18)
+			if((g_nGenRes < 2 || g_nGenRes > 18)&&(g_nGenRes != 0))
 				return das_error(PERR, 
 					"Can't format to %d significant digits, supported range is "
-					"only 2 to 18 significant digits.\n", g_nGenRes
+					"only 2 to 18 significant digits, or 0 for shortest exact.\n",
+					g_nGenRes
 				);
 
 			
@@ -633,6 +677,14 @@ int main( int argc, char *argv[]) {
 				  g_nSecRes + 3, g_nSecRes);
 		g_sTimeFmt = sTimeFmt;
 	}
+
+	/* Same layouts as _das_datum_toStr() and dt_isoc() */
+	char sFmt[64] = {'\0'};
+	snprintf(sFmt, 63, "%%.%de", g_nGenRes);
+	das_fmt_init(&g_fmtReal, sFmt);
+	snprintf(sFmt, 63, "%%04d-%%02d-%%02dT%%02d:%%02d:%%0%d.%df", 
+		g_nSecRes + 3, g_nSecRes);
+	das_fmt_init(&g_fmtTime, sFmt);
 	
 	StreamHandler handler;
 	memset(&handler, 0, sizeof(StreamHandler));
@@ -155,7 +155,17 @@ const ubyte g_tt2kfill[8] = {0x80,0,0,0, 0,0,0,   0};
 
 /* The default memory threshold, read from CDFs in blocks no bigger than 
    this (in bytes, non values) */
-#define MAX_CDF_GET_BYTES 16777216;   /* 16 MBytes */
+#define MAX_CDF_GET_BYTES 16777216   /* 16 MBytes */
+
+#ifdef HOST_IS_LSB_FIRST
+static const char* g_sIntEnc  = "LEint";
+static const char* g_sUIntEnc = "LEuint";
+static const char* g_sRealEnc = "LEreal";
+#else
+static const char* g_sIntEnc  = "BEint";
+static const char* g_sUIntEnc = "BEuint";
+static const char* g_sRealEnc = "BEreal";
+#endif
 
 /* ************************************************************************* */
 
@@ -268,6 +278,11 @@ void prnHelp()
 		"               legal and print a list of files that would have been read for\n"
 		"               the query.\n"
 		"\n"
+		"   -b MB, --buffer=MB\n"
+		"               Read CDF variables in blocks of records no larger than MB\n"
+		"               megabytes in total.  Each block is sent as one run of das3\n"
+		"               packets.  Defaults to 16 MB.\n"
+		"\n"
 		"EXAMPLES\n"
 		"   1. Output a das3 stream of B-field alligned oscillations:\n"
 		"\n"
@@ -401,16 +416,19 @@ typedef struct var_buff_t {
 	char sVar[MAX_CDF_VAR_LEN+1]; /* the name of this var */
 	long nCdfType;                /* The CDF type of the data in the array */
 
-	/* TODO: add other tracking structures as needed */
+	long nVarNum;                 /* zVariable number in the current CDF */
+	long nDims;                   /* Number of dimensions in each record */
+	long aDimSz[CDF_MAX_DIMS];    /* The size of each record dimension */
+	size_t uRecVals;              /* Number of values in each record */
 
 	/* The DasAry that holds buffered reads from cdf HyperGet.  When
-		initializing this array always set the first index to -1 to 
+		initializing this array always set the first index to 0 to 
 		make it auto-expand.  For das3 streams, this is just a 
 		reference to the DasDs array.  For das2 streams, this is the 
 		only copy, but it doesn't matter because arrays are reference
 		counted. */
 
-	DasAry pAry;  /* Init as RANK_1(-1), RANK_2(-1, J), RANK_3(-1, J, K) etc. */
+	DasAry* pAry;  /* Init as RANK_1(0), RANK_2(0, J), RANK_3(0, J, K) etc. */
 } VarBuf;
 
 /* NONE - Send whole var, for das2 rank of data var must be 2 or less
@@ -424,10 +442,26 @@ typedef enum varop {NONE, SUM, AVG, SLICE, COMP } varop_e;
 
 #define MAX_CDF_VARS 63
 
-/* TODO: Use these! Just commented out so source compiles
-static VarBuf g_aVarBufs[MAX_CDF_VARS+1] = {0}; / * Leave null sentinal at end * /
+static VarBuf g_aVarBufs[MAX_CDF_VARS+1] = {{{0}}}; /* Leave null sentinal at end */
 static size_t g_uNextVarBuf = 0;
-*/
+
+/* Get the buffer for a CDF variable, making a new one if needed. Variables
+   are often shared, for example many data vars have the same DEPEND_0, so
+   each name only gets one buffer.  Returns NULL if out of buffers. */
+VarBuf* getVarBuf(const char* sVar)
+{
+	for(size_t u = 0; u < g_uNextVarBuf; ++u){
+		if(strcmp(g_aVarBufs[u].sVar, sVar) == 0)
+			return g_aVarBufs + u;
+	}
+	if(g_uNextVarBuf >= MAX_CDF_VARS)
+		return NULL;
+
+	VarBuf* pBuf = g_aVarBufs + g_uNextVarBuf;
+	++g_uNextVarBuf;
+	strncpy(pBuf->sVar, sVar, MAX_CDF_VAR_LEN);
+	return pBuf;
+}
 
 /* Pointer Map: "O" = owns, "R" = Reference, "P" = Just Points
  *
@@ -483,6 +517,7 @@ typedef struct var_spec {
 	varop_e   nOp;
 
 	/* operation argument */
+	char      sOpCoord[MAX_CDF_VAR_LEN+1]; /* The coordinate var to operate on */
 	int       nIndex;    /* If -1, use dCoordVal below to find the index */
 	double    dCoordVal; /* Temporary until index of value found in CDF */
 
@@ -490,6 +525,11 @@ typedef struct var_spec {
 	   not assigned at argument parsing time */
 	uint32_t  uFlags;   
 
+	/* The output dataset for das3 streams and it's packet ID, the dataset
+	   is owned by the stream */
+	DasDs*    pDs;
+	int       nPktId;
+
 } VarSpec;
 
 #define MAX_DATA_VARS 32
@@ -497,19 +537,104 @@ typedef struct var_spec {
 typedef struct context_t {
 	char       sLevel[12];    /* Logging level */
 	int        nDas;      /* One of 2 or 3 for das2 or das3 */
+	bool       bNoOp;     /* Just list the files that would be read */
+	size_t     uMemBudget; /* Max bytes to read from a CDF at one time */
 	char       sPattern[MAX_FILE_PTRN + 1];  /* The filename pattern */
 	const char* sBeg;     /* The start time as formatted by user */
 	const char* sEnd;     /* The end time as formatted by user */
 	das_range  range;     /* The time range to query */
+	int64_t    nBeg;      /* The query range as TT2000 values, for locating */
+	int64_t    nEnd;      /* records in the DEPEND_0 variables */
 	VarSpec    aSpecs[MAX_DATA_VARS];  /* The variables to extract points to */
 	int        nSpecs;    /* Num of vars to extract */
 } Context;
 
+/* Parse NAME[:OPERATION:COORD_VAR[,INDEX]], returns false and fills in sMsg
+   if the spec isn't legal */
+bool parseVarSpec(const char* sArg, VarSpec* pSpec, char* sMsg, size_t uMsg)
+{
+	char sBuf[256] = {'\0'};
+	char* aParts[3] = {NULL};
+	int nParts = 0;
+
+	strncpy(sBuf, sArg, 255);
+	char* pTok = strtok(sBuf, ":");
+	while((pTok != NULL)&&(nParts < 3)){
+		aParts[nParts] = pTok;
+		++nParts;
+		pTok = strtok(NULL, ":");
+	}
+
+	if((nParts == 0)||(pTok != NULL)||(nParts == 2)){
+		snprintf(sMsg, uMsg, "Malformed variable specification '%s'", sArg);
+		return false;
+	}
+	if(strlen(aParts[0]) > MAX_CDF_VAR_LEN){
+		snprintf(sMsg, uMsg, "CDF variable name '%s' is too long", aParts[0]);
+		return false;
+	}
+
+	memset(pSpec, 0, sizeof(VarSpec));
+	pSpec->nOp = NONE;
+	pSpec->nIndex = -1;
+	if((pSpec->pData = getVarBuf(aParts[0])) == NULL){
+		snprintf(sMsg, uMsg, "Too many CDF variables, max is %d", MAX_CDF_VARS);
+		return false;
+	}
+
+	if(nParts == 1)
+		return true;
+
+	if(strcasecmp(aParts[1], "sum") == 0)        pSpec->nOp = SUM;
+	else if(strcasecmp(aParts[1], "avg") == 0)   pSpec->nOp = AVG;
+	else if(strcasecmp(aParts[1], "slice") == 0) pSpec->nOp = SLICE;
+	else if(strcasecmp(aParts[1], "comp") == 0)  pSpec->nOp = COMP;
+	else{
+		snprintf(sMsg, uMsg, "Unknown operation '%s' in '%s'", aParts[1], sArg);
+		return false;
+	}
+
+	char* pIdx = strchr(aParts[2], ',');
+	if(pIdx != NULL){
+		*pIdx = '\0';
+		++pIdx;
+		char* pEnd = NULL;
+		long nIdx = strtol(pIdx, &pEnd, 10);
+		if((*pEnd == '\0')&&(pEnd != pIdx)&&(nIdx >= 0)){
+			pSpec->nIndex = (int)nIdx;
+		}
+		else{
+			pSpec->dCoordVal = strtod(pIdx, &pEnd);
+			if((*pEnd != '\0')||(pEnd == pIdx)){
+				snprintf(sMsg, uMsg, "Invalid coordinate index or value '%s'", pIdx);
+				return false;
+			}
+		}
+	}
+	else if((pSpec->nOp == SLICE)||(pSpec->nOp == COMP)){
+		snprintf(sMsg, uMsg, "Operation '%s' requires a coordinate index or value",
+			aParts[1]
+		);
+		return false;
+	}
+	strncpy(pSpec->sOpCoord, aParts[2], MAX_CDF_VAR_LEN);
+
+	return true;
+}
 
 DasErrCode parseArgs(int argc, char** argv, Context* pCtx){
 	const char* sHdr = NULL;
 	char sMsg[256] = {'\0'};   /* No XML escapes, watch output! */
 	char sPkt[384] = {'\0'};
+	char sMemBudget[32] = {'\0'};
+	const char* aPos[3] = {NULL};
+	int nPos = 0;
+	das_time dt;
+	float fMemUse;
+
+	memset(pCtx, 0, sizeof(Context));
+	strcpy(pCtx->sLevel, "info");
+	pCtx->uMemBudget = MAX_CDF_GET_BYTES;
 
 	/* Step 0, look for "-2" or "--das2" to affect other output */
 	pCtx->nDas = 3;
@@ -518,24 +643,89 @@ DasErrCode parseArgs(int argc, char** argv, Context* pCtx){
 		if(strcmp(argv[i], "--das2")==0){ pCtx->nDas = 2; break;}
 	}
 
-	/* TODO: 
-		Now proceed on with normal parsing with the ability to jump 
+	/* Now proceed on with normal parsing with the ability to jump 
 	   to the error handler below.  Anything wrong is something to
 	   do with how the user invoked the program so all errors are
-	   output as IllegalArgument/QueryError in here. 
+	   output as IllegalArgument/QueryError in here. */
 
-		A the end of this function we either have legal looking
-		data at pCtx or the the whole program has exited.
+	int i = 0;
+	while(i < (argc-1)){
+		++i;  /* 1st time, skip past the program name */
 
-		Uncomment g_aVarBufs and g_uNextVarBuf above when this get's implimented.
+		if(argv[i][0] == '-'){
+			if(dascmd_isArg(argv[i], "-h", "--help", NULL)){
+				prnHelp();
+				exit(0);
+			}
+			if(dascmd_isArg(argv[i], "-2", "--das2", NULL))
+				continue;  /* Handled above */
+			if(dascmd_isArg(argv[i], "-n", "--no-op", NULL)){
+				pCtx->bNoOp = true;
+				continue;
+			}
+			if(dascmd_getArgVal(
+				pCtx->sLevel, DAS_FIELD_SZ(Context,sLevel), argv, argc, &i, "-l", "--log="
+			))
+				continue;
+			if(dascmd_getArgVal(sMemBudget, 32, argv, argc, &i, "-b", "--buffer="))
+				continue;
+
+			snprintf(sMsg, 255, "Unknown command line argument %s", argv[i]);
+			goto ARG_ERROR;
+		}
 
-	*/
+		if(nPos < 3){
+			aPos[nPos] = argv[i];
+			++nPos;
+			continue;
+		}
+
+		if(pCtx->nSpecs >= MAX_DATA_VARS){
+			snprintf(sMsg, 255, "Too many variables to stream, max is %d", MAX_DATA_VARS);
+			goto ARG_ERROR;
+		}
+		if(!parseVarSpec(argv[i], pCtx->aSpecs + pCtx->nSpecs, sMsg, 255))
+			goto ARG_ERROR;
+		++(pCtx->nSpecs);
+	}
+
+	if(pCtx->nSpecs < 1){
+		strncpy(sMsg, "Expected PATTERN BEGIN END VAR_SPEC arguments, use -h for help", 255);
+		goto ARG_ERROR;
+	}
 
-	strncpy(sMsg, "Function not written yet", 255);
-	goto ARG_ERROR;
+	if(strlen(aPos[0]) > MAX_FILE_PTRN){
+		snprintf(sMsg, 255, "File pattern is longer than %d bytes", MAX_FILE_PTRN);
+		goto ARG_ERROR;
+	}
+	strncpy(pCtx->sPattern, aPos[0], MAX_FILE_PTRN);
+
+	/* Range conversions need das_init(), so they're handled in main */
+	pCtx->sBeg = aPos[1];
+	pCtx->sEnd = aPos[2];
+	das_time dtEnd;
+	if(!dt_parsetime(pCtx->sBeg, &dt)){
+		snprintf(sMsg, 255, "Couldn't parse '%s' as a date-time", pCtx->sBeg);
+		goto ARG_ERROR;
+	}
+	if(!dt_parsetime(pCtx->sEnd, &dtEnd)){
+		snprintf(sMsg, 255, "Couldn't parse '%s' as a date-time", pCtx->sEnd);
+		goto ARG_ERROR;
+	}
+	if(dt_compare(&dt, &dtEnd) >= 0){
+		snprintf(sMsg, 255, "Begin time %s is not before end time %s", pCtx->sBeg, pCtx->sEnd);
+		goto ARG_ERROR;
+	}
 
+	if(sMemBudget[0] != '\0'){
+		if((sscanf(sMemBudget, "%f", &fMemUse) != 1)||(fMemUse < 1)){
+			snprintf(sMsg, 255, "Invalid memory usage argument, '%s' MB", sMemBudget);
+			goto ARG_ERROR;
+		}
+		pCtx->uMemBudget = ((size_t)fMemUse) * 1048576ull;
+	}
 
-	/* return DAS_OKAY; */
+	return DAS_OKAY;
 
 	/* Manual error encoding before DasIO is initialized */
 ARG_ERROR:
@@ -544,15 +734,15 @@ ARG_ERROR:
 	if(pCtx->nDas < 3){
 		sHdr = "<stream version=\"2.2\" />\n";	
 		printf("[00]%06zu%s",strlen(sHdr), sHdr);
-		snprintf(sPkt, 255, 
+		snprintf(sPkt, 383, 
 			"<exception type=\"IllegalArgument\" message=\"%s\" />\n", sMsg
 		);
 		printf("[xx]%06zu%s",strlen(sPkt),sPkt);
 	}
 	else{
 		sHdr = "<stream version=\"3.0\" type=\"das-basic-stream\" />\n";
-		printf("[00]%06zu%s",strlen(sHdr), sHdr);
-		snprintf(sPkt, 255, 
+		printf("|Sx||%zu|%s",strlen(sHdr), sHdr);
+		snprintf(sPkt, 383, 
 			"<exception type=\"QueryError\">\n%s\n</exception>\n", sMsg
 		);
 		printf("|Ex||%zu|%s",strlen(sPkt),sPkt);
@@ -560,6 +750,180 @@ ARG_ERROR:
 	return PERR;
 }
 
+/* ************************************************************************* */
+/* CDF variable inquiries */
+
+das_val_type cdfTypeToVt(long nCdfType)
+{
+	switch(nCdfType){
+	case CDF_INT1:  case CDF_BYTE:  return vtByte;
+	case CDF_UINT1:                 return vtUByte;
+	case CDF_INT2:                  return vtShort;
+	case CDF_UINT2:                 return vtUShort;
+	case CDF_INT4:                  return vtInt;
+	case CDF_UINT4:                 return vtUInt;
+	case CDF_INT8:  case CDF_TIME_TT2000: return vtLong;
+	case CDF_REAL4: case CDF_FLOAT: return vtFloat;
+	case CDF_REAL8: case CDF_DOUBLE: return vtDouble;
+	default:                        return vtUnknown;
+	}
+}
+
+/* Look up a variable in the currently open CDF.  Variable numbers are 
+   looked up for each file, but the type and shape must match the first
+   file read.  Returns false if the variable can't be streamed from this
+   file */
+bool inquireVar(CDFid nCdfId, VarBuf* pBuf)
+{
+	CDFstatus nCdfStatus = CDF_OK;
+	long nType = 0;
+	long nDims = 0;
+	long aDimSz[CDF_MAX_DIMS] = {0};
+	long nRecVary = NOVARY;
+
+	if(CDFconfirmzVarExistence(nCdfId, pBuf->sVar) != CDF_OK){
+		daslog_warn_v("No zVariable named %s in CDF", pBuf->sVar);
+		return false;
+	}
+	pBuf->nVarNum = CDFgetVarNum(nCdfId, pBuf->sVar);
+
+	if(CDF_MAD(CDFgetzVarDataType(nCdfId, pBuf->nVarNum, &nType)))
+		return false;
+	if(CDF_MAD(CDFgetzVarNumDims(nCdfId, pBuf->nVarNum, &nDims)))
+		return false;
+	if(CDF_MAD(CDFgetzVarDimSizes(nCdfId, pBuf->nVarNum, aDimSz)))
+		return false;
+	if(CDF_MAD(CDFgetzVarRecVariance(nCdfId, pBuf->nVarNum, &nRecVary)))
+		return false;
+
+	if(nRecVary != VARY){
+		daslog_warn_v("Variable %s is not record varying", pBuf->sVar);
+		return false;
+	}
+	if(cdfTypeToVt(nType) == vtUnknown){
+		daslog_warn_v("Variable %s has unsupported CDF data type %ld", pBuf->sVar, nType);
+		return false;
+	}
+
+	/* First time seen, record the shape */
+	if(pBuf->nCdfType == 0){
+		pBuf->nCdfType = nType;
+		pBuf->nDims = nDims;
+		pBuf->uRecVals = 1;
+		for(long d = 0; d < nDims; ++d){
+			pBuf->aDimSz[d] = aDimSz[d];
+			pBuf->uRecVals *= (size_t)aDimSz[d];
+		}
+		return true;
+	}
+
+	bool bSame = (nType == pBuf->nCdfType) && (nDims == pBuf->nDims);
+	for(long d = 0; bSame && (d < nDims); ++d)
+		bSame = (aDimSz[d] == pBuf->aDimSz[d]);
+
+	if(!bSame)
+		daslog_warn_v("Type or shape of variable %s differs from the first CDF", pBuf->sVar);
+	return bSame;
+}
+
+/* Get a text attribute of a variable, trailing spaces are removed.  Returns
+   false if the attribute isn't present, or is too long or not text. */
+bool varAttrStr(
+	CDFid nCdfId, const char* sAttr, long nVarNum, char* sBuf, size_t uLen
+){
+	long nAttr = CDFgetAttrNum(nCdfId, (char*)sAttr);
+	long nType = 0;
+	long nElems = 0;
+	if(nAttr < 0)
+		return false;
+
+	/* Missing entries are normal, don't log them */
+	if(CDFgetAttrzEntryDataType(nCdfId, nAttr, nVarNum, &nType) != CDF_OK)
+		return false;
+	if((nType != CDF_CHAR)&&(nType != CDF_UCHAR))
+		return false;
+	if(CDFgetAttrzEntryNumElements(nCdfId, nAttr, nVarNum, &nElems) != CDF_OK)
+		return false;
+	if((nElems < 1)||((size_t)nElems >= uLen))
+		return false;
+	if(CDFgetAttrzEntry(nCdfId, nAttr, nVarNum, sBuf) != CDF_OK)
+		return false;
+
+	sBuf[nElems] = '\0';
+	while((nElems > 0)&&(sBuf[nElems - 1] == ' ')){
+		--nElems;
+		sBuf[nElems] = '\0';
+	}
+	return (nElems > 0);
+}
+
+/* Get the FILLVAL for a variable, if it's the same type as the variable */
+const ubyte* varFill(CDFid nCdfId, const VarBuf* pBuf, ubyte* pFill)
+{
+	if(pBuf->nCdfType == CDF_TIME_TT2000)
+		return g_tt2kfill;
+
+	long nAttr = CDFgetAttrNum(nCdfId, (char*)"FILLVAL");
+	long nType = 0;
+	long nElems = 0;
+	if(nAttr < 0)
+		return NULL;
+	if(CDFgetAttrzEntryDataType(nCdfId, nAttr, pBuf->nVarNum, &nType) != CDF_OK)
+		return NULL;
+	if(CDFgetAttrzEntryNumElements(nCdfId, nAttr, pBuf->nVarNum, &nElems) != CDF_OK)
+		return NULL;
+	if((nType != pBuf->nCdfType)||(nElems != 1))
+		return NULL;
+	if(CDFgetAttrzEntry(nCdfId, nAttr, pBuf->nVarNum, pFill) != CDF_OK)
+		return NULL;
+	return pFill;
+}
+
+/* Find the first record with a time at or after nTime. Assumes DEPEND_0
+   values increase monotonically, as required by ISTP.  Returns -1 on a read
+   error */
+long firstRecAtOrAfter(CDFid nCdfId, const VarBuf* pTime, long nRecs, int64_t nTime)
+{
+	CDFstatus nCdfStatus = CDF_OK;
+	long aIdx[CDF_MAX_DIMS] = {0};
+	int64_t nVal = 0;
+	long nLo = 0;
+	long nHi = nRecs;
+
+	while(nLo < nHi){
+		long nMid = nLo + (nHi - nLo)/2;
+		if(CDF_MAD(CDFgetzVarData(nCdfId, pTime->nVarNum, nMid, aIdx, &nVal)))
+			return -1;
+		if(nVal < nTime)
+			nLo = nMid + 1;
+		else
+			nHi = nMid;
+	}
+	return nLo;
+}
+
+/* Read a block of records directly into the end of a variable's array.
+   The space is first appended as fill, then cdflib writes over it so that
+   packets are encoded straight from the read buffer without a copy. */
+bool readBlock(CDFid nCdfId, VarBuf* pBuf, long iRec, long nRecs)
+{
+	CDFstatus nCdfStatus = CDF_OK;
+	long aIdx[CDF_MAX_DIMS] = {0};
+	long aIntv[CDF_MAX_DIMS];
+	for(long d = 0; d < CDF_MAX_DIMS; ++d) aIntv[d] = 1;
+
+	ubyte* pWrite = DasAry_append(pBuf->pAry, NULL, ((size_t)nRecs) * pBuf->uRecVals);
+	if(pWrite == NULL)
+		return false;
+
+	if(CDF_MAD(CDFhyperGetzVarData(
+		nCdfId, pBuf->nVarNum, iRec, nRecs, 1L, aIdx, pBuf->aDimSz, aIntv, pWrite
+	)))
+		return false;
+
+	return true;
+}
+
 /* ************************************************************************* */
 /* Setup the stream object that will contain data we want to stream
  *
@@ -670,18 +1034,131 @@ void setupDas2Stream(Context* pCtx, DasStream* g_pSd, CDFid nCdfId){
 	daslog_critical("Das2 streaming has not yet been implemented.");
 }
 
-void setupDas3Stream(Context* pCtx, DasStream* g_pSd, CDFid nCdfId){
+/* The das3 path makes one dataset per VAR_SPEC.  The DEPEND_0 time variable
+   is the only coordinate, data arrays keep their native CDF shape. Packet
+   IDs follow VAR_SPEC order. Datasets and arrays are defined from the first
+   CDF and re-used for all following files. */
 
-	/* NOTE: Out of scope, do das2 path first */
+void setupDas3Stream(Context* pCtx, DasStream* g_pSd, CDFid nCdfId){
+	CDFstatus nCdfStatus = CDF_OK;
+	long nMajority = ROW_MAJOR;
+	char sDep[MAX_CDF_VAR_LEN+1] = {'\0'};
+	char sAttr[256] = {'\0'};
+	ubyte aFill[8] = {0};
+
+	if(CDF_MAD(CDFgetMajority(nCdfId, &nMajority)))
+		daslog_critical("Couldn't determine the CDF majority");
+
+	for(int i = 0; i < pCtx->nSpecs; ++i){
+		VarSpec* pSpec = pCtx->aSpecs + i;
+		VarBuf* pData = pSpec->pData;
+
+		if(pSpec->nOp != NONE)
+			daslog_critical_v(
+				"Operation on %s is not applicable in das3 output, das3 supports "
+				"the native rank", pData->sVar
+			);
+
+		if(!inquireVar(nCdfId, pData))
+			daslog_critical_v("Can't stream CDF variable %s", pData->sVar);
+
+		if(pData->nDims + 1 > DASIDX_MAX)
+			daslog_critical_v("Variable %s has too many dimensions", pData->sVar);
+
+		/* Hyper reads return values in the file's majority.  Could transpose
+		   each block, but ISTP CDFs are almost always row major. */
+		if((nMajority == COLUMN_MAJOR)&&(pData->nDims > 1))
+			daslog_critical_v(
+				"Variable %s is stored in column major order, only row major "
+				"multi-dimensional variables are supported", pData->sVar
+			);
+
+		if(!varAttrStr(nCdfId, "DEPEND_0", pData->nVarNum, sDep, MAX_CDF_VAR_LEN+1))
+			daslog_critical_v(
+				"Variable %s has no DEPEND_0, it can't be located in time", pData->sVar
+			);
+
+		VarBuf* pTime = getVarBuf(sDep);
+		if(pTime == NULL)
+			daslog_critical_v("Too many CDF variables, max is %d", MAX_CDF_VARS);
+		if(!inquireVar(nCdfId, pTime))
+			daslog_critical_v("Can't stream time coordinate %s", sDep);
+		if((pTime->nCdfType != CDF_TIME_TT2000)||(pTime->nDims != 0))
+			daslog_critical_v(
+				"Time coordinate %s for %s is not a scalar CDF_TIME_TT2000 "
+				"variable", sDep, pData->sVar
+			);
+		pSpec->apCoords[0] = pTime;
+
+		int nRank = pData->nDims + 1;
+		pSpec->nPktId = i + 1;
+		pSpec->pDs = new_DasDs(pData->sVar, pData->sVar, nRank);
+		DasStream_addDesc(g_pSd, (DasDesc*)(pSpec->pDs), pSpec->nPktId);
+
+		/* Time coordinate, shared with any other dataset using it */
+		if(pTime->pAry == NULL)
+			pTime->pAry = new_DasAry(sDep, vtLong, 0, g_tt2kfill, RANK_1(0), UNIT_TT2000);
+		inc_DasAry(pTime->pAry);  /* DasDs_addAry steals a reference */
+		DasDs_addAry(pSpec->pDs, pTime->pAry);
+		DasDs_addFixedCodec(pSpec->pDs, sDep, "datetime", g_sIntEnc, 8, 1, DASENC_WRITE);
+
+		int8_t aMap[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+		aMap[0] = 0;
+
+		DasDim* pDim = DasDs_makeDim(pSpec->pDs, DASDIM_COORD, "time", sDep);
+		DasDim_addVar(pDim, DASVAR_CENTER, new_DasVarAry(pTime->pAry, nRank, aMap, 0));
+		DasDim_setAxis(pDim, 0, "x");
+		DasDim_primeCoord(pDim, true);
+		DasDesc_setStr((DasDesc*)pDim, "cdfName", sDep);
+
+		/* Data values, read directly in the CDF's binary type */
+		das_val_type vt = cdfTypeToVt(pData->nCdfType);
+		if(pData->pAry == NULL){
+			das_units units = UNIT_DIMENSIONLESS;
+			if(varAttrStr(nCdfId, "UNITS", pData->nVarNum, sAttr, 256))
+				units = Units_fromStr(sAttr);
+
+			size_t aShape[DASIDX_MAX] = {0};
+			for(long d = 0; d < pData->nDims; ++d)
+				aShape[d+1] = (size_t)(pData->aDimSz[d]);
+
+			pData->pAry = new_DasAry(
+				pData->sVar, vt, 0, varFill(nCdfId, pData, aFill), nRank, aShape, units
+			);
+		}
+		inc_DasAry(pData->pAry);
+		DasDs_addAry(pSpec->pDs, pData->pAry);
+
+		const char* sEnc = g_sRealEnc;
+		if(das_vt_isint(vt)){
+			if(das_vt_size(vt) == 1)
+				sEnc = (vt == vtUByte) ? "ubyte" : "byte";
+			else
+				sEnc = ((vt == vtUShort)||(vt == vtUInt)) ? g_sUIntEnc : g_sIntEnc;
+		}
+		DasDs_addFixedCodec(
+			pSpec->pDs, pData->sVar, das_vt_isint(vt) ? "integer" : "real", sEnc,
+			(int)das_vt_size(vt), (int)(pData->uRecVals), DASENC_WRITE
+		);
 
-	daslog_critical("Das3 streaming has not yet been implemented.");
+		for(long d = 0; d < pData->nDims; ++d)
+			aMap[d+1] = (int8_t)(d+1);
+
+		pDim = DasDs_makeDim(pSpec->pDs, DASDIM_DATA, pData->sVar, "");
+		DasDim_addVar(pDim, DASVAR_CENTER, new_DasVarAry(pData->pAry, nRank, aMap, 0));
+		DasDim_setAxis(pDim, 0, (nRank > 1) ? "z" : "y");
+		DasDesc_setStr((DasDesc*)pDim, "cdfName", pData->sVar);
+		if(varAttrStr(nCdfId, "LABLAXIS", pData->nVarNum, sAttr, 256))
+			DasDesc_setStr((DasDesc*)pDim, "label", sAttr);
+		if(varAttrStr(nCdfId, "CATDESC", pData->nVarNum, sAttr, 256))
+			DasDesc_setStr((DasDesc*)pDim, "summary", sAttr);
+	}
 }
 
-
 void setupStream(
 	Context* pCtx, DasIO* g_pIoOut, DasStream* g_pSd, CDFid nCdfId
 ){
-	if(DasIO_getModel(g_pIoOut) == 2)
+	if(pCtx->nDas == 2)
 		setupDas2Stream(pCtx, g_pSd, nCdfId);
 	else
 		setupDas3Stream(pCtx, g_pSd, nCdfId);
@@ -690,15 +1167,72 @@ void setupStream(
 /* ************************************************************************* */
 /* Streaming data */
 
+/* Returns the number of records sent, which for das3 streams is the same
+   as the number of packets */
 int streamFile(Context* pCtx, DasIO* pIoOut, DasStream* pSd, CDFid nCdfId)
 {
 	/* Basic Plan:
 	 * 
-	 * For each VarBuf in the context
-	   which is *much* faster then the one record at a time functions 
-	*/
-	daslog_critical("Das2 streaming has not yet been implemented.");
-	return 0;  /* never get's here */
+	 * For each VarSpec in the context, locate the query range in the
+	 * DEPEND_0 variable, then hyper-read blocks of records for the time and
+	 * data variables directly into the dataset arrays.  Hyper reads are
+	 * *much* faster then the one record at a time functions.  Blocks are
+	 * sized so that all arrays in a dataset fit in the memory budget.
+	 */
+	if(pCtx->nDas == 2)
+		daslog_critical("Das2 streaming has not yet been implemented.");
+
+	CDFstatus nCdfStatus = CDF_OK;   /* needed by the CDF_MAD() macro */
+	DasErrCode nDasStatus = DAS_OKAY; /* needed by the DAS_EXIT() macro */
+	int nRecsSent = 0;
+
+	for(int i = 0; i < pCtx->nSpecs; ++i){
+		VarSpec* pSpec = pCtx->aSpecs + i;
+		VarBuf* pData = pSpec->pData;
+		VarBuf* pTime = pSpec->apCoords[0];
+
+		if(!inquireVar(nCdfId, pTime) || !inquireVar(nCdfId, pData)){
+			daslog_warn_v("Skipping variable %s in this file", pData->sVar);
+			continue;
+		}
+
+		long nMaxTime = -1;
+		long nMaxData = -1;
+		if(CDF_MAD(CDFgetzVarMaxWrittenRecNum(nCdfId, pTime->nVarNum, &nMaxTime)))
+			continue;
+		if(CDF_MAD(CDFgetzVarMaxWrittenRecNum(nCdfId, pData->nVarNum, &nMaxData)))
+			continue;
+		long nRecs = ((nMaxTime < nMaxData) ? nMaxTime : nMaxData) + 1;
+		if(nRecs < 1)
+			continue;
+
+		long iBeg = firstRecAtOrAfter(nCdfId, pTime, nRecs, pCtx->nBeg);
+		long iEnd = firstRecAtOrAfter(nCdfId, pTime, nRecs, pCtx->nEnd);
+		if((iBeg < 0)||(iEnd < 0))
+			continue;
+
+		size_t uRecBytes = pTime->uRecVals * DasAry_valSize(pTime->pAry) + 
+		                   pData->uRecVals * DasAry_valSize(pData->pAry);
+		long nBlock = (long)(pCtx->uMemBudget / uRecBytes);
+		if(nBlock < 1)
+			nBlock = 1;
+
+		for(long iRec = iBeg; iRec < iEnd; iRec += nBlock){
+			long nRead = ((iEnd - iRec) < nBlock) ? (iEnd - iRec) : nBlock;
+
+			DasDs_clearRagged0(pSpec->pDs);
+			if(!readBlock(nCdfId, pTime, iRec, nRead))
+				break;
+			if(!readBlock(nCdfId, pData, iRec, nRead))
+				break;
+
+			DAS_EXIT( DasIO_writeData(pIoOut, (DasDesc*)(pSpec->pDs), pSpec->nPktId) );
+			nRecsSent += (int)nRead;
+		}
+		DasDs_clearRagged0(pSpec->pDs);
+	}
+
+	return nRecsSent;
 }
 
 
@@ -708,7 +1242,8 @@ int streamFile(Context* pCtx, DasIO* pIoOut, DasStream* pSd, CDFid nCdfId)
 int main(int argc, char** argv) 
 {
 	Context context;
-	parseArgs(argc, argv, &context); /* <-- may exit program via log handler */
+	if(parseArgs(argc, argv, &context) != DAS_OKAY)
+		return PERR;  /* Error already sent to the client */
 
 	/* Setup to bounce errors to client, with return on errs and custom 
 	   log handler */
@@ -728,19 +1263,35 @@ int main(int argc, char** argv)
 	DasErrCode nDasStatus = DAS_OKAY;  /* Used by DAS_CHECK */
 	CDFstatus nCdfStatus = CDF_OK; /* needed by the CDF_MAD() macro */ 
 
+	/* Query range, also as TT2000 values for locating records */
+	das_time dt;
+	DAS_EXIT( das_range_fromUtc(&(context.range), context.sBeg, context.sEnd) );
+	dt_parsetime(context.sBeg, &dt);
+	context.nBeg = dt_to_tt2k(&dt);
+	dt_parsetime(context.sEnd, &dt);
+	context.nEnd = dt_to_tt2k(&dt);
+
 	DAS_EXIT( DasUriTplt_pattern(pTplt, context.sPattern) );
 	DasUriIter iter;
 	DAS_EXIT( init_DasUriIter(&iter, pTplt, 1, &(context.range)) );
 
+	const char* sCdfFile = NULL;
+	if(context.bNoOp){
+		while((sCdfFile = DasUriIter_next(&iter)) != NULL)
+			printf("%s\n", sCdfFile);
+		fini_DasUriIter(&iter);
+		del_DasUriTplt(pTplt);
+		return 0;
+	}
+
 	/* Main loop, lots of setup when first legal CDF file is opened */
 
 	int nCdfsRead = 0;
-	const char* sCdfFile = NULL;
 	CDFid nCdfId = 0L;
 	int nPktsSent = 0;
 	while((sCdfFile = DasUriIter_next(&iter)) != NULL){
 
-		if(CDF_MAD( CDFopenCDF(sCdfFile, &nCdfId)) )
+		if(CDF_MAD( CDFopenCDF((char*)sCdfFile, &nCdfId)) )
 			continue;  /* Skip this one */
 
 		if(nCdfsRead == 0){
@@ -748,24 +1299,31 @@ int main(int argc, char** argv)
 			DAS_EXIT( DasIO_writeDesc(g_pIoOut, (DasDesc*)g_pSd, 0) );
 
 			/* Loop over datesets and write thier headers too */
-			for(int nPktId = 1; nPktId < MAX_PKTIDS; ++nPktId){
-				DasDesc* pDesc = g_pSd->descriptors[nPktId];
-				if(pDesc != NULL){
-
-					/* Note, DasDs doesn't have an DasDs_encode2() function to 
-					   output itself using the das2 stream format, we'll 
-					   have to add that in dataset.c, or a help file.
-					   For now that's DasIO's problem, just assume it 
-					   exists. */
-					DAS_EXIT( DasIO_writeDesc(g_pIoOut, pDesc, nPktId) );
-				}
+			int nPktId = 0;
+			DasDesc* pDesc = NULL;
+			while((pDesc = DasStream_nextDesc(g_pSd, &nPktId)) != NULL){
+
+				/* Note, DasDs doesn't have an DasDs_encode2() function to 
+				   output itself using the das2 stream format, we'll 
+				   have to add that in dataset.c, or a help file.
+				   For now that's DasIO's problem, just assume it 
+				   exists. */
+				DAS_EXIT( DasIO_writeDesc(g_pIoOut, pDesc, nPktId) );
 			}
 		}
 
+		++nCdfsRead;
+
 		nPktsSent += streamFile(&context, g_pIoOut, g_pSd, nCdfId);
+		CDFcloseCDF(nCdfId);
 	}
+	fini_DasUriIter(&iter);
+	del_DasUriTplt(pTplt);
 
 	if(nPktsSent == 0){
+		if(!(g_pIoOut->bSentHeader))
+			DAS_EXIT( DasIO_writeStreamDesc(g_pIoOut, g_pSd) );
+
 		/* Send a no-data-in-range message if no data packets sent */
 		OobExcept except;
 		char sMsg[128] = {'\0'};
@@ -774,5 +1332,15 @@ int main(int argc, char** argv)
 		DAS_EXIT( DasIO_writeException(g_pIoOut, &except) );
 	}
 
+	DasIO_close(g_pIoOut);
+	del_DasIO(g_pIoOut);
+	del_DasStream(g_pSd);
+
+	/* Drop the references held by the variable buffers */
+	for(size_t u = 0; u < g_uNextVarBuf; ++u){
+		if(g_aVarBufs[u].pAry != NULL)
+			dec_DasAry(g_aVarBufs[u].pAry);
+	}
+
 	return 0;
 };
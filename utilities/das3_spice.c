@@ -192,6 +192,18 @@ void prnHelp()
 "               for regions where spice kernels are incomplete. NOTE: Coverage\n"
 "               gap detection and recovery may slow processing.\n"
 "\n"
+"   -i ARCSEC[,KM[,SECONDS]], --interp=ARCSEC[,KM[,SECONDS]]\n"
+"               By default SPICE is called for every input record. With this\n"
+"               option, rotations and locations are computed exactly at a\n"
+"               coarser cadence and interpolated in between, quaternion SLERP\n"
+"               is used for rotations and Hermite cubics for locations.  Exact\n"
+"               points are added until rotations are within ARCSEC arc-seconds\n"
+"               and locations are within KM kilometers of the SPICE values.\n"
+"               KM defaults to 0.01.  Exact points are never more than SECONDS\n"
+"               apart, 10 by default.  For spinning spacecraft SECONDS must be\n"
+"               less than half the spin period.  Coverage gaps shorter than\n"
+"               SECONDS may be interpolated over.\n"
+"\n"
 "   -p [TYPE:]NAME=VALUE, --prop [TYPE:]NAME=VALUE\n"
 "               Add property NAME to the output stream header of the given TYPE\n"
 "               with the given VALUE.  If TYPE is missing, it defaults to\n"
@@ -323,6 +335,10 @@ typedef struct xform_request {
 	ubyte uOutDasId;                /* ID used with dasStream to link vectors & frames */
 	bool bGapFill;                  /* Use fill data when SPICE gaps are encountered */
 	int nGapRecs;                   /* Number of gap records encountered */
+	double rRotTol;                 /* Interpolated rotation tolerance, radians */
+	double rLocTol;                 /* Interpolated location tolerance, km */
+	double rMaxStep;                /* Max seconds between exact SPICE calls */
+	bool bFixed;                    /* Rotation between inertial frames, constant */
 	
 	/* The coordinates to output.  The order is:
 	  x,y,z - For cartesian coords
@@ -364,6 +380,10 @@ typedef struct context{
 
 	double rEphemShift;   /* Lesser used option */
 
+	double rRotTol;       /* Interpolation tolerances, 0 to call SPICE for */
+	double rLocTol;       /* every record */
+	double rMaxStep;
+
 	DasIO*     pOut;      /* Output IO object */
 	DasStream* pSdOut;    /* Output Stream holder */
 	int nXReq;
@@ -540,6 +560,18 @@ int parseArgs(int argc, char** argv, Context* pCtx)
 				++(pCtx->nXReq);
 				continue;
 			}
+			if(dascmd_getArgVal(aOpBuf, 64, argv, argc, &i, "-i", "--interp=")){
+				pCtx->rLocTol = 0.01;
+				pCtx->rMaxStep = 10.0;
+				if((sscanf(aOpBuf, "%lf,%lf,%lf", &(pCtx->rRotTol), &(pCtx->rLocTol),
+					&(pCtx->rMaxStep)) < 1)||(pCtx->rRotTol <= 0.0)||
+					(pCtx->rLocTol <= 0.0)||(pCtx->rMaxStep <= 0.0)
+				)
+					return das_error(PERR, "Invalid interpolation tolerances '%s'", aOpBuf);
+
+				pCtx->rRotTol *= rpd_c() / 3600.0;   /* arcsec to radians */
+				continue;
+			}
 			if(dascmd_getArgVal(aOpBuf, 64, argv, argc, &i, "-s", "--shift-et=")){
 				if(sscanf(aOpBuf, "%lf", &(pCtx->rEphemShift)) != 1){
 					return das_error(PERR, 
@@ -589,6 +621,11 @@ int parseArgs(int argc, char** argv, Context* pCtx)
 			pCtx->aXReq[iReq].nGapRecs = 0;
 		}
 	}
+	for(size_t iReq = 0; iReq < pCtx->nXReq; ++iReq){
+		pCtx->aXReq[iReq].rRotTol = pCtx->rRotTol;
+		pCtx->aXReq[iReq].rLocTol = pCtx->rLocTol;
+		pCtx->aXReq[iReq].rMaxStep = pCtx->rMaxStep;
+	}
 	
 	return DAS_OKAY;
 }
@@ -854,6 +891,10 @@ DasErrCode onStream(DasStream* pSdIn, void* pUser){
 	DasDesc_setStr((DasDesc*)pSdOut, "meta_kernel", pCtx->aMetaKern);
 	if(pCtx->rEphemShift != 0)
 		DasDesc_setDouble((DasDesc*)pSdOut, "ephem_time_shift", pCtx->rEphemShift);
+	if(pCtx->rRotTol > 0){
+		DasDesc_setDouble((DasDesc*)pSdOut, "spice_interp_arcsec", pCtx->rRotTol * dpr_c() * 3600.0);
+		DasDesc_setDouble((DasDesc*)pSdOut, "spice_interp_km", pCtx->rLocTol);
+	}
 
 	/* Send it */
 	pCtx->pSdOut = pSdOut;
@@ -1004,6 +1045,23 @@ DasErrCode _addLocation(
 	return DasDs_addDim(pDsOut, pDimOut);
 }
 
+/* True if a frame is known to SPICE and is of the inertial class */
+static bool _isInertial(const char* sFrame)
+{
+	SpiceInt nFrameId;
+	SpiceInt nCentId;
+	SpiceInt nFrmClass;
+	SpiceInt nFrmClassId;
+	SpiceBoolean bFound;
+
+	namfrm_c(sFrame, &nFrameId);
+	if(nFrameId == 0)
+		return false;
+
+	frinfo_c(nFrameId, &nCentId, &nFrmClass, &nFrmClassId, &bFound);
+	return bFound && (nFrmClass == SPICE_FRMTYP_INERTL);
+}
+
 /* Add record dependent, or record independent rotation vector variable */
 
 const char* g_pRngProps[] = {
@@ -1037,6 +1095,10 @@ DasErrCode _addRotation(XCalc* pCalc, const char* sAnonFrame, DasDs* pDsOut)
 		strncpy(pReq->aInFrame, sFrame, DASFRM_NAME_SZ - 1);
 	}
 
+	/* Rotations between two inertial frames don't depend on time */
+	pReq->bFixed = _isInertial(pReq->aInFrame) && _isInertial(pReq->aOutFrame);
+	CHECK_SPICE;
+
 	/* The shape the storage array is:
 
 	   Shape of the input + shape of the time reference
@@ -1494,16 +1556,124 @@ double _dm2et(const das_datum* pInput, double rTimeShift)
 	return rEt;
 }
 
+/* Scratch space for SPICE results, one entry per unique record index.  SPICE
+   is called for all records in a dataset before any output is generated so
+   that the samplers in xform.h can skip most of the calls when interpolation
+   is requested. */
+typedef struct spice_samples {
+	size_t uSize;
+	size_t uLen;
+	double* pEt;
+	double* pVals;   /* 9 values/record for rotations, 6 for locations */
+	bool* pValid;
+	double* pVecs;   /* 3 values/record, input vectors for block rotations */
+} SpiceSamps;
+
+static SpiceSamps g_samps = {0};
+
+static void _freeSamps(void)
+{
+	free(g_samps.pEt);
+	free(g_samps.pVals);
+	free(g_samps.pValid);
+	free(g_samps.pVecs);
+	memset(&g_samps, 0, sizeof(SpiceSamps));
+}
+
+static DasErrCode _getEts(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
+{
+	das_datum dm;
+	DasDsUniqIter iter;
+	DasDsUniqIter_init(&iter, pDsIn, pCalc->pVarOut);
+
+	g_samps.uLen = 0;
+	for(; !iter.done; DasDsUniqIter_next(&iter)){
+		if(g_samps.uLen == g_samps.uSize){
+			size_t uSize = (g_samps.uSize == 0) ? 4096 : g_samps.uSize * 2;
+			double* pEt = (double*)realloc(g_samps.pEt, uSize*sizeof(double));
+			double* pVals = (double*)realloc(g_samps.pVals, 9*uSize*sizeof(double));
+			bool* pValid = (bool*)realloc(g_samps.pValid, uSize*sizeof(bool));
+			double* pVecs = (double*)realloc(g_samps.pVecs, 3*uSize*sizeof(double));
+			if(pEt) g_samps.pEt = pEt;
+			if(pVals) g_samps.pVals = pVals;
+			if(pValid) g_samps.pValid = pValid;
+			if(pVecs) g_samps.pVecs = pVecs;
+			if(!pEt || !pVals || !pValid || !pVecs)
+				return das_error(PERR, "Couldn't allocate %zu SPICE result records", uSize);
+			g_samps.uSize = uSize;
+		}
+		DasVar_get(pCalc->pTime, iter.index, &dm);
+		g_samps.pEt[g_samps.uLen] = _dm2et(&dm, rTimeShift);
+		++(g_samps.uLen);
+	}
+	return DAS_OKAY;
+}
+
+/* Handle SPICE failures for the samplers.  Gaps are reported and cleared if
+   gap filling is on, otherwise the error is left for CHECK_SPICE */
+static bool _spiceOkay(XReq* pReq, double rEt)
+{
+	char sUtc[36];
+
+	if(!failed_c()) return true;
+	if(!pReq->bGapFill) return false;
+
+	reset_c();
+	if(pReq->nGapRecs == 0){
+		memset(sUtc, 0, 36);
+		et2utc_c(rEt, "ISOC", 3, 32, sUtc);
+		if(pReq->uFlags & XFORM_LOC)
+			daslog_warn_v(
+				"SPICE coverage gap detected for %s in frame %s at %s, using fill (-g).", 
+				pReq->aBody, pReq->aOutFrame, sUtc
+			);
+		else
+			daslog_warn_v(
+				"SPICE coverage gap detected for frame %s at %s, using fill (-g).", 
+				pReq->aOutFrame, sUtc
+			);
+	}
+	++(pReq->nGapRecs);
+	return false;
+}
+
+static bool _spiceState(void* pUser, double rEt, double aState[6])
+{
+	XReq* pReq = (XReq*)pUser;
+	double rLt;  /* light time */
+
+	/* Velocities are only needed to interpolate */
+	if(pReq->rLocTol > 0.0){
+		spkez_c(
+			pReq->nBodyId, rEt, pReq->aOutFrame, "NONE", pReq->nOutCenter, aState, &rLt
+		);
+	}
+	else{
+		spkezp_c(
+			pReq->nBodyId, rEt, pReq->aOutFrame, "NONE", pReq->nOutCenter, aState, &rLt
+		);
+		aState[3] = 0.0; aState[4] = 0.0; aState[5] = 0.0;
+	}
+	return _spiceOkay(pReq, rEt);
+}
+
+static bool _spiceRot(void* pUser, double rEt, double mRot[3][3])
+{
+	XReq* pReq = (XReq*)pUser;
+	pxform_c(pReq->aInFrame, pReq->aOutFrame, rEt, mRot);
+	return _spiceOkay(pReq, rEt);
+}
+
 /* We want the input dataset here because we need to know how many provided
 	values we're going to get */
 DasErrCode _writeLocation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 {
-	double rEt, rLt;  /* ephemeris time, light time */ 
 	SpiceDouble aRecOut[3];
 	SpiceDouble aTmp[3];
 	SpiceInt    nTmp;
-	char sUtc[36];
 	float aOutput[3];
+	size_t uRec;
+	DasErrCode nRet;
 	
 	DasAry* pAryOut = DasVar_getArray(pCalc->pVarOut);
 	if(pAryOut == NULL)
@@ -1520,33 +1690,22 @@ DasErrCode _writeLocation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 		flatOut = (radOut - aTmp[0]) / radOut;
 	}
 
-	DasDsUniqIter iter;        /* Produces unique indexes for given DS and Var */
-	DasDsUniqIter_init(&iter, pDsIn, pCalc->pVarOut);
-	das_datum dm;
-	for(; !iter.done; DasDsUniqIter_next(&iter)){
+	if((nRet = _getEts(pDsIn, pCalc, rTimeShift)) != DAS_OKAY)
+		return nRet;
 
-		DasVar_get(pCalc->pTime, iter.index, &dm);
-		rEt = _dm2et(&dm, rTimeShift);
+	das_xform_sampleState(
+		g_samps.pEt, g_samps.uLen, pReq->rLocTol, pReq->rMaxStep, _spiceState,
+		pReq, g_samps.pVals, g_samps.pValid
+	);
+	CHECK_SPICE;
 
-		spkezp_c(
-			pReq->nBodyId, rEt, pReq->aOutFrame, "NONE", pReq->nOutCenter, aRecOut, &rLt
-		);
-		if(pReq->bGapFill && failed_c()){
+	for(uRec = 0; uRec < g_samps.uLen; ++uRec){
+
+		if(!g_samps.pValid[uRec]){
 			DasAry_append(pAryOut, NULL, 3); /* <-- assumes all 3 normally output */
-			reset_c();
-			if(pReq->bGapFill){
-				if(pReq->nGapRecs == 0){
-					memset(sUtc, 0, 36);
-					et2utc_c(rEt, "ISOC", 3, 32, sUtc);
-					daslog_warn_v(
-						"SPICE coverage gap detected for %s in frame %s at %s, using fill (-g).", 
-						pReq->aBody, pReq->aOutFrame, sUtc
-					);
-				}
-				++(pReq->nGapRecs);
-			}
 			continue;
 		}
+		memcpy(aRecOut, g_samps.pVals + 6*uRec, 3*sizeof(SpiceDouble));
 
 		if(uSysOut != DAS_VSYS_CART){  /* Convert output coord sys if needed */
 			switch(uSysOut){
@@ -1585,7 +1744,6 @@ DasErrCode _writeLocation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 		DasAry_append(pAryOut, (ubyte*) aOutput, 3);
 		/* DasAry_markEnd() See TODO note below on updates for rolling ragged arrays */
 	}
-	CHECK_SPICE;
 
 	return DAS_OKAY;
 }
@@ -1612,17 +1770,150 @@ DasErrCode _writeLocation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 	}
  */
 
+/* NaN fill values only match other NaNs */
+#define _VEC_FILL(X, F) (((X) == (F)) || (((X) != (X)) && ((F) != (F))))
+
+/* Get the fill value of the input vector components as a double, returns
+   false if the input isn't backed by a numeric array */
+static bool _vecFill(DasVar* pVarIn, double* pFill)
+{
+	DasAry* pAry = DasVar_getArray(pVarIn);
+	if(pAry == NULL) return false;
+	const ubyte* p = DasAry_getFill(pAry);
+	switch(DasAry_valType(pAry)){
+	case vtUByte:  *pFill = *((const uint8_t*)p);  return true;
+	case vtByte:   *pFill = *((const int8_t*)p);   return true;
+	case vtUShort: *pFill = *((const uint16_t*)p); return true;
+	case vtShort:  *pFill = *((const int16_t*)p);  return true;
+	case vtUInt:   *pFill = *((const uint32_t*)p); return true;
+	case vtInt:    *pFill = *((const int32_t*)p);  return true;
+	case vtULong:  *pFill = *((const uint64_t*)p); return true;
+	case vtLong:   *pFill = *((const int64_t*)p);  return true;
+	case vtFloat:  *pFill = *((const float*)p);    return true;
+	case vtDouble: *pFill = *((const double*)p);   return true;
+	default: return false;
+	}
+}
+
+/* Copy the input vectors for all records straight out of the backing array.
+   Returns the input coordinate system, or 0 if the input isn't a simple
+   record varying array of float or double vectors, in which case vectors
+   have to be read one at a time.  Inputs containing fill also go one at a
+   time, so that both paths output fill for them. */
+static ubyte _loadVecs(DasDs* pDsIn, DasVar* pVarIn)
+{
+	ubyte nComp = 0;
+	ubyte aDirs[3] = {0};
+	ptrdiff_t aVarShape[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+	ptrdiff_t aAryShape[DASIDX_MAX] = DASIDX_INIT_UNUSED;
+	size_t u, uVals;
+	int i;
+
+	if((g_samps.uLen == 0)||(DasDs_rank(pDsIn) != 1)||(DasVar_type(pVarIn) != D2V_ARRAY))
+		return 0;
+
+	ubyte uSys = DasVar_vecMap(pVarIn, &nComp, aDirs);
+	if((uSys != DAS_VSYS_CART)&&(uSys != DAS_VSYS_CYL)&&(uSys != DAS_VSYS_SPH)&&
+		(uSys != DAS_VSYS_CENTRIC)
+	)
+		return 0;
+	if((nComp < 1)||(nComp > 3))
+		return 0;
+
+	DasAry* pAry = DasVar_getArray(pVarIn);
+	if((pAry == NULL)||(DasAry_shape(pAry, aAryShape) != 2))
+		return 0;
+	DasVar_shape(pVarIn, aVarShape);
+	if((aVarShape[0] != (ptrdiff_t)g_samps.uLen)||
+		(aAryShape[0] != (ptrdiff_t)g_samps.uLen)||(aAryShape[1] != nComp)
+	)
+		return 0;
+
+	das_val_type vt = DasAry_valType(pAry);
+	if((vt != vtFloat)&&(vt != vtDouble))
+		return 0;
+	const ubyte* pVals = DasAry_getIn(pAry, vt, DIM0, &uVals);
+	if((pVals == NULL)||(uVals != g_samps.uLen * nComp))
+		return 0;
+
+	/* Missing components default the same way as in das_geovec_values() */
+	double rFill = 0.0;
+	_vecFill(pVarIn, &rFill);
+	double rDef0 = (uSys == DAS_VSYS_CART) ? 0.0 : 1.0;
+	double* pOut = g_samps.pVecs;
+	if(vt == vtDouble){
+		const double* pIn = (const double*)pVals;
+		for(u = 0; u < g_samps.uLen; ++u, pIn += nComp, pOut += 3){
+			pOut[0] = rDef0;  pOut[1] = 0.0;  pOut[2] = 0.0;
+			for(i = 0; i < nComp; ++i){
+				if(_VEC_FILL(pIn[i], rFill)) return 0;
+				pOut[aDirs[i]] = pIn[i];
+			}
+		}
+	}
+	else{
+		const float* pIn = (const float*)pVals;
+		for(u = 0; u < g_samps.uLen; ++u, pIn += nComp, pOut += 3){
+			pOut[0] = rDef0;  pOut[1] = 0.0;  pOut[2] = 0.0;
+			for(i = 0; i < nComp; ++i){
+				if(_VEC_FILL(pIn[i], rFill)) return 0;
+				pOut[aDirs[i]] = pIn[i];
+			}
+		}
+	}
+	return uSys;
+}
+
+/* Rotate the loaded input vectors a block at a time.  Each run of records
+   with the same validity is handled, and appended, in one go. */
+static DasErrCode _rotateBlock(
+	DasAry* pAryOut, XReq* pReq, ubyte uSysIn, size_t uMatStep
+){
+	size_t uBeg, uEnd, uRecs;
+	bool bValid;
+	double* pVecs;
+	DasErrCode nRet;
+
+	if((nRet = das_xform_toCart(uSysIn, g_samps.pVecs, g_samps.uLen)) != DAS_OKAY)
+		return nRet;
+
+	for(uBeg = 0; uBeg < g_samps.uLen; uBeg = uEnd){
+		bValid = g_samps.pValid[uMatStep ? uBeg : 0];
+		uEnd = uBeg + 1;
+		while((uEnd < g_samps.uLen)&&(g_samps.pValid[uMatStep ? uEnd : 0] == bValid))
+			++uEnd;
+		uRecs = uEnd - uBeg;
+
+		if(!bValid){
+			DasAry_append(pAryOut, NULL, 3*uRecs);
+			continue;
+		}
+
+		pVecs = g_samps.pVecs + 3*uBeg;
+		das_xform_rotate(g_samps.pVals + uMatStep*uBeg, uMatStep, pVecs, uRecs, pVecs);
+
+		if((nRet = das_xform_fromCart(pReq->uOutSystem, pVecs, uRecs)) != DAS_OKAY)
+			return nRet;
+
+		if(DasAry_append(pAryOut, (ubyte*)pVecs, 3*uRecs) == NULL)
+			return das_error(PERR, "Couldn't append %zu rotated vectors", uRecs);
+	}
+	return DAS_OKAY;
+}
+
 DasErrCode _writeRotation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 {
-	double rEt;  /* ephemeris time */ 
-	double mRot[3][3];
+	SpiceDouble (*mRot)[3];
 	SpiceDouble aRecIn[3];
 	SpiceDouble aRecOut[3];
 	SpiceDouble aTmp[3];
 	float aOutput[3];
 	ubyte uSysOut = 0;
 	das_geovec* pVecIn = NULL;
-	char sUtc[36];
+	size_t uRec = 0;
+	size_t uMatStep = 9;
+	ubyte uSysIn = 0;
+	DasErrCode nRet;
 
 	DasAry* pAryOut = DasVar_getArray(pCalc->pVarOut);
 	if(pAryOut == NULL)
@@ -1636,30 +1927,40 @@ DasErrCode _writeRotation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 	DasDsUniqIter iter;        /* Produces unique indexes for given DS and Var */
 	DasDsUniqIter_init(&iter, pDsIn, pVarOut);
 
-	das_datum dm;
-	for(; !iter.done; DasDsUniqIter_next(&iter)){
+	if((nRet = _getEts(pDsIn, pCalc, rTimeShift)) != DAS_OKAY)
+		return nRet;
 
-		DasVar_get(pCalc->pTime, iter.index, &dm);
-		
-		rEt = _dm2et(&dm, rTimeShift);
+	if(pReq->bFixed){             /* One matrix for all records */
+		uMatStep = 0;
+		das_xform_sampleRot(
+			g_samps.pEt, (g_samps.uLen > 0) ? 1 : 0, 0.0, 0.0, _spiceRot, pReq,
+			g_samps.pVals, g_samps.pValid
+		);
+	}
+	else{
+		das_xform_sampleRot(                                /* Get rot matrices */
+			g_samps.pEt, g_samps.uLen, pReq->rRotTol, pReq->rMaxStep, _spiceRot,
+			pReq, g_samps.pVals, g_samps.pValid
+		);
+	}
+	CHECK_SPICE;
+
+	/* Rotate in blocks if the input vectors can be read directly */
+	if((DasAry_valType(pAryOut) == vtDouble)&&((uSysIn = _loadVecs(pDsIn, pVarIn)) != 0))
+		return _rotateBlock(pAryOut, pReq, uSysIn, uMatStep);
+
+	/* Input vectors with any fill component are output as fill */
+	double rFill = 0.0;
+	bool bHasFill = _vecFill(pVarIn, &rFill);
 
-		pxform_c(pReq->aInFrame, pReq->aOutFrame, rEt, mRot);   /* Get rot matrix */
-		if(pReq->bGapFill && failed_c()){
+	das_datum dm;
+	for(; !iter.done; DasDsUniqIter_next(&iter), ++uRec){
+
+		if(!g_samps.pValid[uMatStep ? uRec : 0]){
 			DasAry_append(pAryOut, NULL, 3);
-			reset_c();
-			if(pReq->bGapFill){
-				if(pReq->nGapRecs == 0){
-					memset(sUtc, 0, 36);
-					et2utc_c(rEt, "ISOC", 3, 32, sUtc);
-					daslog_warn_v(
-						"SPICE coverage gap detected for frame %s at %s, using fill (-g).", 
-						pReq->aOutFrame, sUtc
-					);
-				}
-				++(pReq->nGapRecs);
-			}
 			continue;
 		}
+		mRot = (SpiceDouble (*)[3])(g_samps.pVals + uMatStep*uRec);
 
 		DasVar_get(pVarIn, iter.index, &dm);
 
@@ -1669,6 +1970,12 @@ DasErrCode _writeRotation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 		memset(aRecIn, 0, 3*sizeof(SpiceDouble));  /* zero any missing components */
 		das_geovec_values(pVecIn, aRecIn);
 
+		if(bHasFill && (_VEC_FILL(aRecIn[0], rFill)||_VEC_FILL(aRecIn[1], rFill)||
+		   _VEC_FILL(aRecIn[2], rFill))){
+			DasAry_append(pAryOut, NULL, 3);
+			continue;
+		}
+
 		if(pVecIn->systype != DAS_VSYS_CART){   /* convert non-cart input coords */
 			memcpy(aTmp, aRecIn, sizeof(SpiceDouble)*3);
 			
@@ -1722,7 +2029,6 @@ DasErrCode _writeRotation(DasDs* pDsIn, XCalc* pCalc, double rTimeShift)
 		}
 		/* DasAry_markEnd()          See TODO note above on rolling ragged arrays */
 	}
-	CHECK_SPICE;
 
 	return DAS_OKAY;
 }
@@ -1886,5 +2192,8 @@ int main(int argc, char** argv)
 
 	DasIO_addProcessor(pIn, &handler);
 	
-	return DasIO_readAll(pIn);  /* <---- RUNS ALL PROCESSING -----<<< */
+	int nRet = DasIO_readAll(pIn);  /* <---- RUNS ALL PROCESSING -----<<< */
+
+	_freeSamps();
+	return nRet;
 };
\ No newline at end of file